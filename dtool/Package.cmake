@@ -72,6 +72,7 @@ if(THIRDPARTY_DIRECTORY)
     HarfBuzz
     JPEG
     LibSquish
+    LZ4
     ODE
     Ogg
     OpenAL
@@ -85,6 +86,7 @@ if(THIRDPARTY_DIRECTORY)
     VorbisFile
     VRPN
     ZLIB
+    Zstd
   )
 
     string(TOLOWER "${_Package}" _package)
@@ -340,6 +342,23 @@ package_option(ZLIB
 
 package_status(ZLIB "zlib")
 
+# lz4
+find_package(LZ4 QUIET)
+
+package_option(LZ4
+  "Enables fast in-memory compression of vertex data with lz4.")
+
+package_status(LZ4 "lz4")
+
+# zstd
+find_package(Zstd QUIET)
+
+package_option(ZSTD
+  "Enables compression of vertex data written to disk with zstd."
+  FOUND_AS Zstd)
+
+package_status(ZSTD "zstd")
+
 
 #
 # ------------ Image formats ------------
@@ -73,6 +73,8 @@ protected:
 
   CPTA_stdfloat _tables[num_matrix_components];
 
+  friend class JointPoseBuffer;
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
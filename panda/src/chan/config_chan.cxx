@@ -101,6 +101,22 @@ PRC_DESC("This specifies the priority assign to an asynchronous bind "
          "model loads).  A higher number here makes the animations "
          "load sooner."));
 
+ConfigVariableBool joint_pose_buffer
+("joint-pose-buffer", false,
+PRC_DESC("Set this true to have each PartBundle blend its animations through "
+         "a JointPoseBuffer, which blends the poses of all of the joints "
+         "together in one pass per animation, instead of one joint at a "
+         "time.  This can also be changed on a per-character basis with "
+         "PartBundle::set_pose_buffer_flag()."));
+
+ConfigVariableInt anim_update_num_threads
+("anim-update-num-threads", 0,
+PRC_DESC("The default number of threads a PartBundleUpdater uses to update "
+         "the joints of its bundles.  When this is greater than 1, the "
+         "bundles are handed out to the threads of the task-graph-chain, "
+         "while the calling thread updates bundles as well.  Set this to 0 "
+         "or 1 to update all bundles on the calling thread."));
+
 ConfigureFn(config_chan) {
   AnimBundle::init_type();
   AnimBundleNode::init_type();
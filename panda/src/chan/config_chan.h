@@ -28,5 +28,7 @@ EXPCL_PANDA_CHAN extern ConfigVariableBool read_compressed_channels;
 EXPCL_PANDA_CHAN extern ConfigVariableBool interpolate_frames;
 EXPCL_PANDA_CHAN extern ConfigVariableBool restore_initial_pose;
 EXPCL_PANDA_CHAN extern ConfigVariableInt async_bind_priority;
+EXPCL_PANDA_CHAN extern ConfigVariableBool joint_pose_buffer;
+EXPCL_PANDA_CHAN extern ConfigVariableInt anim_update_num_threads;
 
 #endif
@@ -0,0 +1,489 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jointPoseBuffer.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "jointPoseBuffer.h"
+#include "partBundle.h"
+#include "movingPartMatrix.h"
+#include "animChannelMatrixXfmTable.h"
+#include "animControl.h"
+#include "compose_matrix.h"
+
+#include <algorithm>
+
+/**
+ * Computes the upper 3x3 part of the matrix that applies the indicated scale
+ * followed by the indicated rotation, as LQuaternion::extract_to_matrix()
+ * does for the rotation alone.  This is written so that the compiler may
+ * vectorize a loop calling it.
+ */
+static INLINE void
+compose_upper_3(PN_stdfloat m[9], PN_stdfloat qr, PN_stdfloat qi,
+                PN_stdfloat qj, PN_stdfloat qk,
+                PN_stdfloat sx, PN_stdfloat sy, PN_stdfloat sz) {
+  PN_stdfloat n = qr * qr + qi * qi + qj * qj + qk * qk;
+  PN_stdfloat s = (n == 0.0f) ? 0.0f : (2.0f / n);
+
+  PN_stdfloat xs = qi * s, ys = qj * s, zs = qk * s;
+  PN_stdfloat wx = qr * xs, wy = qr * ys, wz = qr * zs;
+  PN_stdfloat xx = qi * xs, xy = qi * ys, xz = qi * zs;
+  PN_stdfloat yy = qj * ys, yz = qj * zs, zz = qk * zs;
+
+  m[0] = sx * (1.0f - (yy + zz));
+  m[1] = sx * (xy + wz);
+  m[2] = sx * (xz - wy);
+  m[3] = sy * (xy - wz);
+  m[4] = sy * (1.0f - (xx + zz));
+  m[5] = sy * (yz + wx);
+  m[6] = sz * (xz + wy);
+  m[7] = sz * (yz - wx);
+  m[8] = sz * (1.0f - (xx + yy));
+}
+
+/**
+ * Creates a buffer for the joints that are currently in the indicated bundle.
+ */
+JointPoseBuffer::
+JointPoseBuffer(PartBundle *bundle) :
+  _bundle(bundle),
+  _valid(false),
+  _net_stale(true)
+{
+  r_add_joints(bundle, -1);
+
+  size_t num_joints = _joints.size();
+  for (int c = 0; c < C_num_components; ++c) {
+    _sample[c].resize(num_joints, 0.0f);
+    _blend[c].resize(num_joints, 0.0f);
+  }
+  for (int c = 0; c < num_matrix_components; ++c) {
+    _matrix[c].resize(num_joints, 0.0f);
+  }
+  _mask.resize(num_joints, 0.0f);
+  _weight.resize(num_joints, 0.0f);
+  _local.resize(num_joints, LMatrix4::ident_mat());
+  _net.resize(num_joints, LMatrix4::ident_mat());
+}
+
+/**
+ *
+ */
+JointPoseBuffer::
+~JointPoseBuffer() {
+  // If the bundle has since made a new buffer, the joints now hold indices
+  // into that one, which we must leave alone.
+  PT(PartBundle) bundle = _bundle.lock();
+  if (bundle != nullptr && bundle->_pose_buffer != nullptr) {
+    return;
+  }
+  for (MovingPartMatrix *joint : _joints) {
+    joint->_pose_index = -1;
+  }
+}
+
+/**
+ * Returns the PartBundle whose joints are stored in this buffer, or NULL if
+ * the bundle has since been destructed.
+ */
+PT(PartBundle) JointPoseBuffer::
+get_bundle() const {
+  return _bundle.lock();
+}
+
+/**
+ * Returns the transform of the nth joint relative to the bundle, as of the
+ * last update of the bundle: the joint's value composed with those of its
+ * parents and with the bundle's root transform.  This is computed the first
+ * time it is requested after each update.
+ */
+const LMatrix4 &JointPoseBuffer::
+get_net_transform(int n) {
+  nassertr(n >= 0 && n < (int)_net.size(), LMatrix4::ident_mat());
+  if (_net_stale) {
+    compose_net_transforms();
+  }
+  return _net[n];
+}
+
+/**
+ * Gathers the current frame of each of the bundle's active animations and
+ * blends them together, according to the bundle's blend type.  The results
+ * are then available from get_local_transform().  This is called by the
+ * PartBundle at the start of each update.
+ *
+ * Returns true if the blend was computed, or false if there are no active
+ * animations, or the blend type is not supported by the buffer, in which
+ * case the joints must compute their own values.
+ */
+bool JointPoseBuffer::
+sample(const CycleData *root_cdata) {
+  const PartBundle::CData *cdata = (const PartBundle::CData *)root_cdata;
+  _valid = false;
+  _net_stale = true;
+
+  size_t num_joints = _joints.size();
+  if (num_joints == 0 || cdata->_blend.empty()) {
+    return false;
+  }
+
+  PartBundle::BlendType blend_type = cdata->_blend_type;
+  if (blend_type != PartBundle::BT_linear &&
+      blend_type != PartBundle::BT_normalized_linear &&
+      blend_type != PartBundle::BT_componentwise_quat) {
+    return false;
+  }
+
+  for (int c = 0; c < C_num_components; ++c) {
+    std::fill(_blend[c].begin(), _blend[c].end(), 0.0f);
+  }
+  for (int c = 0; c < num_matrix_components; ++c) {
+    std::fill(_matrix[c].begin(), _matrix[c].end(), 0.0f);
+  }
+  std::fill(_weight.begin(), _weight.end(), 0.0f);
+
+  PartBundle::ChannelBlend::const_iterator cbi;
+  for (cbi = cdata->_blend.begin(); cbi != cdata->_blend.end(); ++cbi) {
+    AnimControl *control = (*cbi).first;
+    PN_stdfloat effect = (*cbi).second;
+    nassertr(effect != 0.0f, false);
+
+    int channel_index = control->get_channel_index();
+    if (channel_index < 0) {
+      continue;
+    }
+
+    // Each frame is gathered into the _sample streams, and then added to the
+    // running sums with its weight.
+    int num_frames = 1;
+    int frames[2] = { control->get_frame(), 0 };
+    PN_stdfloat effects[2] = { effect, 0.0f };
+    if (cdata->_frame_blend_flag) {
+      PN_stdfloat frac = (PN_stdfloat)control->get_frac();
+      num_frames = 2;
+      frames[1] = control->get_next_frame();
+      effects[0] = effect * (1.0f - frac);
+      effects[1] = effect * frac;
+    }
+
+    for (int f = 0; f < num_frames; ++f) {
+      gather(channel_index, frames[f]);
+
+      switch (blend_type) {
+      case PartBundle::BT_linear:
+        accumulate_matrices(effects[f], true);
+        break;
+
+      case PartBundle::BT_normalized_linear:
+        accumulate_matrices(effects[f], false);
+        accumulate_components(effects[f]);
+        break;
+
+      default:
+        accumulate_components(effects[f]);
+        break;
+      }
+    }
+
+    const PN_stdfloat *mask = &_mask[0];
+    PN_stdfloat *weight = &_weight[0];
+    for (size_t j = 0; j < num_joints; ++j) {
+      weight[j] += mask[j] * effect;
+    }
+  }
+
+  // Now divide out the weights, and produce the matrices.
+  if (blend_type == PartBundle::BT_componentwise_quat) {
+    for (int c = 0; c < C_num_components; ++c) {
+      PN_stdfloat *blend = &_blend[c][0];
+      const PN_stdfloat *weight = &_weight[0];
+      for (size_t j = 0; j < num_joints; ++j) {
+        blend[j] = (weight[j] != 0.0f) ? blend[j] / weight[j] : 0.0f;
+      }
+    }
+    // There should be no need to normalize the quaternion, assuming all of
+    // the input quaternions were already normalized.
+    compose_matrices();
+
+  } else {
+    for (int c = 0; c < num_matrix_components; ++c) {
+      PN_stdfloat *matrix = &_matrix[c][0];
+      const PN_stdfloat *weight = &_weight[0];
+      for (size_t j = 0; j < num_joints; ++j) {
+        matrix[j] = (weight[j] != 0.0f) ? matrix[j] / weight[j] : 0.0f;
+      }
+    }
+
+    for (size_t j = 0; j < num_joints; ++j) {
+      LMatrix4 &mat = _local[j];
+      mat.set(_matrix[0][j], _matrix[1][j], _matrix[2][j], 0.0f,
+              _matrix[3][j], _matrix[4][j], _matrix[5][j], 0.0f,
+              _matrix[6][j], _matrix[7][j], _matrix[8][j], 0.0f,
+              _matrix[9][j], _matrix[10][j], _matrix[11][j], 1.0f);
+    }
+
+    if (blend_type == PartBundle::BT_normalized_linear) {
+      // Rebuild each matrix with the correct scale and shear.  This part is
+      // done one joint at a time, as in MovingPartMatrix.
+      for (size_t j = 0; j < num_joints; ++j) {
+        PN_stdfloat weight = _weight[j];
+        if (weight != 0.0f) {
+          LVecBase3 scale(_blend[C_scale_x][j], _blend[C_scale_y][j],
+                          _blend[C_scale_z][j]);
+          LVecBase3 shear(_blend[C_shear_x][j], _blend[C_shear_y][j],
+                          _blend[C_shear_z][j]);
+          scale /= weight;
+          shear /= weight;
+
+          LVector3 false_scale, false_shear, hpr, translate;
+          decompose_matrix(_local[j], false_scale, false_shear, hpr, translate);
+          compose_matrix(_local[j], scale, shear, hpr, translate);
+        }
+      }
+    }
+  }
+
+  _valid = true;
+  return true;
+}
+
+/**
+ * Adds the MovingPartMatrix parts at and below the indicated part to the
+ * buffer, in depth-first order.
+ */
+void JointPoseBuffer::
+r_add_joints(PartGroup *part, int parent_index) {
+  if (part->is_of_type(MovingPartMatrix::get_class_type())) {
+    MovingPartMatrix *joint = DCAST(MovingPartMatrix, part);
+    int index = (int)_joints.size();
+    joint->_pose_index = index;
+    _joints.push_back(joint);
+    _parents.push_back(parent_index);
+    parent_index = index;
+  } else {
+    // A joint below some other kind of part takes its transform from the
+    // root, as in CharacterJoint::update_internals().
+    parent_index = -1;
+  }
+
+  int num_children = part->get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_add_joints(part->get_child(i), parent_index);
+  }
+}
+
+/**
+ * Recomputes the _net array from the current values of the joints.
+ */
+void JointPoseBuffer::
+compose_net_transforms() {
+  LMatrix4 root_xform = LMatrix4::ident_mat();
+  PT(PartBundle) bundle = _bundle.lock();
+  if (bundle != nullptr) {
+    root_xform = bundle->get_root_xform();
+  }
+
+  size_t num_joints = _joints.size();
+  for (size_t j = 0; j < num_joints; ++j) {
+    int parent = _parents[j];
+    _net[j] = _joints[j]->_value * ((parent < 0) ? root_xform : _net[parent]);
+  }
+  _net_stale = false;
+}
+
+/**
+ * Fills the _sample streams with the pose of each joint at the indicated
+ * frame of the animation bound at the indicated channel index, and the _mask
+ * stream with 1 for the joints that have a channel there, or 0 for those that
+ * don't.
+ */
+void JointPoseBuffer::
+gather(int channel_index, int frame) {
+  _sheared.clear();
+
+  size_t num_joints = _joints.size();
+  for (size_t j = 0; j < num_joints; ++j) {
+    MovingPartMatrix *joint = _joints[j];
+    AnimChannelBase *channel = nullptr;
+    if (channel_index < joint->get_max_bound()) {
+      channel = joint->get_bound(channel_index);
+    }
+
+    LVecBase3 pos, scale, shear;
+    LQuaternion quat;
+    if (channel == nullptr) {
+      _mask[j] = 0.0f;
+      pos.set(0.0f, 0.0f, 0.0f);
+      quat.set(0.0f, 0.0f, 0.0f, 0.0f);
+      scale.set(0.0f, 0.0f, 0.0f);
+      shear.set(0.0f, 0.0f, 0.0f);
+
+    } else if (channel->is_exact_type(AnimChannelMatrixXfmTable::get_class_type())) {
+      // This is by far the most common kind of channel; we can read its
+      // tables directly.
+      const AnimChannelMatrixXfmTable *table = (const AnimChannelMatrixXfmTable *)channel;
+      PN_stdfloat components[num_matrix_components];
+      for (int i = 0; i < num_matrix_components; ++i) {
+        const CPTA_stdfloat &data = table->_tables[i];
+        if (data.empty()) {
+          components[i] = AnimChannelMatrixXfmTable::get_default_value(i);
+        } else {
+          components[i] = data[frame % data.size()];
+        }
+      }
+      _mask[j] = 1.0f;
+      scale.set(components[0], components[1], components[2]);
+      shear.set(components[3], components[4], components[5]);
+      quat.set_hpr(LVecBase3(components[6], components[7], components[8]));
+      pos.set(components[9], components[10], components[11]);
+
+    } else {
+      AnimChannelMatrix *matrix_channel = DCAST(AnimChannelMatrix, channel);
+      _mask[j] = 1.0f;
+      matrix_channel->get_pos(frame, pos);
+      matrix_channel->get_quat(frame, quat);
+      matrix_channel->get_scale(frame, scale);
+      matrix_channel->get_shear(frame, shear);
+    }
+
+    _sample[C_pos_x][j] = pos[0];
+    _sample[C_pos_y][j] = pos[1];
+    _sample[C_pos_z][j] = pos[2];
+    _sample[C_quat_r][j] = quat[0];
+    _sample[C_quat_i][j] = quat[1];
+    _sample[C_quat_j][j] = quat[2];
+    _sample[C_quat_k][j] = quat[3];
+    _sample[C_scale_x][j] = scale[0];
+    _sample[C_scale_y][j] = scale[1];
+    _sample[C_scale_z][j] = scale[2];
+    _sample[C_shear_x][j] = shear[0];
+    _sample[C_shear_y][j] = shear[1];
+    _sample[C_shear_z][j] = shear[2];
+
+    if (shear != LVecBase3::zero()) {
+      _sheared.push_back((int)j);
+    }
+  }
+}
+
+/**
+ * Adds the _sample streams to the _blend streams, with the indicated weight.
+ */
+void JointPoseBuffer::
+accumulate_components(PN_stdfloat effect) {
+  size_t num_joints = _joints.size();
+  const PN_stdfloat *mask = &_mask[0];
+
+  for (int c = 0; c < C_num_components; ++c) {
+    const PN_stdfloat *sample = &_sample[c][0];
+    PN_stdfloat *blend = &_blend[c][0];
+    for (size_t j = 0; j < num_joints; ++j) {
+      blend[j] += sample[j] * (mask[j] * effect);
+    }
+  }
+}
+
+/**
+ * Converts the _sample streams to matrices and adds these to the _matrix
+ * streams, with the indicated weight.  If scale_shear is false, the matrices
+ * include only the rotation and translation.
+ */
+void JointPoseBuffer::
+accumulate_matrices(PN_stdfloat effect, bool scale_shear) {
+  size_t num_joints = _joints.size();
+  const PN_stdfloat *mask = &_mask[0];
+
+  const PN_stdfloat *qr = &_sample[C_quat_r][0];
+  const PN_stdfloat *qi = &_sample[C_quat_i][0];
+  const PN_stdfloat *qj = &_sample[C_quat_j][0];
+  const PN_stdfloat *qk = &_sample[C_quat_k][0];
+  const PN_stdfloat *sx = &_sample[C_scale_x][0];
+  const PN_stdfloat *sy = &_sample[C_scale_y][0];
+  const PN_stdfloat *sz = &_sample[C_scale_z][0];
+
+  PN_stdfloat *out[num_matrix_components];
+  for (int c = 0; c < num_matrix_components; ++c) {
+    out[c] = &_matrix[c][0];
+  }
+
+  for (size_t j = 0; j < num_joints; ++j) {
+    PN_stdfloat m[9];
+    if (scale_shear) {
+      compose_upper_3(m, qr[j], qi[j], qj[j], qk[j], sx[j], sy[j], sz[j]);
+    } else {
+      compose_upper_3(m, qr[j], qi[j], qj[j], qk[j], 1.0f, 1.0f, 1.0f);
+    }
+    PN_stdfloat e = mask[j] * effect;
+    for (int c = 0; c < 9; ++c) {
+      out[c][j] += m[c] * e;
+    }
+  }
+
+  for (int c = 0; c < 3; ++c) {
+    const PN_stdfloat *pos = &_sample[C_pos_x + c][0];
+    PN_stdfloat *row = out[9 + c];
+    for (size_t j = 0; j < num_joints; ++j) {
+      row[j] += pos[j] * (mask[j] * effect);
+    }
+  }
+
+  if (scale_shear) {
+    // The loop above left out the shear; correct the joints that have one.
+    for (int j : _sheared) {
+      LVecBase3 scale(sx[j], sy[j], sz[j]);
+      LVecBase3 shear(_sample[C_shear_x][j], _sample[C_shear_y][j],
+                      _sample[C_shear_z][j]);
+      LQuaternion quat(qr[j], qi[j], qj[j], qk[j]);
+      LMatrix4 exact = LMatrix4::scale_shear_mat(scale, shear) * quat;
+
+      PN_stdfloat m[9];
+      compose_upper_3(m, qr[j], qi[j], qj[j], qk[j], sx[j], sy[j], sz[j]);
+      PN_stdfloat e = mask[j] * effect;
+      for (int c = 0; c < 9; ++c) {
+        out[c][j] += (exact(c / 3, c % 3) - m[c]) * e;
+      }
+    }
+  }
+}
+
+/**
+ * Converts the _blend streams, which must already have been divided by their
+ * weights, into the _local matrices.
+ */
+void JointPoseBuffer::
+compose_matrices() {
+  size_t num_joints = _joints.size();
+
+  for (size_t j = 0; j < num_joints; ++j) {
+    PN_stdfloat m[9];
+    compose_upper_3(m, _blend[C_quat_r][j], _blend[C_quat_i][j],
+                    _blend[C_quat_j][j], _blend[C_quat_k][j],
+                    _blend[C_scale_x][j], _blend[C_scale_y][j],
+                    _blend[C_scale_z][j]);
+    _local[j].set(m[0], m[1], m[2], 0.0f,
+                  m[3], m[4], m[5], 0.0f,
+                  m[6], m[7], m[8], 0.0f,
+                  _blend[C_pos_x][j], _blend[C_pos_y][j], _blend[C_pos_z][j], 1.0f);
+
+    if (_blend[C_shear_x][j] != 0.0f || _blend[C_shear_y][j] != 0.0f ||
+        _blend[C_shear_z][j] != 0.0f) {
+      LVecBase3 scale(_blend[C_scale_x][j], _blend[C_scale_y][j],
+                      _blend[C_scale_z][j]);
+      LVecBase3 shear(_blend[C_shear_x][j], _blend[C_shear_y][j],
+                      _blend[C_shear_z][j]);
+      LQuaternion quat(_blend[C_quat_r][j], _blend[C_quat_i][j],
+                       _blend[C_quat_j][j], _blend[C_quat_k][j]);
+      _local[j] = LMatrix4::scale_shear_mat(scale, shear) * quat;
+      _local[j].set_row(3, LVecBase3(_blend[C_pos_x][j], _blend[C_pos_y][j],
+                                     _blend[C_pos_z][j]));
+    }
+  }
+}
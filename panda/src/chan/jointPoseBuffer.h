@@ -0,0 +1,125 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jointPoseBuffer.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef JOINTPOSEBUFFER_H
+#define JOINTPOSEBUFFER_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "weakPointerTo.h"
+#include "pvector.h"
+#include "luse.h"
+
+class PartBundle;
+class PartGroup;
+class MovingPartMatrix;
+class CycleData;
+
+/**
+ * A flattened copy of the joint hierarchy of a PartBundle, which stores the
+ * pose of every joint in a separate array for each component: translation,
+ * rotation (as a quaternion), scale and shear.  Blending between several
+ * animations or frames then becomes a series of simple loops over these
+ * arrays, one per animation, instead of a walk through the hierarchy that
+ * blends each joint separately.
+ *
+ * A PartBundle creates one of these for itself when
+ * PartBundle::set_pose_buffer_flag() is enabled.  It supports the
+ * BT_linear, BT_normalized_linear and BT_componentwise_quat blend types; the
+ * bundle falls back to blending each joint separately with BT_componentwise.
+ *
+ * The buffer is built from the joints in the bundle at the time it is
+ * created; if joints are added later, disable and re-enable the flag.
+ */
+class EXPCL_PANDA_CHAN JointPoseBuffer : public ReferenceCount {
+PUBLISHED:
+  explicit JointPoseBuffer(PartBundle *bundle);
+  ~JointPoseBuffer();
+
+  PT(PartBundle) get_bundle() const;
+
+  INLINE int get_num_joints() const;
+  INLINE MovingPartMatrix *get_joint(int n) const;
+  MAKE_SEQ(get_joints, get_num_joints, get_joint);
+  INLINE int get_parent_index(int n) const;
+
+  INLINE bool has_local_transform(int n) const;
+  INLINE const LMatrix4 &get_local_transform(int n) const;
+  const LMatrix4 &get_net_transform(int n);
+
+  MAKE_PROPERTY(bundle, get_bundle);
+  MAKE_SEQ_PROPERTY(joints, get_num_joints, get_joint);
+
+public:
+  bool sample(const CycleData *root_cdata);
+
+private:
+  void r_add_joints(PartGroup *part, int parent_index);
+  void compose_net_transforms();
+
+  void gather(int channel_index, int frame);
+  void accumulate_components(PN_stdfloat effect);
+  void accumulate_matrices(PN_stdfloat effect, bool scale_shear);
+  void compose_matrices();
+
+  typedef pvector<PN_stdfloat> Stream;
+
+  // The components of a sampled pose, each stored in its own Stream.
+  enum Component {
+    C_pos_x, C_pos_y, C_pos_z,
+    C_quat_r, C_quat_i, C_quat_j, C_quat_k,
+    C_scale_x, C_scale_y, C_scale_z,
+    C_shear_x, C_shear_y, C_shear_z,
+    C_num_components
+  };
+
+  // The upper 4x3 part of a matrix, also stored in a Stream each, in the
+  // order of the matrix rows.
+  enum {
+    num_matrix_components = 12
+  };
+
+  // The bundle holds a reference to its buffer, so the buffer only holds a
+  // weak reference back.
+  WPT(PartBundle) _bundle;
+
+  typedef pvector<PT(MovingPartMatrix)> Joints;
+  Joints _joints;
+  pvector<int> _parents;
+
+  // The pose of each joint for the animation frame being gathered, and 1 for
+  // each joint that has a channel in that animation, or 0 if it has none.
+  Stream _sample[C_num_components];
+  Stream _mask;
+
+  // The weighted sums of the gathered poses, and of their weights.
+  Stream _blend[C_num_components];
+  Stream _matrix[num_matrix_components];
+  Stream _weight;
+
+  // The results of the last call to sample().
+  pvector<LMatrix4> _local;
+  pvector<LMatrix4> _net;
+  bool _valid;
+  bool _net_stale;
+
+  // The joints with a nonzero shear, which compose_matrices() must handle
+  // separately.
+  pvector<int> _sheared;
+};
+
+#include "jointPoseBuffer.I"
+
+#endif
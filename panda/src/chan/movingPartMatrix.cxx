@@ -14,6 +14,7 @@
 #include "movingPartMatrix.h"
 #include "animChannelMatrixDynamic.h"
 #include "animChannelMatrixFixed.h"
+#include "jointPoseBuffer.h"
 #include "compose_matrix.h"
 #include "datagram.h"
 #include "datagramIterator.h"
@@ -59,6 +60,16 @@ get_blend_value(const PartBundle *root) {
     return;
   }
 
+  // If the bundle has already blended this joint along with the others, take
+  // the value from there.
+  if (_pose_index >= 0) {
+    const JointPoseBuffer *pose_buffer = root->_pose_buffer;
+    if (pose_buffer != nullptr && pose_buffer->has_local_transform(_pose_index)) {
+      _value = pose_buffer->get_local_transform(_pose_index);
+      return;
+    }
+  }
+
   PartBundle::CDReader cdata(root->_cycler);
 
   if (cdata->_blend.empty()) {
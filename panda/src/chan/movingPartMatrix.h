@@ -44,6 +44,10 @@ public:
 protected:
   INLINE MovingPartMatrix();
 
+private:
+  // The index of this joint within the bundle's JointPoseBuffer, if any.
+  int _pose_index;
+
 public:
   static void register_with_read_factory();
 
@@ -68,6 +72,8 @@ public:
 
 private:
   static TypeHandle _type_handle;
+
+  friend class JointPoseBuffer;
 };
 
 #include "movingPartMatrix.I"
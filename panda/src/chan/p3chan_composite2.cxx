@@ -1,11 +1,13 @@
 #include "animPreloadTable.cxx"
 #include "bindAnimRequest.cxx"
 #include "config_chan.cxx"
+#include "jointPoseBuffer.cxx"
 #include "movingPartBase.cxx"
 #include "movingPartMatrix.cxx"
 #include "movingPartScalar.cxx"
 #include "partBundle.cxx"
 #include "partBundleNode.cxx"
+#include "partBundleUpdater.cxx"
 #include "partGroup.cxx"
 #include "partSubset.cxx"
 #include "vector_PartGroupStar.cxx"
@@ -55,6 +55,7 @@ PartBundle(const PartBundle &copy) :
 {
   _anim_preload = copy._anim_preload;
   _update_delay = 0.0;
+  _pose_buffer_flag = copy._pose_buffer_flag;
 
   CDWriter cdata(_cycler, true);
   CDReader cdata_from(copy._cycler);
@@ -73,6 +74,7 @@ PartBundle(const string &name) :
   PartGroup(name)
 {
   _update_delay = 0.0;
+  _pose_buffer_flag = joint_pose_buffer;
 }
 
 /**
@@ -140,6 +142,30 @@ set_anim_blend_flag(bool anim_blend_flag) {
   }
 }
 
+/**
+ * Specifies whether the bundle blends its animations through a
+ * JointPoseBuffer, which stores the pose of all of the joints in a separate
+ * array per component and blends these arrays together in a single pass per
+ * animation, rather than blending each joint separately.  This is only
+ * effective with the BT_linear, BT_normalized_linear and
+ * BT_componentwise_quat blend types, and is most worthwhile when several
+ * animations, or consecutive frames, are blended at once.
+ *
+ * The buffer is created at the next update, from the joints in the bundle at
+ * that time.  The default value of this flag is determined by the
+ * joint-pose-buffer Config.prc variable.
+ */
+void PartBundle::
+set_pose_buffer_flag(bool pose_buffer_flag) {
+  _pose_buffer_flag = pose_buffer_flag;
+
+  // The buffer is rebuilt on the next update, if it is needed.
+  _pose_buffer.clear();
+
+  CDWriter cdata(_cycler);
+  cdata->_anim_changed = true;
+}
+
 /**
  * Returns a PartBundle that is a duplicate of this one, but with the
  * indicated transform applied.  If this is called multiple times with the
@@ -483,6 +509,7 @@ update() {
     bool anim_changed = cdata->_anim_changed;
     bool frame_blend_flag = cdata->_frame_blend_flag;
 
+    sample_pose_buffer(cdata);
     any_changed = do_update(this, cdata, nullptr, false, anim_changed,
                             current_thread);
 
@@ -500,6 +527,18 @@ update() {
   return any_changed;
 }
 
+/**
+ * Returns true if a call to update() would recompute the parts in the bundle
+ * now, or false if it would do nothing, because the bundle has already been
+ * updated recently and its animation has not changed since.
+ */
+bool PartBundle::
+needs_update(Thread *current_thread) const {
+  CDReader cdata(_cycler, current_thread);
+  double now = ClockObject::get_global_clock()->get_frame_time(current_thread);
+  return now > cdata->_last_update + _update_delay || cdata->_anim_changed;
+}
+
 /**
  * Updates all the parts in the bundle to reflect the data for the current
  * frame, whether we believe it needs it or not.
@@ -508,6 +547,7 @@ bool PartBundle::
 force_update() {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, false, current_thread);
+  sample_pose_buffer(cdata);
   bool any_changed = do_update(this, cdata, nullptr, true, true, current_thread);
 
   // Now update all the controls for next time.
@@ -695,6 +735,21 @@ do_get_control_effect(AnimControl *control, const CData *cdata) const {
   }
 }
 
+/**
+ * Fills in the JointPoseBuffer, if it is enabled, with the blended values of
+ * the joints for the current frame, to be picked up by the joints during
+ * do_update().
+ */
+void PartBundle::
+sample_pose_buffer(const CData *cdata) {
+  if (_pose_buffer_flag) {
+    if (_pose_buffer == nullptr) {
+      _pose_buffer = new JointPoseBuffer(this);
+    }
+    _pose_buffer->sample(cdata);
+  }
+}
+
 /**
  * Removes and stops all the currently activated AnimControls that animate
  * some joints also animated by the indicated AnimControl.  This is a special
@@ -31,6 +31,7 @@
 #include "transformState.h"
 #include "weakPointerTo.h"
 #include "copyOnWritePointer.h"
+#include "jointPoseBuffer.h"
 
 class Loader;
 class AnimBundle;
@@ -109,6 +110,10 @@ PUBLISHED:
   INLINE const LMatrix4 &get_root_xform() const;
   PT(PartBundle) apply_transform(const TransformState *transform);
 
+  void set_pose_buffer_flag(bool pose_buffer_flag);
+  INLINE bool get_pose_buffer_flag() const;
+  INLINE JointPoseBuffer *get_pose_buffer() const;
+
   INLINE int get_num_nodes() const;
   INLINE PartBundleNode *get_node(int n) const;
   MAKE_SEQ(get_nodes, get_num_nodes, get_node);
@@ -117,6 +122,8 @@ PUBLISHED:
   MAKE_PROPERTY(anim_blend_flag, get_anim_blend_flag, set_anim_blend_flag);
   MAKE_PROPERTY(frame_blend_flag, get_frame_blend_flag, set_frame_blend_flag);
   MAKE_PROPERTY(root_xform, get_root_xform, set_root_xform);
+  MAKE_PROPERTY(pose_buffer_flag, get_pose_buffer_flag, set_pose_buffer_flag);
+  MAKE_PROPERTY(pose_buffer, get_pose_buffer);
   MAKE_SEQ_PROPERTY(nodes, get_num_nodes, get_node);
 
   void clear_control_effects();
@@ -151,6 +158,7 @@ public:
   virtual void control_activated(AnimControl *control);
   void control_removed(AnimControl *control);
   INLINE void set_update_delay(double delay);
+  bool needs_update(Thread *current_thread) const;
 
   bool do_bind_anim(AnimControl *control, AnimBundle *anim,
                     int hierarchy_match_flags, const PartSubset &subset);
@@ -165,6 +173,7 @@ private:
   void do_set_control_effect(AnimControl *control, PN_stdfloat effect, CData *cdata);
   PN_stdfloat do_get_control_effect(AnimControl *control, const CData *cdata) const;
   void clear_and_stop_intersecting(AnimControl *control, CData *cdata);
+  void sample_pose_buffer(const CData *cdata);
 
   COWPT(AnimPreloadTable) _anim_preload;
 
@@ -176,6 +185,9 @@ private:
 
   double _update_delay;
 
+  bool _pose_buffer_flag;
+  PT(JointPoseBuffer) _pose_buffer;
+
   // This is the data that must be cycled between pipeline stages.
   class CData : public CycleData {
   public:
@@ -239,6 +251,7 @@ private:
   friend class MovingPartBase;
   friend class MovingPartMatrix;
   friend class MovingPartScalar;
+  friend class JointPoseBuffer;
 };
 
 inline std::ostream &operator <<(std::ostream &out, const PartBundle &bundle) {
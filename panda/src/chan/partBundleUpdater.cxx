@@ -0,0 +1,196 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file partBundleUpdater.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "partBundleUpdater.h"
+#include "partBundleNode.h"
+#include "config_chan.h"
+#include "nodePath.h"
+#include "pandaNode.h"
+#include "pStatTimer.h"
+#include "asyncTaskGraph.h"
+
+#include <algorithm>
+
+PStatCollector PartBundleUpdater::_update_pcollector("*:Animation");
+
+/**
+ *
+ */
+PartBundleUpdater::
+PartBundleUpdater() :
+  _num_threads(anim_update_num_threads)
+{
+}
+
+/**
+ *
+ */
+PartBundleUpdater::
+~PartBundleUpdater() {
+}
+
+/**
+ * Adds the indicated bundle to the set of bundles updated by update().  It is
+ * not an error to add the same bundle more than once; it is only updated
+ * once per call.
+ */
+void PartBundleUpdater::
+add_bundle(PartBundle *bundle) {
+  nassertv(bundle != nullptr);
+  if (!_bundles.insert(bundle).second) {
+    // It was already added.
+    return;
+  }
+
+  Entry entry;
+  entry._bundle = bundle;
+  entry._pcollector =
+    PStatCollector(PStatCollector(_update_pcollector, bundle->get_name()), "Joints");
+  entry._changed = false;
+  _entries.push_back(entry);
+}
+
+/**
+ * Removes the indicated bundle from the set of bundles updated by update().
+ * Returns true if it was removed, or false if it had not been added.
+ */
+bool PartBundleUpdater::
+remove_bundle(PartBundle *bundle) {
+  if (_bundles.erase(bundle) == 0) {
+    return false;
+  }
+
+  Entries::iterator ei;
+  for (ei = _entries.begin(); ei != _entries.end(); ++ei) {
+    if ((*ei)._bundle == bundle) {
+      _entries.erase(ei);
+      return true;
+    }
+  }
+  nassert_raise("bundle missing from _entries");
+  return false;
+}
+
+/**
+ * Adds the bundles of all of the PartBundleNodes (for instance, Characters)
+ * at or below the indicated node.
+ */
+void PartBundleUpdater::
+collect_bundles(const NodePath &root) {
+  nassertv(!root.is_empty());
+  r_collect_bundles(root.node());
+}
+
+/**
+ * Removes all of the bundles from the updater.
+ */
+void PartBundleUpdater::
+clear_bundles() {
+  _entries.clear();
+  _bundles.clear();
+}
+
+/**
+ * Updates all of the bundles that need it, as if update() were called on
+ * each of them, or force_update() if force is true.  Returns the number of
+ * bundles whose parts changed as a result.
+ *
+ * Each bundle is updated by only one thread, but different bundles may be
+ * updated at the same time by different threads; see set_num_threads().
+ * This call does not return until all of the bundles have been updated.
+ */
+int PartBundleUpdater::
+update(bool force) {
+  PStatTimer timer(_update_pcollector);
+  Thread *current_thread = Thread::get_current_thread();
+
+  EntryList dirty;
+  dirty.reserve(_entries.size());
+  for (Entry &entry : _entries) {
+    entry._changed = false;
+    if (force || entry._bundle->needs_update(current_thread)) {
+      dirty.push_back(&entry);
+    }
+  }
+
+  if (_num_threads > 1 && dirty.size() > 1 && Thread::is_true_threads()) {
+    update_parallel(dirty, force);
+  } else {
+    for (Entry *entry : dirty) {
+      do_update_entry(entry, force, current_thread);
+    }
+  }
+
+  int num_changed = 0;
+  for (const Entry *entry : dirty) {
+    if (entry->_changed) {
+      ++num_changed;
+    }
+  }
+  return num_changed;
+}
+
+/**
+ * The recursive implementation of collect_bundles().
+ */
+void PartBundleUpdater::
+r_collect_bundles(PandaNode *node) {
+  if (node->is_of_type(PartBundleNode::get_class_type())) {
+    PartBundleNode *bundle_node = DCAST(PartBundleNode, node);
+    int num_bundles = bundle_node->get_num_bundles();
+    for (int i = 0; i < num_bundles; ++i) {
+      add_bundle(bundle_node->get_bundle(i));
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_collect_bundles(children.get_child(i));
+  }
+}
+
+/**
+ * Updates the indicated bundles using up to _num_threads threads, including
+ * the calling thread, and waits for all of them to finish.
+ */
+void PartBundleUpdater::
+update_parallel(const EntryList &dirty, bool force) {
+  // Each bundle is a separate part of the range, so that the threads can
+  // balance out bundles that take longer than others.  The threads are those
+  // of the chain shared by all AsyncTaskGraphs; this thread takes part too,
+  // rather than sitting idle.
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph;
+  graph->set_max_workers(_num_threads - 1);
+  graph->add_range(0, (int)dirty.size(), [&](int begin, int end) {
+    Thread *thread = Thread::get_current_thread();
+    for (int i = begin; i < end; ++i) {
+      do_update_entry(dirty[i], force, thread);
+    }
+  }, 1);
+  graph->run();
+}
+
+/**
+ * Updates the bundle of the indicated entry, recording the time spent in its
+ * PStatCollector.  This may be called from any thread.
+ */
+void PartBundleUpdater::
+do_update_entry(Entry *entry, bool force, Thread *current_thread) {
+  PStatTimer timer(entry->_pcollector, current_thread);
+  if (force) {
+    entry->_changed = entry->_bundle->force_update();
+  } else {
+    entry->_changed = entry->_bundle->update();
+  }
+}
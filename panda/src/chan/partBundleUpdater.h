@@ -0,0 +1,96 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file partBundleUpdater.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef PARTBUNDLEUPDATER_H
+#define PARTBUNDLEUPDATER_H
+
+#include "pandabase.h"
+
+#include "partBundle.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "pStatCollector.h"
+#include "pvector.h"
+#include "pset.h"
+
+class NodePath;
+class PandaNode;
+
+/**
+ * Updates the joints of many PartBundles at once, dividing the work among
+ * several threads.
+ *
+ * Add the bundles of all of the animated models in the scene, for instance
+ * with collect_bundles(), and call update() once per frame, before the scene
+ * is rendered.  Each call updates only those bundles that need it, exactly as
+ * PartBundle::update() would; the update() a Character makes when it is
+ * culled will then find that there is nothing left to do.
+ *
+ * Different bundles may be updated at the same time by different threads, so
+ * a bundle should not depend on the joints of another bundle in the same
+ * updater, for instance through control_joint().
+ *
+ * The time spent on each bundle is reported to PStats under
+ * Animation:<bundle name>:Joints.
+ */
+class EXPCL_PANDA_CHAN PartBundleUpdater : public ReferenceCount {
+PUBLISHED:
+  explicit PartBundleUpdater();
+  ~PartBundleUpdater();
+
+  void add_bundle(PartBundle *bundle);
+  bool remove_bundle(PartBundle *bundle);
+  void collect_bundles(const NodePath &root);
+  void clear_bundles();
+
+  INLINE int get_num_bundles() const;
+  INLINE PartBundle *get_bundle(int n) const;
+  MAKE_SEQ(get_bundles, get_num_bundles, get_bundle);
+
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+
+  int update(bool force = false);
+
+  MAKE_SEQ_PROPERTY(bundles, get_num_bundles, get_bundle);
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+
+private:
+  class Entry {
+  public:
+    PT(PartBundle) _bundle;
+    PStatCollector _pcollector;
+    bool _changed;
+  };
+  typedef pvector<Entry> Entries;
+  typedef pvector<Entry *> EntryList;
+
+  void r_collect_bundles(PandaNode *node);
+  void update_parallel(const EntryList &dirty, bool force);
+
+  static void do_update_entry(Entry *entry, bool force, Thread *current_thread);
+
+  Entries _entries;
+
+  // The same bundles as in _entries, to quickly check for duplicates.
+  typedef pset<const PartBundle *> Bundles;
+  Bundles _bundles;
+
+  int _num_threads;
+
+  static PStatCollector _update_pcollector;
+};
+
+#include "partBundleUpdater.I"
+
+#endif
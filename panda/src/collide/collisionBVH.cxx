@@ -0,0 +1,356 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "collisionBVH.h"
+#include "geometricBoundingVolume.h"
+#include "finiteBoundingVolume.h"
+#include "boundingLine.h"
+
+#include <algorithm>
+
+// The number of items at or below which a node is always made a leaf.
+static const int max_leaf_items = 4;
+
+// The number of buckets into which the item centers are sorted when looking
+// for the best split.
+static const int num_bins = 16;
+
+// Beyond this depth, nodes are split at the median rather than by the surface
+// area heuristic, which keeps the depth of the tree bounded.
+static const int max_sah_depth = 48;
+
+// Large enough for any tree built with the above limit.
+static const int max_stack_depth = 128;
+
+/**
+ *
+ */
+CollisionBVH::
+CollisionBVH() {
+}
+
+/**
+ * Adds a new item with the indicated bounding box.  It is an error to call
+ * this after build().
+ */
+void CollisionBVH::
+add_item(int index, const LPoint3 &min, const LPoint3 &max) {
+  nassertv(_nodes.empty());
+
+  Item item;
+  item._min = min;
+  item._max = max;
+  item._center = (min + max) * 0.5f;
+  item._index = index;
+  _items.push_back(item);
+}
+
+/**
+ * Builds the hierarchy from the items that have been added.  This must be
+ * called before any of the find methods.
+ */
+void CollisionBVH::
+build() {
+  _nodes.clear();
+  if (_items.empty()) {
+    return;
+  }
+
+  _nodes.reserve(_items.size() * 2 / max_leaf_items + 1);
+  _nodes.push_back(Node());
+  r_build(0, 0, (int)_items.size(), 0);
+}
+
+/**
+ * Appends to result the indices of all items whose bounding box might
+ * intersect the indicated volume, in increasing order of index.  Returns
+ * false if the volume is not of a kind that can be used to search the
+ * hierarchy (for instance, because it is infinite); in this case, the caller
+ * should consider all of the items.
+ */
+bool CollisionBVH::
+find_overlaps(const GeometricBoundingVolume *gbv, Indices &result) const {
+  if (gbv == nullptr || gbv->is_infinite()) {
+    return false;
+  }
+
+  size_t first = result.size();
+
+  const FiniteBoundingVolume *fbv = gbv->as_finite_bounding_volume();
+  if (fbv != nullptr) {
+    if (!fbv->is_empty()) {
+      find_box_overlaps(fbv->get_min(), fbv->get_max(), result);
+    }
+  } else {
+    const BoundingLine *line = gbv->as_bounding_line();
+    if (line == nullptr) {
+      return false;
+    }
+    find_line_overlaps(line->get_point_a(),
+                       line->get_point_b() - line->get_point_a(), result);
+  }
+
+  result.insert(result.end(), _unbounded.begin(), _unbounded.end());
+  std::sort(result.begin() + first, result.end());
+  return true;
+}
+
+/**
+ * Appends to result the indices of all bounded items whose bounding box
+ * overlaps the indicated box, in no particular order.
+ */
+void CollisionBVH::
+find_box_overlaps(const LPoint3 &min, const LPoint3 &max,
+                  Indices &result) const {
+  if (_nodes.empty()) {
+    return;
+  }
+
+  int stack[max_stack_depth];
+  int sp = 0;
+  stack[sp++] = 0;
+
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+    if (!box_overlaps(node._min, node._max, min, max)) {
+      continue;
+    }
+
+    if (node._count != 0) {
+      const Item *item = &_items[node._first];
+      const Item *end = item + node._count;
+      for (; item < end; ++item) {
+        if (box_overlaps(item->_min, item->_max, min, max)) {
+          result.push_back(item->_index);
+        }
+      }
+    } else {
+      nassertv(sp + 2 <= max_stack_depth);
+      stack[sp++] = node._first;
+      stack[sp++] = node._first + 1;
+    }
+  }
+}
+
+/**
+ * Appends to result the indices of all bounded items whose bounding box is
+ * crossed by the infinite line through origin along direction, in no
+ * particular order.  Since the line is infinite in both directions, this is
+ * also a conservative test for rays.
+ */
+void CollisionBVH::
+find_line_overlaps(const LPoint3 &origin, const LVector3 &direction,
+                   Indices &result) const {
+  if (_nodes.empty()) {
+    return;
+  }
+
+  // Precompute the reciprocal of the direction for the slab test.  Axes along
+  // which the line doesn't move are handled separately.
+  bool parallel[3];
+  LVector3 inv_dir;
+  for (int i = 0; i < 3; ++i) {
+    parallel[i] = IS_NEARLY_ZERO(direction[i]);
+    inv_dir[i] = parallel[i] ? 0.0f : 1.0f / direction[i];
+  }
+
+  int stack[max_stack_depth];
+  int sp = 0;
+  stack[sp++] = 0;
+
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+
+    PN_stdfloat tmin = -FLT_MAX;
+    PN_stdfloat tmax = FLT_MAX;
+    bool hit = true;
+    for (int i = 0; i < 3 && hit; ++i) {
+      if (parallel[i]) {
+        hit = (origin[i] >= node._min[i] && origin[i] <= node._max[i]);
+      } else {
+        PN_stdfloat t0 = (node._min[i] - origin[i]) * inv_dir[i];
+        PN_stdfloat t1 = (node._max[i] - origin[i]) * inv_dir[i];
+        if (t0 > t1) {
+          std::swap(t0, t1);
+        }
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        hit = (tmin <= tmax);
+      }
+    }
+    if (!hit) {
+      continue;
+    }
+
+    if (node._count != 0) {
+      // We don't bother to clip the individual items against the line; the
+      // leaves are small, and the caller performs an exact test anyway.
+      const Item *item = &_items[node._first];
+      const Item *end = item + node._count;
+      for (; item < end; ++item) {
+        result.push_back(item->_index);
+      }
+    } else {
+      nassertv(sp + 2 <= max_stack_depth);
+      stack[sp++] = node._first;
+      stack[sp++] = node._first + 1;
+    }
+  }
+}
+
+/**
+ * The recursive implementation of build().  Fills in the indicated node to
+ * cover the items in the range [begin, end), splitting it if worthwhile.
+ */
+void CollisionBVH::
+r_build(int node_index, int begin, int end, int depth) {
+  LPoint3 min = _items[begin]._min;
+  LPoint3 max = _items[begin]._max;
+  LPoint3 cmin = _items[begin]._center;
+  LPoint3 cmax = _items[begin]._center;
+  for (int i = begin + 1; i < end; ++i) {
+    const Item &item = _items[i];
+    min = min.fmin(item._min);
+    max = max.fmax(item._max);
+    cmin = cmin.fmin(item._center);
+    cmax = cmax.fmax(item._center);
+  }
+
+  _nodes[node_index]._min = min;
+  _nodes[node_index]._max = max;
+
+  int count = end - begin;
+  if (count <= max_leaf_items) {
+    _nodes[node_index]._first = begin;
+    _nodes[node_index]._count = count;
+    return;
+  }
+
+  // Split along the axis in which the centers are most spread out.
+  LVector3 extent = cmax - cmin;
+  int axis = 0;
+  if (extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if (extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  int mid = begin;
+  if (extent[axis] > 0.0f && depth < max_sah_depth) {
+    // Sort the item centers into bins, and evaluate the cost of splitting
+    // between each pair of adjacent bins.
+    int bin_count[num_bins];
+    LPoint3 bin_min[num_bins];
+    LPoint3 bin_max[num_bins];
+    for (int b = 0; b < num_bins; ++b) {
+      bin_count[b] = 0;
+    }
+
+    PN_stdfloat scale = (PN_stdfloat)num_bins / extent[axis];
+    for (int i = begin; i < end; ++i) {
+      const Item &item = _items[i];
+      int b = std::min(num_bins - 1, (int)((item._center[axis] - cmin[axis]) * scale));
+      if (bin_count[b]++ == 0) {
+        bin_min[b] = item._min;
+        bin_max[b] = item._max;
+      } else {
+        bin_min[b] = bin_min[b].fmin(item._min);
+        bin_max[b] = bin_max[b].fmax(item._max);
+      }
+    }
+
+    // Sweep from the right to find the cost of everything to the right of
+    // each split, then from the left to find the best split.
+    PN_stdfloat right_cost[num_bins];
+    int right_count = 0;
+    LPoint3 rmin, rmax;
+    for (int b = num_bins - 1; b > 0; --b) {
+      if (bin_count[b] != 0) {
+        if (right_count == 0) {
+          rmin = bin_min[b];
+          rmax = bin_max[b];
+        } else {
+          rmin = rmin.fmin(bin_min[b]);
+          rmax = rmax.fmax(bin_max[b]);
+        }
+        right_count += bin_count[b];
+      }
+      right_cost[b] = (right_count == 0) ? 0.0f : get_surface_area(rmin, rmax) * right_count;
+    }
+
+    PN_stdfloat best_cost = get_surface_area(min, max) * count;
+    int best_split = -1;
+    int left_count = 0;
+    LPoint3 lmin, lmax;
+    for (int b = 0; b < num_bins - 1; ++b) {
+      if (bin_count[b] != 0) {
+        if (left_count == 0) {
+          lmin = bin_min[b];
+          lmax = bin_max[b];
+        } else {
+          lmin = lmin.fmin(bin_min[b]);
+          lmax = lmax.fmax(bin_max[b]);
+        }
+        left_count += bin_count[b];
+      }
+      if (left_count == 0 || left_count == count) {
+        continue;
+      }
+      PN_stdfloat cost = get_surface_area(lmin, lmax) * left_count + right_cost[b + 1];
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_split = b;
+      }
+    }
+
+    if (best_split >= 0) {
+      Item *first = &_items[0] + begin;
+      Item *last = &_items[0] + end;
+      PN_stdfloat split_scale = scale;
+      PN_stdfloat split_min = cmin[axis];
+      Item *middle = std::partition(first, last, [=](const Item &item) {
+        int b = std::min(num_bins - 1, (int)((item._center[axis] - split_min) * split_scale));
+        return b <= best_split;
+      });
+      mid = begin + (int)(middle - first);
+    }
+  }
+
+  if (mid == begin || mid == end) {
+    if (extent[axis] <= 0.0f && count <= max_leaf_items * 4) {
+      // All of the centers coincide; there's not much to be gained by
+      // splitting these up.
+      _nodes[node_index]._first = begin;
+      _nodes[node_index]._count = count;
+      return;
+    }
+
+    // Fall back to splitting at the median.
+    mid = begin + count / 2;
+    Item *first = &_items[0] + begin;
+    std::nth_element(first, first + (mid - begin), &_items[0] + end,
+                     [=](const Item &a, const Item &b) {
+      return a._center[axis] < b._center[axis];
+    });
+  }
+
+  int child = (int)_nodes.size();
+  _nodes[node_index]._first = child;
+  _nodes[node_index]._count = 0;
+  _nodes.push_back(Node());
+  _nodes.push_back(Node());
+
+  r_build(child, begin, mid, depth + 1);
+  r_build(child + 1, mid, end, depth + 1);
+}
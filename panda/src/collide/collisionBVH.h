@@ -0,0 +1,92 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONBVH_H
+#define COLLISIONBVH_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+
+class GeometricBoundingVolume;
+
+/**
+ * A bounding volume hierarchy over a set of axis-aligned boxes, each of which
+ * is identified by an integer index.  It is used by the CollisionTraverser to
+ * quickly find the few solids within a CollisionNode, or the few triangles
+ * within a Geom, that might intersect with a particular collider, without
+ * having to test the bounding volume of each one in turn.
+ *
+ * Items whose bounds are infinite or unknown may be added with
+ * add_unbounded_item(); these are returned by every query.
+ *
+ * The hierarchy is built with a binned surface area heuristic.  Once
+ * build() has been called, the object is not modified again, and may be
+ * queried from multiple threads at once.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBVH : public ReferenceCount {
+public:
+  typedef pvector<int> Indices;
+
+  CollisionBVH();
+
+  INLINE void reserve(size_t num_items);
+  void add_item(int index, const LPoint3 &min, const LPoint3 &max);
+  INLINE void add_unbounded_item(int index);
+  void build();
+
+  INLINE size_t get_num_items() const;
+  INLINE size_t get_num_nodes() const;
+
+  bool find_overlaps(const GeometricBoundingVolume *gbv, Indices &result) const;
+  void find_box_overlaps(const LPoint3 &min, const LPoint3 &max,
+                         Indices &result) const;
+  void find_line_overlaps(const LPoint3 &origin, const LVector3 &direction,
+                          Indices &result) const;
+
+private:
+  void r_build(int node_index, int begin, int end, int depth);
+  INLINE static bool box_overlaps(const LPoint3 &amin, const LPoint3 &amax,
+                                  const LPoint3 &bmin, const LPoint3 &bmax);
+  INLINE static PN_stdfloat get_surface_area(const LPoint3 &min, const LPoint3 &max);
+
+  class Item {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    LPoint3 _center;
+    int _index;
+  };
+  typedef pvector<Item> Items;
+  Items _items;
+
+  // Each node is either a leaf, which references _count items starting at
+  // _first, or an interior node (_count == 0), whose two children are stored
+  // at _first and _first + 1.
+  class Node {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    int _first;
+    int _count;
+  };
+  typedef pvector<Node> Nodes;
+  Nodes _nodes;
+
+  Indices _unbounded;
+};
+
+#include "collisionBVH.I"
+
+#endif
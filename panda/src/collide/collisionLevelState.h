@@ -20,6 +20,8 @@
 #include "collisionNode.h"
 #include "bitMask.h"
 #include "doubleBitMask.h"
+#include "bitArray.h"
+#include "finiteBoundingVolume.h"
 
 /**
  * This is the state information the CollisionTraverser retains for each level
@@ -46,11 +48,14 @@ public:
 
   bool any_in_bounds();
   bool apply_transform();
+  void sweep_children(const PandaNode::Children &children,
+                      pvector<MaskType> &child_masks) const;
 
   INLINE static bool has_max_colliders();
   INLINE static int get_max_colliders();
 
   INLINE bool has_collider(int n) const;
+  INLINE int get_next_collider(int n) const;
   INLINE bool has_any_collider() const;
 
   INLINE void omit_collider(int n);
@@ -71,11 +76,13 @@ private:
 #include "collisionLevelState.I"
 
 // Now instantiate a handful of implementations of CollisionLevelState: one
-// that uses a word-at-a-time bitmask to track the active colliders, and a
-// couple that use more words at a time.
+// that uses a word-at-a-time bitmask to track the active colliders, a couple
+// that use more words at a time, and one that uses a BitArray, which can
+// track any number of colliders.
 
 typedef CollisionLevelState<BitMaskNative> CollisionLevelStateSingle;
 typedef CollisionLevelState<DoubleBitMaskNative> CollisionLevelStateDouble;
 typedef CollisionLevelState<QuadBitMaskNative> CollisionLevelStateQuad;
+typedef CollisionLevelState<BitArray> CollisionLevelStateArray;
 
 #endif
@@ -17,7 +17,11 @@
 #include "config_collide.h"
 #include "dcast.h"
 
+#include <algorithm>
+
 PStatCollector CollisionLevelStateBase::_node_volume_pcollector("Collision Volumes:PandaNode");
+PStatCollector CollisionLevelStateBase::_broadphase_pairs_pcollector("Collision Volumes:Broadphase pairs");
+PStatCollector CollisionLevelStateBase::_broadphase_pruned_pcollector("Collision Volumes:Broadphase pruned");
 
 TypeHandle CollisionLevelStateBase::_type_handle;
 
@@ -90,3 +94,73 @@ prepare_collider(const ColliderDef &def, const NodePath &root) {
 
   _parent_bounds = _local_bounds;
 }
+
+/**
+ * Finds each pair of a collider and a child node whose boxes overlap, by
+ * sorting all of the boxes along the axis on which they are most spread out
+ * and sweeping along it.  Fills pairs with the (collider, child) indices of
+ * the overlapping pairs.  The items are reordered in the process.
+ */
+void CollisionLevelStateBase::
+sweep_and_prune(SweepItems &items, SweepPairs &pairs) {
+  if (items.empty()) {
+    return;
+  }
+
+  LPoint3 min = items[0]._min;
+  LPoint3 max = items[0]._max;
+  SweepItems::const_iterator ii;
+  for (ii = items.begin(); ii != items.end(); ++ii) {
+    min = min.fmin((*ii)._min);
+    max = max.fmax((*ii)._max);
+  }
+  LVector3 extent = max - min;
+  int axis = 0;
+  if (extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if (extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  SweepItems::iterator si;
+  for (si = items.begin(); si != items.end(); ++si) {
+    (*si)._sort = (*si)._min[axis];
+  }
+  std::sort(items.begin(), items.end());
+
+  // Walk along the axis, keeping track of the colliders and the children
+  // whose intervals are still open.  Each new item needs only to be compared
+  // with the open items of the other kind.
+  pvector<const SweepItem *> open_colliders;
+  pvector<const SweepItem *> open_children;
+  for (ii = items.begin(); ii != items.end(); ++ii) {
+    const SweepItem &item = (*ii);
+    PN_stdfloat start = item._min[axis];
+
+    pvector<const SweepItem *> &open_same = item._is_collider ? open_colliders : open_children;
+    pvector<const SweepItem *> &open_other = item._is_collider ? open_children : open_colliders;
+
+    size_t j = 0;
+    while (j < open_other.size()) {
+      const SweepItem *other = open_other[j];
+      if (other->_max[axis] < start) {
+        // This one has been left behind; remove it from the list.
+        open_other[j] = open_other.back();
+        open_other.pop_back();
+        continue;
+      }
+      if (item._min[0] <= other->_max[0] && other->_min[0] <= item._max[0] &&
+          item._min[1] <= other->_max[1] && other->_min[1] <= item._max[1] &&
+          item._min[2] <= other->_max[2] && other->_min[2] <= item._max[2]) {
+        if (item._is_collider) {
+          pairs.push_back(SweepPairs::value_type(item._index, other->_index));
+        } else {
+          pairs.push_back(SweepPairs::value_type(other->_index, item._index));
+        }
+      }
+      ++j;
+    }
+    open_same.push_back(&item);
+  }
+}
@@ -23,6 +23,7 @@
 #include "workingNodePath.h"
 #include "pointerTo.h"
 #include "plist.h"
+#include "pvector.h"
 #include "pStatCollector.h"
 #include "bitMask.h"
 #include "lvector3.h"
@@ -32,6 +33,7 @@
 
 class CollisionSolid;
 class CollisionNode;
+class CollisionHandler;
 
 /**
  * This is the state information the CollisionTraverser retains for each level
@@ -47,6 +49,7 @@ public:
     CPT(CollisionSolid) _collider;
     CollisionNode *_node;
     NodePath _node_path;
+    CollisionHandler *_handler;
   };
 
   INLINE CollisionLevelStateBase(const NodePath &node_path);
@@ -67,6 +70,7 @@ public:
   INLINE const CollisionSolid *get_collider(int n) const;
   INLINE CollisionNode *get_collider_node(int n) const;
   INLINE NodePath get_collider_node_path(int n) const;
+  INLINE CollisionHandler *get_collider_handler(int n) const;
   INLINE const GeometricBoundingVolume *get_local_bound(int n) const;
   INLINE const GeometricBoundingVolume *get_parent_bound(int n) const;
 
@@ -84,7 +88,25 @@ protected:
   BoundingVolumes _local_bounds;
   BoundingVolumes _parent_bounds;
 
+  // One collider or one child node, as placed on the axis by
+  // sweep_and_prune().
+  class SweepItem {
+  public:
+    INLINE bool operator < (const SweepItem &other) const;
+
+    PN_stdfloat _sort = 0;
+    LPoint3 _min;
+    LPoint3 _max;
+    int _index;
+    bool _is_collider;
+  };
+  typedef pvector<SweepItem> SweepItems;
+  typedef pvector<std::pair<int, int> > SweepPairs;
+  static void sweep_and_prune(SweepItems &items, SweepPairs &pairs);
+
   static PStatCollector _node_volume_pcollector;
+  static PStatCollector _broadphase_pairs_pcollector;
+  static PStatCollector _broadphase_pruned_pcollector;
 
 public:
   static TypeHandle get_class_type() {
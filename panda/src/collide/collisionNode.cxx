@@ -28,7 +28,9 @@
 #include "clockObject.h"
 #include "boundingSphere.h"
 #include "boundingBox.h"
+#include "finiteBoundingVolume.h"
 #include "config_mathutil.h"
+#include "lightMutexHolder.h"
 
 TypeHandle CollisionNode::_type_handle;
 
@@ -268,6 +270,41 @@ set_from_collide_mask(CollideMask mask) {
   _from_collide_mask = mask;
 }
 
+/**
+ * Returns a CollisionBVH over the bounding volumes of the solids in this node,
+ * in which each item is identified by the index of the solid.  This is built
+ * the first time it is requested, and again whenever the set of solids has
+ * changed since.  Solids with an infinite bounding volume are added as
+ * unbounded items.
+ */
+CPT(CollisionBVH) CollisionNode::
+get_solids_bvh(Thread *current_thread) const {
+  CPT(BoundingVolume) internal_bounds = get_internal_bounds(current_thread);
+
+  LightMutexHolder holder(_bvh_lock);
+  if (_bvh != nullptr && _bvh_internal_bounds == internal_bounds) {
+    return _bvh;
+  }
+
+  PT(CollisionBVH) bvh = new CollisionBVH;
+  bvh->reserve(_solids.size());
+  for (size_t i = 0; i < _solids.size(); ++i) {
+    CPT(CollisionSolid) solid = _solids[i].get_read_pointer(current_thread);
+    CPT(BoundingVolume) volume = solid->get_bounds();
+    const FiniteBoundingVolume *fbv = volume->as_finite_bounding_volume();
+    if (fbv == nullptr || fbv->is_infinite()) {
+      bvh->add_unbounded_item((int)i);
+    } else if (!fbv->is_empty()) {
+      bvh->add_item((int)i, fbv->get_min(), fbv->get_max());
+    }
+  }
+  bvh->build();
+
+  _bvh = bvh;
+  _bvh_internal_bounds = internal_bounds;
+  return _bvh;
+}
+
 /**
  * Called when needed to recompute the node's _internal_bound object.  Nodes
  * that contain anything of substance should redefine this to do the right
@@ -17,6 +17,8 @@
 #include "pandabase.h"
 
 #include "collisionSolid.h"
+#include "collisionBVH.h"
+#include "lightMutex.h"
 
 #include "collideMask.h"
 #include "pandaNode.h"
@@ -48,6 +50,8 @@ public:
 
   virtual void output(std::ostream &out) const;
 
+  CPT(CollisionBVH) get_solids_bvh(Thread *current_thread = Thread::get_current_thread()) const;
+
 PUBLISHED:
   INLINE void set_collide_mask(CollideMask mask);
   void set_from_collide_mask(CollideMask mask);
@@ -95,6 +99,13 @@ private:
   typedef pvector< COWPT(CollisionSolid) > Solids;
   Solids _solids;
 
+  // A hierarchy over the bounds of the solids, built on demand by
+  // get_solids_bvh().  It is rebuilt whenever the internal bounds have
+  // changed since it was made, which happens when the solids are modified.
+  mutable LightMutex _bvh_lock;
+  mutable CPT(CollisionBVH) _bvh;
+  mutable CPT(BoundingVolume) _bvh_internal_bounds;
+
   friend class CollisionTraverser;
 
 public:
@@ -0,0 +1,60 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionRayBatch.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "collisionRayBatch.h"
+
+/**
+ *
+ */
+CollisionRayBatch::
+CollisionRayBatch() {
+}
+
+/**
+ * Returns the number of rays that hit something during the last call to
+ * CollisionTraverser::traverse_rays().
+ */
+int CollisionRayBatch::
+get_num_hits() const {
+  int num_hits = 0;
+  Hits::const_iterator hi;
+  for (hi = _hits.begin(); hi != _hits.end(); ++hi) {
+    if ((*hi)._has_hit) {
+      ++num_hits;
+    }
+  }
+  return num_hits;
+}
+
+/**
+ *
+ */
+void CollisionRayBatch::
+output(std::ostream &out) const {
+  out << "CollisionRayBatch, " << _rays.size() << " rays, "
+      << get_num_hits() << " hits";
+}
+
+/**
+ * Forgets the hits of all of the rays.  This is called at the start of each
+ * traversal.
+ */
+void CollisionRayBatch::
+reset_hits() {
+  Hits::iterator hi;
+  for (hi = _hits.begin(); hi != _hits.end(); ++hi) {
+    (*hi)._has_hit = false;
+    (*hi)._t = 0.0f;
+    (*hi)._into_node_path.clear();
+  }
+}
@@ -0,0 +1,102 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionRayBatch.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef COLLISIONRAYBATCH_H
+#define COLLISIONRAYBATCH_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "nodePath.h"
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * A set of rays and line segments to be tested against the scene graph all
+ * at once, with CollisionTraverser::traverse_rays(), along with the nearest
+ * hit found for each of them.
+ *
+ * This is intended for applications that need to make a large number of
+ * simple line-of-sight queries each frame.  Unlike a normal traversal, no
+ * CollisionNode or CollisionHandler is needed for the rays, and only the
+ * nearest hit of each ray is retained, in a flat array.
+ *
+ * The rays are specified in the coordinate space of the root node passed to
+ * traverse_rays(), and the hits are reported in that same space.
+ */
+class EXPCL_PANDA_COLLIDE CollisionRayBatch : public ReferenceCount {
+PUBLISHED:
+  CollisionRayBatch();
+
+  INLINE void clear();
+  INLINE void reserve(size_t num_rays);
+  INLINE size_t add_ray(const LPoint3 &origin, const LVector3 &direction);
+  INLINE size_t add_segment(const LPoint3 &point_a, const LPoint3 &point_b);
+  INLINE size_t get_num_rays() const;
+
+  INLINE LPoint3 get_origin(size_t n) const;
+  INLINE LVector3 get_direction(size_t n) const;
+  INLINE bool is_segment(size_t n) const;
+
+  INLINE bool has_hit(size_t n) const;
+  INLINE PN_stdfloat get_hit_t(size_t n) const;
+  INLINE LPoint3 get_hit_pos(size_t n) const;
+  INLINE LVector3 get_hit_normal(size_t n) const;
+  INLINE NodePath get_hit_node_path(size_t n) const;
+  int get_num_hits() const;
+
+  void output(std::ostream &out) const;
+
+public:
+  class Ray {
+  public:
+    LPoint3 _origin;
+    LVector3 _direction;
+    PN_stdfloat _max_t;
+  };
+
+  // The nearest hit of a ray.  _t is measured in units of the ray's
+  // direction vector, so a segment's hits lie between 0 and 1.
+  class Hit {
+  public:
+    bool _has_hit;
+    PN_stdfloat _t;
+    LPoint3 _pos;
+    LVector3 _normal;
+    NodePath _into_node_path;
+  };
+
+  INLINE const Ray &get_ray(size_t n) const;
+  INLINE const Hit &get_hit(size_t n) const;
+  INLINE const Hit *get_hits() const;
+
+  INLINE PN_stdfloat get_max_t(size_t n) const;
+  void reset_hits();
+  INLINE void record_hit(size_t n, PN_stdfloat t, const LPoint3 &pos,
+                         const LVector3 &normal, const NodePath &into_node_path);
+
+private:
+  typedef pvector<Ray> Rays;
+  Rays _rays;
+
+  typedef pvector<Hit> Hits;
+  Hits _hits;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CollisionRayBatch &batch) {
+  batch.output(out);
+  return out;
+}
+
+#include "collisionRayBatch.I"
+
+#endif
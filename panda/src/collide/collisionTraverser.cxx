@@ -16,6 +16,8 @@
 #include "collisionEntry.h"
 #include "collisionPolygon.h"
 #include "collisionGeom.h"
+#include "collisionRay.h"
+#include "collisionRayBatch.h"
 #include "collisionRecorder.h"
 #include "collisionVisualizer.h"
 #include "collisionSphere.h"
@@ -35,6 +37,7 @@
 #include "nodePath.h"
 #include "pStatTimer.h"
 #include "indent.h"
+#include "asyncTaskGraph.h"
 
 #include <algorithm>
 
@@ -45,6 +48,8 @@ PStatCollector CollisionTraverser::_collisions_pcollector("App:Collisions");
 PStatCollector CollisionTraverser::_cnode_volume_pcollector("Collision Volumes:CollisionNode");
 PStatCollector CollisionTraverser::_gnode_volume_pcollector("Collision Volumes:GeomNode");
 PStatCollector CollisionTraverser::_geom_volume_pcollector("Collision Volumes:Geom");
+PStatCollector CollisionTraverser::_ray_batch_pcollector("App:Collisions:Ray batch");
+
 
 TypeHandle CollisionTraverser::_type_handle;
 
@@ -65,6 +70,62 @@ public:
   const CollisionTraverser &_trav;
 };
 
+/**
+ * Stands in for a real CollisionHandler while a group of colliders is being
+ * traversed on a worker thread.  It records the entries it receives, so that
+ * they can be passed on to the real handler later, on the calling thread.
+ */
+class CollisionTraverser::DeferredHandler : public CollisionHandler {
+public:
+  DeferredHandler(CollisionHandler *target, DeferredEntries &entries) :
+    _target(target),
+    _entries(entries)
+  {
+    _wants_all_potential_collidees = target->wants_all_potential_collidees();
+  }
+
+  virtual void add_entry(CollisionEntry *entry) {
+    _entries.push_back(DeferredEntries::value_type(_target, entry));
+  }
+
+private:
+  CollisionHandler *_target;
+  DeferredEntries &_entries;
+};
+
+/**
+ * A contiguous range of passes that is traversed by a single thread during
+ * traverse_parallel(), along with the entries it has detected.
+ */
+class CollisionTraverser::ParallelPass {
+public:
+  void traverse() {
+    for (size_t pass = _begin; pass < _end; ++pass) {
+#ifdef DO_PSTATS
+      PStatTimer pass_timer(_trav->_pass_collectors[pass]);
+#endif
+      _trav->r_traverse((*_level_states)[pass], pass);
+    }
+  }
+
+  CollisionHandler *get_deferred_handler(CollisionHandler *target) {
+    PT(DeferredHandler) &handler = _handlers[target];
+    if (handler == nullptr) {
+      handler = new DeferredHandler(target, _entries);
+    }
+    return handler;
+  }
+
+  CollisionTraverser *_trav;
+  LevelStatesSingle *_level_states;
+  size_t _begin;
+  size_t _end;
+
+  typedef pmap<CollisionHandler *, PT(DeferredHandler)> Handlers;
+  Handlers _handlers;
+  DeferredEntries _entries;
+};
+
 /**
  *
  */
@@ -74,6 +135,8 @@ CollisionTraverser(const std::string &name) :
   _this_pcollector(_collisions_pcollector, name)
 {
   _respect_prev_transform = respect_prev_transform;
+  _num_threads = collision_num_threads;
+  _broadphase_threshold = collision_broadphase_threshold;
   #ifdef DO_COLLISION_RECORDING
   _recorder = nullptr;
   #endif
@@ -272,12 +335,20 @@ traverse(const NodePath &root) {
   }
 
   bool traversal_done = false;
-  if ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
-      !allow_collider_multiple) {
+  if (can_traverse_parallel()) {
+    // Split the colliders up among several threads.
+    traverse_parallel(root);
+    traversal_done = true;
+  }
+
+  if (!traversal_done &&
+      ((int)_colliders.size() <= CollisionLevelStateSingle::get_max_colliders() ||
+       !allow_collider_multiple)) {
     // Use the single-word-at-a-time traverser, which might need to make lots
     // of passes.
     LevelStatesSingle level_states;
-    prepare_colliders_single(level_states, root);
+    prepare_colliders(level_states, root,
+                      CollisionLevelStateSingle::get_max_colliders());
 
     if (level_states.size() == 1 || !allow_collider_multiple) {
       traversal_done = true;
@@ -288,7 +359,7 @@ traverse(const NodePath &root) {
 #ifdef DO_PSTATS
         PStatTimer pass_timer(get_pass_collector(pass));
 #endif
-        r_traverse_single(level_states[pass], pass);
+        r_traverse(level_states[pass], pass);
       }
     }
   }
@@ -297,7 +368,8 @@ traverse(const NodePath &root) {
       (int)_colliders.size() <= CollisionLevelStateDouble::get_max_colliders()) {
     // Try the double-word-at-a-time traverser.
     LevelStatesDouble level_states;
-    prepare_colliders_double(level_states, root);
+    prepare_colliders(level_states, root,
+                      CollisionLevelStateDouble::get_max_colliders());
 
     if (level_states.size() == 1) {
       traversal_done = true;
@@ -306,15 +378,36 @@ traverse(const NodePath &root) {
 #ifdef DO_PSTATS
         PStatTimer pass_timer(get_pass_collector(pass));
 #endif
-        r_traverse_double(level_states[pass], pass);
+        r_traverse(level_states[pass], pass);
       }
     }
   }
 
-  if (!traversal_done) {
-    // OK, do the quad-word-at-a-time traverser.
+  if (!traversal_done &&
+      (int)_colliders.size() <= CollisionLevelStateQuad::get_max_colliders()) {
+    // Try the quad-word-at-a-time traverser.
     LevelStatesQuad level_states;
-    prepare_colliders_quad(level_states, root);
+    prepare_colliders(level_states, root,
+                      CollisionLevelStateQuad::get_max_colliders());
+
+    if (level_states.size() == 1) {
+      traversal_done = true;
+
+      for (size_t pass = 0; pass < level_states.size(); ++pass) {
+#ifdef DO_PSTATS
+        PStatTimer pass_timer(get_pass_collector(pass));
+#endif
+        r_traverse(level_states[pass], pass);
+      }
+    }
+  }
+
+  if (!traversal_done) {
+    // OK, there are too many colliders for a fixed-width mask.  Use the
+    // arbitrary-width traverser, which handles all of them in one pass.
+    LevelStatesArray level_states;
+    prepare_colliders(level_states, root,
+                      CollisionLevelStateArray::get_max_colliders());
 
     traversal_done = true;
 
@@ -322,7 +415,7 @@ traverse(const NodePath &root) {
 #ifdef DO_PSTATS
       PStatTimer pass_timer(get_pass_collector(pass));
 #endif
-      r_traverse_quad(level_states[pass], pass);
+      r_traverse(level_states[pass], pass);
     }
   }
 
@@ -343,6 +436,8 @@ traverse(const NodePath &root) {
   #endif  // DO_COLLISION_RECORDING
 
   CollisionLevelStateBase::_node_volume_pcollector.flush_level();
+  CollisionLevelStateBase::_broadphase_pairs_pcollector.flush_level();
+  CollisionLevelStateBase::_broadphase_pruned_pcollector.flush_level();
   _cnode_volume_pcollector.flush_level();
   _gnode_volume_pcollector.flush_level();
   _geom_volume_pcollector.flush_level();
@@ -354,6 +449,70 @@ traverse(const NodePath &root) {
   CollisionBox::flush_level();
 }
 
+/**
+ * Tests all of the rays and segments of the indicated CollisionRayBatch
+ * against the CollisionNodes and visible geometry at or below the indicated
+ * root, and stores the nearest hit of each one back in the batch.  The rays
+ * are in the coordinate space of root, and so are the hits.
+ *
+ * from_mask plays the role of the from collide mask of a CollisionNode
+ * containing the rays; only nodes whose into collide mask shares a bit with
+ * it are considered.  The colliders and handlers of this traverser are not
+ * involved.
+ *
+ * Unlike traverse(), this walks the scene graph just once for the whole
+ * batch, dropping each ray as soon as it leaves the bounding volume of a
+ * subgraph or has already hit something nearer, and no CollisionEntry is
+ * created for rays that strike visible geometry.  Clip planes are respected
+ * for CollisionNodes, but not for visible geometry.
+ */
+void CollisionTraverser::
+traverse_rays(const NodePath &root, CollisionRayBatch *batch,
+              CollideMask from_mask) {
+  nassertv(!root.is_empty());
+  nassertv(batch != nullptr);
+  PStatTimer timer(_ray_batch_pcollector);
+
+  batch->reset_hits();
+  size_t num_rays = batch->get_num_rays();
+  if (num_rays == 0 || from_mask.is_zero()) {
+    return;
+  }
+
+  // The bounding volume of the root is in the coordinate space of its
+  // parent, so that is where we begin.
+  CPT(TransformState) transform = root.get_transform();
+  const LMatrix4 &root_mat = transform->get_mat();
+
+  RayLevel level;
+  if (!level._to_root.invert_from(root_mat)) {
+    return;
+  }
+  level._rays.reserve(num_rays);
+  level._origins.reserve(num_rays);
+  level._directions.reserve(num_rays);
+  for (size_t i = 0; i < num_rays; ++i) {
+    const CollisionRayBatch::Ray &ray = batch->get_ray(i);
+    level._rays.push_back((int)i);
+    level._origins.push_back(root_mat.xform_point(ray._origin));
+    level._directions.push_back(root_mat.xform_vec(ray._direction));
+  }
+
+  // This ray is moved around to test each ray against the CollisionSolids we
+  // come across.
+  PT(CollisionRay) ray = new CollisionRay;
+  r_traverse_rays(batch, from_mask, root, level, ray);
+
+  CollisionLevelStateBase::_node_volume_pcollector.flush_level();
+  _geom_volume_pcollector.flush_level();
+
+  CollisionSphere::flush_level();
+  CollisionCapsule::flush_level();
+  CollisionPolygon::flush_level();
+  CollisionPlane::flush_level();
+  CollisionBox::flush_level();
+}
+
 #if defined(DO_COLLISION_RECORDING) || !defined(CPPPARSER)
 /**
  * Uses the indicated CollisionRecorder object to start recording the
@@ -485,16 +644,20 @@ write(std::ostream &out, int indent_level) const {
  * Fills up the set of LevelStates corresponding to the active colliders in
  * use.
  *
- * This flavor uses a CollisionLevelStateSingle, which is limited to a certain
- * number of colliders per pass (typically 32).
+ * Each LevelState holds at most max_colliders colliders, which must not be
+ * more than LevelState::get_max_colliders(); the remaining colliders go into
+ * further LevelStates, each of which is traversed in a separate pass.
  */
+template<class LevelState>
 void CollisionTraverser::
-prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
-                         const NodePath &root) {
+prepare_colliders(pvector<LevelState> &level_states, const NodePath &root,
+                  int max_colliders) {
   int num_colliders = _colliders.size();
-  int max_colliders = CollisionLevelStateSingle::get_max_colliders();
+  nassertv(max_colliders > 0 &&
+           (!LevelState::has_max_colliders() ||
+            max_colliders <= LevelState::get_max_colliders()));
 
-  CollisionLevelStateSingle level_state(root);
+  LevelState level_state(root);
   // This reserve() call is only correct if there is exactly one solid per
   // collider added to the traverser, which is the normal case.  If there is
   // more than one solid in any of the colliders, this reserve() call won't
@@ -528,9 +691,13 @@ prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
       ocd._in_graph = true;
       CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
 
-      CollisionLevelStateSingle::ColliderDef def;
+      Colliders::const_iterator ci = _colliders.find(cnode_path);
+      nassertv(ci != _colliders.end());
+
+      typename LevelState::ColliderDef def;
       def._node = cnode;
       def._node_path = cnode_path;
+      def._handler = (*ci).second;
 
       int num_solids = cnode->get_num_solids();
       for (int s = 0; s < num_solids; ++s) {
@@ -558,10 +725,13 @@ prepare_colliders_single(CollisionTraverser::LevelStatesSingle &level_states,
 }
 
 /**
- *
+ * Visits the node indicated by the level state, testing it against the
+ * colliders that are still interested in it, and then recursively visits its
+ * children.
  */
+template<class LevelState>
 void CollisionTraverser::
-r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
+r_traverse(LevelState &level_state, size_t pass) {
   if (!level_state.any_in_bounds()) {
     return;
   }
@@ -586,25 +756,25 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
       entry._flags |= CollisionEntry::F_respect_prev_transform;
     }
 
-    int num_colliders = level_state.get_num_colliders();
-    for (int c = 0; c < num_colliders; ++c) {
-      if (level_state.has_collider(c)) {
-        entry._from_node = level_state.get_collider_node(c);
-
-        if ((entry._from_node->get_from_collide_mask() &
-             cnode->get_into_collide_mask()) != 0) {
-          #ifdef DO_PSTATS
-          // PStatTimer collide_timer(_solid_collide_collectors[pass]);
-          #endif
-          entry._from_node_path = level_state.get_collider_node_path(c);
-          entry._from = level_state.get_collider(c);
-
-          compare_collider_to_node(
-              entry,
-              level_state.get_parent_bound(c),
-              level_state.get_local_bound(c),
-              node_gbv);
-        }
+    for (int c = level_state.get_next_collider(0);
+         c >= 0;
+         c = level_state.get_next_collider(c + 1)) {
+      entry._from_node = level_state.get_collider_node(c);
+
+      if ((entry._from_node->get_from_collide_mask() &
+           cnode->get_into_collide_mask()) != 0) {
+        #ifdef DO_PSTATS
+        // PStatTimer collide_timer(_solid_collide_collectors[pass]);
+        #endif
+        entry._from_node_path = level_state.get_collider_node_path(c);
+        entry._from = level_state.get_collider(c);
+
+        compare_collider_to_node(
+            entry,
+            level_state.get_collider_handler(c),
+            level_state.get_parent_bound(c),
+            level_state.get_local_bound(c),
+            node_gbv);
       }
     }
 
@@ -631,25 +801,25 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
       entry._flags |= CollisionEntry::F_respect_prev_transform;
     }
 
-    int num_colliders = level_state.get_num_colliders();
-    for (int c = 0; c < num_colliders; ++c) {
-      if (level_state.has_collider(c)) {
-        entry._from_node = level_state.get_collider_node(c);
-
-        if ((entry._from_node->get_from_collide_mask() &
-             gnode->get_into_collide_mask()) != 0) {
-          #ifdef DO_PSTATS
-          // PStatTimer collide_timer(_solid_collide_collectors[pass]);
-          #endif
-          entry._from_node_path = level_state.get_collider_node_path(c);
-          entry._from = level_state.get_collider(c);
-
-          compare_collider_to_geom_node(
-              entry,
-              level_state.get_parent_bound(c),
-              level_state.get_local_bound(c),
-              node_gbv);
-        }
+    for (int c = level_state.get_next_collider(0);
+         c >= 0;
+         c = level_state.get_next_collider(c + 1)) {
+      entry._from_node = level_state.get_collider_node(c);
+
+      if ((entry._from_node->get_from_collide_mask() &
+           gnode->get_into_collide_mask()) != 0) {
+        #ifdef DO_PSTATS
+        // PStatTimer collide_timer(_solid_collide_collectors[pass]);
+        #endif
+        entry._from_node_path = level_state.get_collider_node_path(c);
+        entry._from = level_state.get_collider(c);
+
+        compare_collider_to_geom_node(
+            entry,
+            level_state.get_collider_handler(c),
+            level_state.get_parent_bound(c),
+            level_state.get_local_bound(c),
+            node_gbv);
       }
     }
   }
@@ -659,8 +829,10 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
     // child.
     int index = node->get_visible_child();
     if (index >= 0 && index < node->get_num_children()) {
-      CollisionLevelStateSingle next_state(level_state, node->get_child(index));
-      r_traverse_single(next_state, pass);
+      LevelState next_state(level_state, node->get_child(index));
+      borrow_mask(next_state._current);
+      r_traverse(next_state, pass);
+      return_mask(next_state._current);
     }
 
   } else if (node->is_lod_node()) {
@@ -673,511 +845,280 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
     PandaNode::Children children = node->get_children();
     int num_children = children.get_num_children();
     for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateSingle next_state(level_state, children.get_child(i));
+      LevelState next_state(level_state, children.get_child(i));
       if (i != index) {
         next_state.set_include_mask(next_state.get_include_mask() &
           ~GeomNode::get_default_collide_mask());
       }
-      r_traverse_single(next_state, pass);
+      borrow_mask(next_state._current);
+      r_traverse(next_state, pass);
+      return_mask(next_state._current);
     }
 
   } else {
     // Otherwise, visit all the children.
     PandaNode::Children children = node->get_children();
     int num_children = children.get_num_children();
+
+    pvector<typename LevelState::CurrentMask> child_masks;
+    bool use_broadphase =
+      sweep_children(level_state, children, child_masks, pass);
+
     for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateSingle next_state(level_state, children.get_child(i));
-      r_traverse_single(next_state, pass);
+      LevelState next_state(level_state, children.get_child(i));
+      borrow_mask(next_state._current);
+      if (use_broadphase) {
+        next_state._current &= child_masks[i];
+      }
+      r_traverse(next_state, pass);
+      return_mask(next_state._current);
     }
   }
 }
 
 /**
- * Fills up the set of LevelStates corresponding to the active colliders in
- * use.
- *
- * This flavor uses a CollisionLevelStateDouble, which is limited to a certain
- * number of colliders per pass (typically 32).
+ * If the children of the level state's node are numerous enough, and enough
+ * colliders are still interested in them, runs the broadphase to determine
+ * which of the colliders might intersect with each child, rather than testing
+ * every pair of them.  Returns true if it did, in which case child_masks
+ * contains one mask of colliders per child, or false if every collider should
+ * be tested against every child.
  */
-void CollisionTraverser::
-prepare_colliders_double(CollisionTraverser::LevelStatesDouble &level_states,
-                         const NodePath &root) {
-  int num_colliders = _colliders.size();
-  int max_colliders = CollisionLevelStateDouble::get_max_colliders();
-
-  CollisionLevelStateDouble level_state(root);
-  // This reserve() call is only correct if there is exactly one solid per
-  // collider added to the traverser, which is the normal case.  If there is
-  // more than one solid in any of the colliders, this reserve() call won't
-  // reserve enough, but the code is otherwise correct.
-  level_state.reserve(min(num_colliders, max_colliders));
-
-  // Create an indirect index array to walk through the colliders in sorted
-  // order, without affect the actual collider order.
-  int *indirect = (int *)alloca(sizeof(int) * num_colliders);
-  int i;
-  for (i = 0; i < num_colliders; ++i) {
-    indirect[i] = i;
+template<class LevelState>
+bool CollisionTraverser::
+sweep_children(const LevelState &level_state,
+               const PandaNode::Children &children,
+               pvector<typename LevelState::CurrentMask> &child_masks,
+               size_t pass) {
+  if (_broadphase_threshold <= 0 ||
+      (int)children.get_num_children() < _broadphase_threshold ||
+      level_state._current.get_num_on_bits() < _broadphase_threshold) {
+    return false;
   }
-  std::sort(indirect, indirect + num_colliders, SortByColliderSort(*this));
 
-  int num_remaining_colliders = num_colliders;
-  for (i = 0; i < num_colliders; ++i) {
-    OrderedColliderDef &ocd = _ordered_colliders[indirect[i]];
-    NodePath cnode_path = ocd._node_path;
+#ifdef DO_PSTATS
+  PStatTimer broadphase_timer(_broadphase_collectors[pass]);
+#endif
+  level_state.sweep_children(children, child_masks);
+  return true;
+}
 
-    if (!cnode_path.is_same_graph(root)) {
-      if (ocd._in_graph) {
-        // Only report this warning once.
-        collide_cat.info()
-          << "Collider " << cnode_path
-          << " is not in scene graph.  Ignoring.\n";
-        ocd._in_graph = false;
-      }
+/**
+ * Called before the indicated mask of a new level state is modified, this may
+ * replace its storage with storage of its own, so that modifying it does not
+ * have to allocate a copy of the parent's mask.  This does nothing except for
+ * the BitArray masks of CollisionLevelStateArray.
+ */
+template<class MaskType>
+void CollisionTraverser::
+borrow_mask(MaskType &) {
+}
 
-    } else {
-      ocd._in_graph = true;
-      CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
+/**
+ * Called when the level state owning the indicated mask is about to go away,
+ * to keep its storage for the next level state.  See borrow_mask().
+ */
+template<class MaskType>
+void CollisionTraverser::
+return_mask(MaskType &) {
+}
 
-      CollisionLevelStateDouble::ColliderDef def;
-      def._node = cnode;
-      def._node_path = cnode_path;
+/**
+ * A BitArray shares its words with the copy it was made from, and allocates
+ * new words as soon as either of them is modified.  Since the level state of
+ * every node starts out as a copy of its parent's, this would otherwise mean
+ * an allocation at nearly every level of the traversal.  Instead, the bits
+ * are copied into the words of a mask that was used by an earlier level state
+ * and is no longer shared, which have usually been allocated already.
+ */
+void CollisionTraverser::
+borrow_mask(BitArray &mask) {
+  if (_spare_masks.empty()) {
+    return;
+  }
 
-      int num_solids = cnode->get_num_solids();
-      for (int s = 0; s < num_solids; ++s) {
-        CPT(CollisionSolid) collider = cnode->get_solid(s);
-        def._collider = collider;
-        level_state.prepare_collider(def, root);
+  // None of these operations release the words of the spare mask: clearing
+  // all of its bits and then inverting them leaves it with all bits on, but
+  // its words still reserved, and and-ing it with the mask fills them in.
+  BitArray &spare = _spare_masks.back();
+  spare &= BitArray();
+  spare.invert_in_place();
+  spare &= mask;
+  std::swap(spare, mask);
+  _spare_masks.pop_back();
+}
 
-        if (level_state.get_num_colliders() == max_colliders) {
-          // That's the limit.  Save off this level state and make a new one.
-          level_states.push_back(level_state);
-          level_state.clear();
-          level_state.reserve(min(num_remaining_colliders, max_colliders));
-        }
-      }
-    }
+/**
+ * Keeps the storage of the indicated mask for the next call to borrow_mask().
+ */
+void CollisionTraverser::
+return_mask(BitArray &mask) {
+  _spare_masks.push_back(mask);
+}
 
-    --num_remaining_colliders;
-    nassertv(num_remaining_colliders >= 0);
+/**
+ * Returns true if traverse() should split up the colliders among several
+ * threads, or false if it should do all the work on the calling thread.
+ */
+bool CollisionTraverser::
+can_traverse_parallel() const {
+  if (_num_threads <= 1 || _colliders.size() <= 1 ||
+      !Thread::is_true_threads()) {
+    return false;
   }
 
-  if (level_state.get_num_colliders() != 0) {
-    level_states.push_back(level_state);
+#ifdef DO_COLLISION_RECORDING
+  // The recorder isn't thread-safe.
+  if (has_recorder()) {
+    return false;
   }
-  nassertv(num_remaining_colliders == 0);
+#endif  // DO_COLLISION_RECORDING
+
+  return true;
 }
 
 /**
+ * Performs the traversal with the colliders divided into the same single-word
+ * passes that the serial traversal uses when allow-collider-multiple is off.
+ * The passes are divided into one share per thread, which are handed out to
+ * the calling thread and the threads of the chain shared by all
+ * AsyncTaskGraphs.
  *
+ * While the passes are running, the detected entries are held back.  Once all
+ * of the threads are done, they are handed to the actual handlers in pass
+ * order, which is the same order in which the serial traversal would have
+ * produced them.
  */
 void CollisionTraverser::
-r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
-  if (!level_state.any_in_bounds()) {
+traverse_parallel(const NodePath &root) {
+  LevelStatesSingle level_states;
+  prepare_colliders(level_states, root,
+                    CollisionLevelStateSingle::get_max_colliders());
+  if (level_states.empty()) {
     return;
   }
-  if (!level_state.apply_transform()) {
+
+  if (level_states.size() == 1) {
+    // Everything fits in one pass; there is nothing to divide up.
+#ifdef DO_PSTATS
+    PStatTimer pass_timer(get_pass_collector(0));
+#endif
+    r_traverse(level_states[0], 0);
     return;
   }
 
-  PandaNode *node = level_state.node();
-  if (node->is_collision_node()) {
-    CollisionNode *cnode;
-    DCAST_INTO_V(cnode, node);
-    CPT(BoundingVolume) node_bv = cnode->get_bounds();
-    const GeometricBoundingVolume *node_gbv = nullptr;
-    if (node_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
-      DCAST_INTO_V(node_gbv, node_bv);
+  // Make sure all of the pass collectors exist before the threads start.
+  get_pass_collector((int)level_states.size() - 1);
+
+  size_t num_passes = level_states.size();
+  size_t num_threads = min((size_t)_num_threads, num_passes);
+
+  pvector<ParallelPass> passes(num_threads);
+  for (size_t t = 0; t < num_threads; ++t) {
+    ParallelPass &pp = passes[t];
+    pp._trav = this;
+    pp._level_states = &level_states;
+    pp._begin = (num_passes * t) / num_threads;
+    pp._end = (num_passes * (t + 1)) / num_threads;
+
+    // Direct the entries for these passes to the stand-in handlers.
+    for (size_t pass = pp._begin; pass < pp._end; ++pass) {
+      CollisionLevelStateSingle::Colliders &colliders = level_states[pass]._colliders;
+      for (size_t c = 0; c < colliders.size(); ++c) {
+        colliders[c]._handler = pp.get_deferred_handler(colliders[c]._handler);
+      }
     }
+  }
 
-    CollisionEntry entry;
-    entry._into_node = cnode;
-    entry._into_node_path = level_state.get_node_path();
-    if (_respect_prev_transform) {
-      entry._flags |= CollisionEntry::F_respect_prev_transform;
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph;
+  graph->set_max_workers((int)num_threads - 1);
+  graph->add_range(0, (int)num_threads, [&](int begin, int end) {
+    for (int t = begin; t < end; ++t) {
+      passes[t].traverse();
     }
-
-    int num_colliders = level_state.get_num_colliders();
-    for (int c = 0; c < num_colliders; ++c) {
-      if (level_state.has_collider(c)) {
-        entry._from_node = level_state.get_collider_node(c);
-
-        if ((entry._from_node->get_from_collide_mask() &
-             cnode->get_into_collide_mask()) != 0) {
-          #ifdef DO_PSTATS
-          // PStatTimer collide_timer(_solid_collide_collectors[pass]);
-          #endif
-          entry._from_node_path = level_state.get_collider_node_path(c);
-          entry._from = level_state.get_collider(c);
-
-          compare_collider_to_node(
-              entry,
-              level_state.get_parent_bound(c),
-              level_state.get_local_bound(c),
-              node_gbv);
-        }
-      }
+  }, 1);
+  graph->run();
+
+  for (size_t t = 0; t < num_threads; ++t) {
+    const DeferredEntries &entries = passes[t]._entries;
+    DeferredEntries::const_iterator ei;
+    for (ei = entries.begin(); ei != entries.end(); ++ei) {
+      (*ei).first->add_entry((*ei).second);
     }
+  }
+}
 
-  } else if (node->is_geom_node()) {
-    #ifndef NDEBUG
+/**
+ *
+ */
+void CollisionTraverser::
+compare_collider_to_node(CollisionEntry &entry, CollisionHandler *handler,
+                         const GeometricBoundingVolume *from_parent_gbv,
+                         const GeometricBoundingVolume *from_node_gbv,
+                         const GeometricBoundingVolume *into_node_gbv) {
+  bool within_node_bounds = true;
+  if (from_parent_gbv != nullptr &&
+      into_node_gbv != nullptr) {
+    within_node_bounds = (into_node_gbv->contains(from_parent_gbv) != 0);
+    _cnode_volume_pcollector.add_level(1);
+  }
+
+  if (within_node_bounds) {
+    Thread *current_thread = Thread::get_current_thread();
+
+    CollisionNode *cnode;
+    DCAST_INTO_V(cnode, entry._into_node);
+
+    int num_solids = cnode->get_num_solids();
     if (collide_cat.is_spam()) {
       collide_cat.spam()
-        << "Reached " << *node << "\n";
+        << "Colliding against CollisionNode " << entry._into_node
+        << " which has " << num_solids << " collision solids.\n";
     }
-    #endif
 
-    GeomNode *gnode;
-    DCAST_INTO_V(gnode, node);
-    CPT(BoundingVolume) node_bv = gnode->get_bounds();
-    const GeometricBoundingVolume *node_gbv = nullptr;
-    if (node_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
-      DCAST_INTO_V(node_gbv, node_bv);
-    }
+    // Only bother to test against each solid's bounding volume if we have
+    // more than one solid in the node, as a slight optimization.  (If the
+    // node contains just one solid, then the node's bounding volume, which
+    // we just tested, is the same as the solid's bounding volume.)
+    if (num_solids == 1) {
+      entry._into = cnode->_solids[0].get_read_pointer(current_thread);
+      entry.test_intersection(handler, this);
+    } else {
+      // If there are a lot of solids, let the node's BVH narrow down the
+      // solids that are worth testing.
+      CollisionBVH::Indices indices;
+      bool use_bvh = false;
+      if (collision_bvh_threshold > 0 && num_solids >= collision_bvh_threshold) {
+        CPT(CollisionBVH) bvh = cnode->get_solids_bvh(current_thread);
+        use_bvh = bvh->find_overlaps(from_node_gbv, indices);
+      }
 
-    CollisionEntry entry;
-    entry._into_node = gnode;
-    entry._into_node_path = level_state.get_node_path();
-    if (_respect_prev_transform) {
-      entry._flags |= CollisionEntry::F_respect_prev_transform;
-    }
+      size_t num_tests = use_bvh ? indices.size() : cnode->_solids.size();
+      for (size_t t = 0; t < num_tests; ++t) {
+        size_t si = use_bvh ? (size_t)indices[t] : t;
+        entry._into = cnode->_solids[si].get_read_pointer(current_thread);
 
-    int num_colliders = level_state.get_num_colliders();
-    for (int c = 0; c < num_colliders; ++c) {
-      if (level_state.has_collider(c)) {
-        entry._from_node = level_state.get_collider_node(c);
-
-        if ((entry._from_node->get_from_collide_mask() &
-             gnode->get_into_collide_mask()) != 0) {
-          #ifdef DO_PSTATS
-          // PStatTimer collide_timer(_solid_collide_collectors[pass]);
-          #endif
-          entry._from_node_path = level_state.get_collider_node_path(c);
-          entry._from = level_state.get_collider(c);
-
-          compare_collider_to_geom_node(
-              entry,
-              level_state.get_parent_bound(c),
-              level_state.get_local_bound(c),
-              node_gbv);
+        // We should allow a collision test for solid into itself, because the
+        // solid might be simply instanced into multiple different
+        // CollisionNodes.  We are already filtering out tests for a
+        // CollisionNode into itself.
+        CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
+        const GeometricBoundingVolume *solid_gbv = nullptr;
+        if (solid_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
+          solid_gbv = (const GeometricBoundingVolume *)solid_bv.p();
         }
+
+        compare_collider_to_solid(entry, handler, from_node_gbv, solid_gbv);
       }
     }
   }
-
-  if (node->has_single_child_visibility()) {
-    // If it's a switch node or sequence node, visit just the one visible
-    // child.
-    int index = node->get_visible_child();
-    if (index >= 0 && index < node->get_num_children()) {
-      CollisionLevelStateDouble next_state(level_state, node->get_child(index));
-      r_traverse_double(next_state, pass);
-    }
-
-  } else if (node->is_lod_node()) {
-    // If it's an LODNode, visit the lowest level of detail with all bits,
-    // allowing collision with geometry under the lowest level of default; and
-    // visit all other levels without GeomNode::get_default_collide_mask(),
-    // allowing only collision with CollisionNodes and special geometry under
-    // higher levels of detail.
-    int index = DCAST(LODNode, node)->get_lowest_switch();
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateDouble next_state(level_state, children.get_child(i));
-      if (i != index) {
-        next_state.set_include_mask(next_state.get_include_mask() &
-          ~GeomNode::get_default_collide_mask());
-      }
-      r_traverse_double(next_state, pass);
-    }
-
-  } else {
-    // Otherwise, visit all the children.
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateDouble next_state(level_state, children.get_child(i));
-      r_traverse_double(next_state, pass);
-    }
-  }
-}
-
-/**
- * Fills up the set of LevelStates corresponding to the active colliders in
- * use.
- *
- * This flavor uses a CollisionLevelStateQuad, which is limited to a certain
- * number of colliders per pass (typically 32).
- */
-void CollisionTraverser::
-prepare_colliders_quad(CollisionTraverser::LevelStatesQuad &level_states,
-                         const NodePath &root) {
-  int num_colliders = _colliders.size();
-  int max_colliders = CollisionLevelStateQuad::get_max_colliders();
-
-  CollisionLevelStateQuad level_state(root);
-  // This reserve() call is only correct if there is exactly one solid per
-  // collider added to the traverser, which is the normal case.  If there is
-  // more than one solid in any of the colliders, this reserve() call won't
-  // reserve enough, but the code is otherwise correct.
-  level_state.reserve(min(num_colliders, max_colliders));
-
-  // Create an indirect index array to walk through the colliders in sorted
-  // order, without affect the actual collider order.
-  int *indirect = (int *)alloca(sizeof(int) * num_colliders);
-  int i;
-  for (i = 0; i < num_colliders; ++i) {
-    indirect[i] = i;
-  }
-  std::sort(indirect, indirect + num_colliders, SortByColliderSort(*this));
-
-  int num_remaining_colliders = num_colliders;
-  for (i = 0; i < num_colliders; ++i) {
-    OrderedColliderDef &ocd = _ordered_colliders[indirect[i]];
-    NodePath cnode_path = ocd._node_path;
-
-    if (!cnode_path.is_same_graph(root)) {
-      if (ocd._in_graph) {
-        // Only report this warning once.
-        collide_cat.info()
-          << "Collider " << cnode_path
-          << " is not in scene graph.  Ignoring.\n";
-        ocd._in_graph = false;
-      }
-
-    } else {
-      ocd._in_graph = true;
-      CollisionNode *cnode = DCAST(CollisionNode, cnode_path.node());
-
-      CollisionLevelStateQuad::ColliderDef def;
-      def._node = cnode;
-      def._node_path = cnode_path;
-
-      int num_solids = cnode->get_num_solids();
-      for (int s = 0; s < num_solids; ++s) {
-        CPT(CollisionSolid) collider = cnode->get_solid(s);
-        def._collider = collider;
-        level_state.prepare_collider(def, root);
-
-        if (level_state.get_num_colliders() == max_colliders) {
-          // That's the limit.  Save off this level state and make a new one.
-          level_states.push_back(level_state);
-          level_state.clear();
-          level_state.reserve(min(num_remaining_colliders, max_colliders));
-        }
-      }
-    }
-
-    --num_remaining_colliders;
-    nassertv(num_remaining_colliders >= 0);
-  }
-
-  if (level_state.get_num_colliders() != 0) {
-    level_states.push_back(level_state);
-  }
-  nassertv(num_remaining_colliders == 0);
-}
-
-/**
- *
- */
-void CollisionTraverser::
-r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
-  if (!level_state.any_in_bounds()) {
-    return;
-  }
-  if (!level_state.apply_transform()) {
-    return;
-  }
-
-  PandaNode *node = level_state.node();
-  if (node->is_collision_node()) {
-    CollisionNode *cnode;
-    DCAST_INTO_V(cnode, node);
-    CPT(BoundingVolume) node_bv = cnode->get_bounds();
-    const GeometricBoundingVolume *node_gbv = nullptr;
-    if (node_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
-      DCAST_INTO_V(node_gbv, node_bv);
-    }
-
-    CollisionEntry entry;
-    entry._into_node = cnode;
-    entry._into_node_path = level_state.get_node_path();
-    if (_respect_prev_transform) {
-      entry._flags |= CollisionEntry::F_respect_prev_transform;
-    }
-
-    int num_colliders = level_state.get_num_colliders();
-    for (int c = 0; c < num_colliders; ++c) {
-      if (level_state.has_collider(c)) {
-        entry._from_node = level_state.get_collider_node(c);
-
-        if ((entry._from_node->get_from_collide_mask() &
-             cnode->get_into_collide_mask()) != 0) {
-          #ifdef DO_PSTATS
-          // PStatTimer collide_timer(_solid_collide_collectors[pass]);
-          #endif
-          entry._from_node_path = level_state.get_collider_node_path(c);
-          entry._from = level_state.get_collider(c);
-
-          compare_collider_to_node(
-              entry,
-              level_state.get_parent_bound(c),
-              level_state.get_local_bound(c),
-              node_gbv);
-        }
-      }
-    }
-
-  } else if (node->is_geom_node()) {
-    #ifndef NDEBUG
-    if (collide_cat.is_spam()) {
-      collide_cat.spam()
-        << "Reached " << *node << "\n";
-    }
-    #endif
-
-    GeomNode *gnode;
-    DCAST_INTO_V(gnode, node);
-    CPT(BoundingVolume) node_bv = gnode->get_bounds();
-    const GeometricBoundingVolume *node_gbv = nullptr;
-    if (node_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
-      DCAST_INTO_V(node_gbv, node_bv);
-    }
-
-    CollisionEntry entry;
-    entry._into_node = gnode;
-    entry._into_node_path = level_state.get_node_path();
-    if (_respect_prev_transform) {
-      entry._flags |= CollisionEntry::F_respect_prev_transform;
-    }
-
-    int num_colliders = level_state.get_num_colliders();
-    for (int c = 0; c < num_colliders; ++c) {
-      if (level_state.has_collider(c)) {
-        entry._from_node = level_state.get_collider_node(c);
-
-        if ((entry._from_node->get_from_collide_mask() &
-             gnode->get_into_collide_mask()) != 0) {
-          #ifdef DO_PSTATS
-          // PStatTimer collide_timer(_solid_collide_collectors[pass]);
-          #endif
-          entry._from_node_path = level_state.get_collider_node_path(c);
-          entry._from = level_state.get_collider(c);
-
-          compare_collider_to_geom_node(
-              entry,
-              level_state.get_parent_bound(c),
-              level_state.get_local_bound(c),
-              node_gbv);
-        }
-      }
-    }
-  }
-
-  if (node->has_single_child_visibility()) {
-    // If it's a switch node or sequence node, visit just the one visible
-    // child.
-    int index = node->get_visible_child();
-    if (index >= 0 && index < node->get_num_children()) {
-      CollisionLevelStateQuad next_state(level_state, node->get_child(index));
-      r_traverse_quad(next_state, pass);
-    }
-
-  } else if (node->is_lod_node()) {
-    // If it's an LODNode, visit the lowest level of detail with all bits,
-    // allowing collision with geometry under the lowest level of default; and
-    // visit all other levels without GeomNode::get_default_collide_mask(),
-    // allowing only collision with CollisionNodes and special geometry under
-    // higher levels of detail.
-    int index = DCAST(LODNode, node)->get_lowest_switch();
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateQuad next_state(level_state, children.get_child(i));
-      if (i != index) {
-        next_state.set_include_mask(next_state.get_include_mask() &
-          ~GeomNode::get_default_collide_mask());
-      }
-      r_traverse_quad(next_state, pass);
-    }
-
-  } else {
-    // Otherwise, visit all the children.
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateQuad next_state(level_state, children.get_child(i));
-      r_traverse_quad(next_state, pass);
-    }
-  }
-}
-
-/**
- *
- */
-void CollisionTraverser::
-compare_collider_to_node(CollisionEntry &entry,
-                         const GeometricBoundingVolume *from_parent_gbv,
-                         const GeometricBoundingVolume *from_node_gbv,
-                         const GeometricBoundingVolume *into_node_gbv) {
-  bool within_node_bounds = true;
-  if (from_parent_gbv != nullptr &&
-      into_node_gbv != nullptr) {
-    within_node_bounds = (into_node_gbv->contains(from_parent_gbv) != 0);
-    _cnode_volume_pcollector.add_level(1);
-  }
-
-  if (within_node_bounds) {
-    Thread *current_thread = Thread::get_current_thread();
-
-    CollisionNode *cnode;
-    DCAST_INTO_V(cnode, entry._into_node);
-
-    int num_solids = cnode->get_num_solids();
-    if (collide_cat.is_spam()) {
-      collide_cat.spam()
-        << "Colliding against CollisionNode " << entry._into_node
-        << " which has " << num_solids << " collision solids.\n";
-    }
-
-    // Only bother to test against each solid's bounding volume if we have
-    // more than one solid in the node, as a slight optimization.  (If the
-    // node contains just one solid, then the node's bounding volume, which
-    // we just tested, is the same as the solid's bounding volume.)
-    if (num_solids == 1) {
-      entry._into = cnode->_solids[0].get_read_pointer(current_thread);
-      Colliders::const_iterator ci;
-      ci = _colliders.find(entry.get_from_node_path());
-      nassertv(ci != _colliders.end());
-      entry.test_intersection((*ci).second, this);
-    } else {
-      CollisionNode::Solids::const_iterator si;
-      for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
-        entry._into = (*si).get_read_pointer(current_thread);
-
-        // We should allow a collision test for solid into itself, because the
-        // solid might be simply instanced into multiple different
-        // CollisionNodes.  We are already filtering out tests for a
-        // CollisionNode into itself.
-        CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
-        const GeometricBoundingVolume *solid_gbv = nullptr;
-        if (solid_bv->is_of_type(GeometricBoundingVolume::get_class_type())) {
-          solid_gbv = (const GeometricBoundingVolume *)solid_bv.p();
-        }
-
-        compare_collider_to_solid(entry, from_node_gbv, solid_gbv);
-      }
-    }
-  }
-}
+}
 
 /**
  *
  */
 void CollisionTraverser::
-compare_collider_to_geom_node(CollisionEntry &entry,
+compare_collider_to_geom_node(CollisionEntry &entry, CollisionHandler *handler,
                               const GeometricBoundingVolume *from_parent_gbv,
                               const GeometricBoundingVolume *from_node_gbv,
                               const GeometricBoundingVolume *into_node_gbv) {
@@ -1208,7 +1149,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
           DCAST_INTO_V(geom_gbv, geom_bv);
         }
 
-        compare_collider_to_geom(entry, geom, from_node_gbv, geom_gbv);
+        compare_collider_to_geom(entry, handler, geom, from_node_gbv, geom_gbv);
       }
     }
   }
@@ -1218,7 +1159,7 @@ compare_collider_to_geom_node(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_solid(CollisionEntry &entry,
+compare_collider_to_solid(CollisionEntry &entry, CollisionHandler *handler,
                           const GeometricBoundingVolume *from_node_gbv,
                           const GeometricBoundingVolume *solid_gbv) {
   bool within_solid_bounds = true;
@@ -1238,10 +1179,7 @@ compare_collider_to_solid(CollisionEntry &entry,
 #endif  // NDEBUG
   }
   if (within_solid_bounds) {
-    Colliders::const_iterator ci;
-    ci = _colliders.find(entry.get_from_node_path());
-    nassertv(ci != _colliders.end());
-    entry.test_intersection((*ci).second, this);
+    entry.test_intersection(handler, this);
   }
 }
 
@@ -1249,7 +1187,8 @@ compare_collider_to_solid(CollisionEntry &entry,
  *
  */
 void CollisionTraverser::
-compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
+compare_collider_to_geom(CollisionEntry &entry, CollisionHandler *handler,
+                         const Geom *geom,
                          const GeometricBoundingVolume *from_node_gbv,
                          const GeometricBoundingVolume *geom_gbv) {
   bool within_geom_bounds = true;
@@ -1259,12 +1198,30 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
     _geom_volume_pcollector.add_level(1);
   }
   if (within_geom_bounds) {
-    Colliders::const_iterator ci;
-    ci = _colliders.find(entry.get_from_node_path());
-    nassertv(ci != _colliders.end());
-
     if (geom->get_primitive_type() == Geom::PT_polygons) {
       Thread *current_thread = Thread::get_current_thread();
+
+      CPT(TriangleCache) cache = get_triangle_cache(geom, current_thread);
+      if (cache != nullptr) {
+        // We have the triangles of this Geom already, along with a BVH to
+        // tell us which of them are worth testing.
+        const LPoint3 *vertices = &cache->_vertices[0];
+        CollisionBVH::Indices indices;
+        if (cache->_bvh->find_overlaps(from_node_gbv, indices)) {
+          for (size_t t = 0; t < indices.size(); ++t) {
+            compare_collider_to_triangle(entry, handler, vertices + indices[t] * 3,
+                                         from_node_gbv);
+          }
+        } else {
+          size_t num_triangles = cache->_vertices.size() / 3;
+          for (size_t t = 0; t < num_triangles; ++t) {
+            compare_collider_to_triangle(entry, handler, vertices + t * 3,
+                                         from_node_gbv);
+          }
+        }
+        return;
+      }
+
       CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
       GeomVertexReader vertex(data, InternalName::get_vertex());
 
@@ -1287,23 +1244,8 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
             vertex.set_row_unsafe(index.get_data1i());
             v[2] = vertex.get_data3();
 
-            // Generate a temporary CollisionGeom on the fly for each triangle
-            // in the Geom.
             if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
-              bool within_solid_bounds = true;
-              if (from_node_gbv != nullptr) {
-                BoundingSphere sphere;
-                sphere.around(v, v + 3);
-                within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
-#ifdef DO_PSTATS
-                CollisionGeom::_volume_pcollector.add_level(1);
-#endif  // DO_PSTATS
-              }
-              if (within_solid_bounds) {
-                PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
-                entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
-              }
+              compare_collider_to_triangle(entry, handler, v, from_node_gbv);
             }
           }
         } else {
@@ -1317,23 +1259,8 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
             v[1] = vertex.get_data3();
             v[2] = vertex.get_data3();
 
-            // Generate a temporary CollisionGeom on the fly for each triangle
-            // in the Geom.
             if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
-              bool within_solid_bounds = true;
-              if (from_node_gbv != nullptr) {
-                BoundingSphere sphere;
-                sphere.around(v, v + 3);
-                within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
-#ifdef DO_PSTATS
-                CollisionGeom::_volume_pcollector.add_level(1);
-#endif  // DO_PSTATS
-              }
-              if (within_solid_bounds) {
-                PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
-                entry._into = cgeom;
-                entry.test_intersection((*ci).second, this);
-              }
+              compare_collider_to_triangle(entry, handler, v, from_node_gbv);
             }
           }
         }
@@ -1342,6 +1269,446 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
   }
 }
 
+/**
+ * Tests the collider against a single triangle of a Geom, which has already
+ * been verified with CollisionPolygon::verify_points().
+ */
+void CollisionTraverser::
+compare_collider_to_triangle(CollisionEntry &entry, CollisionHandler *handler,
+                             const LPoint3 *v,
+                             const GeometricBoundingVolume *from_node_gbv) {
+  bool within_solid_bounds = true;
+  if (from_node_gbv != nullptr) {
+    BoundingSphere sphere;
+    sphere.around(v, v + 3);
+    within_solid_bounds = (sphere.contains(from_node_gbv) != 0);
+#ifdef DO_PSTATS
+    CollisionGeom::_volume_pcollector.add_level(1);
+#endif  // DO_PSTATS
+  }
+  if (within_solid_bounds) {
+    // Generate a temporary CollisionGeom on the fly for the triangle.
+    PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
+    entry._into = cgeom;
+    entry.test_intersection(handler, this);
+  }
+}
+
+/**
+ * Returns the triangles of the indicated Geom, along with a BVH over them,
+ * building them if necessary.  Returns NULL if the Geom is animated or too
+ * small to be worth caching, in which case the caller should visit its
+ * triangles directly.
+ *
+ * The cache is stored on the Geom, and is replaced once either the Geom or
+ * its vertex data has been modified.
+ */
+CPT(CollisionTraverser::TriangleCache) CollisionTraverser::
+get_triangle_cache(const Geom *geom, Thread *current_thread) {
+  if (collision_bvh_threshold <= 0 ||
+      geom->get_nested_vertices(current_thread) < collision_bvh_threshold * 3) {
+    return nullptr;
+  }
+
+  CPT(GeomVertexData) data = geom->get_vertex_data(current_thread);
+  if (data->get_format()->get_animation().get_animation_type() != Geom::AT_none) {
+    return nullptr;
+  }
+  UpdateSeq geom_modified = geom->get_modified(current_thread);
+  UpdateSeq data_modified = data->get_modified(current_thread);
+
+  {
+    // Nothing but the CollisionTraverser stores a collision cache on a Geom.
+    CPT(ReferenceCount) stored = geom->get_collision_cache();
+    const TriangleCache *cache = (const TriangleCache *)stored.p();
+    if (cache != nullptr &&
+        cache->_geom_modified == geom_modified &&
+        cache->_vertex_data_modified == data_modified) {
+      return cache;
+    }
+  }
+
+  // If another thread builds the same entry at the same time, one of the two
+  // results is simply discarded.
+  PT(TriangleCache) cache = new TriangleCache;
+  cache->_geom_modified = geom_modified;
+  cache->_vertex_data_modified = data_modified;
+  cache->_bvh = new CollisionBVH;
+
+  GeomVertexReader vertex(data, InternalName::get_vertex(), current_thread);
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) tris = geom->get_primitive(i)->decompose();
+    nassertr(tris->is_of_type(GeomTriangles::get_class_type()), nullptr);
+
+    int num_vertices = tris->get_num_vertices();
+    for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+      LPoint3 v[3];
+      for (int k = 0; k < 3; ++k) {
+        vertex.set_row_unsafe(tris->get_vertex(vi + k));
+        v[k] = vertex.get_data3();
+      }
+
+      if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
+        int index = (int)(cache->_vertices.size() / 3);
+        cache->_vertices.insert(cache->_vertices.end(), v, v + 3);
+        cache->_bvh->add_item(index, v[0].fmin(v[1]).fmin(v[2]),
+                              v[0].fmax(v[1]).fmax(v[2]));
+      }
+    }
+  }
+
+  if (cache->_vertices.empty()) {
+    return nullptr;
+  }
+  cache->_bvh->build();
+
+  geom->set_collision_cache(cache);
+  return cache;
+}
+
+/**
+ * The recursive part of traverse_rays().  parent_level contains the rays that
+ * are still of interest, in the coordinate space of the node's parent.
+ */
+void CollisionTraverser::
+r_traverse_rays(CollisionRayBatch *batch, CollideMask from_mask,
+                const NodePath &node_path, const RayLevel &parent_level,
+                CollisionRay *ray) {
+  PandaNode *node = node_path.node();
+  if ((node->get_net_collide_mask() & from_mask).is_zero()) {
+    return;
+  }
+
+  // Drop the rays that miss this node's bounding volume altogether, or that
+  // have already hit something nearer than it.
+  CPT(BoundingVolume) node_bv = node->get_bounds();
+  if (node_bv->is_empty()) {
+    return;
+  }
+  const FiniteBoundingVolume *node_fbv = nullptr;
+  if (!node_bv->is_infinite()) {
+    node_fbv = node_bv->as_finite_bounding_volume();
+  }
+
+  RayLevel level;
+  size_t num_parent_rays = parent_level._rays.size();
+  level._rays.reserve(num_parent_rays);
+  for (size_t i = 0; i < num_parent_rays; ++i) {
+    int r = parent_level._rays[i];
+    if (node_fbv == nullptr ||
+        ray_intersects_box(parent_level._origins[i], parent_level._directions[i],
+                           batch->get_max_t(r), node_fbv->get_min(),
+                           node_fbv->get_max())) {
+      level._rays.push_back(r);
+      level._origins.push_back(parent_level._origins[i]);
+      level._directions.push_back(parent_level._directions[i]);
+    }
+  }
+  CollisionLevelStateBase::_node_volume_pcollector.add_level(1);
+  if (level._rays.empty()) {
+    return;
+  }
+
+  // Now bring the surviving rays into the node's own coordinate space.
+  CPT(TransformState) transform = node->get_transform();
+  if (transform->is_identity()) {
+    level._to_root = parent_level._to_root;
+  } else {
+    const LMatrix4 &mat = transform->get_mat();
+    LMatrix4 inv;
+    if (!inv.invert_from(mat)) {
+      return;
+    }
+    level._to_root.multiply(mat, parent_level._to_root);
+
+    size_t num_rays = level._rays.size();
+    for (size_t i = 0; i < num_rays; ++i) {
+      level._origins[i] = inv.xform_point(level._origins[i]);
+      level._directions[i] = inv.xform_vec(level._directions[i]);
+    }
+  }
+
+  if (node->is_collision_node()) {
+    if (!(((CollisionNode *)node)->get_into_collide_mask() & from_mask).is_zero()) {
+      compare_rays_to_node(batch, node_path, level, ray);
+    }
+
+  } else if (node->is_geom_node()) {
+    if (!(((GeomNode *)node)->get_into_collide_mask() & from_mask).is_zero()) {
+      compare_rays_to_geom_node(batch, node_path, level);
+    }
+  }
+
+  if (node->has_single_child_visibility()) {
+    int index = node->get_visible_child();
+    if (index >= 0 && index < node->get_num_children()) {
+      r_traverse_rays(batch, from_mask,
+                      NodePath(node_path, node->get_child(index)), level, ray);
+    }
+
+  } else if (node->is_lod_node()) {
+    // As in r_traverse(), only the lowest level of detail may collide
+    // with visible geometry.
+    int index = DCAST(LODNode, node)->get_lowest_switch();
+    CollideMask lod_mask = from_mask & ~GeomNode::get_default_collide_mask();
+    PandaNode::Children children = node->get_children();
+    int num_children = children.get_num_children();
+    for (int i = 0; i < num_children; ++i) {
+      r_traverse_rays(batch, (i == index) ? from_mask : lod_mask,
+                      NodePath(node_path, children.get_child(i)), level, ray);
+    }
+
+  } else {
+    PandaNode::Children children = node->get_children();
+    int num_children = children.get_num_children();
+    for (int i = 0; i < num_children; ++i) {
+      r_traverse_rays(batch, from_mask,
+                      NodePath(node_path, children.get_child(i)), level, ray);
+    }
+  }
+}
+
+/**
+ * Tests the rays of the level against the solids of a CollisionNode.
+ */
+void CollisionTraverser::
+compare_rays_to_node(CollisionRayBatch *batch, const NodePath &node_path,
+                     const RayLevel &level, CollisionRay *ray) {
+  Thread *current_thread = Thread::get_current_thread();
+
+  CollisionNode *cnode;
+  DCAST_INTO_V(cnode, node_path.node());
+  int num_solids = cnode->get_num_solids();
+
+  CPT(CollisionBVH) bvh;
+  if (collision_bvh_threshold > 0 && num_solids >= collision_bvh_threshold) {
+    bvh = cnode->get_solids_bvh(current_thread);
+  }
+
+  // The ray is already in the space of the node, so the entry describes a
+  // collision of the node with itself.
+  CollisionEntry entry;
+  entry._from = ray;
+  entry._into_node = cnode;
+  entry._from_node_path = node_path;
+  entry._into_node_path = node_path;
+
+  CollisionBVH::Indices indices;
+  size_t num_rays = level._rays.size();
+  for (size_t i = 0; i < num_rays; ++i) {
+    const LPoint3 &origin = level._origins[i];
+    const LVector3 &direction = level._directions[i];
+    ray->set_origin(origin);
+    ray->set_direction(direction);
+
+    size_t num_tests = (size_t)num_solids;
+    if (bvh != nullptr) {
+      indices.clear();
+      bvh->find_line_overlaps(origin, direction, indices);
+      num_tests = indices.size();
+    }
+
+    for (size_t t = 0; t < num_tests; ++t) {
+      size_t si = (bvh != nullptr) ? (size_t)indices[t] : t;
+      entry._into = cnode->_solids[si].get_read_pointer(current_thread);
+
+      PT(CollisionEntry) result = ray->test_intersection(entry);
+#ifdef DO_PSTATS
+      ((CollisionSolid *)entry._into.p())->get_test_pcollector().add_level(1);
+#endif  // DO_PSTATS
+      if (result != nullptr && result->has_surface_point()) {
+        LVector3 offset = result->_surface_point - origin;
+        PN_stdfloat t = offset.dot(direction) / direction.length_squared();
+        LVector3 normal = result->has_surface_normal() ?
+          result->_surface_normal : -direction;
+        record_ray_hit(batch, level, i, t, result->_surface_point, normal,
+                       node_path);
+      }
+    }
+  }
+}
+
+/**
+ * Tests the rays of the level against the triangles of a GeomNode.  This
+ * performs the ray-triangle test directly, rather than through a
+ * CollisionGeom.
+ */
+void CollisionTraverser::
+compare_rays_to_geom_node(CollisionRayBatch *batch, const NodePath &node_path,
+                          const RayLevel &level) {
+  Thread *current_thread = Thread::get_current_thread();
+
+  GeomNode *gnode;
+  DCAST_INTO_V(gnode, node_path.node());
+
+  pvector<size_t> geom_rays;
+  CollisionBVH::Indices indices;
+  pvector<LPoint3> vertices;
+
+  int num_geoms = gnode->get_num_geoms();
+  for (int g = 0; g < num_geoms; ++g) {
+    CPT(Geom) geom = gnode->get_geom(g);
+    if (geom->get_primitive_type() != Geom::PT_polygons) {
+      continue;
+    }
+
+    // Find the rays that touch this particular Geom.
+    CPT(BoundingVolume) geom_bv = geom->get_bounds(current_thread);
+    if (geom_bv->is_empty()) {
+      continue;
+    }
+    const FiniteBoundingVolume *geom_fbv = nullptr;
+    if (!geom_bv->is_infinite()) {
+      geom_fbv = geom_bv->as_finite_bounding_volume();
+    }
+
+    geom_rays.clear();
+    size_t num_rays = level._rays.size();
+    for (size_t i = 0; i < num_rays; ++i) {
+      if (geom_fbv == nullptr ||
+          ray_intersects_box(level._origins[i], level._directions[i],
+                             batch->get_max_t(level._rays[i]),
+                             geom_fbv->get_min(), geom_fbv->get_max())) {
+        geom_rays.push_back(i);
+      }
+    }
+    _geom_volume_pcollector.add_level(1);
+    if (geom_rays.empty()) {
+      continue;
+    }
+
+    // Collect the triangles, unless they have been cached already.
+    CPT(TriangleCache) cache = get_triangle_cache(geom, current_thread);
+    const LPoint3 *v;
+    size_t num_triangles;
+    if (cache != nullptr) {
+      v = &cache->_vertices[0];
+      num_triangles = cache->_vertices.size() / 3;
+    } else {
+      vertices.clear();
+      CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
+      GeomVertexReader vertex(data, InternalName::get_vertex(), current_thread);
+
+      int num_primitives = geom->get_num_primitives();
+      for (int pi = 0; pi < num_primitives; ++pi) {
+        CPT(GeomPrimitive) tris = geom->get_primitive(pi)->decompose();
+        nassertv(tris->is_of_type(GeomTriangles::get_class_type()));
+
+        int num_vertices = tris->get_num_vertices();
+        num_vertices -= num_vertices % 3;
+        for (int vi = 0; vi < num_vertices; ++vi) {
+          vertex.set_row_unsafe(tris->get_vertex(vi));
+          vertices.push_back(vertex.get_data3());
+        }
+      }
+      if (vertices.empty()) {
+        continue;
+      }
+      v = &vertices[0];
+      num_triangles = vertices.size() / 3;
+    }
+
+    for (size_t ri = 0; ri < geom_rays.size(); ++ri) {
+      size_t i = geom_rays[ri];
+      const LPoint3 &origin = level._origins[i];
+      const LVector3 &direction = level._directions[i];
+
+      size_t num_tests = num_triangles;
+      if (cache != nullptr) {
+        indices.clear();
+        cache->_bvh->find_line_overlaps(origin, direction, indices);
+        num_tests = indices.size();
+      }
+
+      // Test the ray against each triangle, from both sides, as
+      // CollisionPolygon would.
+      for (size_t t = 0; t < num_tests; ++t) {
+        const LPoint3 *tri = v + ((cache != nullptr) ? (size_t)indices[t] : t) * 3;
+        LVector3 e1 = tri[1] - tri[0];
+        LVector3 e2 = tri[2] - tri[0];
+        LVector3 p = direction.cross(e2);
+        PN_stdfloat det = e1.dot(p);
+        if (IS_NEARLY_ZERO(det)) {
+          continue;
+        }
+        PN_stdfloat inv_det = 1.0f / det;
+        LVector3 s = origin - tri[0];
+        PN_stdfloat bu = s.dot(p) * inv_det;
+        if (bu < 0.0f || bu > 1.0f) {
+          continue;
+        }
+        LVector3 q = s.cross(e1);
+        PN_stdfloat bv = direction.dot(q) * inv_det;
+        if (bv < 0.0f || bu + bv > 1.0f) {
+          continue;
+        }
+        PN_stdfloat hit_t = e2.dot(q) * inv_det;
+        if (hit_t < 0.0f || hit_t > batch->get_max_t(level._rays[i])) {
+          continue;
+        }
+        record_ray_hit(batch, level, i, hit_t, origin + direction * hit_t,
+                       e1.cross(e2), node_path);
+      }
+    }
+  }
+}
+
+/**
+ * Records a hit of the ith ray of the level, which is expressed in the
+ * level's coordinate space, in the batch.
+ */
+void CollisionTraverser::
+record_ray_hit(CollisionRayBatch *batch, const RayLevel &level, size_t i,
+               PN_stdfloat t, const LPoint3 &point, const LVector3 &normal,
+               const NodePath &node_path) {
+  int r = level._rays[i];
+  if (t < 0.0f || t > batch->get_max_t(r)) {
+    return;
+  }
+
+  LMatrix3 normal_mat;
+  if (!normal_mat.invert_transpose_from(level._to_root)) {
+    return;
+  }
+  LVector3 root_normal = normal_mat.xform(normal);
+  root_normal.normalize();
+  batch->record_hit(r, t, level._to_root.xform_point(point), root_normal,
+                    node_path);
+}
+
+/**
+ * Returns true if the part of the ray between parameters 0 and max_t passes
+ * through the indicated axis-aligned box.
+ */
+bool CollisionTraverser::
+ray_intersects_box(const LPoint3 &origin, const LVector3 &direction,
+                   PN_stdfloat max_t, const LPoint3 &min, const LPoint3 &max) {
+  PN_stdfloat t0 = 0.0f;
+  PN_stdfloat t1 = max_t;
+  for (int a = 0; a < 3; ++a) {
+    if (direction[a] == 0.0f) {
+      if (origin[a] < min[a] || origin[a] > max[a]) {
+        return false;
+      }
+    } else {
+      PN_stdfloat inv = 1.0f / direction[a];
+      PN_stdfloat near_t = (min[a] - origin[a]) * inv;
+      PN_stdfloat far_t = (max[a] - origin[a]) * inv;
+      if (near_t > far_t) {
+        std::swap(near_t, far_t);
+      }
+      t0 = std::max(t0, near_t);
+      t1 = std::min(t1, far_t);
+      if (t0 > t1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 /**
  * Removes the indicated CollisionHandler from the list of handlers to be
  * processed, and returns the iterator to the next handler in the list.  This
@@ -1408,6 +1775,8 @@ get_pass_collector(int pass) {
     _pass_collectors.push_back(col);
     PStatCollector sc_col(col, "solid_collide");
     _solid_collide_collectors.push_back(sc_col);
+    PStatCollector bp_col(col, "broadphase");
+    _broadphase_collectors.push_back(bp_col);
   }
 
   return _pass_collectors[pass];
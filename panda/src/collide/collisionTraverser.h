@@ -19,17 +19,23 @@
 #include "collisionHandler.h"
 #include "collisionLevelState.h"
 
+#include "collisionBVH.h"
+#include "collideMask.h"
+#include "geom.h"
 #include "pointerTo.h"
+#include "updateSeq.h"
 #include "pStatCollector.h"
 
 #include "pset.h"
+#include "pvector.h"
 #include "register_type.h"
 #include "extension.h"
 
 class CollisionNode;
+class CollisionRay;
+class CollisionRayBatch;
 class CollisionRecorder;
 class CollisionVisualizer;
-class Geom;
 class NodePath;
 class CollisionEntry;
 
@@ -53,6 +59,15 @@ PUBLISHED:
   MAKE_PROPERTY(respect_prev_transform, get_respect_prev_transform,
                                         set_respect_prev_transform);
 
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+
+  INLINE void set_broadphase_threshold(int threshold);
+  INLINE int get_broadphase_threshold() const;
+  MAKE_PROPERTY(broadphase_threshold, get_broadphase_threshold,
+                                      set_broadphase_threshold);
+
   void add_collider(const NodePath &collider, CollisionHandler *handler);
   bool remove_collider(const NodePath &collider);
   bool has_collider(const NodePath &collider) const;
@@ -64,6 +79,8 @@ PUBLISHED:
   MAKE_SEQ_PROPERTY(colliders, get_num_colliders, get_collider);
 
   BLOCKING void traverse(const NodePath &root);
+  BLOCKING void traverse_rays(const NodePath &root, CollisionRayBatch *batch,
+                              CollideMask from_mask);
 
 #if defined(DO_COLLISION_RECORDING) || !defined(CPPPARSER)
   void set_recorder(CollisionRecorder *recorder);
@@ -85,31 +102,87 @@ PUBLISHED:
 
 private:
   typedef pvector<CollisionLevelStateSingle> LevelStatesSingle;
-  void prepare_colliders_single(LevelStatesSingle &level_states, const NodePath &root);
-  void r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass);
-
   typedef pvector<CollisionLevelStateDouble> LevelStatesDouble;
-  void prepare_colliders_double(LevelStatesDouble &level_states, const NodePath &root);
-  void r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass);
-
   typedef pvector<CollisionLevelStateQuad> LevelStatesQuad;
-  void prepare_colliders_quad(LevelStatesQuad &level_states, const NodePath &root);
-  void r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass);
-
-  void compare_collider_to_node(CollisionEntry &entry,
+  typedef pvector<CollisionLevelStateArray> LevelStatesArray;
+
+  template<class LevelState>
+  void prepare_colliders(pvector<LevelState> &level_states, const NodePath &root,
+                         int max_colliders);
+  template<class LevelState>
+  void r_traverse(LevelState &level_state, size_t pass);
+  template<class LevelState>
+  bool sweep_children(const LevelState &level_state,
+                      const PandaNode::Children &children,
+                      pvector<typename LevelState::CurrentMask> &child_masks,
+                      size_t pass);
+
+  template<class MaskType>
+  void borrow_mask(MaskType &mask);
+  template<class MaskType>
+  void return_mask(MaskType &mask);
+  void borrow_mask(BitArray &mask);
+  void return_mask(BitArray &mask);
+
+  bool can_traverse_parallel() const;
+  void traverse_parallel(const NodePath &root);
+
+  void compare_collider_to_node(CollisionEntry &entry, CollisionHandler *handler,
                                 const GeometricBoundingVolume *from_parent_gbv,
                                 const GeometricBoundingVolume *from_node_gbv,
                                 const GeometricBoundingVolume *into_node_gbv);
   void compare_collider_to_geom_node(CollisionEntry &entry,
+                                     CollisionHandler *handler,
                                      const GeometricBoundingVolume *from_parent_gbv,
                                      const GeometricBoundingVolume *from_node_gbv,
                                      const GeometricBoundingVolume *into_node_gbv);
-  void compare_collider_to_solid(CollisionEntry &entry,
+  void compare_collider_to_solid(CollisionEntry &entry, CollisionHandler *handler,
                                  const GeometricBoundingVolume *from_node_gbv,
                                  const GeometricBoundingVolume *solid_gbv);
-  void compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
+  void compare_collider_to_geom(CollisionEntry &entry, CollisionHandler *handler,
+                                const Geom *geom,
                                 const GeometricBoundingVolume *from_node_gbv,
                                 const GeometricBoundingVolume *solid_gbv);
+  void compare_collider_to_triangle(CollisionEntry &entry, CollisionHandler *handler,
+                                    const LPoint3 *v,
+                                    const GeometricBoundingVolume *from_node_gbv);
+
+  // The triangles of a static Geom, as collected by get_triangle_cache().
+  // This is stored on the Geom itself, with Geom::set_collision_cache().
+  class TriangleCache : public ReferenceCount {
+  public:
+    UpdateSeq _geom_modified;
+    UpdateSeq _vertex_data_modified;
+
+    // Three vertices per triangle, indexed by the items in _bvh.
+    pvector<LPoint3> _vertices;
+    PT(CollisionBVH) _bvh;
+  };
+  static CPT(TriangleCache) get_triangle_cache(const Geom *geom, Thread *current_thread);
+
+  // The rays of a CollisionRayBatch that are still of interest at a
+  // particular node, transformed into that node's coordinate space.
+  class RayLevel {
+  public:
+    pvector<int> _rays;
+    pvector<LPoint3> _origins;
+    pvector<LVector3> _directions;
+    LMatrix4 _to_root;
+  };
+  void r_traverse_rays(CollisionRayBatch *batch, CollideMask from_mask,
+                       const NodePath &node_path, const RayLevel &parent_level,
+                       CollisionRay *ray);
+  void compare_rays_to_node(CollisionRayBatch *batch, const NodePath &node_path,
+                            const RayLevel &level, CollisionRay *ray);
+  void compare_rays_to_geom_node(CollisionRayBatch *batch,
+                                 const NodePath &node_path,
+                                 const RayLevel &level);
+  static void record_ray_hit(CollisionRayBatch *batch, const RayLevel &level,
+                             size_t i, PN_stdfloat t, const LPoint3 &point,
+                             const LVector3 &normal, const NodePath &node_path);
+  static bool ray_intersects_box(const LPoint3 &origin, const LVector3 &direction,
+                                 PN_stdfloat max_t, const LPoint3 &min,
+                                 const LPoint3 &max);
 
   PStatCollector &get_pass_collector(int pass);
 
@@ -133,6 +206,8 @@ private:
   Handlers::iterator remove_handler(Handlers::iterator hi);
 
   bool _respect_prev_transform;
+  int _num_threads;
+  int _broadphase_threshold;
 #ifdef DO_COLLISION_RECORDING
   CollisionRecorder *_recorder;
   NodePath _collision_visualizer_np;
@@ -147,6 +222,7 @@ private:
   static PStatCollector _cnode_volume_pcollector;
   static PStatCollector _gnode_volume_pcollector;
   static PStatCollector _geom_volume_pcollector;
+  static PStatCollector _ray_batch_pcollector;
 
   PStatCollector _this_pcollector;
   typedef pvector<PStatCollector> PassCollectors;
@@ -155,6 +231,14 @@ private:
   // collision detection)
   typedef pvector<PStatCollector> SolidCollideCollectors;
   SolidCollideCollectors _solid_collide_collectors;
+  typedef pvector<PStatCollector> BroadphaseCollectors;
+  BroadphaseCollectors _broadphase_collectors;
+
+  // Storage for the masks of the CollisionLevelStateArray, kept from one
+  // level of the traversal to the next.  See borrow_mask().
+  typedef pvector<BitArray> SpareMasks;
+  SpareMasks _spare_masks;
+
 
 public:
   static TypeHandle get_class_type() {
@@ -167,6 +251,13 @@ public:
 private:
   static TypeHandle _type_handle;
 
+  // The entries detected by each thread of traverse_parallel(), to be passed
+  // on to the real handlers once all of the threads are done.
+  typedef pvector<std::pair<CollisionHandler *, PT(CollisionEntry)> > DeferredEntries;
+
+  class DeferredHandler;
+  class ParallelPass;
+
   friend class SortByColliderSort;
 };
 
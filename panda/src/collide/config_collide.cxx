@@ -111,6 +111,36 @@ ConfigVariableBool pushers_horizontal
           "set_horizontal() flag by default, false to let the move "
           "in three dimensions by default."));
 
+ConfigVariableInt collision_num_threads
+("collision-num-threads", 0,
+ PRC_DESC("The default number of threads a CollisionTraverser may use to "
+          "test its colliders in parallel.  The colliders are divided into "
+          "groups that are traversed simultaneously by the threads of the "
+          "task-graph-chain, and the results are delivered to the handlers "
+          "in a deterministic order.  Set this to 0 or 1 to traverse on the "
+          "calling thread only.  This may be overridden per traverser with "
+          "CollisionTraverser::set_num_threads()."));
+
+ConfigVariableInt collision_bvh_threshold
+("collision-bvh-threshold", 32,
+ PRC_DESC("CollisionNodes with at least this many solids, and static Geoms "
+          "with at least this many triangles, are searched through a "
+          "bounding volume hierarchy when a collider enters them, rather "
+          "than testing each solid or triangle in turn.  The hierarchy is "
+          "built the first time it is needed and rebuilt when the node or "
+          "Geom is modified.  Set this to 0 to disable it."));
+
+ConfigVariableInt collision_broadphase_threshold
+("collision-broadphase-threshold", 0,
+ PRC_DESC("When a node has at least this many children, and at least this "
+          "many colliders are still interested in it, the CollisionTraverser "
+          "sorts the colliders and the children along an axis to find out "
+          "which colliders might reach each child, rather than testing each "
+          "child against every collider.  This helps when many colliders are "
+          "moving among each other.  Set this to 0 to disable it.  This may "
+          "be overridden per traverser with "
+          "CollisionTraverser::set_broadphase_threshold()."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -14,11 +14,47 @@
 #include "binCullHandler.h"
 #include "pStatTimer.h"
 
+/**
+ *
+ */
+BinCullHandler::
+~BinCullHandler() {
+  delete _pending;
+}
+
 /**
  * This callback function is intended to be overridden by a derived class.
  * This is called as each Geom is discovered by the CullTraverser.
  */
 void BinCullHandler::
 record_object(CullableObject *object, const CullTraverser *traverser) {
-  _cull_result->add_object(object, traverser);
+  if (_pending != nullptr) {
+    _cull_result->add_object(object, traverser, *_pending);
+  } else {
+    _cull_result->add_object(object, traverser);
+  }
+}
+
+/**
+ * Returns a new BinCullHandler for the same CullResult, which another thread
+ * may use to collect objects for the bins.  See
+ * CullHandler::make_thread_handler().
+ */
+CullHandler *BinCullHandler::
+make_thread_handler() {
+  BinCullHandler *handler = new BinCullHandler(_cull_result);
+  handler->_pending = new CullResult::PendingObjects;
+  return handler;
+}
+
+/**
+ * Moves the objects collected by a handler returned by make_thread_handler()
+ * into the bins.
+ */
+void BinCullHandler::
+merge_thread_handler(CullHandler *handler, Thread *current_thread) {
+  BinCullHandler *bin_handler = (BinCullHandler *)handler;
+  nassertv(bin_handler->_pending != nullptr &&
+           bin_handler->_cull_result == _cull_result);
+  _cull_result->merge_objects(*bin_handler->_pending, current_thread);
 }
@@ -27,12 +27,21 @@
 class EXPCL_PANDA_CULL BinCullHandler : public CullHandler {
 public:
   INLINE BinCullHandler(CullResult *cull_result);
+  virtual ~BinCullHandler();
 
   virtual void record_object(CullableObject *object,
                              const CullTraverser *traverser);
 
+  virtual CullHandler *make_thread_handler();
+  virtual void merge_thread_handler(CullHandler *handler,
+                                    Thread *current_thread);
+
 private:
   PT(CullResult) _cull_result;
+
+  // This is only set on a handler returned by make_thread_handler(), which
+  // collects its objects here until they are merged into the bins.
+  CullResult::PendingObjects *_pending;
 };
 
 #include "binCullHandler.I"
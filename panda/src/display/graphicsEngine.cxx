@@ -859,6 +859,8 @@ render_frame() {
     GeomCacheManager::_geom_cache_record_pcollector.clear_level();
     GeomCacheManager::_geom_cache_erase_pcollector.clear_level();
     GeomCacheManager::_geom_cache_evict_pcollector.clear_level();
+    VertexDataPage::_vdata_compress_bytes_pcollector.clear_level();
+    VertexDataPage::_vdata_decompress_bytes_pcollector.clear_level();
 
     GraphicsStateGuardian::init_frame_pstats();
 
@@ -301,9 +301,9 @@ GraphicsStateGuardian::
   // Note that if uniquify-states is false, we can't iterate over all the
   // states, and some GSGs will linger.  Let's hope this isn't a problem.
   LightReMutexHolder holder(*RenderState::_states_lock);
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
+  pvector<const RenderState *> states;
+  RenderState::_states->get_states(states);
+  for (const RenderState *state : states) {
     state->_mungers.remove(_id);
     state->_munged_states.remove(_id);
   }
@@ -400,6 +400,29 @@ jump_to_task_chain(AsyncTaskManager *manager) {
 AsyncTask::DoneStatus AsyncTask::
 unlock_and_do_task() {
   nassertr(_manager != nullptr, DS_done);
+
+  // It's important to release the lock while the task is being serviced.
+  _manager->_lock.unlock();
+
+  double dt = 0.0;
+  DoneStatus status = do_task_timed(dt);
+
+  // Now reacquire the lock (so we can return with the lock held).
+  _manager->_lock.lock();
+
+  record_dt(dt);
+  return status;
+}
+
+/**
+ * Runs the task, storing the time it took in dt.  Unlike unlock_and_do_task(),
+ * this assumes the lock is *not* held, and it does not update the task's
+ * timing statistics; the caller should pass dt to record_dt() once it holds
+ * the lock again.
+ */
+AsyncTask::DoneStatus AsyncTask::
+do_task_timed(double &dt) {
+  nassertr(_manager != nullptr, DS_done);
   PT(ClockObject) clock = _manager->get_clock();
 
   // Indicate that this task is now the current task running on the thread.
@@ -422,23 +445,13 @@ unlock_and_do_task() {
   nassertr(current_thread->_current_task == this, DS_interrupt);
 #endif  // __GNUC__
 
-  // It's important to release the lock while the task is being serviced.
-  _manager->_lock.unlock();
-
   double start = clock->get_real_time();
   _task_pcollector.start();
   DoneStatus status = do_task();
   _task_pcollector.stop();
   double end = clock->get_real_time();
 
-  // Now reacquire the lock (so we can return with the lock held).
-  _manager->_lock.lock();
-
-  _dt = end - start;
-  _max_dt = std::max(_dt, _max_dt);
-  _total_dt += _dt;
-
-  _chain->_time_in_frame += _dt;
+  dt = end - start;
 
   // Now indicate that this is no longer the current task.
   nassertr(current_thread->_current_task == this, status);
@@ -459,6 +472,20 @@ unlock_and_do_task() {
   return status;
 }
 
+/**
+ * Records the time taken by the last run of the task, as returned by
+ * do_task_timed(), in the task's statistics and in its chain's frame budget.
+ * Assumes the lock is held.
+ */
+void AsyncTask::
+record_dt(double dt) {
+  _dt = dt;
+  _max_dt = std::max(_dt, _max_dt);
+  _total_dt += _dt;
+
+  _chain->_time_in_frame += _dt;
+}
+
 /**
  * Cancels this task.  This is equivalent to remove(), except for coroutines,
  * for which it will throw an exception into any currently pending await.
@@ -123,6 +123,8 @@ PUBLISHED:
 protected:
   void jump_to_task_chain(AsyncTaskManager *manager);
   DoneStatus unlock_and_do_task();
+  DoneStatus do_task_timed(double &dt);
+  void record_dt(double dt);
 
   virtual bool cancel();
   virtual bool is_task() const final {return true;}
@@ -15,6 +15,7 @@
 #include "asyncTaskManager.h"
 #include "event.h"
 #include "mutexHolder.h"
+#include "lightMutexHolder.h"
 #include "indent.h"
 #include "pStatClient.h"
 #include "pStatTimer.h"
@@ -32,6 +33,8 @@ TypeHandle AsyncTaskChain::_type_handle;
 
 PStatCollector AsyncTaskChain::_task_pcollector("Task");
 PStatCollector AsyncTaskChain::_wait_pcollector("Wait");
+PStatCollector AsyncTaskChain::_idle_pcollector("Wait:Idle");
+PStatCollector AsyncTaskChain::_steal_pcollector("Task steals");
 
 /**
  *
@@ -47,6 +50,7 @@ AsyncTaskChain(AsyncTaskManager *manager, const string &name) :
   _thread_priority(TP_normal),
   _frame_budget(-1.0),
   _frame_sync(false),
+  _work_stealing(false),
   _num_busy_threads(0),
   _num_tasks(0),
   _num_awaiting_tasks(0),
@@ -57,7 +61,9 @@ AsyncTaskChain(AsyncTaskManager *manager, const string &name) :
   _current_frame(0),
   _time_in_frame(0.0),
   _block_till_next_frame(false),
-  _next_implicit_sort(0)
+  _next_implicit_sort(0),
+  _num_queued(0),
+  _num_steals(0)
 {
 }
 
@@ -261,6 +267,41 @@ get_timeslice_priority() const {
   return _timeslice_priority;
 }
 
+/**
+ * Sets the work_stealing flag.  This changes the way the tasks are handed out
+ * to the threads of a chain with more than one thread.
+ *
+ * When this flag is false (the default), each thread takes its next task from
+ * the chain's shared queue, which requires all of the threads to contend for
+ * the same lock between every two tasks.
+ *
+ * When this flag is true, the first thread to reach a new group of tasks with
+ * the same sort value deals the whole group out to a queue for each thread,
+ * round-robin in order of priority.  Each thread then runs the tasks on its
+ * own queue from the front, and when it runs out, steals tasks from the back
+ * of the other threads' queues, only taking the chain's lock occasionally to
+ * report the tasks it has finished.  Tasks with different sort values are
+ * still never run in parallel, and within a sort value, the tasks are still
+ * started roughly in decreasing order by priority value.  However, the frame
+ * budget is only checked before each group of tasks is dealt out.
+ *
+ * This is worthwhile for chains that run many short tasks on several threads.
+ */
+void AsyncTaskChain::
+set_work_stealing(bool work_stealing) {
+  MutexHolder holder(_manager->_lock);
+  _work_stealing = work_stealing;
+}
+
+/**
+ * Returns the work_stealing flag.  See set_work_stealing().
+ */
+bool AsyncTaskChain::
+get_work_stealing() const {
+  MutexHolder holder(_manager->_lock);
+  return _work_stealing;
+}
+
 /**
  * Stops any threads that are currently running.  If any tasks are still
  * pending and have not yet been picked up by a thread, they will not be
@@ -477,6 +518,15 @@ do_remove(AsyncTask *task, bool upon_death) {
 
   switch (task->_state) {
   case AsyncTask::S_servicing:
+    {
+      PT(AsyncTask) hold_task = task;
+      if (remove_queued_task(task)) {
+        // It was dealt out to a thread in work-stealing mode, but no thread
+        // has started it yet.
+        cleanup_task(task, upon_death, false);
+        return true;
+      }
+    }
     // This task is being serviced.  upon_death will be called afterwards.
     task->_state = AsyncTask::S_servicing_removed;
     return true;
@@ -630,7 +680,8 @@ do_has_task(AsyncTask *task) const {
   return (find_task_on_heap(_active, task) != -1 ||
           find_task_on_heap(_next_active, task) != -1 ||
           find_task_on_heap(_sleeping, task) != -1 ||
-          find_task_on_heap(_this_active, task) != -1);
+          find_task_on_heap(_this_active, task) != -1 ||
+          has_queued_task(task));
 }
 
 /**
@@ -685,86 +736,98 @@ service_one_task(AsyncTaskChain::AsyncTaskChainThread *thread) {
     }
     task->_servicing_thread = nullptr;
 
-    if (task->_chain == this) {
-      if (task->_state == AsyncTask::S_servicing_removed) {
-        // This task wants to kill itself.
-        cleanup_task(task, true, false);
+    finish_task(task, ds);
+  }
+  thread_consider_yield();
+}
 
-      } else if (task->_chain_name != get_name()) {
-        // The task wants to jump to a different chain.
-        PT(AsyncTask) hold_task = task;
-        cleanup_task(task, false, false);
-        task->jump_to_task_chain(_manager);
+/**
+ * Called internally when a task has been serviced, to put it back on the
+ * appropriate queue according to the indicated DoneStatus, or to clean it up
+ * if it is finished.  Assumes the lock is held.
+ *
+ * Note that the lock may be temporarily released by this method.
+ */
+void AsyncTaskChain::
+finish_task(AsyncTask *task, AsyncTask::DoneStatus ds) {
+  if (task->_chain == this) {
+    if (task->_state == AsyncTask::S_servicing_removed) {
+      // This task wants to kill itself.
+      cleanup_task(task, true, false);
+
+    } else if (task->_chain_name != get_name()) {
+      // The task wants to jump to a different chain.
+      PT(AsyncTask) hold_task = task;
+      cleanup_task(task, false, false);
+      task->jump_to_task_chain(_manager);
 
-      } else {
-        switch (ds) {
-        case AsyncTask::DS_cont:
-          // The task is still alive; put it on the next frame's active queue.
-          task->_state = AsyncTask::S_active;
-          _next_active.push_back(task);
-          _cvar.notify_all();
-          break;
-
-        case AsyncTask::DS_again:
-          // The task wants to sleep again.
-          {
-            double now = _manager->_clock->get_frame_time();
-            task->_wake_time = now + task->get_delay();
-            task->_start_time = task->_wake_time;
-            task->_state = AsyncTask::S_sleeping;
-            _sleeping.push_back(task);
-            push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
-            if (task_cat.is_spam()) {
-              task_cat.spam()
-                << "Sleeping " << *task << ", wake time at "
-                << task->_wake_time - now << "\n";
-            }
-            _cvar.notify_all();
+    } else {
+      switch (ds) {
+      case AsyncTask::DS_cont:
+        // The task is still alive; put it on the next frame's active queue.
+        task->_state = AsyncTask::S_active;
+        _next_active.push_back(task);
+        _cvar.notify_all();
+        break;
+
+      case AsyncTask::DS_again:
+        // The task wants to sleep again.
+        {
+          double now = _manager->_clock->get_frame_time();
+          task->_wake_time = now + task->get_delay();
+          task->_start_time = task->_wake_time;
+          task->_state = AsyncTask::S_sleeping;
+          _sleeping.push_back(task);
+          push_heap(_sleeping.begin(), _sleeping.end(), AsyncTaskSortWakeTime());
+          if (task_cat.is_spam()) {
+            task_cat.spam()
+              << "Sleeping " << *task << ", wake time at "
+              << task->_wake_time - now << "\n";
           }
-          break;
-
-        case AsyncTask::DS_pickup:
-          // The task wants to run again this frame if possible.
-          task->_state = AsyncTask::S_active;
-          _this_active.push_back(task);
           _cvar.notify_all();
-          break;
-
-        case AsyncTask::DS_interrupt:
-          // The task had an exception and wants to raise a big flag.
-          task->_state = AsyncTask::S_active;
-          _next_active.push_back(task);
-          if (_state == S_started) {
-            _state = S_interrupted;
-            _cvar.notify_all();
-          }
-          break;
-
-        case AsyncTask::DS_await:
-          // The task wants to wait for another one to finish.
-          task->_state = AsyncTask::S_awaiting;
+        }
+        break;
+
+      case AsyncTask::DS_pickup:
+        // The task wants to run again this frame if possible.
+        task->_state = AsyncTask::S_active;
+        _this_active.push_back(task);
+        _cvar.notify_all();
+        break;
+
+      case AsyncTask::DS_interrupt:
+        // The task had an exception and wants to raise a big flag.
+        task->_state = AsyncTask::S_active;
+        _next_active.push_back(task);
+        if (_state == S_started) {
+          _state = S_interrupted;
           _cvar.notify_all();
-          ++_num_awaiting_tasks;
-          break;
-
-        default:
-          // The task has finished.
-          cleanup_task(task, true, true);
         }
+        break;
+
+      case AsyncTask::DS_await:
+        // The task wants to wait for another one to finish.
+        task->_state = AsyncTask::S_awaiting;
+        _cvar.notify_all();
+        ++_num_awaiting_tasks;
+        break;
+
+      default:
+        // The task has finished.
+        cleanup_task(task, true, true);
       }
-    } else {
-      task_cat.error()
-        << "Task is no longer on chain " << get_name()
-        << ": " << *task << "\n";
     }
+  } else {
+    task_cat.error()
+      << "Task is no longer on chain " << get_name()
+      << ": " << *task << "\n";
+  }
 
-    if (task_cat.is_spam()) {
-      task_cat.spam()
-        << "Done servicing " << *task << " in "
-        << *Thread::get_current_thread() << "\n";
-    }
+  if (task_cat.is_spam()) {
+    task_cat.spam()
+      << "Done servicing " << *task << " in "
+      << *Thread::get_current_thread() << "\n";
   }
-  thread_consider_yield();
 }
 
 /**
@@ -860,6 +923,13 @@ finish_sort_group() {
 
     _pickup_mode = false;
 
+    // Report the number of tasks the threads stole from each other during the
+    // last epoch.
+    if (_work_stealing) {
+      _steal_pcollector.set_level(_num_steals);
+    }
+    _num_steals = 0;
+
     // Here, there's no difference between _this_active and _next_active.
     // Combine them.
     _next_active.insert(_next_active.end(), _this_active.begin(), _this_active.end());
@@ -1106,23 +1176,277 @@ do_start_threads() {
 }
 
 /**
- * Returns the set of tasks that are active (and not sleeping) on the task
- * chain, at the time of the call.  Assumes the lock is held.
+ * Called by a thread in work-stealing mode when it finds tasks of the current
+ * sort value on the active queue.  Removes all of them from the queue, and
+ * deals them out round-robin, in order of priority, to the queues of the
+ * threads.  Assumes the lock is held.
  */
-AsyncTaskCollection AsyncTaskChain::
-do_get_active_tasks() const {
-  AsyncTaskCollection result;
+void AsyncTaskChain::
+deal_sort_group() {
+  nassertv(!_threads.empty());
+
+  TaskHeap group;
+  while (!_active.empty() && _active.front()->get_sort() == _current_sort) {
+    group.push_back(_active.front());
+    pop_heap(_active.begin(), _active.end(), AsyncTaskSortPriority());
+    _active.pop_back();
+  }
+
+  // The tasks count as being serviced from now on, since the threads take
+  // them off their queues without holding the lock.  If one is removed
+  // before a thread gets to it, do_remove() takes it off the queue again.
+  for (AsyncTask *task : group) {
+    nassertd(task->_state == AsyncTask::S_active) continue;
+    task->_state = AsyncTask::S_servicing;
+  }
+
+  size_t num_threads = _threads.size();
+  for (size_t ti = 0; ti < num_threads && ti < group.size(); ++ti) {
+    AsyncTaskChainThread *thread = _threads[ti];
+    LightMutexHolder holder(thread->_queue_lock);
+    for (size_t i = ti; i < group.size(); i += num_threads) {
+      thread->_queue.push_back(group[i]);
+    }
+  }
+  AtomicAdjust::add(_num_queued, (AtomicAdjust::Integer)group.size());
+
+  if (task_cat.is_spam()) {
+    do_output(task_cat.spam());
+    task_cat.spam(false)
+      << ": dealt " << group.size() << " tasks with sort " << _current_sort
+      << " to " << num_threads << " threads\n";
+  }
+
+  // Wake up the other threads to help with the new tasks.
+  _cvar.notify_all();
+}
+
+/**
+ * Called by a thread in work-stealing mode to run the tasks on its own queue,
+ * and then any it can steal from the other threads' queues, until there are
+ * none left.  Assumes the lock is held.
+ *
+ * The lock is released while the tasks are run.  It is only acquired again
+ * every so often to put the finished tasks back on the appropriate queues.
+ */
+void AsyncTaskChain::
+service_queued_tasks(AsyncTaskChain::AsyncTaskChainThread *thread) {
+  // The set of threads may change while the lock is released, so we make a
+  // copy of it to steal from.  The threads aren't destructed while they are
+  // running, so we don't need to hold a reference to them.
+  pvector<AsyncTaskChainThread *> peers;
+  peers.reserve(_threads.size());
+  Threads::const_iterator thi;
+  for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
+    peers.push_back(*thi);
+  }
+
+  struct FinishedTask {
+    PT(AsyncTask) _task;
+    AsyncTask::DoneStatus _status;
+    double _dt;
+  };
+  pvector<FinishedTask> finished;
+  static const size_t max_finished = 32;
+  finished.reserve(max_finished);
+
+  int num_steals = 0;
+  bool interrupted = false;
+
+  _manager->_lock.unlock();
+  while (!interrupted) {
+    PT(AsyncTask) task = pop_queued_task(thread, peers, num_steals);
+    if (task == nullptr) {
+      break;
+    }
+
+    FinishedTask ft;
+    ft._task = task;
+    ft._status = task->do_task_timed(ft._dt);
+    interrupted = (ft._status == AsyncTask::DS_interrupt);
+
+    {
+      LightMutexHolder holder(thread->_queue_lock);
+      thread->_servicing = nullptr;
+    }
+    task->_servicing_thread = nullptr;
+
+    finished.push_back(std::move(ft));
+    if (finished.size() >= max_finished || interrupted) {
+      // Report the tasks we have finished so far, so that they don't wait
+      // too long for the end of the sort group.
+      _manager->_lock.lock();
+      for (FinishedTask &done : finished) {
+        done._task->record_dt(done._dt);
+        finish_task(done._task, done._status);
+      }
+      _manager->_lock.unlock();
+      finished.clear();
+    }
+  }
+  _manager->_lock.lock();
+
+  for (FinishedTask &done : finished) {
+    done._task->record_dt(done._dt);
+    finish_task(done._task, done._status);
+  }
+  _num_steals += num_steals;
+}
+
+/**
+ * Returns the next task for the indicated thread to run in work-stealing
+ * mode, taken from the front of its own queue, or failing that, from the back
+ * of another thread's queue.  Returns NULL if all of the queues are empty.
+ * The lock should *not* be held.
+ */
+PT(AsyncTask) AsyncTaskChain::
+pop_queued_task(AsyncTaskChain::AsyncTaskChainThread *thread,
+                const pvector<AsyncTaskChainThread *> &peers,
+                int &num_steals) {
+  if (AtomicAdjust::get(_num_queued) == 0) {
+    return nullptr;
+  }
+
+  PT(AsyncTask) task;
+  {
+    LightMutexHolder holder(thread->_queue_lock);
+    if (!thread->_queue.empty()) {
+      task = thread->_queue.front();
+      thread->_queue.pop_front();
+      task->_servicing_thread = thread;
+      thread->_servicing = task;
+      AtomicAdjust::dec(_num_queued);
+      return task;
+    }
+  }
+
+  // Our own queue is empty.  Look through the other threads' queues, starting
+  // with the one after ours, so that the threads don't all gang up on the
+  // same victim.
+  size_t num_peers = peers.size();
+  size_t start = std::find(peers.begin(), peers.end(), thread) - peers.begin();
+  for (size_t i = 1; i <= num_peers && task == nullptr; ++i) {
+    AsyncTaskChainThread *victim = peers[(start + i) % num_peers];
+    if (victim == thread) {
+      continue;
+    }
+    LightMutexHolder holder(victim->_queue_lock);
+    if (!victim->_queue.empty()) {
+      task = victim->_queue.back();
+      victim->_queue.pop_back();
+      task->_servicing_thread = thread;
+      AtomicAdjust::dec(_num_queued);
+    }
+  }
+
+  if (task != nullptr) {
+    ++num_steals;
+    LightMutexHolder holder(thread->_queue_lock);
+    thread->_servicing = task;
+  }
+  return task;
+}
+
+/**
+ * Removes the indicated task from whichever thread's queue it is waiting on.
+ * Returns true if it was found, false otherwise.  Assumes the lock is held.
+ */
+bool AsyncTaskChain::
+remove_queued_task(AsyncTask *task) {
+  if (AtomicAdjust::get(_num_queued) == 0) {
+    return false;
+  }
 
+  Threads::const_iterator thi;
+  for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
+    AsyncTaskChainThread *thread = (*thi);
+    LightMutexHolder holder(thread->_queue_lock);
+    pdeque<PT(AsyncTask)>::iterator qi =
+      std::find(thread->_queue.begin(), thread->_queue.end(), task);
+    if (qi != thread->_queue.end()) {
+      thread->_queue.erase(qi);
+      AtomicAdjust::dec(_num_queued);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Returns true if the indicated task is waiting on one of the threads'
+ * queues, false otherwise.  Assumes the lock is held.
+ */
+bool AsyncTaskChain::
+has_queued_task(AsyncTask *task) const {
+  if (AtomicAdjust::get(_num_queued) == 0) {
+    return false;
+  }
+
+  Threads::const_iterator thi;
+  for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
+    AsyncTaskChainThread *thread = (*thi);
+    LightMutexHolder holder(thread->_queue_lock);
+    if (std::find(thread->_queue.begin(), thread->_queue.end(), task) != thread->_queue.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Puts any tasks that are still waiting on the indicated thread's queue back
+ * on the active queue.  This is called when the thread exits.  Assumes the
+ * lock is held.
+ */
+void AsyncTaskChain::
+return_queued_tasks(AsyncTaskChain::AsyncTaskChainThread *thread) {
+  LightMutexHolder holder(thread->_queue_lock);
+  while (!thread->_queue.empty()) {
+    AsyncTask *task = thread->_queue.front();
+    task->_state = AsyncTask::S_active;
+    _active.push_back(task);
+    push_heap(_active.begin(), _active.end(), AsyncTaskSortPriority());
+    thread->_queue.pop_front();
+    AtomicAdjust::dec(_num_queued);
+  }
+}
+
+/**
+ * Adds to the indicated list the tasks that the threads are currently
+ * servicing, as well as the tasks that are waiting on their queues.  Assumes
+ * the lock is held.
+ */
+void AsyncTaskChain::
+collect_thread_tasks(TaskHeap &tasks) const {
 #ifdef HAVE_THREADS
   Threads::const_iterator thi;
   for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
-    AsyncTask *task = (*thi)->_servicing;
-    if (task != nullptr) {
-      result.add_task(task);
+    AsyncTaskChainThread *thread = (*thi);
+    LightMutexHolder holder(thread->_queue_lock);
+    if (thread->_servicing != nullptr) {
+      tasks.push_back(thread->_servicing);
     }
+    tasks.insert(tasks.end(), thread->_queue.begin(), thread->_queue.end());
   }
 #endif
+}
+
+/**
+ * Returns the set of tasks that are active (and not sleeping) on the task
+ * chain, at the time of the call.  Assumes the lock is held.
+ */
+AsyncTaskCollection AsyncTaskChain::
+do_get_active_tasks() const {
+  AsyncTaskCollection result;
+
+  TaskHeap thread_tasks;
+  collect_thread_tasks(thread_tasks);
+
   TaskHeap::const_iterator ti;
+  for (ti = thread_tasks.begin(); ti != thread_tasks.end(); ++ti) {
+    AsyncTask *task = (*ti);
+    result.add_task(task);
+  }
   for (ti = _active.begin(); ti != _active.end(); ++ti) {
     AsyncTask *task = (*ti);
     result.add_task(task);
@@ -1286,6 +1610,10 @@ do_write(ostream &out, int indent_level) const {
     indent(out, indent_level + 2)
       << "tick clock\n";
   }
+  if (_work_stealing) {
+    indent(out, indent_level + 2)
+      << "work stealing\n";
+  }
 
   static const size_t buffer_size = 1024;
   char buffer[buffer_size];
@@ -1309,16 +1637,7 @@ do_write(ostream &out, int indent_level) const {
   TaskHeap tasks = _active;
   tasks.insert(tasks.end(), _this_active.begin(), _this_active.end());
   tasks.insert(tasks.end(), _next_active.begin(), _next_active.end());
-
-#ifdef HAVE_THREADS
-  Threads::const_iterator thi;
-  for (thi = _threads.begin(); thi != _threads.end(); ++thi) {
-    AsyncTask *task = (*thi)->_servicing;
-    if (task != nullptr) {
-      tasks.push_back(task);
-    }
-  }
-#endif
+  collect_thread_tasks(tasks);
 
   double now = _manager->_clock->get_frame_time();
 
@@ -1450,7 +1769,22 @@ thread_main() {
 
       PStatTimer timer(_task_pcollector);
       _chain->_num_busy_threads++;
-      _chain->service_one_task(this);
+      if (_chain->_work_stealing && _chain->_threads.size() > 1) {
+        // Deal out the whole sort group at once, then run our share of it.
+        _chain->deal_sort_group();
+        _chain->service_queued_tasks(this);
+      } else {
+        _chain->service_one_task(this);
+      }
+      _chain->_num_busy_threads--;
+      _chain->_cvar.notify_all();
+
+    } else if (AtomicAdjust::get(_chain->_num_queued) != 0) {
+      // Another thread has dealt out tasks of the current sort value.  Help
+      // out with running them.
+      PStatTimer timer(_task_pcollector);
+      _chain->_num_busy_threads++;
+      _chain->service_queued_tasks(this);
       _chain->_num_busy_threads--;
       _chain->_cvar.notify_all();
 
@@ -1477,10 +1811,14 @@ thread_main() {
       } else {
         // Wait for the other threads to finish their current task before we
         // continue.
-        PStatTimer timer(_wait_pcollector);
+        PStatTimer timer(_chain->_work_stealing ? _idle_pcollector : _wait_pcollector);
         _chain->_cvar.wait();
       }
     }
   }
+
+  // If we were stopped partway through a sort group, give back any tasks we
+  // didn't get to.
+  _chain->return_queued_tasks(this);
 #endif  // HAVE_THREADS
 }
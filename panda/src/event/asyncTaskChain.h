@@ -23,6 +23,8 @@
 #include "conditionVar.h"
 #include "pvector.h"
 #include "pdeque.h"
+#include "lightMutex.h"
+#include "atomicAdjust.h"
 #include "pStatCollector.h"
 #include "clockObject.h"
 
@@ -46,6 +48,11 @@ class AsyncTaskManager;
  * parallelism.  Tasks with different sort values are never run in parallel
  * together, but tasks with different priority values might be (if there is
  * more than one thread).
+ *
+ * If work stealing is enabled with set_work_stealing(), a chain with more
+ * than one thread deals each group of tasks with the same sort value out to
+ * per-thread queues, rather than having every thread take its tasks one at a
+ * time from the shared queue.  See set_work_stealing().
  */
 class EXPCL_PANDA_EVENT AsyncTaskChain : public TypedReferenceCount, public Namable {
 public:
@@ -72,6 +79,9 @@ PUBLISHED:
   void set_timeslice_priority(bool timeslice_priority);
   bool get_timeslice_priority() const;
 
+  void set_work_stealing(bool work_stealing);
+  bool get_work_stealing() const;
+
   BLOCKING void stop_threads();
   void start_threads();
   INLINE bool is_started() const;
@@ -104,11 +114,21 @@ protected:
   int find_task_on_heap(const TaskHeap &heap, AsyncTask *task) const;
 
   void service_one_task(AsyncTaskChainThread *thread);
+  void finish_task(AsyncTask *task, AsyncTask::DoneStatus ds);
   void cleanup_task(AsyncTask *task, bool upon_death, bool clean_exit);
   bool finish_sort_group();
   void filter_timeslice_priority();
   void do_stop_threads();
   void do_start_threads();
+  void deal_sort_group();
+  void service_queued_tasks(AsyncTaskChainThread *thread);
+  PT(AsyncTask) pop_queued_task(AsyncTaskChainThread *thread,
+                                const pvector<AsyncTaskChainThread *> &peers,
+                                int &num_steals);
+  bool remove_queued_task(AsyncTask *task);
+  bool has_queued_task(AsyncTask *task) const;
+  void return_queued_tasks(AsyncTaskChainThread *thread);
+  void collect_thread_tasks(TaskHeap &tasks) const;
   AsyncTaskCollection do_get_active_tasks() const;
   AsyncTaskCollection do_get_sleeping_tasks() const;
   void do_poll();
@@ -128,6 +148,12 @@ protected:
 
     AsyncTaskChain *_chain;
     AsyncTask *_servicing;
+
+    // The tasks dealt to this thread in work-stealing mode.  The thread takes
+    // tasks from the front; other threads steal them from the back.  When
+    // work stealing is enabled, _servicing is also protected by this lock.
+    LightMutex _queue_lock;
+    pdeque<PT(AsyncTask)> _queue;
   };
 
   class AsyncTaskSortWakeTime {
@@ -175,6 +201,7 @@ protected:
   Threads _threads;
   double _frame_budget;
   bool _frame_sync;
+  bool _work_stealing;
   int _num_busy_threads;
   int _num_tasks;
   int _num_awaiting_tasks;
@@ -193,8 +220,15 @@ protected:
 
   unsigned int _next_implicit_sort;
 
+  // The total number of tasks waiting on the threads' queues.  This may be
+  // read without holding any lock.
+  AtomicAdjust::Integer _num_queued;
+  int _num_steals;
+
   static PStatCollector _task_pcollector;
   static PStatCollector _wait_pcollector;
+  static PStatCollector _idle_pcollector;
+  static PStatCollector _steal_pcollector;
 
 public:
   static TypeHandle get_class_type() {
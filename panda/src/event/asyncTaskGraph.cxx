@@ -0,0 +1,402 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncTaskGraph.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "asyncTaskGraph.h"
+#include "asyncTaskManager.h"
+#include "mutexHolder.h"
+#include "config_event.h"
+
+TypeHandle AsyncTaskGraph::_type_handle;
+
+/**
+ * Creates an empty graph, whose jobs will be run by the threads of the
+ * indicated task chain.  If the chain name is empty, the chain named by the
+ * task-graph-chain config variable is used; it is created with
+ * task-graph-num-threads threads if it doesn't already exist.
+ */
+AsyncTaskGraph::
+AsyncTaskGraph(const std::string &chain_name, AsyncTaskManager *manager) :
+  _chain_name(chain_name),
+  _pipeline_stage(0),
+  _started(false),
+  _finished(false),
+  _cancelled(0),
+  _num_unfinished(0),
+  _cvar(_lock),
+  _num_workers(0),
+  _max_workers(0),
+  _worker_limit(-1)
+{
+  if (_chain_name.empty()) {
+    _chain_name = task_graph_chain;
+  }
+  _manager = (manager != nullptr) ? manager : AsyncTaskManager::get_global_ptr();
+}
+
+/**
+ *
+ */
+AsyncTaskGraph::
+~AsyncTaskGraph() {
+  // The tasks running the jobs hold a reference to the graph, so it can't be
+  // destructed before they have all finished.
+  nassertv(_num_workers == 0);
+}
+
+/**
+ * Adds a job that calls the indicated function once.  Returns the index of
+ * the job, which may be passed to add_dependency().
+ */
+int AsyncTaskGraph::
+add_job(JobFunc func) {
+  nassertr(!_started, -1);
+
+  Job job;
+  job._func = std::move(func);
+  job._begin = 0;
+  job._end = 0;
+  job._grain_size = 1;
+  job._next = 0;
+  job._num_unfinished = 1;
+  job._num_pending = 0;
+  _jobs.push_back(std::move(job));
+  return (int)_jobs.size() - 1;
+}
+
+/**
+ * Adds a job that calls the indicated function for consecutive, non-
+ * overlapping parts of the range [begin, end), which together cover the whole
+ * range.  Different parts may be processed by different threads at the same
+ * time.  Returns the index of the job, which may be passed to
+ * add_dependency().
+ *
+ * Each part is at most grain_size long.  If grain_size is 0, a size is chosen
+ * that divides the range into a few parts for each thread.
+ */
+int AsyncTaskGraph::
+add_range(int begin, int end, RangeFunc func, int grain_size) {
+  nassertr(!_started, -1);
+  nassertr(grain_size >= 0, -1);
+
+  Job job;
+  job._range_func = std::move(func);
+  job._begin = begin;
+  job._end = std::max(begin, end);
+  job._grain_size = grain_size;
+  job._next = begin;
+  job._num_unfinished = 0;
+  job._num_pending = 0;
+  _jobs.push_back(std::move(job));
+  return (int)_jobs.size() - 1;
+}
+
+/**
+ * Specifies that the indicated job may not start until the prerequisite job
+ * has finished.  Both must be indices returned by add_job() or add_range().
+ */
+void AsyncTaskGraph::
+add_dependency(int job, int prerequisite) {
+  nassertv(!_started);
+  nassertv(job >= 0 && job < (int)_jobs.size());
+  nassertv(prerequisite >= 0 && prerequisite < (int)_jobs.size());
+  nassertv(job != prerequisite);
+
+  _jobs[prerequisite]._dependents.push_back(job);
+  ++_jobs[job]._num_pending;
+}
+
+/**
+ * Starts running the jobs on the threads of the task chain, and returns
+ * immediately.  The graph is done when all of the jobs have finished.
+ *
+ * The jobs are run in the same pipeline stage as the thread that calls this.
+ */
+void AsyncTaskGraph::
+start() {
+  nassertv(!_started);
+  _started = true;
+
+  if (done()) {
+    // It was cancelled before it was started.
+    return;
+  }
+
+  if (!check_acyclic()) {
+    nassert_raise("AsyncTaskGraph has a cyclic dependency");
+    if (set_future_state(FS_cancelled)) {
+      notify_done(false);
+    }
+    return;
+  }
+
+  if (_jobs.empty()) {
+    set_result(nullptr);
+    return;
+  }
+
+  _pipeline_stage = Thread::get_current_thread()->get_pipeline_stage();
+
+  AsyncTaskChain *chain = _manager->find_task_chain(_chain_name);
+  if (chain == nullptr) {
+    chain = _manager->make_task_chain(_chain_name);
+    if (_chain_name == task_graph_chain.get_value()) {
+      chain->set_num_threads(std::max((int)task_graph_num_threads, 0));
+    }
+  }
+  _max_workers = chain->get_num_threads();
+  if (_worker_limit >= 0) {
+    _max_workers = std::min(_max_workers, _worker_limit);
+  }
+
+  // Now that we know how many threads there are, we can divide up the ranges.
+  for (Job &job : _jobs) {
+    if (job._range_func) {
+      int count = job._end - job._begin;
+      if (job._grain_size == 0) {
+        job._grain_size = std::max(count / ((_max_workers + 1) * 4), 1);
+      }
+      job._num_unfinished = std::max((count + job._grain_size - 1) / job._grain_size, 1);
+    }
+  }
+
+  _num_unfinished = (AtomicAdjust::Integer)_jobs.size();
+  {
+    MutexHolder holder(_lock);
+    for (size_t i = 0; i < _jobs.size(); ++i) {
+      if (_jobs[i]._num_pending == 0) {
+        _ready.push_back((int)i);
+      }
+    }
+  }
+  start_workers();
+}
+
+/**
+ * Starts the graph if it hasn't been started yet, and then runs jobs on the
+ * calling thread until all of the jobs have finished.
+ */
+void AsyncTaskGraph::
+run() {
+  if (!_started) {
+    start();
+  }
+
+  while (!done()) {
+    if (run_next_job(false)) {
+      continue;
+    }
+
+    // The remaining jobs are running on other threads.  Sleep until one of
+    // them makes another job ready, or the last one finishes.
+    MutexHolder holder(_lock);
+    while (_ready.empty() && !_finished) {
+      _cvar.wait();
+    }
+  }
+}
+
+/**
+ * Cancels the graph.  If it has been started, the jobs that are already
+ * running are allowed to finish, but no new jobs are started, and the graph
+ * becomes cancelled once the running jobs have finished.  Returns false if
+ * the graph was already done.
+ */
+bool AsyncTaskGraph::
+cancel() {
+  if (!_started) {
+    return AsyncFuture::cancel();
+  }
+  if (done()) {
+    return false;
+  }
+  return AtomicAdjust::compare_and_exchange(_cancelled, 0, 1) == 0;
+}
+
+/**
+ * Runs the next part of the job at the front of the ready queue, if any.
+ * Returns true if a job was run, or false if the queue was empty.  If retire
+ * is true, the caller is one of the graph's tasks, which finishes when the
+ * queue is empty.
+ */
+bool AsyncTaskGraph::
+run_next_job(bool retire) {
+  int index;
+  int begin = 0;
+  int end = 0;
+  {
+    MutexHolder holder(_lock);
+    if (_ready.empty()) {
+      if (retire) {
+        --_num_workers;
+      }
+      return false;
+    }
+    index = _ready.front();
+    Job &job = _jobs[index];
+    if (job._range_func) {
+      // Claim the next part of the range, and leave the job at the front of
+      // the queue for the next thread if there is more of it left.
+      begin = job._next;
+      end = (job._end - begin > job._grain_size) ? begin + job._grain_size : job._end;
+      job._next = end;
+      if (end >= job._end) {
+        _ready.pop_front();
+      }
+    } else {
+      _ready.pop_front();
+    }
+  }
+
+  Job &job = _jobs[index];
+  if (!AtomicAdjust::get(_cancelled)) {
+    if (job._range_func) {
+      if (begin < end) {
+        job._range_func(begin, end);
+      }
+    } else if (job._func) {
+      job._func();
+    }
+  }
+
+  if (!AtomicAdjust::dec(job._num_unfinished)) {
+    finish_job(index);
+  }
+  return true;
+}
+
+/**
+ * Called when all parts of the indicated job have finished.  Makes the jobs
+ * that were waiting for it ready, and resolves the future if it was the last
+ * one.
+ */
+void AsyncTaskGraph::
+finish_job(int index) {
+  bool any_ready = false;
+  {
+    MutexHolder holder(_lock);
+    for (int dependent : _jobs[index]._dependents) {
+      if (!AtomicAdjust::dec(_jobs[dependent]._num_pending)) {
+        _ready.push_back(dependent);
+        any_ready = true;
+      }
+    }
+    if (any_ready) {
+      _cvar.notify_all();
+    }
+  }
+  if (any_ready) {
+    start_workers();
+  }
+
+  if (!AtomicAdjust::dec(_num_unfinished)) {
+    // That was the last job.
+    if (AtomicAdjust::get(_cancelled)) {
+      if (set_future_state(FS_cancelled)) {
+        notify_done(false);
+      }
+    } else {
+      set_result(nullptr);
+    }
+
+    MutexHolder holder(_lock);
+    _finished = true;
+    _cvar.notify_all();
+  }
+}
+
+/**
+ * Adds more tasks to run the graph's jobs, if there are more ready jobs than
+ * tasks to run them, up to the number of threads on the chain.
+ */
+void AsyncTaskGraph::
+start_workers() {
+  int num_new;
+  {
+    MutexHolder holder(_lock);
+    int available = 0;
+    for (int index : _ready) {
+      const Job &job = _jobs[index];
+      if (job._range_func) {
+        available += std::max((job._end - job._next + job._grain_size - 1) / job._grain_size, 1);
+      } else {
+        ++available;
+      }
+      if (available >= _max_workers) {
+        break;
+      }
+    }
+    num_new = std::min(available, _max_workers) - _num_workers;
+    if (num_new <= 0) {
+      return;
+    }
+    _num_workers += num_new;
+  }
+
+  for (int i = 0; i < num_new; ++i) {
+    // Each task holds a reference to the graph until it finishes.
+    ref();
+    PT(GenericAsyncTask) task = new GenericAsyncTask("graph", &worker_func, this);
+    task->set_task_chain(_chain_name);
+    _manager->add(task);
+  }
+}
+
+/**
+ * Returns true if the dependencies between the jobs don't form a cycle, which
+ * would prevent some of them from ever starting.
+ */
+bool AsyncTaskGraph::
+check_acyclic() const {
+  pvector<int> num_pending;
+  pvector<int> ready;
+  num_pending.reserve(_jobs.size());
+  for (size_t i = 0; i < _jobs.size(); ++i) {
+    num_pending.push_back((int)_jobs[i]._num_pending);
+    if (num_pending.back() == 0) {
+      ready.push_back((int)i);
+    }
+  }
+
+  size_t num_visited = 0;
+  while (!ready.empty()) {
+    int index = ready.back();
+    ready.pop_back();
+    ++num_visited;
+    for (int dependent : _jobs[index]._dependents) {
+      if (--num_pending[dependent] == 0) {
+        ready.push_back(dependent);
+      }
+    }
+  }
+  return num_visited == _jobs.size();
+}
+
+/**
+ * The function run by each of the graph's tasks.  Runs jobs until there are
+ * none ready.
+ */
+AsyncTask::DoneStatus AsyncTaskGraph::
+worker_func(GenericAsyncTask *, void *user_data) {
+  AsyncTaskGraph *graph = (AsyncTaskGraph *)user_data;
+
+  Thread *current_thread = Thread::get_current_thread();
+  int pipeline_stage = current_thread->get_pipeline_stage();
+  current_thread->set_pipeline_stage(graph->_pipeline_stage);
+
+  while (graph->run_next_job(true)) {
+  }
+
+  current_thread->set_pipeline_stage(pipeline_stage);
+  unref_delete(graph);
+  return AsyncTask::DS_done;
+}
@@ -0,0 +1,143 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncTaskGraph.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef ASYNCTASKGRAPH_H
+#define ASYNCTASKGRAPH_H
+
+#include "pandabase.h"
+
+#include "asyncFuture.h"
+#include "genericAsyncTask.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pdeque.h"
+#include "pvector.h"
+
+#include <functional>
+
+class AsyncTaskManager;
+
+/**
+ * A set of jobs to be run on the threads of an AsyncTaskChain, some of which
+ * may have to wait for others to finish first.  A job is either a single
+ * function call, or a range of integers which is split into smaller ranges
+ * that are processed in parallel, as with a parallel for loop.
+ *
+ * Unlike adding a separate AsyncTask for each job, the graph only adds as
+ * many tasks as there are threads on the chain to run its jobs, and each of
+ * these runs as many jobs as it can get before finishing.
+ *
+ * The graph is itself a future, which is done when all of its jobs have
+ * finished.  Call run() to run the graph and wait for it, with the calling
+ * thread lending a hand; or call start() and wait on the future some time
+ * later.  Jobs may not be added once the graph has been started.
+ *
+ * Unless another chain is specified, the jobs are run on a chain shared by
+ * all graphs, named by the task-graph-chain config variable, so that
+ * different subsystems don't each have to start their own threads.
+ */
+class EXPCL_PANDA_EVENT AsyncTaskGraph : public AsyncFuture {
+PUBLISHED:
+  explicit AsyncTaskGraph(const std::string &chain_name = std::string(),
+                          AsyncTaskManager *manager = nullptr);
+  virtual ~AsyncTaskGraph();
+
+  INLINE const std::string &get_chain_name() const;
+  INLINE int get_num_jobs() const;
+  INLINE bool is_started() const;
+
+  void start();
+  BLOCKING void run();
+  virtual bool cancel() override;
+
+  MAKE_PROPERTY(chain_name, get_chain_name);
+
+public:
+  typedef std::function<void()> JobFunc;
+  typedef std::function<void(int begin, int end)> RangeFunc;
+
+  int add_job(JobFunc func);
+  int add_range(int begin, int end, RangeFunc func, int grain_size = 0);
+  void add_dependency(int job, int prerequisite);
+
+  INLINE void set_max_workers(int max_workers);
+  INLINE int get_max_workers() const;
+
+private:
+  bool run_next_job(bool retire);
+  void finish_job(int index);
+  void start_workers();
+  bool check_acyclic() const;
+
+  static AsyncTask::DoneStatus worker_func(GenericAsyncTask *task, void *user_data);
+
+  class Job {
+  public:
+    JobFunc _func;
+    RangeFunc _range_func;
+    int _begin;
+    int _end;
+    int _grain_size;
+
+    // The start of the next part of the range to be handed out.  Protected
+    // by the graph's lock.
+    int _next;
+
+    // The number of parts of the job that have not yet finished, and the
+    // number of other jobs that must finish before this one can start.
+    AtomicAdjust::Integer _num_unfinished;
+    AtomicAdjust::Integer _num_pending;
+
+    pvector<int> _dependents;
+  };
+  typedef pvector<Job> Jobs;
+  Jobs _jobs;
+
+  std::string _chain_name;
+  int _pipeline_stage;
+  bool _started;
+  AtomicAdjust::Integer _cancelled;
+  AtomicAdjust::Integer _num_unfinished;
+
+  // The jobs that may be started now, and the number of tasks currently
+  // running jobs from the graph.  The condition variable is signalled when a
+  // job becomes ready or the graph is finished, to wake up run().
+  Mutex _lock;
+  ConditionVar _cvar;
+  pdeque<int> _ready;
+  bool _finished;
+  int _num_workers;
+  int _max_workers;
+  int _worker_limit;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AsyncFuture::init_type();
+    register_type(_type_handle, "AsyncTaskGraph",
+                  AsyncFuture::get_class_type());
+  }
+  virtual TypeHandle get_type() const override {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() override {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "asyncTaskGraph.I"
+
+#endif
@@ -465,6 +465,20 @@ get_sleeping_tasks() const {
   return result;
 }
 
+/**
+ * Calls the indicated function for consecutive, non-overlapping parts of the
+ * range [begin, end), in parallel on the threads of the shared task graph
+ * chain as well as the calling thread, and returns when the whole range has
+ * been processed.  See AsyncTaskGraph::add_range().
+ */
+void AsyncTaskManager::
+parallel_for(int begin, int end, const AsyncTaskGraph::RangeFunc &func,
+             int grain_size) {
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph(std::string(), this);
+  graph->add_range(begin, end, func, grain_size);
+  graph->run();
+}
+
 /**
  * Runs through all the tasks in the task list, once, if the task manager is
  * running in single-threaded mode (no threads available).  This method does
@@ -19,6 +19,7 @@
 #include "asyncTask.h"
 #include "asyncTaskCollection.h"
 #include "asyncTaskChain.h"
+#include "asyncTaskGraph.h"
 #include "typedReferenceCount.h"
 #include "thread.h"
 #include "pmutex.h"
@@ -95,6 +96,11 @@ PUBLISHED:
 
   INLINE static AsyncTaskManager *get_global_ptr();
 
+public:
+  BLOCKING void parallel_for(int begin, int end,
+                             const AsyncTaskGraph::RangeFunc &func,
+                             int grain_size = 0);
+
 protected:
   AsyncTaskChain *do_make_task_chain(const std::string &name);
   AsyncTaskChain *do_find_task_chain(const std::string &name);
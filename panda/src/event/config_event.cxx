@@ -15,6 +15,7 @@
 #include "asyncFuture.h"
 #include "asyncTask.h"
 #include "asyncTaskChain.h"
+#include "asyncTaskGraph.h"
 #include "asyncTaskManager.h"
 #include "asyncTaskPause.h"
 #include "asyncTaskSequence.h"
@@ -27,6 +28,8 @@
 
 #include "dconfig.h"
 
+#include <thread>
+
 #if !defined(CPPPARSER) && !defined(LINK_ALL_STATIC) && !defined(BUILDING_PANDA_EVENT)
   #error Buildsystem error: BUILDING_PANDA_EVENT not defined
 #endif
@@ -35,11 +38,26 @@ Configure(config_event);
 NotifyCategoryDef(event, "");
 NotifyCategoryDef(task, "");
 
+ConfigVariableString task_graph_chain
+("task-graph-chain", "graph",
+ PRC_DESC("The name of the task chain on which an AsyncTaskGraph runs its "
+          "jobs, unless another chain is specified.  This chain is shared by "
+          "all of the subsystems that use AsyncTaskGraph."));
+
+ConfigVariableInt task_graph_num_threads
+("task-graph-num-threads", (int)std::thread::hardware_concurrency(),
+ PRC_DESC("The number of threads to start on the task-graph-chain, if it "
+          "hasn't already been created by the application.  The default is "
+          "the number of hardware threads.  The thread that runs an "
+          "AsyncTaskGraph also runs jobs while it waits for the graph to "
+          "finish.  Set it to 0 to run all jobs on the calling thread."));
+
 ConfigureFn(config_event) {
   AsyncFuture::init_type();
   AsyncGatheringFuture::init_type();
   AsyncTask::init_type();
   AsyncTaskChain::init_type();
+  AsyncTaskGraph::init_type();
   AsyncTaskManager::init_type();
   AsyncTaskPause::init_type();
   AsyncTaskSequence::init_type();
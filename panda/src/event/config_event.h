@@ -17,8 +17,13 @@
 #include "pandabase.h"
 
 #include "notifyCategoryProxy.h"
+#include "configVariableInt.h"
+#include "configVariableString.h"
 
 NotifyCategoryDecl(event, EXPCL_PANDA_EVENT, EXPTP_PANDA_EVENT);
 NotifyCategoryDecl(task, EXPCL_PANDA_EVENT, EXPTP_PANDA_EVENT);
 
+extern EXPCL_PANDA_EVENT ConfigVariableString task_graph_chain;
+extern EXPCL_PANDA_EVENT ConfigVariableInt task_graph_num_threads;
+
 #endif
@@ -2,6 +2,7 @@
 #include "asyncTask.cxx"
 #include "asyncTaskChain.cxx"
 #include "asyncTaskCollection.cxx"
+#include "asyncTaskGraph.cxx"
 #include "asyncTaskManager.cxx"
 #include "asyncTaskPause.cxx"
 #include "asyncTaskSequence.cxx"
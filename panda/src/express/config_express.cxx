@@ -77,6 +77,15 @@ ConfigVariableBool multifile_always_binary
           "or extracted in either binary or text mode, according to the "
           "set_binary() or set_text() flag on the Filename."));
 
+ConfigVariableBool multifile_mmap
+("multifile-mmap", true,
+ PRC_DESC("Set this true to map a Multifile that is opened from a file on "
+          "disk into memory, so that its subfiles may be read by many "
+          "threads at once without contending for a shared file pointer.  "
+          "Set it false to always read subfiles through the file stream, "
+          "for instance when the address space is too small to hold the "
+          "larger multifiles."));
+
 ConfigVariableBool collect_tcp
 ("collect-tcp", false,
  PRC_DESC("Set this true to enable accumulation of several small consecutive "
@@ -37,6 +37,24 @@ save_datagram(SubfileInfo &info) {
   return false;
 }
 
+/**
+ * Reads the next datagram and returns its contents as a FileData.  For
+ * generators that read from a memory-mapped file, this may be a view into the
+ * file itself, so that the datagram is never copied; the default
+ * implementation copies it.
+ *
+ * Returns NULL on failure.
+ */
+CPT(FileData) DatagramGenerator::
+get_datagram_data() {
+  Datagram dg;
+  if (!get_datagram(dg)) {
+    return nullptr;
+  }
+  const unsigned char *data = (const unsigned char *)dg.get_data();
+  return new FileData(vector_uchar(data, data + dg.get_length()));
+}
+
 /**
  * Returns the filename that provides the source for these datagrams, if any,
  * or empty string if the datagrams do not originate from a file on disk.
@@ -17,6 +17,7 @@
 #include "pandabase.h"
 
 #include "datagram.h"
+#include "fileData.h"
 
 class SubfileInfo;
 class FileReference;
@@ -34,6 +35,7 @@ PUBLISHED:
 
   virtual bool get_datagram(Datagram &data) = 0;
   virtual bool save_datagram(SubfileInfo &info);
+  virtual CPT(FileData) get_datagram_data();
   virtual bool is_eof() = 0;
   virtual bool is_error() = 0;
 
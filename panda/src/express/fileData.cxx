@@ -0,0 +1,84 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file fileData.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "fileData.h"
+#include "mappedStream.h"
+
+/**
+ * Creates a FileData that views size bytes of the indicated mapping,
+ * beginning at byte start.  The FileData keeps the mapping alive.
+ */
+FileData::
+FileData(const FileMapping *mapping, size_t start, size_t size) :
+  _mapping(mapping),
+  _data(nullptr),
+  _size(0)
+{
+  nassertv(mapping != nullptr && mapping->is_open());
+  nassertv(start <= mapping->get_size() && size <= mapping->get_size() - start);
+  _data = mapping->get_data() + start;
+  _size = size;
+}
+
+/**
+ * Creates a FileData that takes ownership of the indicated data.
+ */
+FileData::
+FileData(vector_uchar &&data) :
+  _copy(std::move(data))
+{
+  _data = _copy.data();
+  _size = _copy.size();
+}
+
+/**
+ * Creates a FileData that views size bytes of another FileData, beginning at
+ * byte start.  If the source is mapped, the new FileData shares the mapping;
+ * otherwise, it keeps the source alive.
+ */
+FileData::
+FileData(const FileData *source, size_t start, size_t size) :
+  _data(nullptr),
+  _size(0)
+{
+  nassertv(source != nullptr);
+  nassertv(start <= source->_size && size <= source->_size - start);
+  if (source->_mapping != nullptr) {
+    _mapping = source->_mapping;
+  } else {
+    _source = source;
+  }
+  _data = source->_data + start;
+  _size = size;
+}
+
+/**
+ * Returns a copy of size bytes of the data, beginning at byte start.
+ */
+vector_uchar FileData::
+get_subdata(size_t start, size_t size) const {
+  start = std::min(start, _size);
+  size = std::min(size, _size - start);
+  return vector_uchar(_data + start, _data + start + size);
+}
+
+/**
+ * Returns a newly allocated istream that reads from the data, without copying
+ * it.  The stream keeps a reference to this object, so it remains valid even
+ * if the FileData is released first.  The stream should be deleted with
+ * VirtualFileSystem::close_read_file() when it is no longer needed.
+ */
+std::istream *FileData::
+open_read() const {
+  return new IMappedStream(this);
+}
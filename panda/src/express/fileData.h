@@ -0,0 +1,61 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file fileData.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef FILEDATA_H
+#define FILEDATA_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "fileMapping.h"
+#include "pointerTo.h"
+#include "vector_uchar.h"
+
+/**
+ * The complete contents of a file, as returned by
+ * VirtualFile::read_file_data().  This is a read-only block of memory that
+ * remains valid for as long as the FileData object exists.
+ *
+ * Where possible, the block is a view into a FileMapping of the file on disk,
+ * in which case the data is never copied at all; otherwise, the FileData owns
+ * a copy of the data in memory.
+ */
+class EXPCL_PANDA_EXPRESS FileData : public ReferenceCount {
+public:
+  FileData(const FileMapping *mapping, size_t start, size_t size);
+  explicit FileData(vector_uchar &&data);
+  FileData(const FileData *source, size_t start, size_t size);
+  FileData(const FileData &copy) = delete;
+
+  INLINE const unsigned char *get_data() const;
+
+PUBLISHED:
+  INLINE size_t get_size() const;
+  INLINE bool is_mapped() const;
+  vector_uchar get_subdata(size_t start, size_t size) const;
+
+  BLOCKING std::istream *open_read() const;
+
+  MAKE_PROPERTY(size, get_size);
+  MAKE_PROPERTY(mapped, is_mapped);
+
+private:
+  CPT(FileMapping) _mapping;
+  CPT(FileData) _source;
+  vector_uchar _copy;
+  const unsigned char *_data;
+  size_t _size;
+};
+
+#include "fileData.I"
+
+#endif
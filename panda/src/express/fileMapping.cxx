@@ -0,0 +1,175 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file fileMapping.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "fileMapping.h"
+#include "config_express.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ *
+ */
+FileMapping::
+FileMapping() :
+  _base(nullptr),
+  _base_size(0),
+  _data(nullptr),
+  _size(0)
+{
+}
+
+/**
+ *
+ */
+FileMapping::
+~FileMapping() {
+  close();
+}
+
+/**
+ * Maps size bytes of the indicated file, beginning at byte start, into
+ * memory.  If size is -1, the mapping extends to the end of the file.  The
+ * filename is a physical file on disk, and is not looked up via the vfs.
+ * Returns true on success, false on failure.
+ */
+bool FileMapping::
+open(const Filename &filename, std::streampos start, std::streamsize size) {
+  close();
+
+  if (start < 0) {
+    return false;
+  }
+  uint64_t offset = (uint64_t)(std::streamoff)start;
+
+#ifdef _WIN32
+  std::wstring os_specific = filename.to_os_specific_w();
+  HANDLE file = CreateFileW(os_specific.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    return false;
+  }
+  uint64_t file_length = (uint64_t)file_size.QuadPart;
+#else
+  std::string os_specific = filename.to_os_specific();
+  int fd = ::open(os_specific.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+  uint64_t file_length = (uint64_t)st.st_size;
+#endif
+
+  if (size < 0) {
+    size = (std::streamsize)(file_length - std::min(offset, file_length));
+  }
+  uint64_t length = (uint64_t)size;
+
+  // The start of the mapping must be aligned to the allocation granularity,
+  // so we map a few extra bytes before the range we were asked for.
+#ifdef _WIN32
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  uint64_t granularity = sysinfo.dwAllocationGranularity;
+#else
+  uint64_t granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+  uint64_t base_offset = offset - (offset % granularity);
+  uint64_t base_length = length + (offset - base_offset);
+
+  bool valid = (length != 0 && offset + length <= file_length &&
+                base_length <= (uint64_t)SIZE_MAX);
+
+  void *base = nullptr;
+#ifdef _WIN32
+  if (valid) {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      base = MapViewOfFile(mapping, FILE_MAP_READ,
+                           (DWORD)(base_offset >> 32),
+                           (DWORD)(base_offset & 0xffffffff),
+                           (SIZE_T)base_length);
+      // The view keeps the file mapping alive.
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  if (valid) {
+    base = mmap(nullptr, (size_t)base_length, PROT_READ, MAP_SHARED, fd,
+                (off_t)base_offset);
+    if (base == MAP_FAILED) {
+      base = nullptr;
+    }
+  }
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+#endif
+
+  if (base == nullptr) {
+    if (express_cat.is_debug()) {
+      express_cat.debug()
+        << "Unable to map " << length << " bytes at " << offset << " of "
+        << filename << "\n";
+    }
+    return false;
+  }
+
+  _filename = filename;
+  _base = base;
+  _base_size = (size_t)base_length;
+  _data = (const unsigned char *)base + (size_t)(offset - base_offset);
+  _size = (size_t)length;
+  return true;
+}
+
+/**
+ * Unmaps the file.  Any pointers previously returned by get_data() become
+ * invalid.
+ */
+void FileMapping::
+close() {
+  if (_base != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(_base);
+#else
+    munmap(_base, _base_size);
+#endif
+    _base = nullptr;
+  }
+  _base_size = 0;
+  _data = nullptr;
+  _size = 0;
+  _filename = Filename();
+}
@@ -0,0 +1,54 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file fileMapping.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef FILEMAPPING_H
+#define FILEMAPPING_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "filename.h"
+
+/**
+ * A read-only memory mapping of a byte range within a file on disk.  The
+ * mapped bytes remain valid for as long as the FileMapping object exists, so
+ * any number of readers, on any number of threads, may read from it at the
+ * same time without locking.
+ *
+ * The file should not be truncated or modified while it is mapped.
+ */
+class EXPCL_PANDA_EXPRESS FileMapping : public ReferenceCount {
+public:
+  FileMapping();
+  FileMapping(const FileMapping &copy) = delete;
+  ~FileMapping();
+
+  bool open(const Filename &filename, std::streampos start = 0,
+            std::streamsize size = -1);
+  void close();
+
+  INLINE bool is_open() const;
+  INLINE const Filename &get_filename() const;
+  INLINE const unsigned char *get_data() const;
+  INLINE size_t get_size() const;
+
+private:
+  Filename _filename;
+  void *_base;
+  size_t _base_size;
+  const unsigned char *_data;
+  size_t _size;
+};
+
+#include "fileMapping.I"
+
+#endif
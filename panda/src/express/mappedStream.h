@@ -0,0 +1,48 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedStream.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef MAPPEDSTREAM_H
+#define MAPPEDSTREAM_H
+
+#include "pandabase.h"
+#include "mappedStreamBuf.h"
+#include "fileMapping.h"
+#include "fileData.h"
+
+/**
+ * An istream object that reads a range of bytes from a FileMapping, or the
+ * contents of a FileData.  Unlike ISubStream, it does not share a file
+ * pointer with any other stream, so any number of IMappedStreams may read
+ * from the same mapping on different threads without contention.
+ */
+class EXPCL_PANDA_EXPRESS IMappedStream : public std::istream {
+public:
+  INLINE IMappedStream();
+  INLINE explicit IMappedStream(const FileMapping *mapping, size_t start, size_t size);
+  INLINE explicit IMappedStream(const FileData *data);
+
+#if _MSC_VER >= 1800
+  INLINE IMappedStream(const IMappedStream &copy) = delete;
+#endif
+
+  INLINE IMappedStream &open(const FileMapping *mapping, size_t start, size_t size);
+  INLINE IMappedStream &open(const FileData *data);
+  INLINE IMappedStream &close();
+
+private:
+  MappedStreamBuf _buf;
+};
+
+#include "mappedStream.I"
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedStreamBuf.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "mappedStreamBuf.h"
+#include "pnotify.h"
+
+using std::ios;
+using std::streamoff;
+using std::streampos;
+using std::streamsize;
+
+/**
+ *
+ */
+MappedStreamBuf::
+MappedStreamBuf() {
+  setg(nullptr, nullptr, nullptr);
+}
+
+/**
+ *
+ */
+MappedStreamBuf::
+~MappedStreamBuf() {
+  close();
+}
+
+/**
+ * Starts reading size bytes from the indicated block of memory.  The owner is
+ * the object that keeps the memory valid; the MappedStreamBuf keeps a
+ * reference to it until it is closed.
+ */
+void MappedStreamBuf::
+open(const ReferenceCount *owner, const unsigned char *data, size_t size) {
+  static char empty = 0;
+
+  _owner = owner;
+
+  // The memory is never written to; the const_cast is only needed to satisfy
+  // the streambuf interface.
+  char *begin = (data != nullptr) ? (char *)const_cast<unsigned char *>(data) : &empty;
+  setg(begin, begin, begin + size);
+}
+
+/**
+ * Releases the memory block.
+ */
+void MappedStreamBuf::
+close() {
+  setg(nullptr, nullptr, nullptr);
+  _owner.clear();
+}
+
+/**
+ * Implements seeking within the stream.  Only the read pointer is supported.
+ */
+streampos MappedStreamBuf::
+seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
+  if ((which & ios::in) == 0 || eback() == nullptr) {
+    return EOF;
+  }
+
+  streamoff size = (streamoff)(egptr() - eback());
+  streamoff new_pos;
+  switch (dir) {
+  case ios::beg:
+    new_pos = off;
+    break;
+
+  case ios::cur:
+    new_pos = (streamoff)(gptr() - eback()) + off;
+    break;
+
+  case ios::end:
+    new_pos = size + off;
+    break;
+
+  default:
+    return EOF;
+  }
+
+  if (new_pos < 0 || new_pos > size) {
+    return EOF;
+  }
+
+  setg(eback(), eback() + (size_t)new_pos, egptr());
+  return new_pos;
+}
+
+/**
+ * A variant on seekoff() to implement seeking within a stream.
+ */
+streampos MappedStreamBuf::
+seekpos(streampos pos, ios_openmode which) {
+  return seekoff(pos, ios::beg, which);
+}
+
+/**
+ * Returns the number of bytes that remain to be read.
+ */
+streamsize MappedStreamBuf::
+showmanyc() {
+  return (gptr() < egptr()) ? (streamsize)(egptr() - gptr()) : -1;
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.  Since the whole range is already in the buffer, this
+ * only happens at the end of the range.
+ */
+int MappedStreamBuf::
+underflow() {
+  if (gptr() < egptr()) {
+    return (unsigned char)*gptr();
+  }
+  return EOF;
+}
@@ -0,0 +1,46 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedStreamBuf.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef MAPPEDSTREAMBUF_H
+#define MAPPEDSTREAMBUF_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+
+/**
+ * The streambuf object that implements IMappedStream.  The get area is the
+ * memory block itself, so no data is copied until it is read out of the
+ * stream.
+ */
+class EXPCL_PANDA_EXPRESS MappedStreamBuf : public std::streambuf {
+public:
+  MappedStreamBuf();
+  MappedStreamBuf(const MappedStreamBuf &copy) = delete;
+  virtual ~MappedStreamBuf();
+
+  void open(const ReferenceCount *owner, const unsigned char *data, size_t size);
+  void close();
+
+  virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+  virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+protected:
+  virtual std::streamsize showmanyc();
+  virtual int underflow();
+
+private:
+  CPT(ReferenceCount) _owner;
+};
+
+#endif
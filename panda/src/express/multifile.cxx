@@ -21,6 +21,7 @@
 #include "encryptStream.h"
 #include "virtualFileSystem.h"
 #include "virtualFile.h"
+#include "mappedStream.h"
 
 #include <algorithm>
 #include <iterator>
@@ -179,6 +180,20 @@ open_read(const Filename &multifile_name, const streampos &offset) {
   _owns_stream = true;
   _multifile_name = multifile_name;
   _offset = offset;
+
+  if (multifile_mmap) {
+    // If the Multifile is a plain file on disk, map it into memory, so that
+    // the subfiles can be read without going through the shared _read stream
+    // (and its lock).  The index is still read through the stream.
+    SubfileInfo info;
+    if (vfile->get_system_info(info) && !info.get_filename().empty()) {
+      _mapping = new FileMapping;
+      if (!_mapping->open(info.get_filename(), info.get_start(), info.get_size())) {
+        _mapping.clear();
+      }
+    }
+  }
+
   return read_index();
 }
 
@@ -343,6 +358,7 @@ close() {
   }
 
   _read = nullptr;
+  _mapping.clear();
   _write = nullptr;
   _offset = 0;
   _owns_stream = false;
@@ -1928,6 +1944,12 @@ read_subfile(int index, vector_uchar &result) {
     success = VirtualFile::simple_read_file(in, result);
     close_read_subfile(in);
 
+  } else if (const unsigned char *data = get_mapped_data(subfile)) {
+    // If the Multifile is mapped into memory, we can copy the data straight
+    // out of the mapping.  This doesn't need to hold the lock on _read, so
+    // any number of threads can do this at once.
+    result.assign(data, data + subfile->_data_length);
+
   } else {
     // But if the subfile is just a plain file, we can just read the data
     // directly from the Multifile, without paying the cost of an ISubStream.
@@ -1966,6 +1988,34 @@ read_subfile(int index, vector_uchar &result) {
   return true;
 }
 
+/**
+ * Returns the entire contents of the indicated subfile as a read-only block of
+ * memory, or NULL if it cannot be read.  If the Multifile is mapped into
+ * memory and the subfile is neither compressed nor encrypted, the result is a
+ * view into the mapping, and no data is copied.
+ */
+CPT(FileData) Multifile::
+read_subfile_data(int index) {
+  nassertr(is_read_valid(), nullptr);
+  nassertr(index >= 0 && index < (int)_subfiles.size(), nullptr);
+  Subfile *subfile = _subfiles[index];
+
+  if (subfile->_source == nullptr && subfile->_source_filename.empty() &&
+      (subfile->_flags & (SF_encrypted | SF_compressed)) == 0) {
+    const unsigned char *data = get_mapped_data(subfile);
+    if (data != nullptr) {
+      return new FileData(_mapping, (size_t)(data - _mapping->get_data()),
+                          subfile->_data_length);
+    }
+  }
+
+  vector_uchar result;
+  if (!read_subfile(index, result)) {
+    return nullptr;
+  }
+  return new FileData(std::move(result));
+}
+
 /**
  * Assumes the _write pointer is at the indicated fpos, rounds the fpos up to
  * the next legitimate address (using normalize_streampos()), and writes
@@ -2047,12 +2097,21 @@ open_read_subfile(Subfile *subfile) {
   nassertr(subfile->_source == nullptr &&
            subfile->_source_filename.empty(), nullptr);
 
-  // Return an ISubStream object that references into the open Multifile
-  // istream.
   nassertr(subfile->_data_start != (streampos)0, nullptr);
-  istream *stream =
-    new ISubStream(_read, _offset + subfile->_data_start,
-                   _offset + subfile->_data_start + (streampos)subfile->_data_length);
+  istream *stream;
+  if (const unsigned char *data = get_mapped_data(subfile)) {
+    // Return an IMappedStream object that reads straight from the mapped
+    // Multifile.  It keeps the mapping alive, and it has its own read
+    // pointer, so it doesn't contend with other readers.
+    stream = new IMappedStream(_mapping, (size_t)(data - _mapping->get_data()),
+                               subfile->_data_length);
+  } else {
+    // Return an ISubStream object that references into the open Multifile
+    // istream.
+    stream =
+      new ISubStream(_read, _offset + subfile->_data_start,
+                     _offset + subfile->_data_start + (streampos)subfile->_data_length);
+  }
 
   if ((subfile->_flags & SF_encrypted) != 0) {
 #ifndef HAVE_OPENSSL
@@ -2100,6 +2159,26 @@ open_read_subfile(Subfile *subfile) {
   return stream;
 }
 
+/**
+ * If the Multifile has been mapped into memory, returns a pointer to the
+ * first byte of the indicated subfile's data within the mapping.  Returns
+ * NULL if the Multifile is not mapped, or if the subfile doesn't lie within
+ * the mapped range.
+ */
+const unsigned char *Multifile::
+get_mapped_data(const Subfile *subfile) const {
+  if (_mapping == nullptr) {
+    return nullptr;
+  }
+
+  streamoff start = (streamoff)(_offset + subfile->_data_start);
+  if (start < 0 || (uint64_t)start > (uint64_t)_mapping->get_size() ||
+      (uint64_t)subfile->_data_length > (uint64_t)_mapping->get_size() - (uint64_t)start) {
+    return nullptr;
+  }
+  return _mapping->get_data() + (size_t)start;
+}
+
 /**
  * Returns the standard form of the subfile name.
  */
@@ -19,6 +19,9 @@
 #include "config_express.h"
 #include "streamWrapper.h"
 #include "subStream.h"
+#include "fileMapping.h"
+#include "fileData.h"
+#include "pointerTo.h"
 #include "filename.h"
 #include "ordered_vector.h"
 #include "indirectLess.h"
@@ -161,6 +164,7 @@ public:
 
   bool read_subfile(int index, std::string &result);
   bool read_subfile(int index, vector_uchar &result);
+  CPT(FileData) read_subfile_data(int index);
 
 private:
   enum SubfileFlags {
@@ -214,6 +218,7 @@ private:
 
   void add_new_subfile(Subfile *subfile, int compression_level);
   std::istream *open_read_subfile(Subfile *subfile);
+  const unsigned char *get_mapped_data(const Subfile *subfile) const;
   std::string standardize_subfile_name(const std::string &subfile_name) const;
 
   void clear_subfiles();
@@ -238,6 +243,7 @@ private:
 
   std::streampos _offset;
   IStreamWrapper *_read;
+  PT(FileMapping) _mapping;
   std::ostream *_write;
   bool _owns_stream;
   std::streampos _next_index;
@@ -10,9 +10,13 @@
 #include "dcast.cxx"
 #include "encrypt_string.cxx"
 #include "error_utils.cxx"
+#include "fileData.cxx"
+#include "fileMapping.cxx"
 #include "fileReference.cxx"
 #include "hashGeneratorBase.cxx"
 #include "hashVal.cxx"
+#include "mappedStream.cxx"
+#include "mappedStreamBuf.cxx"
 #include "memoryInfo.cxx"
 #include "memoryUsage.cxx"
 #include "memoryUsagePointerCounts.cxx"
@@ -65,6 +65,7 @@ public:
 
   INLINE bool ref_if_nonzero() const;
   INLINE bool unref_if_one() const;
+  INLINE bool unref_if_not_one() const;
 
 protected:
   bool do_test_ref_count_integrity() const;
@@ -377,6 +377,23 @@ read_file(vector_uchar &result, bool auto_unwrap) const {
   return false;
 }
 
+/**
+ * Returns the entire contents of the file as a read-only block of memory, or
+ * NULL if the file cannot be read.
+ *
+ * Unlike read_file(), this may avoid copying the data altogether: if the file
+ * is stored uncompressed on disk, the FileData is a view into a memory
+ * mapping of the file.  Otherwise, it holds a copy of the data.
+ */
+CPT(FileData) VirtualFile::
+read_file_data(bool auto_unwrap) const {
+  vector_uchar result;
+  if (!read_file(result, auto_unwrap)) {
+    return nullptr;
+  }
+  return new FileData(std::move(result));
+}
+
 /**
  * Writes the indicated data to the file, if it is writable.  Returns true on
  * success, false otherwise.
@@ -22,6 +22,7 @@
 #include "typedReferenceCount.h"
 #include "ordered_vector.h"
 #include "vector_uchar.h"
+#include "fileData.h"
 
 class VirtualFileMount;
 class VirtualFileList;
@@ -59,6 +60,7 @@ PUBLISHED:
   EXTENSION(PyObject *read_file(bool auto_unwrap) const);
   BLOCKING virtual std::istream *open_read_file(bool auto_unwrap) const;
   BLOCKING virtual void close_read_file(std::istream *stream) const;
+  BLOCKING virtual CPT(FileData) read_file_data(bool auto_unwrap) const;
   virtual bool was_read_successful() const;
 
   EXTENSION(PyObject *write_file(PyObject *data, bool auto_wrap));
@@ -15,6 +15,7 @@
 #include "virtualFileSimple.h"
 #include "virtualFileSystem.h"
 #include "zStream.h"
+#include "fileMapping.h"
 
 using std::iostream;
 using std::istream;
@@ -180,6 +181,34 @@ write_file(const Filename &file, bool do_compress,
   return okflag;
 }
 
+/**
+ * Returns the entire contents of the file as a read-only block of memory, or
+ * NULL if the file cannot be read.
+ *
+ * The default implementation maps the file into memory if it is stored
+ * uncompressed within a file on disk, as reported by get_system_info(), and
+ * otherwise falls back to read_file().
+ */
+CPT(FileData) VirtualFileMount::
+read_file_data(const Filename &file, bool do_uncompress) {
+  if (!do_uncompress && !file.is_text() &&
+      VirtualFileSystem::get_global_ptr()->vfs_mmap) {
+    SubfileInfo info;
+    if (get_system_info(file, info) && !info.get_filename().empty()) {
+      PT(FileMapping) mapping = new FileMapping;
+      if (mapping->open(info.get_filename(), info.get_start(), info.get_size())) {
+        return new FileData(mapping, 0, mapping->get_size());
+      }
+    }
+  }
+
+  vector_uchar result;
+  if (!read_file(file, do_uncompress, result)) {
+    return nullptr;
+  }
+  return new FileData(std::move(result));
+}
+
 /**
  * Opens the file for reading.  Returns a newly allocated istream on success
  * (which you should eventually delete when you are done reading). Returns
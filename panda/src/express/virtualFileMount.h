@@ -57,6 +57,7 @@ public:
                          vector_uchar &result) const;
   virtual bool write_file(const Filename &file, bool do_compress,
                           const unsigned char *data, size_t data_size);
+  virtual CPT(FileData) read_file_data(const Filename &file, bool do_uncompress);
 
   virtual std::istream *open_read_file(const Filename &file) const=0;
   std::istream *open_read_file(const Filename &file, bool do_uncompress) const;
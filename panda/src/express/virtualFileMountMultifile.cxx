@@ -99,6 +99,27 @@ open_read_file(const Filename &file) const {
   return _multifile->open_read_subfile(subfile_index);
 }
 
+/**
+ * Returns the entire contents of the file as a read-only block of memory, or
+ * NULL if the file cannot be read.  Uncompressed subfiles of a Multifile that
+ * has been mapped into memory are returned without copying.
+ */
+CPT(FileData) VirtualFileMountMultifile::
+read_file_data(const Filename &file, bool do_uncompress) {
+  if (do_uncompress) {
+    return VirtualFileMount::read_file_data(file, do_uncompress);
+  }
+
+  int subfile_index = _multifile->find_subfile(file);
+  if (subfile_index < 0) {
+    express_cat.info()
+      << "Unable to read " << file << "\n";
+    return nullptr;
+  }
+
+  return _multifile->read_subfile_data(subfile_index);
+}
+
 /**
  * Returns the current size on disk (or wherever it is) of the already-open
  * file.  Pass in the stream that was returned by open_read_file(); some
@@ -39,6 +39,7 @@ public:
                          vector_uchar &result) const;
 
   virtual std::istream *open_read_file(const Filename &file) const;
+  virtual CPT(FileData) read_file_data(const Filename &file, bool do_uncompress);
   virtual std::streamsize get_file_size(const Filename &file, std::istream *stream) const;
   virtual std::streamsize get_file_size(const Filename &file) const;
   virtual time_t get_timestamp(const Filename &file) const;
@@ -223,6 +223,38 @@ open_read_file(const Filename &file) const {
   return new ISubStream(&f2->_wrapper, 0, 0);
 }
 
+/**
+ * Returns the entire contents of the file as a read-only block of memory, or
+ * NULL if the file cannot be read.  The contents of a ramdisk file may change
+ * at any time, so they can't be shared; but they are copied directly into the
+ * result in one piece, rather than through an intermediate stream.
+ */
+CPT(FileData) VirtualFileMountRamdisk::
+read_file_data(const Filename &file, bool do_uncompress) {
+  if (do_uncompress) {
+    return VirtualFileMount::read_file_data(file, do_uncompress);
+  }
+
+  _lock.lock();
+  PT(FileBase) f = _root.do_find_file(file);
+  _lock.unlock();
+  if (f == nullptr || f->is_directory()) {
+    return nullptr;
+  }
+
+  File *f2 = DCAST(File, f);
+  std::streamsize size = f2->_wrapper.seek_gpos_eof();
+  vector_uchar result((size_t)std::max(size, (std::streamsize)0));
+
+  std::streamsize count = 0;
+  bool eof = false;
+  if (!result.empty()) {
+    f2->_wrapper.seek_read(0, (char *)result.data(), size, count, eof);
+  }
+  result.resize((size_t)count);
+  return new FileData(std::move(result));
+}
+
 /**
  * Opens the file for writing.  Returns a newly allocated ostream on success
  * (which you should eventually delete when you are done writing). Returns
@@ -43,6 +43,7 @@ public:
   virtual bool is_writable(const Filename &file) const;
 
   virtual std::istream *open_read_file(const Filename &file) const;
+  virtual CPT(FileData) read_file_data(const Filename &file, bool do_uncompress);
   virtual std::ostream *open_write_file(const Filename &file, bool truncate);
   virtual std::ostream *open_append_file(const Filename &file);
   virtual std::iostream *open_read_write_file(const Filename &file, bool truncate);
@@ -189,6 +189,24 @@ open_read_file(const Filename &file) const {
   return stream;
 }
 
+/**
+ * Returns the entire contents of the file as a read-only block of memory, or
+ * NULL if the file cannot be read.  Unless it is to be decompressed, the file
+ * is mapped into memory rather than copied.
+ */
+CPT(FileData) VirtualFileMountSystem::
+read_file_data(const Filename &file, bool do_uncompress) {
+#ifdef _WIN32
+  // First ensure that the file exists to validate its case.
+  if (VirtualFileSystem::get_global_ptr()->vfs_case_sensitive) {
+    if (!has_file(file)) {
+      return nullptr;
+    }
+  }
+#endif  // WIN32
+  return VirtualFileMount::read_file_data(file, do_uncompress);
+}
+
 /**
  * Opens the file for writing.  Returns a newly allocated ostream on success
  * (which you should eventually delete when you are done writing). Returns
@@ -233,6 +233,27 @@ close_read_file(istream *stream) const {
   _mount->close_read_file(stream);
 }
 
+/**
+ * Returns the entire contents of the file as a read-only block of memory, or
+ * NULL if the file cannot be read.  See VirtualFile::read_file_data().
+ */
+CPT(FileData) VirtualFileSimple::
+read_file_data(bool auto_unwrap) const {
+
+  // Will we be automatically unwrapping a .pz file?
+  bool do_uncompress = (_implicit_pz_file ||
+    (auto_unwrap && (_local_filename.get_extension() == "pz" ||
+                     _local_filename.get_extension() == "gz")));
+
+  Filename local_filename(_local_filename);
+  if (do_uncompress) {
+    // .pz files are always binary, of course.
+    local_filename.set_binary();
+  }
+
+  return _mount->read_file_data(local_filename, do_uncompress);
+}
+
 /**
  * Opens the file for writing.  Returns a newly allocated ostream on success
  * (which you should eventually delete when you are done writing). Returns
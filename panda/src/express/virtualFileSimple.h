@@ -47,6 +47,7 @@ PUBLISHED:
 
   virtual std::istream *open_read_file(bool auto_unwrap) const;
   virtual void close_read_file(std::istream *stream) const;
+  virtual CPT(FileData) read_file_data(bool auto_unwrap) const;
   virtual std::ostream *open_write_file(bool auto_wrap, bool truncate);
   virtual std::ostream *open_append_file();
   virtual void close_write_file(std::ostream *stream);
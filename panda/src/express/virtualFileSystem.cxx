@@ -70,7 +70,13 @@ VirtualFileSystem() :
             "will implicitly retrieve a file named 'dirname/mytex.jpg' "
             "within the multifile /c/files/foo.mf, even if the multifile "
             "has not already been mounted.  This makes all of your multifiles "
-            "act like directories."))
+            "act like directories.")),
+  vfs_mmap
+  ("vfs-mmap", true,
+   PRC_DESC("When this is true, VirtualFile::read_file_data() will map a file "
+            "into memory instead of reading a copy of it, whenever the file "
+            "is stored uncompressed on disk.  Set this false to always read "
+            "a copy of the data."))
 {
   _cwd = "/";
   _mount_seq = 0;
@@ -981,6 +987,24 @@ close_read_file(istream *stream) {
   }
 }
 
+/**
+ * Convenience function; returns the entire contents of the indicated file as
+ * a read-only block of memory, or NULL if the file cannot be read.  Where
+ * possible, the file is mapped into memory rather than copied.  See
+ * VirtualFile::read_file_data().
+ *
+ * If auto_unwrap is true, an explicitly-named .pz/.gz file is automatically
+ * decompressed and the decompressed contents are returned.
+ */
+CPT(FileData) VirtualFileSystem::
+read_file_data(const Filename &filename, bool auto_unwrap) const {
+  PT(VirtualFile) file = get_file(filename, false);
+  if (file == nullptr) {
+    return nullptr;
+  }
+  return file->read_file_data(auto_unwrap);
+}
+
 /**
  * Convenience function; returns a newly allocated ostream if the file exists
  * and can be written, or NULL otherwise.  Does not return an invalid ostream.
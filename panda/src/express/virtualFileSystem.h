@@ -101,6 +101,7 @@ PUBLISHED:
   EXTENSION(PyObject *read_file(const Filename &filename, bool auto_unwrap) const);
   BLOCKING std::istream *open_read_file(const Filename &filename, bool auto_unwrap) const;
   BLOCKING static void close_read_file(std::istream *stream);
+  BLOCKING CPT(FileData) read_file_data(const Filename &filename, bool auto_unwrap) const;
 
   EXTENSION(PyObject *write_file(const Filename &filename, PyObject *data, bool auto_wrap));
   BLOCKING std::ostream *open_write_file(const Filename &filename, bool auto_wrap, bool truncate);
@@ -148,6 +149,7 @@ public:
   ConfigVariableBool vfs_case_sensitive;
   ConfigVariableBool vfs_implicit_pz;
   ConfigVariableBool vfs_implicit_mf;
+  ConfigVariableBool vfs_mmap;
 
 private:
   Filename normalize_mount_point(const Filename &mount_point) const;
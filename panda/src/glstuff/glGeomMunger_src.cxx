@@ -129,6 +129,36 @@ munge_format_impl(const GeomVertexFormat *orig,
       array_format->add_column(column->get_name(), 3, NT_float32,
                                column->get_contents(), column->get_start(),
                                column->get_column_alignment());
+
+    } else if (column->get_numeric_type() == NT_packed_oct16) {
+      // OpenGL can't decode octahedral vectors, so we re-pack them in the
+      // 10-bit format, which is just as small, or else as 32-bit floats.
+      PT(GeomVertexArrayFormat) array_format = new_format->modify_array(array);
+      if (glgsg->_supports_packed_snorm10) {
+        array_format->add_column(column->get_name(), 1, NT_packed_snorm10,
+                                 column->get_contents(), column->get_start(),
+                                 column->get_column_alignment());
+      } else {
+        array_format->add_column(column->get_name(), 3, NT_float32,
+                                 column->get_contents(), column->get_start(),
+                                 column->get_column_alignment());
+      }
+
+    } else if (column->get_numeric_type() == NT_packed_snorm10 &&
+               !glgsg->_supports_packed_snorm10) {
+      // Unpack to four 32-bit floats.
+      PT(GeomVertexArrayFormat) array_format = new_format->modify_array(array);
+      array_format->add_column(column->get_name(), 4, NT_float32,
+                               column->get_contents(), column->get_start(),
+                               column->get_column_alignment());
+
+    } else if (column->get_numeric_type() == NT_float16 &&
+               !glgsg->_supports_vertex_half_float) {
+      PT(GeomVertexArrayFormat) array_format = new_format->modify_array(array);
+      array_format->add_column(column->get_name(), column->get_num_components(),
+                               NT_float32, column->get_contents(),
+                               column->get_start(),
+                               std::max(column->get_column_alignment(), 4));
     }
 #ifdef OPENGLES
     else if (column->get_numeric_type() == NT_float64) {
@@ -333,6 +363,36 @@ premunge_format_impl(const GeomVertexFormat *orig) {
       array_format->add_column(column->get_name(), 3, NT_float32,
                                column->get_contents(), column->get_start(),
                                column->get_column_alignment());
+
+    } else if (column->get_numeric_type() == NT_packed_oct16) {
+      // OpenGL can't decode octahedral vectors, so we re-pack them in the
+      // 10-bit format, which is just as small, or else as 32-bit floats.
+      PT(GeomVertexArrayFormat) array_format = new_format->modify_array(array);
+      if (glgsg->_supports_packed_snorm10) {
+        array_format->add_column(column->get_name(), 1, NT_packed_snorm10,
+                                 column->get_contents(), column->get_start(),
+                                 column->get_column_alignment());
+      } else {
+        array_format->add_column(column->get_name(), 3, NT_float32,
+                                 column->get_contents(), column->get_start(),
+                                 column->get_column_alignment());
+      }
+
+    } else if (column->get_numeric_type() == NT_packed_snorm10 &&
+               !glgsg->_supports_packed_snorm10) {
+      // Unpack to four 32-bit floats.
+      PT(GeomVertexArrayFormat) array_format = new_format->modify_array(array);
+      array_format->add_column(column->get_name(), 4, NT_float32,
+                               column->get_contents(), column->get_start(),
+                               column->get_column_alignment());
+
+    } else if (column->get_numeric_type() == NT_float16 &&
+               !glgsg->_supports_vertex_half_float) {
+      PT(GeomVertexArrayFormat) array_format = new_format->modify_array(array);
+      array_format->add_column(column->get_name(), column->get_num_components(),
+                               NT_float32, column->get_contents(),
+                               column->get_start(),
+                               std::max(column->get_column_alignment(), 4));
     }
 #ifdef OPENGLES
     else if (column->get_numeric_type() == NT_float64) {
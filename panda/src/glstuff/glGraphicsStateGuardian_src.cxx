@@ -1349,12 +1349,24 @@ reset() {
 #ifdef OPENGLES
   _supports_packed_dabc = false;
   _supports_packed_ufloat = false;
+  _supports_packed_snorm10 = false;
 #else
   _supports_packed_dabc = is_at_least_gl_version(3, 2) ||
                           has_extension("GL_ARB_vertex_array_bgra") ||
                           has_extension("GL_EXT_vertex_array_bgra");
   _supports_packed_ufloat = is_at_least_gl_version(4, 4) ||
                             has_extension("GL_ARB_vertex_type_10f_11f_11f_rev");
+  _supports_packed_snorm10 = is_at_least_gl_version(3, 3) ||
+                             has_extension("GL_ARB_vertex_type_2_10_10_10_rev");
+#endif
+
+#if defined(OPENGLES_1)
+  _supports_vertex_half_float = false;
+#elif defined(OPENGLES)
+  _supports_vertex_half_float = is_at_least_gles_version(3, 0);
+#else
+  _supports_vertex_half_float = is_at_least_gl_version(3, 0) ||
+                                has_extension("GL_ARB_half_float_vertex");
 #endif
 
 #ifdef OPENGLES
@@ -4808,7 +4820,8 @@ update_shader_vertex_format(const GeomVertexFormat *format) {
 
     GLuint offset = column->get_start();
     GLenum type = get_numeric_type(column->get_numeric_type());
-    GLboolean normalized = (column->get_contents() == GeomEnums::C_color);
+    GLboolean normalized = (column->get_contents() == GeomEnums::C_color ||
+                            column->get_numeric_type() == GeomEnums::NT_packed_snorm10);
     GLint size = column->get_num_values();
 
     if (column->get_numeric_type() == GeomEnums::NT_packed_dabc) {
@@ -9252,6 +9265,24 @@ get_numeric_type(Geom::NumericType numeric_type) {
 #else
     break;
 #endif
+
+  case Geom::NT_float16:
+#ifndef OPENGLES_1
+    return GL_HALF_FLOAT;
+#else
+    break;
+#endif
+
+  case Geom::NT_packed_snorm10:
+#ifndef OPENGLES
+    return GL_INT_2_10_10_10_REV;
+#else
+    break;
+#endif
+
+  case Geom::NT_packed_oct16:
+    // Has no GL equivalent; the GeomMunger should have decoded it.
+    break;
   }
 
   GLCAT.error()
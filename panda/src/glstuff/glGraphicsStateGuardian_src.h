@@ -821,6 +821,8 @@ public:
   bool _supports_bgra_read;
   bool _supports_packed_dabc;
   bool _supports_packed_ufloat;
+  bool _supports_packed_snorm10;
+  bool _supports_vertex_half_float;
 
 #ifdef SUPPORT_FIXED_FUNCTION
   bool _supports_rescale_normal;
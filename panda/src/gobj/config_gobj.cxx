@@ -46,6 +46,7 @@
 #include "texture.h"
 #include "texturePoolFilter.h"
 #include "textureReloadRequest.h"
+#include "textureStreamer.h"
 #include "textureStage.h"
 #include "textureContext.h"
 #include "timerQueryContext.h"
@@ -301,6 +302,23 @@ ConfigVariableBool vertex_animation_align_16
           "impacts only vertex formats created within Panda subsystems; custom "
           "vertex formats are not affected."));
 
+ConfigVariableInt vertex_cache_size
+("vertex-cache-size", 32,
+ PRC_DESC("This is the number of vertices that are assumed to fit in the "
+          "post-transform vertex cache of the graphics card, when triangles "
+          "are reordered by GeomPrimitive::optimize_vertex_cache() and when "
+          "the average cache miss ratio is computed by calc_acmr().  The "
+          "cache is modeled as a FIFO of this size."));
+
+ConfigVariableInt vertex_conversion_plan_cache_size
+("vertex-conversion-plan-cache-size", 128,
+ PRC_DESC("This is the maximum number of conversion plans that are kept "
+          "around for converting vertex data between a pair of vertex "
+          "formats.  A plan is computed the first time data is converted "
+          "between a particular pair of formats, and is reused for subsequent "
+          "conversions between the same formats.  When the limit is exceeded, "
+          "all of the cached plans are discarded."));
+
 ConfigVariableEnum<AutoTextureScale> textures_power_2
 ("textures-power-2", ATS_down,
  PRC_DESC("Specify whether textures should automatically be constrained to "
@@ -350,6 +368,36 @@ ConfigVariableDouble simple_image_threshold
           "simple images.  Generally the value should be considerably "
           "less than 1."));
 
+ConfigVariableBool texture_streaming
+("texture-streaming", false,
+ PRC_DESC("Set this true to have the TexturePool stream the mipmap levels of "
+          "the 2-d textures it loads.  Each texture is first made resident "
+          "at a reduced size (see texture-stream-initial-size), and its "
+          "larger mipmap levels are reloaded in a background thread as it "
+          "appears larger on the screen, within the limit given by "
+          "texture-stream-budget."));
+
+ConfigVariableInt64 texture_stream_budget
+("texture-stream-budget", 268435456,
+ PRC_DESC("The number of bytes that the mipmap levels of all streamed "
+          "textures may occupy together, when texture-streaming is enabled.  "
+          "When loading a larger mipmap level would exceed this budget, the "
+          "textures that have gone unseen for the longest time are reduced "
+          "first.  This is an estimate of both the system memory and the "
+          "graphics memory used by the textures."));
+
+ConfigVariableInt texture_stream_initial_size
+("texture-stream-initial-size", 64,
+ PRC_DESC("The size, in texels, to which the larger dimension of a streamed "
+          "texture is reduced when it is first loaded.  Textures that are "
+          "no larger than this are not streamed."));
+
+ConfigVariableDouble texture_stream_interval
+("texture-stream-interval", 0.05,
+ PRC_DESC("The number of seconds between successive passes of the texture "
+          "streamer, each of which loads at most one more mipmap level of "
+          "each texture that needs it."));
+
 ConfigVariableInt geom_cache_size
 ("geom-cache-size", 5000,
  PRC_DESC("Specifies the maximum number of entries in the cache "
@@ -447,6 +495,14 @@ ConfigVariableInt vertex_data_page_threads
           "is 0, this work will be done in the main thread, which may "
           "introduce occasional random chugs in rendering."));
 
+ConfigVariableInt skinning_parallel_threshold
+("skinning-parallel-threshold", 0,
+ PRC_DESC("When this is nonzero (and Panda has been compiled with true "
+          "threads), the vertices of a GeomVertexData that is animated on "
+          "the CPU are transformed on the threads of the task-graph-chain "
+          "when there are at least this many of them.  Set it to 0 to "
+          "always transform them on the thread that draws them."));
+
 ConfigVariableInt graphics_memory_limit
 ("graphics-memory-limit", -1,
  PRC_DESC("This is a default limit that is imposed on each GSG at "
@@ -592,6 +648,7 @@ ConfigureFn(config_gobj) {
   TextureContext::init_type();
   TexturePoolFilter::init_type();
   TextureReloadRequest::init_type();
+  TextureStreamer::init_type();
   TextureStage::init_type();
   TimerQueryContext::init_type();
   TransformBlend::init_type();
@@ -927,6 +927,98 @@ make_adjacency_in_place() {
   nassertv(all_is_valid);
 }
 
+/**
+ * Reorders the triangles of each primitive within this Geom for better use of
+ * the vertex cache, leaving the results in place.  The vertex data is used to
+ * also reduce overdraw.  See GeomPrimitive::optimize_vertex_cache().
+ *
+ * This does not change the order of the vertices themselves; see
+ * SceneGraphReducer::optimize_vertex_cache() for that.
+ *
+ * Don't call this in a downstream thread unless you don't mind it blowing
+ * away other changes you might have recently made in an upstream thread.
+ */
+void Geom::
+optimize_vertex_cache_in_place(int cache_size) {
+  Thread *current_thread = Thread::get_current_thread();
+  CDWriter cdata(_cycler, true, current_thread);
+
+  CPT(GeomVertexData) vertex_data = cdata->_data.get_read_pointer(current_thread);
+
+  bool any_changed = false;
+  Primitives::iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) prim = (*pi).get_read_pointer(current_thread);
+    CPT(GeomPrimitive) new_prim = prim->optimize_vertex_cache(cache_size, vertex_data);
+    if (new_prim != prim) {
+      (*pi) = (GeomPrimitive *)new_prim.p();
+      any_changed = true;
+    }
+  }
+
+  if (any_changed) {
+    cdata->_modified = Geom::get_next_modified();
+    clear_cache_stage(current_thread);
+  }
+}
+
+/**
+ * Returns the average cache miss ratio of all of the triangle primitives in
+ * this Geom together, which is the average number of vertices that need to be
+ * transformed for each triangle.  See GeomPrimitive::calc_acmr().
+ */
+PN_stdfloat Geom::
+calc_acmr(int cache_size) const {
+  if (cache_size <= 0) {
+    cache_size = vertex_cache_size;
+  }
+
+  Thread *current_thread = Thread::get_current_thread();
+  CDReader cdata(_cycler, current_thread);
+
+  int num_misses = 0;
+  int num_faces = 0;
+  Primitives::const_iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) prim = (*pi).get_read_pointer(current_thread);
+    if (prim->get_primitive_type() != PT_polygons) {
+      continue;
+    }
+    num_misses += prim->calc_vertex_cache_misses(cache_size);
+    num_faces += prim->get_num_faces();
+  }
+
+  if (num_faces == 0) {
+    return 0.0f;
+  }
+  return (PN_stdfloat)num_misses / (PN_stdfloat)num_faces;
+}
+
+/**
+ * Divides the triangles of this Geom into meshlets of at most the indicated
+ * numbers of vertices and triangles, so that the cull traversal can skip the
+ * parts of the Geom that are offscreen or facing away from the camera.  This
+ * is worthwhile only for large Geoms whose triangles have already been
+ * ordered for locality, for instance with optimize_vertex_cache().
+ *
+ * The meshlets are discarded, and the Geom is again culled as a whole, as
+ * soon as the Geom or its vertices are modified.  They are not written to a
+ * bam file.
+ *
+ * Returns true on success, or false if the Geom does not consist of a single
+ * indexed triangle primitive with unanimated vertices.
+ */
+bool Geom::
+make_meshlets(int max_vertices, int max_triangles) {
+  Thread *current_thread = Thread::get_current_thread();
+  CPT(GeomMeshlets) meshlets =
+    GeomMeshlets::make_meshlets(this, max_vertices, max_triangles, current_thread);
+
+  CDWriter cdata(_cycler, true, current_thread);
+  cdata->_meshlets = meshlets;
+  return (meshlets != nullptr);
+}
+
 /**
  * Copies the primitives from the indicated Geom into this one.  This does
  * require that both Geoms contain the same fundamental type primitives, both
@@ -39,6 +39,8 @@
 #include "pStatCollector.h"
 #include "deletedChain.h"
 #include "lightMutex.h"
+#include "lightMutexHolder.h"
+#include "geomMeshlets.h"
 
 class GeomContext;
 class PreparedGraphicsObjects;
@@ -109,6 +111,7 @@ PUBLISHED:
   INLINE PT(Geom) make_lines() const;
   INLINE PT(Geom) make_patches() const;
   INLINE PT(Geom) make_adjacency() const;
+  INLINE PT(Geom) optimize_vertex_cache(int cache_size = 0) const;
 
   void decompose_in_place();
   void doubleside_in_place();
@@ -119,9 +122,17 @@ PUBLISHED:
   void make_lines_in_place();
   void make_patches_in_place();
   void make_adjacency_in_place();
+  void optimize_vertex_cache_in_place(int cache_size = 0);
 
   virtual bool copy_primitives_from(const Geom *other);
 
+  PN_stdfloat calc_acmr(int cache_size = 0) const;
+
+  bool make_meshlets(int max_vertices = 64, int max_triangles = 124);
+  INLINE CPT(GeomMeshlets) get_meshlets(Thread *current_thread = Thread::get_current_thread()) const;
+  INLINE void clear_meshlets();
+  MAKE_PROPERTY(meshlets, get_meshlets);
+
   int get_num_bytes() const;
   INLINE UpdateSeq get_modified(Thread *current_thread = Thread::get_current_thread()) const;
   MAKE_PROPERTY(num_bytes, get_num_bytes);
@@ -159,6 +170,9 @@ PUBLISHED:
 public:
   bool is_in_view(const BoundingVolume *view_frustum, Thread *current_thread) const;
 
+  INLINE CPT(ReferenceCount) get_collision_cache() const;
+  INLINE void set_collision_cache(const ReferenceCount *cache) const;
+
   bool draw(GraphicsStateGuardianBase *gsg,
             const GeomVertexData *vertex_data, size_t num_instances,
             bool force, Thread *current_thread) const;
@@ -329,6 +343,7 @@ private:
     bool _internal_bounds_stale;
     BoundingVolume::BoundsType _bounds_type;
     CPT(BoundingVolume) _user_bounds;
+    CPT(GeomMeshlets) _meshlets;
 
   public:
     static TypeHandle get_class_type() {
@@ -352,6 +367,11 @@ private:
   Cache _cache;
   LightMutex _cache_lock;
 
+  // This is kept for the collision system, outside of the cycler, since it
+  // is filled in during traversal, possibly by several threads at once.
+  mutable LightMutex _collision_cache_lock;
+  mutable CPT(ReferenceCount) _collision_cache;
+
   // This works just like the Texture contexts: each Geom keeps a record of
   // all the PGO objects that hold the Geom, and vice-versa.
   typedef pmap<PreparedGraphicsObjects *, GeomContext *> Contexts;
@@ -0,0 +1,320 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomMeshlets.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "geomMeshlets.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "boundingSphere.h"
+#include "lightMutexHolder.h"
+#include "config_gobj.h"
+
+/**
+ *
+ */
+GeomMeshlets::
+GeomMeshlets() :
+  _use_counter(0)
+{
+}
+
+/**
+ *
+ */
+GeomMeshlets::
+~GeomMeshlets() {
+}
+
+/**
+ * Divides the triangles of the indicated Geom into meshlets of at most the
+ * indicated numbers of vertices and triangles.  Each meshlet is a run of
+ * consecutive triangles in the index buffer.
+ *
+ * Returns nullptr if the Geom cannot be divided: it must consist of a single
+ * indexed GeomTriangles primitive, and its vertices may not be animated.
+ */
+CPT(GeomMeshlets) GeomMeshlets::
+make_meshlets(const Geom *geom, int max_vertices, int max_triangles,
+              Thread *current_thread) {
+  nassertr(max_vertices >= 3 && max_triangles >= 1, nullptr);
+
+  if (geom->get_num_primitives() != 1) {
+    return nullptr;
+  }
+  CPT(GeomPrimitive) prim = geom->get_primitive(0);
+  if (!prim->is_exact_type(GeomTriangles::get_class_type()) ||
+      !prim->is_indexed()) {
+    return nullptr;
+  }
+
+  CPT(GeomVertexData) vdata = geom->get_vertex_data(current_thread);
+  if (vdata->get_format()->get_animation().get_animation_type() != AT_none ||
+      !vdata->has_column(InternalName::get_vertex())) {
+    return nullptr;
+  }
+
+  int num_rows = vdata->get_num_rows();
+  pvector<LPoint3> positions(num_rows);
+  {
+    GeomVertexReader vertex(vdata, InternalName::get_vertex(), current_thread);
+    for (int i = 0; i < num_rows; ++i) {
+      positions[i] = vertex.get_data3();
+    }
+  }
+
+  GeomPrimitivePipelineReader reader(prim, current_thread);
+  reader.check_minmax();
+  if (reader.get_max_vertex() >= num_rows) {
+    return nullptr;
+  }
+  int num_indices = (reader.get_num_vertices() / 3) * 3;
+
+  PT(GeomMeshlets) meshlets = new GeomMeshlets;
+  pvector<int> indices(num_indices);
+  for (int i = 0; i < num_indices; ++i) {
+    indices[i] = reader.get_vertex(i);
+  }
+
+  // Adds a meshlet for the indicated range of indices, computing its bounding
+  // sphere and normal cone.
+  pvector<int> vertices;
+  auto add_meshlet = [&](int first_index, int end_index) {
+    Meshlet meshlet;
+    meshlet._first_index = first_index;
+    meshlet._num_indices = end_index - first_index;
+
+    LPoint3 min_point = positions[vertices[0]];
+    LPoint3 max_point = min_point;
+    for (int v : vertices) {
+      min_point = min_point.fmin(positions[v]);
+      max_point = max_point.fmax(positions[v]);
+    }
+    meshlet._center = (min_point + max_point) * 0.5f;
+    PN_stdfloat radius_2 = 0.0f;
+    for (int v : vertices) {
+      radius_2 = std::max(radius_2, (positions[v] - meshlet._center).length_squared());
+    }
+    meshlet._radius = csqrt(radius_2);
+
+    LVector3 axis(0.0f);
+    pvector<LVector3> normals;
+    normals.reserve(meshlet._num_indices / 3);
+    for (int i = first_index; i < end_index; i += 3) {
+      const LPoint3 &p0 = positions[indices[i]];
+      LVector3 normal = (positions[indices[i + 1]] - p0).cross(positions[indices[i + 2]] - p0);
+      if (normal.normalize()) {
+        normals.push_back(normal);
+        axis += normal;
+      }
+    }
+
+    // A cutoff greater than 1 never passes the test in cull().
+    meshlet._cone_axis = LVector3::zero();
+    meshlet._cone_cutoff = 2.0f;
+    if (axis.normalize()) {
+      PN_stdfloat min_dot = 1.0f;
+      for (const LVector3 &normal : normals) {
+        min_dot = std::min(min_dot, normal.dot(axis));
+      }
+      if (min_dot > 0.0f) {
+        meshlet._cone_axis = axis;
+        meshlet._cone_cutoff = csqrt(1.0f - min_dot * min_dot);
+      }
+    }
+
+    meshlets->_meshlets.push_back(meshlet);
+  };
+
+  pvector<int> marks(num_rows, -1);
+  int first_index = 0;
+  for (int i = 0; i < num_indices; i += 3) {
+    int num_meshlets = (int)meshlets->_meshlets.size();
+    int new_vertices = 0;
+    for (int k = 0; k < 3; ++k) {
+      int v = indices[i + k];
+      if (marks[v] != num_meshlets &&
+          (k < 1 || v != indices[i]) && (k < 2 || v != indices[i + 1])) {
+        ++new_vertices;
+      }
+    }
+
+    if (i > first_index &&
+        ((i - first_index) / 3 >= max_triangles ||
+         (int)vertices.size() + new_vertices > max_vertices)) {
+      add_meshlet(first_index, i);
+      vertices.clear();
+      first_index = i;
+      ++num_meshlets;
+    }
+
+    for (int k = 0; k < 3; ++k) {
+      int v = indices[i + k];
+      if (marks[v] != num_meshlets) {
+        marks[v] = num_meshlets;
+        vertices.push_back(v);
+      }
+    }
+  }
+  if (num_indices > first_index) {
+    add_meshlet(first_index, num_indices);
+  }
+
+  meshlets->_geom_modified = geom->get_modified(current_thread);
+  meshlets->_vdata_modified = vdata->get_modified(current_thread);
+  return meshlets;
+}
+
+/**
+ * Returns true if the meshlets still describe the indicated Geom, or false if
+ * it or its vertices have been modified since the meshlets were made.
+ */
+bool GeomMeshlets::
+is_valid(const Geom *geom, Thread *current_thread) const {
+  return geom->get_modified(current_thread) == _geom_modified &&
+    geom->get_vertex_data(current_thread)->get_modified(current_thread) == _vdata_modified;
+}
+
+/**
+ * Returns the part of the indicated Geom that consists of the meshlets that
+ * are within the indicated view frustum, which should be given in the
+ * coordinate space of the Geom.  If eye is not nullptr, the meshlets whose
+ * triangles all face away from that point are also removed.
+ *
+ * Returns the Geom itself if all of the meshlets are visible, or nullptr if
+ * none are.  num_culled is filled in with the number of meshlets removed.
+ */
+CPT(Geom) GeomMeshlets::
+cull(const Geom *geom, const GeometricBoundingVolume *frustum,
+     const LPoint3 *eye, int &num_culled, Thread *current_thread) const {
+  int num_meshlets = (int)_meshlets.size();
+  int num_visible = 0;
+  int num_visible_indices = 0;
+  BitArray visible;
+
+  for (int n = 0; n < num_meshlets; ++n) {
+    const Meshlet &meshlet = _meshlets[n];
+    if (frustum != nullptr) {
+      BoundingSphere sphere(meshlet._center, meshlet._radius);
+      if (frustum->contains(&sphere) == BoundingVolume::IF_no_intersection) {
+        continue;
+      }
+    }
+    if (eye != nullptr) {
+      LVector3 to_center = meshlet._center - *eye;
+      if (to_center.dot(meshlet._cone_axis) >=
+          meshlet._cone_cutoff * to_center.length() + meshlet._radius) {
+        continue;
+      }
+    }
+    visible.set_bit(n);
+    ++num_visible;
+    num_visible_indices += meshlet._num_indices;
+  }
+
+  num_culled = num_meshlets - num_visible;
+  if (num_culled == 0) {
+    return geom;
+  }
+  if (num_visible == 0) {
+    return nullptr;
+  }
+
+  LightMutexHolder holder(_lock);
+  ++_use_counter;
+
+  Subset *subset = nullptr;
+  for (Subset &other : _subsets) {
+    if (other._visible == visible) {
+      other._last_used = _use_counter;
+      return other._geom;
+    }
+    if (subset == nullptr || other._last_used < subset->_last_used) {
+      subset = &other;
+    }
+  }
+  if (_subsets.size() < max_subsets) {
+    _subsets.push_back(Subset());
+    subset = &_subsets.back();
+  }
+
+  PT(Geom) result;
+  PT(GeomPrimitive) new_prim;
+  if (subset->_geom != nullptr && subset->_geom->get_ref_count() == 1) {
+    // Nothing is drawing the least recently used subset any more, so rather
+    // than making a new Geom, we can rewrite its index buffer in place.
+    result = (Geom *)subset->_geom.p();
+    new_prim = result->modify_primitive(0);
+  } else {
+    CPT(GeomPrimitive) prim = geom->get_primitive(0);
+    new_prim = new GeomTriangles(UH_dynamic);
+    new_prim->set_shade_model(prim->get_shade_model());
+    new_prim->set_index_type(prim->get_index_type());
+    new_prim->set_vertices(new_prim->make_index_data());
+  }
+
+  // Copy the index ranges of the visible meshlets into the index buffer.
+  // Adjacent meshlets are copied together.
+  {
+    CPT(GeomPrimitive) prim = geom->get_primitive(0);
+    CPT(GeomVertexArrayDataHandle) from = prim->get_vertices()->get_handle(current_thread);
+    PT(GeomVertexArrayDataHandle) to = new_prim->modify_vertices_handle(current_thread);
+    to->unclean_set_num_rows(num_visible_indices);
+
+    size_t stride = prim->get_index_stride();
+    const unsigned char *read_pointer = from->get_read_pointer(true);
+    unsigned char *write_pointer = to->get_write_pointer();
+
+    int n = 0;
+    while (n < num_meshlets) {
+      if (!visible.get_bit(n)) {
+        ++n;
+        continue;
+      }
+      int begin = _meshlets[n]._first_index;
+      int end = begin;
+      while (n < num_meshlets && visible.get_bit(n)) {
+        end = _meshlets[n]._first_index + _meshlets[n]._num_indices;
+        ++n;
+      }
+      memcpy(write_pointer, read_pointer + begin * stride, (end - begin) * stride);
+      write_pointer += (end - begin) * stride;
+    }
+  }
+
+  if (result == nullptr) {
+    result = geom->make_copy();
+    result->set_primitive(0, new_prim);
+    result->set_bounds(geom->get_bounds(current_thread));
+
+    // The subset must not refer back to this object, which holds on to it.
+    result->clear_meshlets();
+  }
+
+  subset->_visible = visible;
+  subset->_geom = result;
+  subset->_last_used = _use_counter;
+  return result;
+}
+
+/**
+ *
+ */
+void GeomMeshlets::
+output(std::ostream &out) const {
+  int num_indices = 0;
+  for (const Meshlet &meshlet : _meshlets) {
+    num_indices += meshlet._num_indices;
+  }
+  out << "GeomMeshlets, " << _meshlets.size() << " meshlets of "
+      << num_indices / 3 << " triangles";
+}
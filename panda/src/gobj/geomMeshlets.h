@@ -0,0 +1,108 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomMeshlets.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef GEOMMESHLETS_H
+#define GEOMMESHLETS_H
+
+#include "pandabase.h"
+#include "geomEnums.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "updateSeq.h"
+#include "bitArray.h"
+#include "lightMutex.h"
+#include "luse.h"
+#include "pvector.h"
+
+class Geom;
+class GeometricBoundingVolume;
+
+/**
+ * This divides the triangles of a large Geom into small clusters of adjacent
+ * triangles, called meshlets, each with its own bounding sphere and a cone
+ * that bounds the normals of its triangles.  It allows the cull traversal to
+ * skip the parts of a Geom that are outside of the view frustum or that face
+ * away from the camera, rather than drawing all of it or none of it.
+ *
+ * Each meshlet is a consecutive range of the index buffer, so the triangles
+ * should already be ordered for locality, which optimize_vertex_cache() does.
+ *
+ * This is created by Geom::make_meshlets().
+ */
+class EXPCL_PANDA_GOBJ GeomMeshlets : public ReferenceCount, public GeomEnums {
+public:
+  GeomMeshlets();
+  ~GeomMeshlets();
+
+  static CPT(GeomMeshlets) make_meshlets(const Geom *geom, int max_vertices,
+                                         int max_triangles,
+                                         Thread *current_thread);
+
+PUBLISHED:
+  INLINE int get_num_meshlets() const;
+  INLINE int get_first_index(int n) const;
+  INLINE int get_num_indices(int n) const;
+  INLINE const LPoint3 &get_center(int n) const;
+  INLINE PN_stdfloat get_radius(int n) const;
+  INLINE const LVector3 &get_cone_axis(int n) const;
+  INLINE PN_stdfloat get_cone_cutoff(int n) const;
+
+  void output(std::ostream &out) const;
+
+public:
+  bool is_valid(const Geom *geom, Thread *current_thread) const;
+
+  CPT(Geom) cull(const Geom *geom, const GeometricBoundingVolume *frustum,
+                 const LPoint3 *eye, int &num_culled,
+                 Thread *current_thread) const;
+
+private:
+  class Meshlet {
+  public:
+    int _first_index;
+    int _num_indices;
+    LPoint3 _center;
+    PN_stdfloat _radius;
+    LVector3 _cone_axis;
+    PN_stdfloat _cone_cutoff;
+  };
+  typedef pvector<Meshlet> Meshlets;
+  Meshlets _meshlets;
+
+  // The Geom and its vertex data must not have changed since the meshlets
+  // were computed.
+  UpdateSeq _geom_modified;
+  UpdateSeq _vdata_modified;
+
+  // The most recently drawn subsets of the Geom, which are usually the same
+  // from one frame to the next.  There are several, so that a Geom that is
+  // seen by more than one camera doesn't have to be rebuilt for each.
+  class Subset {
+  public:
+    BitArray _visible;
+    CPT(Geom) _geom;
+    int _last_used;
+  };
+  typedef pvector<Subset> Subsets;
+  enum { max_subsets = 4 };
+
+  mutable LightMutex _lock;
+  mutable Subsets _subsets;
+  mutable int _use_counter;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const GeomMeshlets &obj);
+
+#include "geomMeshlets.I"
+
+#endif
@@ -42,6 +42,7 @@ PStatCollector GeomPrimitive::_decompose_pcollector("*:Munge:Decompose");
 PStatCollector GeomPrimitive::_doubleside_pcollector("*:Munge:Doubleside");
 PStatCollector GeomPrimitive::_reverse_pcollector("*:Munge:Reverse");
 PStatCollector GeomPrimitive::_rotate_pcollector("*:Munge:Rotate");
+PStatCollector GeomPrimitive::_optimize_vertex_cache_pcollector("*:Munge:Optimize vertex cache");
 
 /**
  * Constructs an invalid object.  Only used when reading from bam.
@@ -1049,6 +1050,61 @@ make_adjacency() const {
   return nullptr;
 }
 
+/**
+ * Returns a new primitive with the same triangles in a different order,
+ * chosen so that the vertices are more likely to be found in the post-
+ * transform vertex cache of the graphics card when they are reused.  The
+ * winding order and provoking vertex of each triangle are preserved.
+ *
+ * cache_size is the number of vertices assumed to fit in the cache; if it is
+ * 0, the value of the vertex-cache-size config variable is used.  If
+ * vertex_data is given, the triangles are furthermore grouped into clusters
+ * that are sorted so that the ones facing outward from the center of the
+ * model are drawn first, which tends to reduce overdraw.  This may change the
+ * average cache miss ratio slightly, in either direction.
+ *
+ * This only has an effect on indexed triangles; other primitive types, for
+ * instance triangle strips, are returned unchanged, and may be decomposed
+ * first.
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache(int cache_size, const GeomVertexData *vertex_data) const {
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Optimizing vertex cache for " << get_type() << ": " << (void *)this << "\n";
+  }
+
+  if (cache_size <= 0) {
+    cache_size = vertex_cache_size;
+  }
+
+  PStatTimer timer(_optimize_vertex_cache_pcollector);
+  return optimize_vertex_cache_impl(std::max(cache_size, 3), vertex_data);
+}
+
+/**
+ * Returns the average cache miss ratio of the primitive: the average number
+ * of vertices that have to be transformed for each triangle (or other face)
+ * when the primitive is drawn, given a FIFO vertex cache of the indicated
+ * size.  The result is between 0.5 (for a very large mesh that is ideally
+ * ordered) and 3 (for disconnected triangles).
+ *
+ * If cache_size is 0, the value of the vertex-cache-size config variable is
+ * used.  Returns 0 if the primitive has no faces.
+ */
+PN_stdfloat GeomPrimitive::
+calc_acmr(int cache_size) const {
+  int num_faces = get_num_faces();
+  if (num_faces == 0) {
+    return 0.0f;
+  }
+
+  if (cache_size <= 0) {
+    cache_size = vertex_cache_size;
+  }
+  return (PN_stdfloat)calc_vertex_cache_misses(cache_size) / (PN_stdfloat)num_faces;
+}
+
 /**
  * Returns the number of bytes consumed by the primitive and its index
  * table(s).
@@ -1811,6 +1867,49 @@ calc_sphere_radius(const LPoint3 &center, PN_stdfloat &sq_radius,
   }
 }
 
+/**
+ * Returns the number of vertices that miss a FIFO vertex cache of the
+ * indicated size when the vertices of this primitive are processed in order.
+ * This is the numerator of calc_acmr().
+ */
+int GeomPrimitive::
+calc_vertex_cache_misses(int cache_size) const {
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader reader(this, current_thread);
+
+  int num_vertices = reader.get_num_vertices();
+  if (!reader.is_indexed()) {
+    // Every vertex is used only once.
+    return num_vertices;
+  }
+  if (num_vertices == 0) {
+    return 0;
+  }
+
+  // Rather than keeping a list of the cached vertices, we store the time at
+  // which each vertex last entered the cache, where the time is the number of
+  // misses so far.  A vertex is still in the cache if fewer than cache_size
+  // vertices have entered it since.
+  reader.check_minmax();
+  int strip_cut_index = reader.get_strip_cut_index();
+  pvector<int> cache_time(reader.get_max_vertex() + 1, -cache_size - 1);
+  int num_misses = 0;
+
+  for (int i = 0; i < num_vertices; ++i) {
+    int vertex = reader.get_vertex(i);
+    if (vertex == strip_cut_index || vertex < 0) {
+      continue;
+    }
+    nassertr(vertex < (int)cache_time.size(), num_misses);
+    if (num_misses - cache_time[vertex] > cache_size) {
+      cache_time[vertex] = num_misses;
+      ++num_misses;
+    }
+  }
+
+  return num_misses;
+}
+
 /**
  * Decomposes a complex primitive type into a simpler primitive type, for
  * instance triangle strips to triangles, and returns a pointer to the new
@@ -1852,6 +1951,14 @@ reverse_impl() const {
   return this;
 }
 
+/**
+ * The virtual implementation of optimize_vertex_cache().
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache_impl(int, const GeomVertexData *) const {
+  return this;
+}
+
 /**
  * Should be redefined to return true in any primitive that implements
  * append_unused_vertices().
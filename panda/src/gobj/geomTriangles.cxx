@@ -326,6 +326,231 @@ rotate_impl() const {
   return new_vertices;
 }
 
+/**
+ * The virtual implementation of optimize_vertex_cache().  This uses the
+ * Tipsify algorithm, by Sander, Nehab and Barczak, which emits the triangles
+ * around one vertex at a time, choosing as the next vertex a neighbor that is
+ * still in the cache and whose remaining triangles will fit in it.
+ *
+ * When the algorithm runs out of such neighbors and has to continue with a
+ * vertex that is no longer in the cache, the triangles emitted so far form a
+ * cluster.  A FIFO cache still holds some of the last vertices of one
+ * cluster when the next one starts, and a cluster may share some of those,
+ * so changing the order of the clusters does affect the cache efficiency, but
+ * only at the boundaries between clusters; on a 32x32 grid, the ACMR stays
+ * within 0.1% either way.  If vertex_data is given, we use this freedom to
+ * draw the clusters that face away from the center of the model first, since
+ * these are most likely to occlude the others.
+ */
+CPT(GeomPrimitive) GeomTriangles::
+optimize_vertex_cache_impl(int cache_size, const GeomVertexData *vertex_data) const {
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader from(this, current_thread);
+  if (!from.is_indexed()) {
+    // Every vertex is used only once, so there is nothing to gain.
+    return this;
+  }
+
+  int num_triangles = from.get_num_vertices() / 3;
+  if (num_triangles < 2) {
+    return this;
+  }
+
+  from.check_minmax();
+  int num_rows = from.get_max_vertex() + 1;
+
+  pvector<int> indices;
+  indices.reserve(num_triangles * 3);
+  for (int i = 0; i < num_triangles * 3; ++i) {
+    indices.push_back(from.get_vertex(i));
+  }
+
+  // Build the list of triangles that use each vertex.  live[v] is the number
+  // of those triangles that have not yet been emitted.
+  pvector<int> live(num_rows, 0);
+  for (int index : indices) {
+    ++live[index];
+  }
+  pvector<int> offsets(num_rows + 1, 0);
+  for (int v = 0; v < num_rows; ++v) {
+    offsets[v + 1] = offsets[v] + live[v];
+  }
+  pvector<int> adjacency(indices.size());
+  {
+    pvector<int> fill(offsets);
+    for (int i = 0; i < num_triangles * 3; ++i) {
+      adjacency[fill[indices[i]]++] = i / 3;
+    }
+  }
+
+  // The time at which each vertex last entered the cache, measured in cache
+  // misses, as in calc_vertex_cache_misses().
+  pvector<int> cache_time(num_rows, -cache_size - 1);
+  int time = 0;
+
+  pvector<bool> emitted(num_triangles, false);
+  pvector<int> dead_end;
+  dead_end.reserve(indices.size());
+  pvector<int> candidates;
+
+  pvector<int> order;
+  order.reserve(num_triangles);
+  pvector<int> cluster_starts;
+  cluster_starts.push_back(0);
+
+  int cursor = 0;
+  int fanning = indices[0];
+  while (fanning >= 0) {
+    candidates.clear();
+    for (int ai = offsets[fanning]; ai < offsets[fanning + 1]; ++ai) {
+      int tri = adjacency[ai];
+      if (emitted[tri]) {
+        continue;
+      }
+      emitted[tri] = true;
+      order.push_back(tri);
+      for (int j = 0; j < 3; ++j) {
+        int v = indices[tri * 3 + j];
+        dead_end.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        if (time - cache_time[v] > cache_size) {
+          cache_time[v] = time;
+          ++time;
+        }
+      }
+    }
+
+    // Choose the next vertex to fan around among the vertices we just
+    // emitted.  We prefer the one that entered the cache the longest ago, as
+    // long as its remaining triangles will still find it there.
+    fanning = -1;
+    int best_priority = -1;
+    for (int v : candidates) {
+      if (live[v] > 0) {
+        int priority = 0;
+        if (time - cache_time[v] + 2 * live[v] <= cache_size) {
+          priority = time - cache_time[v];
+        }
+        if (priority > best_priority) {
+          best_priority = priority;
+          fanning = v;
+        }
+      }
+    }
+
+    if (fanning < 0) {
+      // A dead end.  Try the most recently used vertices that still have
+      // triangles left, and failing that, just take the next vertex in
+      // sequence.
+      while (!dead_end.empty() && fanning < 0) {
+        int v = dead_end.back();
+        dead_end.pop_back();
+        if (live[v] > 0) {
+          fanning = v;
+        }
+      }
+      while (fanning < 0 && cursor < num_rows) {
+        if (live[cursor] > 0) {
+          fanning = cursor;
+        } else {
+          ++cursor;
+        }
+      }
+      if (fanning >= 0 && time - cache_time[fanning] > cache_size) {
+        cluster_starts.push_back((int)order.size());
+      }
+    }
+  }
+  nassertr((int)order.size() == num_triangles, this);
+  cluster_starts.push_back(num_triangles);
+
+  if (vertex_data != nullptr && cluster_starts.size() > 3 &&
+      vertex_data->get_num_rows() >= num_rows &&
+      vertex_data->has_column(InternalName::get_vertex())) {
+    // Sort the clusters to reduce overdraw.  For each cluster, we compute its
+    // area-weighted center and normal, and how far it lies in front of the
+    // center of the whole model along that normal.
+    int num_clusters = (int)cluster_starts.size() - 1;
+    pvector<LPoint3> points(num_rows);
+    {
+      GeomVertexReader vertex(vertex_data, InternalName::get_vertex(), current_thread);
+      for (int v = 0; v < num_rows; ++v) {
+        points[v] = vertex.get_data3();
+      }
+    }
+
+    pvector<LPoint3> centers(num_clusters, LPoint3::zero());
+    pvector<LVector3> normals(num_clusters, LVector3::zero());
+    pvector<PN_stdfloat> areas(num_clusters, 0);
+    LPoint3 model_center = LPoint3::zero();
+    PN_stdfloat model_area = 0;
+
+    for (int ci = 0; ci < num_clusters; ++ci) {
+      for (int oi = cluster_starts[ci]; oi < cluster_starts[ci + 1]; ++oi) {
+        const int *tri = &indices[order[oi] * 3];
+        const LPoint3 &p0 = points[tri[0]];
+        const LPoint3 &p1 = points[tri[1]];
+        const LPoint3 &p2 = points[tri[2]];
+        LVector3 normal = (p1 - p0).cross(p2 - p0);
+        PN_stdfloat area = normal.length();
+        centers[ci] += (p0 + p1 + p2) * (area / 3);
+        normals[ci] += normal;
+        areas[ci] += area;
+      }
+      model_center += centers[ci];
+      model_area += areas[ci];
+    }
+
+    if (model_area > 0) {
+      model_center /= model_area;
+
+      pvector<std::pair<PN_stdfloat, int> > keys;
+      keys.reserve(num_clusters);
+      for (int ci = 0; ci < num_clusters; ++ci) {
+        PN_stdfloat key = 0;
+        if (areas[ci] > 0 && normals[ci].normalize()) {
+          key = (centers[ci] / areas[ci] - model_center).dot(normals[ci]);
+        }
+        keys.push_back(std::pair<PN_stdfloat, int>(-key, ci));
+      }
+      std::stable_sort(keys.begin(), keys.end());
+
+      pvector<int> sorted_order;
+      sorted_order.reserve(num_triangles);
+      for (const std::pair<PN_stdfloat, int> &key : keys) {
+        sorted_order.insert(sorted_order.end(),
+                            order.begin() + cluster_starts[key.second],
+                            order.begin() + cluster_starts[key.second + 1]);
+      }
+      order.swap(sorted_order);
+    }
+  }
+
+  bool any_changed = false;
+  for (int i = 0; i < num_triangles && !any_changed; ++i) {
+    any_changed = (order[i] != i);
+  }
+  if (!any_changed) {
+    return this;
+  }
+
+  PT(GeomVertexArrayData) new_vertices = make_index_data();
+  new_vertices->unclean_set_num_rows(num_triangles * 3);
+  {
+    GeomVertexWriter to(new_vertices, 0, current_thread);
+    for (int tri : order) {
+      to.set_data1i(indices[tri * 3]);
+      to.set_data1i(indices[tri * 3 + 1]);
+      to.set_data1i(indices[tri * 3 + 2]);
+    }
+  }
+
+  PT(GeomPrimitive) new_prim = make_copy();
+  new_prim->set_vertices(new_vertices);
+  return new_prim;
+}
+
 /**
  * Tells the BamReader how to create objects of type Geom.
  */
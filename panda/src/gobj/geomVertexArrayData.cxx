@@ -24,6 +24,8 @@
 #include "simpleAllocator.h"
 #include "vertexDataBuffer.h"
 #include "pbitops.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
 
 using std::max;
 using std::min;
@@ -409,9 +411,68 @@ write_datagram(BamWriter *manager, Datagram &dg) {
   CopyOnWriteObject::write_datagram(manager, dg);
 
   manager->write_pointer(dg, _array_format);
+
+  CPT(GeomVertexArrayFormat) bam_format =
+    _array_format->get_bam_compatible_format(manager->get_file_minor_ver());
+  if (bam_format != _array_format) {
+    // The format will be written with some columns replaced by ones that the
+    // older bam version supports, so we have to write the data in that layout
+    // as well.
+    PT(GeomVertexArrayData) converted = convert_for_bam(bam_format);
+    manager->write_cdata(dg, converted->_cycler, converted);
+    return;
+  }
+
   manager->write_cdata(dg, _cycler, this);
 }
 
+/**
+ * Returns a copy of the array's data in the indicated format, which must have
+ * been returned by GeomVertexArrayFormat::get_bam_compatible_format().  The
+ * columns are expected to be in the same order.
+ */
+PT(GeomVertexArrayData) GeomVertexArrayData::
+convert_for_bam(const GeomVertexArrayFormat *format) const {
+  int num_rows = get_num_rows();
+  PT(GeomVertexArrayData) converted = new GeomVertexArrayData(format, get_usage_hint());
+  converted->unclean_set_num_rows(num_rows);
+
+  int num_columns = _array_format->get_num_columns();
+  nassertr(num_columns == format->get_num_columns(), converted);
+
+  CPT(GeomVertexArrayDataHandle) from_handle = get_handle();
+  const unsigned char *from_data = from_handle->get_read_pointer(true);
+  int from_stride = _array_format->get_stride();
+  int to_stride = format->get_stride();
+
+  for (int ci = 0; ci < num_columns; ++ci) {
+    const GeomVertexColumn *from_column = _array_format->get_column(ci);
+    const GeomVertexColumn *to_column = format->get_column(ci);
+
+    if (from_column->get_numeric_type() == to_column->get_numeric_type()) {
+      // This column is unchanged; just copy the bytes.
+      PT(GeomVertexArrayDataHandle) to_handle = converted->modify_handle();
+      unsigned char *to_data = to_handle->get_write_pointer();
+      const unsigned char *from = from_data + from_column->get_start();
+      unsigned char *to = to_data + to_column->get_start();
+      size_t num_bytes = from_column->get_total_bytes();
+      for (int i = 0; i < num_rows; ++i) {
+        memcpy(to, from, num_bytes);
+        from += from_stride;
+        to += to_stride;
+      }
+    } else {
+      GeomVertexReader reader(this, ci);
+      GeomVertexWriter writer(converted, ci);
+      for (int i = 0; i < num_rows; ++i) {
+        writer.set_data4(reader.get_data4());
+      }
+    }
+  }
+
+  return converted;
+}
+
 /**
  * Called by CData::fillin to read the raw data of the array from the
  * indicated datagram.
@@ -532,6 +593,24 @@ write_datagram(BamWriter *manager, Datagram &dg, void *extra_data) const {
 
   dg.add_uint32(_buffer.get_size());
 
+  if (manager->get_file_minor_ver() >= 47) {
+    // Large arrays are written as a separate payload, which the reader may
+    // be able to use directly from the file.
+    bool as_payload = manager->should_write_payload(_buffer.get_size());
+    dg.add_bool(as_payload);
+
+    if (as_payload) {
+      if (manager->get_file_endian() == BamWriter::BE_native) {
+        manager->write_payload(_buffer.get_read_pointer(true), _buffer.get_size());
+      } else {
+        vector_uchar new_data(_buffer.get_size());
+        array_data->reverse_data_endianness(new_data.data(), _buffer.get_read_pointer(true), _buffer.get_size());
+        manager->write_payload(new_data.data(), new_data.size());
+      }
+      return;
+    }
+  }
+
   if (manager->get_file_endian() == BamWriter::BE_native) {
     // For native endianness, we only have to write the data directly.
     dg.append_data(_buffer.get_read_pointer(true), _buffer.get_size());
@@ -562,15 +641,32 @@ fillin(DatagramIterator &scan, BamReader *manager, void *extra_data) {
     memcpy(_buffer.get_write_pointer(), &new_data[0], new_data.size());
 
   } else {
-    // Now, the array data is just stored directly.
+    // Now, the array data is just stored directly, or as a payload record
+    // that may be a view into the memory-mapped file.
     size_t size = scan.get_uint32();
-    _buffer.unclean_realloc(size);
-    _buffer.set_size(size);
+    bool as_payload = false;
+    if (manager->get_file_minor_ver() >= 47) {
+      as_payload = scan.get_bool();
+    }
+
+    if (as_payload) {
+      CPT(FileData) data = manager->read_payload();
+      if (data == nullptr || data->get_size() != size) {
+        gobj_cat.error()
+          << "Vertex data payload is missing or has the wrong size.\n";
+        _buffer.clear();
+      } else {
+        _buffer.set_mapped_data(data);
+      }
+    } else {
+      _buffer.unclean_realloc(size);
+      _buffer.set_size(size);
 
-    const unsigned char *source_data =
-      (const unsigned char *)scan.get_datagram().get_data();
-    memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
-    scan.skip_bytes(size);
+      const unsigned char *source_data =
+        (const unsigned char *)scan.get_datagram().get_data();
+      memcpy(_buffer.get_write_pointer(), source_data + scan.get_current_index(), size);
+      scan.skip_bytes(size);
+    }
   }
 
   bool endian_reversed = false;
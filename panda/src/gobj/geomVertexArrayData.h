@@ -129,6 +129,7 @@ private:
   void clear_prepared(PreparedGraphicsObjects *prepared_objects);
   void reverse_data_endianness(unsigned char *dest,
                                const unsigned char *source, size_t size);
+  PT(GeomVertexArrayData) convert_for_bam(const GeomVertexArrayFormat *format) const;
 
 
   CPT(GeomVertexArrayFormat) _array_format;
@@ -579,9 +579,15 @@ get_format_string(bool pad) const {
     case NT_uint32:
     case NT_packed_dcba:
     case NT_packed_dabc:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
       fmt_code = 'I';
       break;
 
+    case NT_float16:
+      fmt_code = 'e';
+      break;
+
     case NT_float32:
       fmt_code = 'f';
       break;
@@ -721,12 +727,65 @@ register_with_read_factory() {
   BamReader::get_factory()->register_factory(get_class_type(), make_from_bam);
 }
 
+/**
+ * Returns a format that can be written to a bam file of the indicated minor
+ * version.  Bam files older than 6.46 can't store the numeric types
+ * NT_float16, NT_packed_snorm10 and NT_packed_oct16, so these columns are
+ * replaced with NT_float32 columns of the same number of values, and the
+ * other columns are packed around them.  If the format has no such columns,
+ * it is returned unchanged.
+ */
+CPT(GeomVertexArrayFormat) GeomVertexArrayFormat::
+get_bam_compatible_format(int file_minor_ver) const {
+  if (file_minor_ver >= 46) {
+    return this;
+  }
+
+  consider_sort_columns();
+
+  bool any_converted = false;
+  for (const GeomVertexColumn *column : _columns) {
+    if (column->get_numeric_type() >= NT_float16) {
+      any_converted = true;
+      break;
+    }
+  }
+  if (!any_converted) {
+    return this;
+  }
+
+  PT(GeomVertexArrayFormat) format = new GeomVertexArrayFormat;
+  format->set_pad_to(_pad_to);
+  format->set_divisor(_divisor);
+  for (const GeomVertexColumn *column : _columns) {
+    if (column->get_numeric_type() >= NT_float16) {
+      format->add_column(column->get_name(), column->get_num_values(),
+                         NT_float32, column->get_contents());
+    } else {
+      format->add_column(column->get_name(), column->get_num_components(),
+                         column->get_numeric_type(), column->get_contents(),
+                         -1, column->get_column_alignment());
+    }
+  }
+  return register_format(format);
+}
+
 /**
  * Writes the contents of this object to the datagram for shipping out to a
  * Bam file.
  */
 void GeomVertexArrayFormat::
 write_datagram(BamWriter *manager, Datagram &dg) {
+  if (manager->get_file_minor_ver() < 46) {
+    // Write a layout that the older version can read instead.
+    // GeomVertexArrayData converts its data to match.
+    CPT(GeomVertexArrayFormat) compat = get_bam_compatible_format(manager->get_file_minor_ver());
+    if (compat != this) {
+      ((GeomVertexArrayFormat *)compat.p())->write_datagram(manager, dg);
+      return;
+    }
+  }
+
   TypedWritableReferenceCount::write_datagram(manager, dg);
 
   dg.add_uint16(_stride);
@@ -123,6 +123,8 @@ PUBLISHED:
 public:
   int compare_to(const GeomVertexArrayFormat &other) const;
 
+  CPT(GeomVertexArrayFormat) get_bam_compatible_format(int file_minor_ver) const;
+
   static const GeomVertexArrayFormat *get_instance_array_format();
 
 private:
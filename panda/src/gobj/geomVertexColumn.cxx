@@ -134,8 +134,14 @@ output(std::ostream &out) const {
     out << "d";
     break;
 
+  case NT_float16:
+    out << "h";
+    break;
+
   case NT_stdfloat:
   case NT_packed_ufloat:
+  case NT_packed_snorm10:
+  case NT_packed_oct16:
     out << "?";
     break;
   }
@@ -200,9 +206,19 @@ setup() {
     break;
 
   case NT_packed_ufloat:
+  case NT_packed_oct16:
     _component_bytes = 4;  // sizeof(uint32_t)
     _num_values *= 3;
     break;
+
+  case NT_float16:
+    _component_bytes = 2;  // sizeof(uint16_t)
+    break;
+
+  case NT_packed_snorm10:
+    _component_bytes = 4;  // sizeof(uint32_t)
+    _num_values *= 4;
+    break;
   }
 
   if (_num_elements == 0) {
@@ -239,6 +255,34 @@ setup() {
  */
 GeomVertexColumn::Packer *GeomVertexColumn::
 make_packer() const {
+  // The quantized types are always decoded to floats first, so they have
+  // their own packers that take care of the contents themselves.
+  switch (get_numeric_type()) {
+  case NT_float16:
+    if (get_num_components() > 4) {
+      gobj_cat.error()
+        << "GeomVertexColumn with type NT_float16 must have 1 to 4 components!\n";
+    }
+    return new Packer_float16;
+
+  case NT_packed_snorm10:
+    if (get_num_components() != 1) {
+      gobj_cat.error()
+        << "GeomVertexColumn with type NT_packed_snorm10 must have 1 component!\n";
+    }
+    return new Packer_snorm10;
+
+  case NT_packed_oct16:
+    if (get_num_components() != 1) {
+      gobj_cat.error()
+        << "GeomVertexColumn with type NT_packed_oct16 must have 1 component!\n";
+    }
+    return new Packer_oct16;
+
+  default:
+    break;
+  }
+
   switch (get_contents()) {
   case C_point:
   case C_clip_point:
@@ -383,6 +427,12 @@ void GeomVertexColumn::
 write_datagram(BamWriter *manager, Datagram &dg) {
   manager->write_pointer(dg, _name);
   dg.add_uint8(_num_components);
+
+  if (_numeric_type >= NT_float16 && manager->get_file_minor_ver() < 46) {
+    // GeomVertexArrayFormat should have replaced this column with one that
+    // the older version can read; see get_bam_compatible_format().
+    nassert_raise("numeric type requires bam version 6.46");
+  }
   dg.add_uint8(_numeric_type);
 
   if (_contents == C_normal && manager->get_file_minor_ver() < 38) {
@@ -595,6 +645,12 @@ get_data2f(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v2);
       return _v2;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v2);
+      break;
     }
   }
 
@@ -706,6 +762,12 @@ get_data3f(const unsigned char *pointer) {
                 GeomVertexData::unpack_ufloat_c(dword));
       }
       return _v3;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v3);
+      break;
     }
   }
 
@@ -821,6 +883,12 @@ get_data4f(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4);
+      break;
     }
   }
 
@@ -878,6 +946,12 @@ get_data1d(const unsigned char *pointer) {
       uint32_t dword = *(const uint32_t *)pointer;
       return GeomVertexData::unpack_ufloat_a(dword);
     }
+
+  case NT_float16:
+  case NT_packed_snorm10:
+  case NT_packed_oct16:
+    nassertr(false, 0.0);
+    break;
   }
 
   return 0.0;
@@ -973,6 +1047,12 @@ get_data2d(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v2d);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v2d);
+      break;
     }
   }
 
@@ -1084,6 +1164,12 @@ get_data3d(const unsigned char *pointer) {
                  GeomVertexData::unpack_ufloat_c(dword));
       }
       return _v3d;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v3d);
+      break;
     }
   }
 
@@ -1199,6 +1285,12 @@ get_data4d(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4d);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4d);
+      break;
     }
   }
 
@@ -1256,6 +1348,12 @@ get_data1i(const unsigned char *pointer) {
       uint32_t dword = *(const uint32_t *)pointer;
       return (int)GeomVertexData::unpack_ufloat_a(dword);
     }
+
+  case NT_float16:
+  case NT_packed_snorm10:
+  case NT_packed_oct16:
+    nassertr(false, 0);
+    break;
   }
 
   return 0;
@@ -1349,6 +1447,12 @@ get_data2i(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v2i);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v2i);
+      break;
     }
   }
 
@@ -1457,6 +1561,12 @@ get_data3i(const unsigned char *pointer) {
                  (int)GeomVertexData::unpack_ufloat_c(dword));
       }
       return _v3i;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v3i);
+      break;
     }
   }
 
@@ -1569,6 +1679,12 @@ get_data4i(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4i);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4i);
+      break;
     }
   }
 
@@ -1627,6 +1743,11 @@ set_data1f(unsigned char *pointer, float data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -1732,6 +1853,11 @@ set_data2f(unsigned char *pointer, const LVecBase2f &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -1845,6 +1971,11 @@ set_data3f(unsigned char *pointer, const LVecBase3f &data) {
     case NT_packed_ufloat:
       *(uint32_t *)pointer = GeomVertexData::pack_ufloat(data[0], data[1], data[2]);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -1969,6 +2100,11 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
   }
@@ -2026,6 +2162,11 @@ set_data1d(unsigned char *pointer, double data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -2130,6 +2271,11 @@ set_data2d(unsigned char *pointer, const LVecBase2d &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -2243,6 +2389,11 @@ set_data3d(unsigned char *pointer, const LVecBase3d &data) {
     case NT_packed_ufloat:
       *(uint32_t *)pointer = GeomVertexData::pack_ufloat(data[0], data[1], data[2]);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -2367,6 +2518,11 @@ set_data4d(unsigned char *pointer, const LVecBase4d &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
   }
@@ -2428,6 +2584,11 @@ set_data1i(unsigned char *pointer, int data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -2530,6 +2691,11 @@ set_data2i(unsigned char *pointer, const LVecBase2i &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -2640,6 +2806,11 @@ set_data3i(unsigned char *pointer, const LVecBase3i &data) {
     case NT_packed_ufloat:
       *(uint32_t *)pointer = GeomVertexData::pack_ufloat(data[0], data[1], data[2]);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
 
@@ -2761,6 +2932,11 @@ set_data4i(unsigned char *pointer, const LVecBase4i &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
   }
@@ -2916,6 +3092,12 @@ get_data4f(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4);
+      break;
     }
   }
 
@@ -3072,6 +3254,12 @@ get_data4d(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4d);
       break;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4d);
+      break;
     }
   }
 
@@ -3229,6 +3417,11 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
   }
@@ -3385,6 +3578,11 @@ set_data4d(unsigned char *pointer, const LVecBase4d &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
     break;
   }
@@ -3511,6 +3709,12 @@ get_data3f(const unsigned char *pointer) {
                 GeomVertexData::unpack_ufloat_c(dword));
       }
       return _v3;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v3);
+      break;
     }
   } else {
     const LVecBase4f &v4 = get_data4f(pointer);
@@ -3599,6 +3803,12 @@ get_data4f(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4);
       return _v4;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4);
+      break;
     }
   }
 
@@ -3726,6 +3936,12 @@ get_data3d(const unsigned char *pointer) {
                  GeomVertexData::unpack_ufloat_c(dword));
       }
       return _v3d;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v3d);
+      break;
     }
   } else {
     const LVecBase4d &v4 = get_data4d(pointer);
@@ -3814,6 +4030,12 @@ get_data4d(const unsigned char *pointer) {
     case NT_packed_ufloat:
       nassertr(false, _v4d);
       return _v4d;
+
+    case NT_float16:
+    case NT_packed_snorm10:
+    case NT_packed_oct16:
+      nassertr(false, _v4d);
+      break;
     }
   }
 
@@ -3925,6 +4147,11 @@ set_data3f(unsigned char *pointer, const LVecBase3f &data) {
     case NT_packed_ufloat:
       *(uint32_t *)pointer = GeomVertexData::pack_ufloat(data[0], data[1], data[2]);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
   } else {
     set_data4f(pointer, LVecBase4f(data[0], data[1], data[2], 1.0f));
@@ -4019,6 +4246,11 @@ set_data4f(unsigned char *pointer, const LVecBase4f &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
   }
 }
@@ -4128,6 +4360,11 @@ set_data3d(unsigned char *pointer, const LVecBase3d &data) {
     case NT_packed_ufloat:
       *(uint32_t *)pointer = GeomVertexData::pack_ufloat(data[0], data[1], data[2]);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
   } else {
     set_data4d(pointer, LVecBase4d(data[0], data[1], data[2], 1.0f));
@@ -4222,6 +4459,11 @@ set_data4d(unsigned char *pointer, const LVecBase4d &data) {
     case NT_packed_ufloat:
       nassertv(false);
       break;
+      case NT_float16:
+      case NT_packed_snorm10:
+      case NT_packed_oct16:
+              nassertv(false);
+        break;
     }
   }
 }
@@ -4554,3 +4796,291 @@ set_data1i(unsigned char *pointer, int data) {
   *(uint16_t *)pointer = data;
   nassertv(*(uint16_t *)pointer == data);
 }
+
+/**
+ * Returns the first three components, divided by the fourth if the column
+ * stores a homogeneous point with four values.
+ */
+const LVecBase3f &GeomVertexColumn::Packer_decoded::
+get_divided(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  if (_column->get_num_values() == 4 && is_homogeneous()) {
+    _v3.set(_v4[0] / _v4[3], _v4[1] / _v4[3], _v4[2] / _v4[3]);
+  } else {
+    _v3.set(_v4[0], _v4[1], _v4[2]);
+  }
+  return _v3;
+}
+
+/**
+ *
+ */
+float GeomVertexColumn::Packer_decoded::
+get_data1f(const unsigned char *pointer) {
+  return get_divided(pointer)[0];
+}
+
+/**
+ *
+ */
+const LVecBase2f &GeomVertexColumn::Packer_decoded::
+get_data2f(const unsigned char *pointer) {
+  const LVecBase3f &v3 = get_divided(pointer);
+  _v2.set(v3[0], v3[1]);
+  return _v2;
+}
+
+/**
+ *
+ */
+const LVecBase3f &GeomVertexColumn::Packer_decoded::
+get_data3f(const unsigned char *pointer) {
+  return get_divided(pointer);
+}
+
+/**
+ *
+ */
+const LVecBase4f &GeomVertexColumn::Packer_decoded::
+get_data4f(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  return _v4;
+}
+
+/**
+ *
+ */
+double GeomVertexColumn::Packer_decoded::
+get_data1d(const unsigned char *pointer) {
+  return get_divided(pointer)[0];
+}
+
+/**
+ *
+ */
+const LVecBase2d &GeomVertexColumn::Packer_decoded::
+get_data2d(const unsigned char *pointer) {
+  const LVecBase3f &v3 = get_divided(pointer);
+  _v2d.set(v3[0], v3[1]);
+  return _v2d;
+}
+
+/**
+ *
+ */
+const LVecBase3d &GeomVertexColumn::Packer_decoded::
+get_data3d(const unsigned char *pointer) {
+  const LVecBase3f &v3 = get_divided(pointer);
+  _v3d.set(v3[0], v3[1], v3[2]);
+  return _v3d;
+}
+
+/**
+ *
+ */
+const LVecBase4d &GeomVertexColumn::Packer_decoded::
+get_data4d(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  _v4d.set(_v4[0], _v4[1], _v4[2], _v4[3]);
+  return _v4d;
+}
+
+/**
+ *
+ */
+int GeomVertexColumn::Packer_decoded::
+get_data1i(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  return (int)_v4[0];
+}
+
+/**
+ *
+ */
+const LVecBase2i &GeomVertexColumn::Packer_decoded::
+get_data2i(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  _v2i.set((int)_v4[0], (int)_v4[1]);
+  return _v2i;
+}
+
+/**
+ *
+ */
+const LVecBase3i &GeomVertexColumn::Packer_decoded::
+get_data3i(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  _v3i.set((int)_v4[0], (int)_v4[1], (int)_v4[2]);
+  return _v3i;
+}
+
+/**
+ *
+ */
+const LVecBase4i &GeomVertexColumn::Packer_decoded::
+get_data4i(const unsigned char *pointer) {
+  decode(pointer, _v4);
+  _v4i.set((int)_v4[0], (int)_v4[1], (int)_v4[2], (int)_v4[3]);
+  return _v4i;
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data1f(unsigned char *pointer, float data) {
+  encode(pointer, LVecBase4f(data, 0.0f, 0.0f, get_missing_w()));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data2f(unsigned char *pointer, const LVecBase2f &data) {
+  encode(pointer, LVecBase4f(data[0], data[1], 0.0f, get_missing_w()));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data3f(unsigned char *pointer, const LVecBase3f &data) {
+  encode(pointer, LVecBase4f(data[0], data[1], data[2], get_missing_w()));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data4f(unsigned char *pointer, const LVecBase4f &data) {
+  encode(pointer, data);
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data1d(unsigned char *pointer, double data) {
+  set_data1f(pointer, (float)data);
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data2d(unsigned char *pointer, const LVecBase2d &data) {
+  set_data2f(pointer, LCAST(float, data));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data3d(unsigned char *pointer, const LVecBase3d &data) {
+  set_data3f(pointer, LCAST(float, data));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data4d(unsigned char *pointer, const LVecBase4d &data) {
+  encode(pointer, LCAST(float, data));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data1i(unsigned char *pointer, int data) {
+  encode(pointer, LVecBase4f((float)data, 0.0f, 0.0f, 0.0f));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data2i(unsigned char *pointer, const LVecBase2i &data) {
+  encode(pointer, LVecBase4f((float)data[0], (float)data[1], 0.0f, 0.0f));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data3i(unsigned char *pointer, const LVecBase3i &data) {
+  encode(pointer, LVecBase4f((float)data[0], (float)data[1], (float)data[2], 0.0f));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_decoded::
+set_data4i(unsigned char *pointer, const LVecBase4i &data) {
+  encode(pointer, LVecBase4f((float)data[0], (float)data[1], (float)data[2], (float)data[3]));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_float16::
+decode(const unsigned char *pointer, LVecBase4f &value) {
+  const uint16_t *pi = (const uint16_t *)pointer;
+  value.set(0.0f, 0.0f, 0.0f, get_missing_w());
+
+  int num_values = std::min(_column->get_num_values(), 4);
+  for (int i = 0; i < num_values; ++i) {
+    value[i] = GeomVertexData::unpack_half(pi[i]);
+  }
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_float16::
+encode(unsigned char *pointer, const LVecBase4f &value) {
+  uint16_t *pi = (uint16_t *)pointer;
+
+  int num_values = std::min(_column->get_num_values(), 4);
+  for (int i = 0; i < num_values; ++i) {
+    pi[i] = GeomVertexData::pack_half(value[i]);
+  }
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_snorm10::
+decode(const unsigned char *pointer, LVecBase4f &value) {
+  uint32_t dword = *(const uint32_t *)pointer;
+  value.set(GeomVertexData::unpack_snorm10_a(dword),
+            GeomVertexData::unpack_snorm10_b(dword),
+            GeomVertexData::unpack_snorm10_c(dword),
+            GeomVertexData::unpack_snorm10_d(dword));
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_snorm10::
+encode(unsigned char *pointer, const LVecBase4f &value) {
+  *(uint32_t *)pointer =
+    GeomVertexData::pack_snorm10(value[0], value[1], value[2], value[3]);
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_oct16::
+decode(const unsigned char *pointer, LVecBase4f &value) {
+  LVecBase3f v3 = GeomVertexData::unpack_oct16(*(const uint32_t *)pointer);
+  value.set(v3[0], v3[1], v3[2], get_missing_w());
+}
+
+/**
+ *
+ */
+void GeomVertexColumn::Packer_oct16::
+encode(unsigned char *pointer, const LVecBase4f &value) {
+  *(uint32_t *)pointer = GeomVertexData::pack_oct16(value[0], value[1], value[2]);
+}
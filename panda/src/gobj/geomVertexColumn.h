@@ -427,7 +427,94 @@ private:
     }
   };
 
+  // This is a specialization on the generic Packer for the quantized numeric
+  // types, which can only be converted to and from floating-point values.  The
+  // subclasses only need to implement decode() and encode(); this class takes
+  // care of the column contents, like Packer_point and Packer_color do.
+  class Packer_decoded : public Packer {
+  public:
+    virtual float get_data1f(const unsigned char *pointer);
+    virtual const LVecBase2f &get_data2f(const unsigned char *pointer);
+    virtual const LVecBase3f &get_data3f(const unsigned char *pointer);
+    virtual const LVecBase4f &get_data4f(const unsigned char *pointer);
+
+    virtual double get_data1d(const unsigned char *pointer);
+    virtual const LVecBase2d &get_data2d(const unsigned char *pointer);
+    virtual const LVecBase3d &get_data3d(const unsigned char *pointer);
+    virtual const LVecBase4d &get_data4d(const unsigned char *pointer);
+
+    virtual int get_data1i(const unsigned char *pointer);
+    virtual const LVecBase2i &get_data2i(const unsigned char *pointer);
+    virtual const LVecBase3i &get_data3i(const unsigned char *pointer);
+    virtual const LVecBase4i &get_data4i(const unsigned char *pointer);
+
+    virtual void set_data1f(unsigned char *pointer, float data);
+    virtual void set_data2f(unsigned char *pointer, const LVecBase2f &data);
+    virtual void set_data3f(unsigned char *pointer, const LVecBase3f &data);
+    virtual void set_data4f(unsigned char *pointer, const LVecBase4f &data);
+
+    virtual void set_data1d(unsigned char *pointer, double data);
+    virtual void set_data2d(unsigned char *pointer, const LVecBase2d &data);
+    virtual void set_data3d(unsigned char *pointer, const LVecBase3d &data);
+    virtual void set_data4d(unsigned char *pointer, const LVecBase4d &data);
+
+    virtual void set_data1i(unsigned char *pointer, int data);
+    virtual void set_data2i(unsigned char *pointer, const LVecBase2i &data);
+    virtual void set_data3i(unsigned char *pointer, const LVecBase3i &data);
+    virtual void set_data4i(unsigned char *pointer, const LVecBase4i &data);
+
+    virtual const char *get_name() const {
+      return "Packer_decoded";
+    }
+
+  protected:
+    // Fills in all four components; the ones not stored in the data are set
+    // as get_data4f() would return them for an unquantized column.
+    virtual void decode(const unsigned char *pointer, LVecBase4f &value)=0;
+
+    // Stores as many of the components as the column has values.
+    virtual void encode(unsigned char *pointer, const LVecBase4f &value)=0;
+
+    INLINE bool is_homogeneous() const;
+    INLINE float get_missing_w() const;
+    const LVecBase3f &get_divided(const unsigned char *pointer);
+  };
+
+  class Packer_float16 final : public Packer_decoded {
+  public:
+    virtual const char *get_name() const {
+      return "Packer_float16";
+    }
+
+  protected:
+    virtual void decode(const unsigned char *pointer, LVecBase4f &value);
+    virtual void encode(unsigned char *pointer, const LVecBase4f &value);
+  };
+
+  class Packer_snorm10 final : public Packer_decoded {
+  public:
+    virtual const char *get_name() const {
+      return "Packer_snorm10";
+    }
+
+  protected:
+    virtual void decode(const unsigned char *pointer, LVecBase4f &value);
+    virtual void encode(unsigned char *pointer, const LVecBase4f &value);
+  };
+
+  class Packer_oct16 final : public Packer_decoded {
+  public:
+    virtual const char *get_name() const {
+      return "Packer_oct16";
+    }
+
+  protected:
+    virtual void decode(const unsigned char *pointer, LVecBase4f &value);
+    virtual void encode(unsigned char *pointer, const LVecBase4f &value);
+  };
+
   friend class GeomVertexArrayFormat;
+  friend class GeomVertexConversionPlan;
   friend class GeomVertexData;
   friend class GeomVertexReader;
   friend class GeomVertexWriter;
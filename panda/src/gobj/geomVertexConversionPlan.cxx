@@ -0,0 +1,583 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomVertexConversionPlan.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "geomVertexConversionPlan.h"
+#include "geomVertexColumn.h"
+#include "geomVertexData.h"
+#include "lightMutexHolder.h"
+#include "config_gobj.h"
+
+#include <algorithm>
+
+LightMutex GeomVertexConversionPlan::_plans_lock("GeomVertexConversionPlan::_plans_lock");
+GeomVertexConversionPlan::Plans *GeomVertexConversionPlan::_plans = nullptr;
+
+namespace {
+  /**
+   * Converts num_values consecutive values of type From in each row to values
+   * of type To.  If both columns fill up their rows completely, the rows are
+   * treated as one long run of values, so that the inner loop runs over the
+   * whole array.
+   */
+  template<class To, class From, class Convert>
+  void
+  convert_values(unsigned char *to, int to_stride,
+                 const unsigned char *from, int from_stride,
+                 int num_values, int num_rows, Convert convert) {
+    if (to_stride == num_values * (int)sizeof(To) &&
+        from_stride == num_values * (int)sizeof(From)) {
+      num_values *= num_rows;
+      num_rows = 1;
+    }
+
+    for (int ri = 0; ri < num_rows; ++ri) {
+      To *to_values = (To *)to;
+      const From *from_values = (const From *)from;
+      for (int vi = 0; vi < num_values; ++vi) {
+        to_values[vi] = convert(from_values[vi]);
+      }
+      to += to_stride;
+      from += from_stride;
+    }
+  }
+
+  struct CastToFloat32 {
+    PN_float32 operator () (PN_float64 value) const {
+      return (PN_float32)value;
+    }
+  };
+
+  struct CastToFloat64 {
+    PN_float64 operator () (PN_float32 value) const {
+      return (PN_float64)value;
+    }
+  };
+
+  struct PackHalf {
+    uint16_t operator () (PN_float32 value) const {
+      return GeomVertexData::pack_half(value);
+    }
+  };
+
+  struct UnpackHalf {
+    PN_float32 operator () (uint16_t value) const {
+      return GeomVertexData::unpack_half(value);
+    }
+  };
+
+  // These match the rounding done by Packer_rgba_uint8_4.
+  struct PackUnorm8 {
+    unsigned char operator () (PN_float32 value) const {
+      return (unsigned char)(unsigned int)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+    }
+  };
+
+  struct UnpackUnorm8 {
+    PN_float32 operator () (unsigned char value) const {
+      return (PN_float32)value / 255.0f;
+    }
+  };
+}
+
+/**
+ * Computes the plan for converting data in the source format to the dest
+ * format.  Normally you should call get_plan() instead, which reuses a plan
+ * that was computed before for the same pair of formats.
+ */
+GeomVertexConversionPlan::
+GeomVertexConversionPlan(const GeomVertexFormat *source_format,
+                         const GeomVertexFormat *dest_format) :
+  _source_format(source_format),
+  _dest_format(dest_format)
+{
+  int num_arrays = source_format->get_num_arrays();
+  int dest_num_arrays = dest_format->get_num_arrays();
+
+  _shared_arrays.resize(dest_num_arrays, -1);
+  _source_arrays_read.resize(num_arrays, false);
+  _dest_arrays_written.resize(dest_num_arrays, false);
+
+  _source_strides.reserve(num_arrays);
+  for (int source_i = 0; source_i < num_arrays; ++source_i) {
+    _source_strides.push_back(source_format->get_array(source_i)->get_stride());
+  }
+  _dest_strides.reserve(dest_num_arrays);
+  for (int dest_i = 0; dest_i < dest_num_arrays; ++dest_i) {
+    _dest_strides.push_back(dest_format->get_array(dest_i)->get_stride());
+  }
+
+  // First, check to see if any arrays can be simply appropriated for the new
+  // format, without changing the data.
+  for (int source_i = 0; source_i < num_arrays; ++source_i) {
+    const GeomVertexArrayFormat *source_array_format =
+      source_format->get_array(source_i);
+
+    for (int dest_i = 0; dest_i < dest_num_arrays; ++dest_i) {
+      if (dest_format->get_array(dest_i)->is_data_subset_of(*source_array_format)) {
+        _shared_arrays[dest_i] = source_i;
+        break;
+      }
+    }
+  }
+
+  // Now determine how to fill in each column of the arrays we didn't share.
+  for (int source_i = 0; source_i < num_arrays; ++source_i) {
+    const GeomVertexArrayFormat *source_array_format =
+      source_format->get_array(source_i);
+    int num_columns = source_array_format->get_num_columns();
+    for (int ci = 0; ci < num_columns; ++ci) {
+      const GeomVertexColumn *source_column = source_array_format->get_column(ci);
+
+      int dest_i = dest_format->get_array_with(source_column->get_name());
+      if (dest_i < 0 || _shared_arrays[dest_i] >= 0) {
+        continue;
+      }
+
+      const GeomVertexColumn *dest_column =
+        dest_format->get_array(dest_i)->get_column(source_column->get_name());
+      nassertd(dest_column != nullptr) continue;
+
+      Op op;
+      op._type = choose_op_type(dest_column, source_column);
+      op._dest_i = dest_i;
+      op._source_i = source_i;
+      op._dest_start = dest_column->get_start();
+      op._source_start = source_column->get_start();
+      op._dest_column = dest_column;
+      op._source_column = source_column;
+
+      switch (op._type) {
+      case OT_copy:
+        op._num_values = source_column->get_total_bytes();
+        break;
+
+      case OT_uint8_rgba_to_packed_argb:
+      case OT_packed_argb_to_uint8_rgba:
+        op._num_values = 1;
+        break;
+
+      case OT_generic_f:
+      case OT_generic_d:
+      case OT_generic_i:
+        op._num_values = std::min(source_column->get_num_elements(),
+                                  dest_column->get_num_elements());
+        if (gobj_cat.is_debug()) {
+          gobj_cat.debug()
+            << "generic copy " << *dest_column << " from "
+            << *source_column << "\n";
+        }
+        break;
+
+      default:
+        op._num_values = source_column->get_num_values();
+        break;
+      }
+
+      _ops.push_back(op);
+      _source_arrays_read[source_i] = true;
+      _dest_arrays_written[dest_i] = true;
+    }
+  }
+
+  merge_copies();
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Computed vertex conversion plan: " << *this << "\n";
+  }
+}
+
+/**
+ * Returns a plan for converting data in the source format to the dest format.
+ * The plan is cached, so that the same plan is returned the next time it is
+ * requested for the same pair of formats.
+ */
+CPT(GeomVertexConversionPlan) GeomVertexConversionPlan::
+get_plan(const GeomVertexFormat *source_format,
+         const GeomVertexFormat *dest_format) {
+  if (!source_format->is_registered() || !dest_format->is_registered()) {
+    // Unregistered formats may still be modified, so we can't cache these.
+    return new GeomVertexConversionPlan(source_format, dest_format);
+  }
+
+  PlanKey key(source_format, dest_format);
+  {
+    LightMutexHolder holder(_plans_lock);
+    if (_plans != nullptr) {
+      Plans::const_iterator pi = _plans->find(key);
+      if (pi != _plans->end()) {
+        return (*pi).second;
+      }
+    }
+  }
+
+  // Compute the plan without holding the lock.  If another thread computes
+  // the same plan in the meantime, we keep the one that got there first.
+  CPT(GeomVertexConversionPlan) plan =
+    new GeomVertexConversionPlan(source_format, dest_format);
+
+  // The plans hold a reference to their formats, so we move any plans we
+  // discard out of the map and release them after the lock is released.
+  Plans discarded;
+  {
+    LightMutexHolder holder(_plans_lock);
+    if (_plans == nullptr) {
+      _plans = new Plans;
+    }
+    if ((int)_plans->size() >= std::max((int)vertex_conversion_plan_cache_size, 1)) {
+      _plans->swap(discarded);
+    }
+    std::pair<Plans::iterator, bool> result =
+      _plans->insert(Plans::value_type(key, plan));
+    plan = (*result.first).second;
+  }
+
+  return plan;
+}
+
+/**
+ * Discards all of the cached plans.
+ */
+void GeomVertexConversionPlan::
+clear_cache() {
+  Plans discarded;
+  {
+    LightMutexHolder holder(_plans_lock);
+    if (_plans != nullptr) {
+      _plans->swap(discarded);
+    }
+  }
+}
+
+/**
+ * Converts num_rows rows of data.  source_arrays should contain a pointer to
+ * the beginning of the data of each array in the source format for which
+ * is_source_array_read() returns true, and dest_arrays likewise for each array
+ * of the dest format for which is_dest_array_written() returns true.  The
+ * other pointers are not used, and may be null.
+ *
+ * The dest arrays must already have room for num_rows rows.
+ */
+void GeomVertexConversionPlan::
+execute(unsigned char *const *dest_arrays,
+        const unsigned char *const *source_arrays,
+        int num_rows) const {
+  if (num_rows <= 0) {
+    return;
+  }
+
+  for (const Op &op : _ops) {
+    nassertd(dest_arrays[op._dest_i] != nullptr &&
+             source_arrays[op._source_i] != nullptr) continue;
+
+    execute_op(op, dest_arrays[op._dest_i] + op._dest_start,
+               source_arrays[op._source_i] + op._source_start, num_rows);
+  }
+}
+
+/**
+ *
+ */
+void GeomVertexConversionPlan::
+output(std::ostream &out) const {
+  static const char *const op_names[] = {
+    "copy",
+    "float32_to_float64",
+    "float64_to_float32",
+    "float32_to_float16",
+    "float16_to_float32",
+    "float32_to_unorm8",
+    "unorm8_to_float32",
+    "uint8_rgba_to_packed_argb",
+    "packed_argb_to_uint8_rgba",
+    "generic_f",
+    "generic_d",
+    "generic_i",
+  };
+
+  out << "GeomVertexConversionPlan(";
+  bool any = false;
+  for (size_t i = 0; i < _shared_arrays.size(); ++i) {
+    if (_shared_arrays[i] >= 0) {
+      if (any) {
+        out << ", ";
+      }
+      out << "share " << _shared_arrays[i] << " as " << i;
+      any = true;
+    }
+  }
+  for (const Op &op : _ops) {
+    if (any) {
+      out << ", ";
+    }
+    out << op_names[op._type] << " " << op._num_values << " "
+        << op._source_i << ":" << op._source_start << " -> "
+        << op._dest_i << ":" << op._dest_start;
+    any = true;
+  }
+  out << ")";
+}
+
+/**
+ * Determines the operation that is used to copy the data of the indicated
+ * source column to the indicated dest column.  The two columns have the same
+ * name.
+ */
+GeomVertexConversionPlan::OpType GeomVertexConversionPlan::
+choose_op_type(const GeomVertexColumn *dest_column,
+               const GeomVertexColumn *source_column) {
+  if (dest_column->is_bytewise_equivalent(*source_column)) {
+    return OT_copy;
+  }
+
+  if (dest_column->is_packed_argb() && source_column->is_uint8_rgba()) {
+    // A common special case: OpenGL color to DirectX color.
+    return OT_uint8_rgba_to_packed_argb;
+  }
+
+  if (dest_column->is_uint8_rgba() && source_column->is_packed_argb()) {
+    // Another common special case: DirectX color to OpenGL color.
+    return OT_packed_argb_to_uint8_rgba;
+  }
+
+  NumericType source_type = source_column->get_numeric_type();
+  NumericType dest_type = dest_column->get_numeric_type();
+
+  // The remaining special cases are a straight conversion of each value, which
+  // is only the same as going through the Packer if the number of values is
+  // the same.  Any implicit w is 1 on read, and is divided out again on write.
+  if (source_column->get_num_elements() == 1 &&
+      dest_column->get_num_elements() == 1 &&
+      source_column->get_num_values() == dest_column->get_num_values()) {
+    if (source_type == NT_float32 && dest_type == NT_float64) {
+      return OT_float32_to_float64;
+    }
+    if (source_type == NT_float64 && dest_type == NT_float32) {
+      return OT_float64_to_float32;
+    }
+    if (source_type == NT_float32 && dest_type == NT_float16) {
+      return OT_float32_to_float16;
+    }
+    if (source_type == NT_float16 && dest_type == NT_float32) {
+      return OT_float16_to_float32;
+    }
+    if (source_column->get_contents() == C_color &&
+        dest_column->get_contents() == C_color &&
+        source_column->get_num_values() == 4) {
+      if (source_type == NT_float32 && dest_type == NT_uint8) {
+        return OT_float32_to_unorm8;
+      }
+      if (source_type == NT_uint8 && dest_type == NT_float32) {
+        return OT_unorm8_to_float32;
+      }
+    }
+  }
+
+  if (source_type == NT_float64 || dest_type == NT_float64) {
+    // Don't lose precision by going through single-precision floats.
+    return OT_generic_d;
+  }
+
+  if (is_integer(source_type) && is_integer(dest_type) &&
+      source_column->get_contents() != C_color &&
+      dest_column->get_contents() != C_color &&
+      source_column->get_num_values() == dest_column->get_num_values()) {
+    // Large integers, such as indices, can't be represented exactly in a
+    // float.  Colors are excluded since they are scaled to 0..1 as floats.
+    return OT_generic_i;
+  }
+
+  return OT_generic_f;
+}
+
+/**
+ * Returns true if the indicated numeric type stores each value as a plain
+ * integer.
+ */
+bool GeomVertexConversionPlan::
+is_integer(NumericType numeric_type) {
+  switch (numeric_type) {
+  case NT_uint8:
+  case NT_uint16:
+  case NT_uint32:
+  case NT_int8:
+  case NT_int16:
+  case NT_int32:
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+/**
+ * Orders the operations by the arrays they operate on, and then by their
+ * position within the dest row.
+ */
+bool GeomVertexConversionPlan::
+compare_ops(const Op &a, const Op &b) {
+  if (a._dest_i != b._dest_i) {
+    return a._dest_i < b._dest_i;
+  }
+  if (a._source_i != b._source_i) {
+    return a._source_i < b._source_i;
+  }
+  return a._dest_start < b._dest_start;
+}
+
+/**
+ * Combines copy operations on adjacent columns, which are laid out the same way
+ * in both rows, into a single copy.
+ */
+void GeomVertexConversionPlan::
+merge_copies() {
+  if (_ops.size() < 2) {
+    return;
+  }
+
+  std::stable_sort(_ops.begin(), _ops.end(), &compare_ops);
+
+  Ops ops;
+  ops.reserve(_ops.size());
+  for (const Op &op : _ops) {
+    if (!ops.empty()) {
+      Op &prev = ops.back();
+      if (prev._type == OT_copy && op._type == OT_copy &&
+          prev._dest_i == op._dest_i && prev._source_i == op._source_i &&
+          prev._dest_start + prev._num_values == op._dest_start &&
+          prev._source_start + prev._num_values == op._source_start) {
+        prev._num_values += op._num_values;
+        prev._dest_column = nullptr;
+        prev._source_column = nullptr;
+        continue;
+      }
+    }
+    ops.push_back(op);
+  }
+  _ops.swap(ops);
+}
+
+/**
+ * Performs a single operation on all of the rows.  The pointers point to the
+ * column within the first row.
+ */
+void GeomVertexConversionPlan::
+execute_op(const Op &op, unsigned char *dest, const unsigned char *source,
+           int num_rows) const {
+  int dest_stride = _dest_strides[op._dest_i];
+  int source_stride = _source_strides[op._source_i];
+
+  switch (op._type) {
+  case OT_copy:
+    if (dest_stride == op._num_values && source_stride == op._num_values) {
+      // It's just a linear array of this one data type.  Copy the whole
+      // thing all at once.
+      memcpy(dest, source, (size_t)num_rows * op._num_values);
+    } else {
+      for (int ri = 0; ri < num_rows; ++ri) {
+        memcpy(dest, source, op._num_values);
+        dest += dest_stride;
+        source += source_stride;
+      }
+    }
+    break;
+
+  case OT_float32_to_float64:
+    convert_values<PN_float64, PN_float32>
+      (dest, dest_stride, source, source_stride, op._num_values, num_rows,
+       CastToFloat64());
+    break;
+
+  case OT_float64_to_float32:
+    convert_values<PN_float32, PN_float64>
+      (dest, dest_stride, source, source_stride, op._num_values, num_rows,
+       CastToFloat32());
+    break;
+
+  case OT_float32_to_float16:
+    convert_values<uint16_t, PN_float32>
+      (dest, dest_stride, source, source_stride, op._num_values, num_rows,
+       PackHalf());
+    break;
+
+  case OT_float16_to_float32:
+    convert_values<PN_float32, uint16_t>
+      (dest, dest_stride, source, source_stride, op._num_values, num_rows,
+       UnpackHalf());
+    break;
+
+  case OT_float32_to_unorm8:
+    convert_values<unsigned char, PN_float32>
+      (dest, dest_stride, source, source_stride, op._num_values, num_rows,
+       PackUnorm8());
+    break;
+
+  case OT_unorm8_to_float32:
+    convert_values<PN_float32, unsigned char>
+      (dest, dest_stride, source, source_stride, op._num_values, num_rows,
+       UnpackUnorm8());
+    break;
+
+  case OT_uint8_rgba_to_packed_argb:
+    for (int ri = 0; ri < num_rows; ++ri) {
+      *(uint32_t *)dest = GeomVertexData::pack_abcd(source[3], source[0], source[1], source[2]);
+      dest += dest_stride;
+      source += source_stride;
+    }
+    break;
+
+  case OT_packed_argb_to_uint8_rgba:
+    for (int ri = 0; ri < num_rows; ++ri) {
+      uint32_t dword = *(const uint32_t *)source;
+      dest[0] = GeomVertexData::unpack_abcd_b(dword);
+      dest[1] = GeomVertexData::unpack_abcd_c(dword);
+      dest[2] = GeomVertexData::unpack_abcd_d(dword);
+      dest[3] = GeomVertexData::unpack_abcd_a(dword);
+      dest += dest_stride;
+      source += source_stride;
+    }
+    break;
+
+  case OT_generic_f:
+  case OT_generic_d:
+  case OT_generic_i:
+    {
+      // Go through the Packers, but call them directly rather than through a
+      // GeomVertexReader and GeomVertexWriter.  Each element of a matrix
+      // column is copied separately.
+      GeomVertexColumn::Packer *dest_packer = op._dest_column->_packer;
+      GeomVertexColumn::Packer *source_packer = op._source_column->_packer;
+      int dest_element_stride = op._dest_column->get_element_stride();
+      int source_element_stride = op._source_column->get_element_stride();
+
+      for (int ri = 0; ri < num_rows; ++ri) {
+        unsigned char *dest_element = dest;
+        const unsigned char *source_element = source;
+        for (int ei = 0; ei < op._num_values; ++ei) {
+          if (op._type == OT_generic_d) {
+            dest_packer->set_data4d(dest_element, source_packer->get_data4d(source_element));
+          } else if (op._type == OT_generic_i) {
+            dest_packer->set_data4i(dest_element, source_packer->get_data4i(source_element));
+          } else {
+            dest_packer->set_data4f(dest_element, source_packer->get_data4f(source_element));
+          }
+          dest_element += dest_element_stride;
+          source_element += source_element_stride;
+        }
+        dest += dest_stride;
+        source += source_stride;
+      }
+    }
+    break;
+  }
+}
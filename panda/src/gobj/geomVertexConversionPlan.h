@@ -0,0 +1,129 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomVertexConversionPlan.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef GEOMVERTEXCONVERSIONPLAN_H
+#define GEOMVERTEXCONVERSIONPLAN_H
+
+#include "pandabase.h"
+#include "geomEnums.h"
+#include "geomVertexFormat.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "pvector.h"
+#include "pmap.h"
+#include "lightMutex.h"
+
+class GeomVertexColumn;
+
+/**
+ * This describes how to convert the rows of a GeomVertexData from one
+ * GeomVertexFormat to another.  It is computed once for a particular pair of
+ * formats, and then applied to all of the data converted between them.
+ *
+ * Each column that is present in both formats is copied by one operation,
+ * which processes all of the rows at once.  Columns that can be copied without
+ * conversion are merged into a single memcpy per row where possible, and the
+ * common conversions between numeric types are done in simple loops that the
+ * compiler can vectorize.  Anything else is handed to the column's Packer.
+ *
+ * This is used internally by GeomVertexData::copy_from().
+ */
+class EXPCL_PANDA_GOBJ GeomVertexConversionPlan : public ReferenceCount, public GeomEnums {
+public:
+  GeomVertexConversionPlan(const GeomVertexFormat *source_format,
+                           const GeomVertexFormat *dest_format);
+
+  static CPT(GeomVertexConversionPlan)
+  get_plan(const GeomVertexFormat *source_format,
+           const GeomVertexFormat *dest_format);
+  static void clear_cache();
+
+  INLINE const GeomVertexFormat *get_source_format() const;
+  INLINE const GeomVertexFormat *get_dest_format() const;
+
+  INLINE int get_shared_array(int dest_i) const;
+  INLINE bool is_source_array_read(int source_i) const;
+  INLINE bool is_dest_array_written(int dest_i) const;
+  INLINE int get_num_ops() const;
+
+  void execute(unsigned char *const *dest_arrays,
+               const unsigned char *const *source_arrays,
+               int num_rows) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  enum OpType {
+    OT_copy,
+    OT_float32_to_float64,
+    OT_float64_to_float32,
+    OT_float32_to_float16,
+    OT_float16_to_float32,
+    OT_float32_to_unorm8,
+    OT_unorm8_to_float32,
+    OT_uint8_rgba_to_packed_argb,
+    OT_packed_argb_to_uint8_rgba,
+    OT_generic_f,
+    OT_generic_d,
+    OT_generic_i,
+  };
+
+  class Op {
+  public:
+    OpType _type;
+    int _dest_i;
+    int _source_i;
+    int _dest_start;
+    int _source_start;
+
+    // The number of bytes copied by OT_copy, or the number of scalar values
+    // converted by the numeric conversions.
+    int _num_values;
+
+    const GeomVertexColumn *_dest_column;
+    const GeomVertexColumn *_source_column;
+  };
+
+  static OpType choose_op_type(const GeomVertexColumn *dest_column,
+                               const GeomVertexColumn *source_column);
+  static bool is_integer(NumericType numeric_type);
+  static bool compare_ops(const Op &a, const Op &b);
+  void merge_copies();
+
+  void execute_op(const Op &op, unsigned char *dest,
+                  const unsigned char *source, int num_rows) const;
+
+private:
+  CPT(GeomVertexFormat) _source_format;
+  CPT(GeomVertexFormat) _dest_format;
+
+  pvector<int> _shared_arrays;
+  pvector<bool> _source_arrays_read;
+  pvector<bool> _dest_arrays_written;
+  pvector<int> _source_strides;
+  pvector<int> _dest_strides;
+
+  typedef pvector<Op> Ops;
+  Ops _ops;
+
+  typedef std::pair<const GeomVertexFormat *, const GeomVertexFormat *> PlanKey;
+  typedef pmap<PlanKey, CPT(GeomVertexConversionPlan) > Plans;
+  static LightMutex _plans_lock;
+  static Plans *_plans;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const GeomVertexConversionPlan &obj);
+
+#include "geomVertexConversionPlan.I"
+
+#endif
@@ -16,11 +16,18 @@
 #include "geomVertexReader.h"
 #include "geomVertexWriter.h"
 #include "geomVertexRewriter.h"
+#include "geomVertexConversionPlan.h"
 #include "pStatTimer.h"
 #include "bamReader.h"
 #include "bamWriter.h"
 #include "pset.h"
 #include "indent.h"
+#include "asyncTaskManager.h"
+#include "config_gobj.h"
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#endif
 
 using std::ostream;
 
@@ -481,39 +488,26 @@ copy_from(const GeomVertexData *source, bool keep_data_objects,
 
   int num_rows = source->get_num_rows();
   int num_arrays = source_format->get_num_arrays();
-  int source_i;
-
-  // First, check to see if any arrays can be simply appropriated for the new
-  // format, without changing the data.
-  pset<int> done_arrays;
-
-  for (source_i = 0; source_i < num_arrays; ++source_i) {
-    const GeomVertexArrayFormat *source_array_format =
-      source_format->get_array(source_i);
-
-    bool array_done = false;
-
-    int dest_num_arrays = dest_format->get_num_arrays();
-    for (int dest_i = 0;
-         dest_i < dest_num_arrays && !array_done;
-         ++dest_i) {
-      const GeomVertexArrayFormat *dest_array_format =
-        dest_format->get_array(dest_i);
-      if (dest_array_format->is_data_subset_of(*source_array_format)) {
-        // Great!  Just use the same data for this one.
-        if (keep_data_objects) {
-          // Copy the data, but keep the same GeomVertexArrayData object.
-
-          modify_array_handle(dest_i)->copy_data_from(source->get_array_handle(source_i));
-        } else {
-          // Copy the GeomVertexArrayData object.
-          if (get_array(dest_i) != source->get_array(source_i)) {
-            set_array(dest_i, source->get_array(source_i));
-          }
-        }
+  int dest_num_arrays = dest_format->get_num_arrays();
 
-        array_done = true;
-        done_arrays.insert(dest_i);
+  CPT(GeomVertexConversionPlan) plan =
+    GeomVertexConversionPlan::get_plan(source_format, dest_format);
+
+  // First, appropriate any arrays that can be used for the new format
+  // without changing the data.
+  for (int dest_i = 0; dest_i < dest_num_arrays; ++dest_i) {
+    int source_i = plan->get_shared_array(dest_i);
+    if (source_i >= 0) {
+      // Great!  Just use the same data for this one.
+      if (keep_data_objects) {
+        // Copy the data, but keep the same GeomVertexArrayData object.
+
+        modify_array_handle(dest_i)->copy_data_from(source->get_array_handle(source_i));
+      } else {
+        // Copy the GeomVertexArrayData object.
+        if (get_array(dest_i) != source->get_array(source_i)) {
+          set_array(dest_i, source->get_array(source_i));
+        }
       }
     }
   }
@@ -527,75 +521,26 @@ copy_from(const GeomVertexData *source, bool keep_data_objects,
   }
 
   // Now go back through and copy any data that's left over.
-  for (source_i = 0; source_i < num_arrays; ++source_i) {
-    CPT(GeomVertexArrayDataHandle) array_handle = source->get_array_handle(source_i);
-    const unsigned char *array_data = array_handle->get_read_pointer(true);
-    const GeomVertexArrayFormat *source_array_format = source_format->get_array(source_i);
-    int num_columns = source_array_format->get_num_columns();
-    for (int di = 0; di < num_columns; ++di) {
-      const GeomVertexColumn *source_column = source_array_format->get_column(di);
-
-      int dest_i = dest_format->get_array_with(source_column->get_name());
-      if (dest_i >= 0 && done_arrays.count(dest_i) == 0) {
-        // The data type exists in the new format; we have to copy it.
-        const GeomVertexArrayFormat *dest_array_format =
-          dest_format->get_array(dest_i);
-        const GeomVertexColumn *dest_column =
-          dest_array_format->get_column(source_column->get_name());
-        nassertv(dest_column != nullptr);
-
-        if (dest_column->is_bytewise_equivalent(*source_column)) {
-          // We can do a quick bytewise copy.
-          PT(GeomVertexArrayDataHandle) dest_handle = modify_array_handle(dest_i);
-          unsigned char *dest_array_data = dest_handle->get_write_pointer();
-
-          bytewise_copy(dest_array_data + dest_column->get_start(),
-                        dest_array_format->get_stride(),
-                        array_data + source_column->get_start(), source_array_format->get_stride(),
-                        source_column, num_rows);
-
-        } else if (dest_column->is_packed_argb() &&
-                   source_column->is_uint8_rgba()) {
-          // A common special case: OpenGL color to DirectX color.
-          PT(GeomVertexArrayDataHandle) dest_handle = modify_array_handle(dest_i);
-          unsigned char *dest_array_data = dest_handle->get_write_pointer();
-
-          uint8_rgba_to_packed_argb
-            (dest_array_data + dest_column->get_start(),
-             dest_array_format->get_stride(),
-             array_data + source_column->get_start(), source_array_format->get_stride(),
-             num_rows);
-
-        } else if (dest_column->is_uint8_rgba() &&
-                   source_column->is_packed_argb()) {
-          // Another common special case: DirectX color to OpenGL color.
-          PT(GeomVertexArrayDataHandle) dest_handle = modify_array_handle(dest_i);
-          unsigned char *dest_array_data = dest_handle->get_write_pointer();
-
-          packed_argb_to_uint8_rgba
-            (dest_array_data + dest_column->get_start(),
-             dest_array_format->get_stride(),
-             array_data + source_column->get_start(), source_array_format->get_stride(),
-             num_rows);
-
-        } else {
-          // A generic copy.
-          if (gobj_cat.is_debug()) {
-            gobj_cat.debug()
-              << "generic copy " << *dest_column << " from "
-              << *source_column << "\n";
-          }
-          GeomVertexWriter to(this);
-          to.set_column(dest_i, dest_column);
-          GeomVertexReader from(source);
-          from.set_column(source_i, source_column);
+  if (plan->get_num_ops() > 0) {
+    pvector<CPT(GeomVertexArrayDataHandle)> source_handles(num_arrays);
+    pvector<const unsigned char *> source_pointers(num_arrays, nullptr);
+    for (int source_i = 0; source_i < num_arrays; ++source_i) {
+      if (plan->is_source_array_read(source_i)) {
+        source_handles[source_i] = source->get_array_handle(source_i);
+        source_pointers[source_i] = source_handles[source_i]->get_read_pointer(true);
+      }
+    }
 
-          while (!from.is_at_end()) {
-            to.set_data4(from.get_data4());
-          }
-        }
+    pvector<PT(GeomVertexArrayDataHandle)> dest_handles(dest_num_arrays);
+    pvector<unsigned char *> dest_pointers(dest_num_arrays, nullptr);
+    for (int dest_i = 0; dest_i < dest_num_arrays; ++dest_i) {
+      if (plan->is_dest_array_written(dest_i)) {
+        dest_handles[dest_i] = modify_array_handle(dest_i);
+        dest_pointers[dest_i] = dest_handles[dest_i]->get_write_pointer();
       }
     }
+
+    plan->execute(dest_pointers.data(), source_pointers.data(), num_rows);
   }
 
     // Also convert the animation tables as necessary.
@@ -1142,38 +1087,6 @@ do_set_color(GeomVertexData *vdata, const LColor &color) {
   }
 }
 
-/**
- * Quickly copies data without the need to convert it.
- */
-void GeomVertexData::
-bytewise_copy(unsigned char *to, int to_stride,
-              const unsigned char *from, int from_stride,
-              const GeomVertexColumn *from_type,
-              int num_records) {
-  if (gobj_cat.is_debug()) {
-    gobj_cat.debug()
-      << "bytewise_copy(" << (void *)to << ", " << to_stride
-      << ", " << (const void *)from << ", " << from_stride
-      << ", " << *from_type << ", " << num_records << ")\n";
-  }
-  if (to_stride == from_type->get_total_bytes() &&
-      from_stride == from_type->get_total_bytes()) {
-    // Fantastic!  It's just a linear array of this one data type.  Copy the
-    // whole thing all at once.
-    memcpy(to, from, num_records * from_type->get_total_bytes());
-
-  } else {
-    // Ok, it's interleaved in with other data.  Copy them one record at a
-    // time.
-    while (num_records > 0) {
-      memcpy(to, from, from_type->get_total_bytes());
-      to += to_stride;
-      from += from_stride;
-      num_records--;
-    }
-  }
-}
-
 /**
  * Returns a new GeomVertexData object, suitable for modification, with the
  * indicated data type replaced with a new table filled with undefined values.
@@ -1403,56 +1316,6 @@ clear_cache_stage() {
   }
 }
 
-/**
- * Quickly converts DirectX-style color to OpenGL-style color.
- */
-void GeomVertexData::
-packed_argb_to_uint8_rgba(unsigned char *to, int to_stride,
-                          const unsigned char *from, int from_stride,
-                          int num_records) {
-  if (gobj_cat.is_debug()) {
-    gobj_cat.debug()
-      << "packed_argb_to_uint8_rgba(" << (void *)to << ", " << to_stride
-      << ", " << (const void *)from << ", " << from_stride
-      << ", " << num_records << ")\n";
-  }
-
-  while (num_records > 0) {
-    uint32_t dword = *(const uint32_t *)from;
-    to[0] = unpack_abcd_b(dword);
-    to[1] = unpack_abcd_c(dword);
-    to[2] = unpack_abcd_d(dword);
-    to[3] = unpack_abcd_a(dword);
-
-    to += to_stride;
-    from += from_stride;
-    num_records--;
-  }
-}
-
-/**
- * Quickly converts OpenGL-style color to DirectX-style color.
- */
-void GeomVertexData::
-uint8_rgba_to_packed_argb(unsigned char *to, int to_stride,
-                          const unsigned char *from, int from_stride,
-                          int num_records) {
-  if (gobj_cat.is_debug()) {
-    gobj_cat.debug()
-      << "uint8_rgba_to_packed_argb(" << (void *)to << ", " << to_stride
-      << ", " << (const void *)from << ", " << from_stride
-      << ", " << num_records << ")\n";
-  }
-
-  while (num_records > 0) {
-    *(uint32_t *)to = pack_abcd(from[3], from[0], from[1], from[2]);
-
-    to += to_stride;
-    from += from_stride;
-    num_records--;
-  }
-}
-
 /**
  * Recomputes the results of computing the vertex animation on the CPU, and
  * applies them to the existing animated_vertices object.
@@ -1585,9 +1448,6 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
     // Now go through and apply the transforms.
     PStatTimer timer3(_skinning_pcollector);
 
-    const SparseArray &rows = tb_table->get_rows();
-    int num_subranges = rows.get_num_subranges();
-
     int blend_array_index = orig_format->get_array_with(InternalName::get_transform_blend());
     if (blend_array_index < 0) {
       gobj_cat.warning()
@@ -1596,188 +1456,251 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
       return;
     }
 
-    CPT(GeomVertexArrayFormat) blend_array_format = orig_format->get_array(blend_array_index);
-
-    if (blend_array_format->get_stride() == 2 &&
-        blend_array_format->get_column(0)->get_component_bytes() == 2) {
-      // The blend indices are a table of ushorts.  Optimize this common case.
-      CPT(GeomVertexArrayDataHandle) blend_array_handle =
-        new GeomVertexArrayDataHandle(cdata->_arrays[blend_array_index].get_read_pointer(current_thread), current_thread);
-      const unsigned short *blendt = (const unsigned short *)blend_array_handle->get_read_pointer(true);
-
-      size_t ci;
-      for (ci = 0; ci < new_format->get_num_points(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_point(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-
-          int first_vertex = begin;
-          int first_bi = blendt[first_vertex];
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendt[next_vertex];
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
+    // Find the runs of consecutive vertices that share the same blend, each
+    // of which is transformed as a block.  This is the same for all columns.
+    SkinRuns runs;
+    find_skin_runs(cdata, tb_table, blend_array_index, runs, current_thread);
+
+    // Also compute the matrices of each of the blends only once, rather than
+    // once for each run of each column.
+    int num_blends = tb_table->get_num_blends();
+    SkinMatrices mats(num_blends);
+    for (const SkinRun &run : runs) {
+      nassertv(run._blend >= 0 && run._blend < num_blends);
+      SkinMatrix &sm = mats[run._blend];
+      if (!sm._valid) {
+        tb_table->get_blend(run._blend).get_blend(sm._mat, current_thread);
+        sm._matf = LCAST(float, sm._mat);
+        LMatrix4 normal_mat;
+        sm._normalize = compute_normal_xform(sm._mat, normal_mat);
+        sm._normalf = LCAST(float, normal_mat);
+        sm._valid = true;
+      }
+    }
 
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_point_column(new_format, data, mat, first_vertex, next_vertex);
+    // If all of the columns to be transformed are tables of floats, which is
+    // by far the most common case, we can transform them directly in memory,
+    // possibly on several threads at once.
+    size_t num_points = new_format->get_num_points();
+    size_t num_vectors = new_format->get_num_vectors();
+    size_t num_arrays = new_format->get_num_arrays();
+
+    bool all_float = true;
+    for (size_t ci = 0; ci < num_points + num_vectors && all_float; ++ci) {
+      const InternalName *name = (ci < num_points) ? new_format->get_point(ci)
+                                                   : new_format->get_vector(ci - num_points);
+      const GeomVertexColumn *column = new_format->get_column(name);
+      all_float = (column != nullptr &&
+                   column->get_numeric_type() == NT_float32 &&
+                   (column->get_num_values() == 3 || column->get_num_values() == 4));
+    }
 
-            first_vertex = next_vertex;
-            first_bi = next_bi;
-          }
+    if (runs.empty()) {
+      // There's nothing to transform.
+
+    } else if (all_float) {
+      pvector<PT(GeomVertexArrayDataHandle)> handles(num_arrays);
+      SkinColumns columns;
+      columns.reserve(num_points + num_vectors);
+      for (size_t ci = 0; ci < num_points + num_vectors; ++ci) {
+        bool is_point = (ci < num_points);
+        const InternalName *name = is_point ? new_format->get_point(ci)
+                                            : new_format->get_vector(ci - num_points);
+        int array_index = new_format->get_array_with(name);
+        if (handles[array_index] == nullptr) {
+          handles[array_index] = new_data->modify_array_handle(array_index);
         }
+        const GeomVertexColumn *column = new_format->get_column(name);
+
+        SkinColumn sc;
+        sc._data = handles[array_index]->get_write_pointer() + column->get_start();
+        sc._stride = new_format->get_array(array_index)->get_stride();
+        sc._num_values = column->get_num_values();
+        sc._contents = column->get_contents();
+        sc._is_point = is_point;
+        columns.push_back(sc);
       }
 
-      for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
-        GeomVertexRewriter data(new_data, new_format->get_vector(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-
-          int first_vertex = begin;
-          int first_bi = blendt[first_vertex];
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendt[next_vertex];
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
-
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_vector_column(new_format, data, mat, first_vertex, next_vertex);
-
-            first_vertex = next_vertex;
-            first_bi = next_bi;
-          }
-        }
+      int threshold = skinning_parallel_threshold;
+      if (threshold > 0 && runs.size() > 1 && Thread::is_true_threads() &&
+          (int)(runs.back()._end - runs.front()._begin) >= threshold) {
+        // The runs don't overlap, so different threads can safely transform
+        // different runs at the same time.
+        const SkinRun *run_data = &runs[0];
+        AsyncTaskManager::get_global_ptr()->parallel_for(0, (int)runs.size(),
+          [&](int begin, int end) {
+            skin_runs(columns, run_data + begin, end - begin, mats);
+          });
+      } else {
+        skin_runs(columns, &runs[0], runs.size(), mats);
       }
 
     } else {
-      // The blend indices are anything else.  Use the GeomVertexReader to
-      // iterate through them.
-      GeomVertexReader blendi(this, InternalName::get_transform_blend());
-      nassertv(blendi.has_column());
-
-      size_t ci;
-      for (ci = 0; ci < new_format->get_num_points(); ci++) {
+      // Some of the columns have some other format.  Use the
+      // GeomVertexRewriter to transform them one at a time.
+      for (size_t ci = 0; ci < num_points; ci++) {
         GeomVertexRewriter data(new_data, new_format->get_point(ci));
-
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin < end);
-          blendi.set_row_unsafe(begin);
-
-          int first_vertex = begin;
-          int first_bi = blendi.get_data1i();
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendi.get_data1i();
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
-
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_point_column(new_format, data, mat, first_vertex, next_vertex);
-
-            first_vertex = next_vertex;
-            first_bi = next_bi;
-          }
+        for (const SkinRun &run : runs) {
+          new_data->do_transform_point_column(new_format, data, mats[run._blend]._mat,
+                                              run._begin, run._end);
         }
       }
 
-      for (ci = 0; ci < new_format->get_num_vectors(); ci++) {
+      for (size_t ci = 0; ci < num_vectors; ci++) {
         GeomVertexRewriter data(new_data, new_format->get_vector(ci));
+        for (const SkinRun &run : runs) {
+          new_data->do_transform_vector_column(new_format, data, mats[run._blend]._mat,
+                                               run._begin, run._end);
+        }
+      }
+    }
+  }
+}
 
-        for (int i = 0; i < num_subranges; ++i) {
-          int begin = rows.get_subrange_begin(i);
-          int end = rows.get_subrange_end(i);
-          nassertv(begin != end);
-          blendi.set_row_unsafe(begin);
-
-          int first_vertex = begin;
-          int first_bi = blendi.get_data1i();
-
-          while (first_vertex < end) {
-            // At this point, first_vertex is the first of a series of
-            // vertices that shares the blend index first_bi.
-
-            // Scan for the end of this series of vertices--we're looking for
-            // the next vertex with a different blend index.
-            int next_vertex = first_vertex;
-            int next_bi = first_bi;
-            ++next_vertex;
-            while (next_vertex < end) {
-              next_bi = blendi.get_data1i();
-              if (next_bi != first_bi) {
-                break;
-              }
-              ++next_vertex;
-            }
+/**
+ * Fills runs with the runs of consecutive rows that are animated by the
+ * indicated TransformBlendTable and share the same blend index, in order.
+ */
+void GeomVertexData::
+find_skin_runs(CData *cdata, const TransformBlendTable *tb_table,
+               int blend_array_index, SkinRuns &runs,
+               Thread *current_thread) const {
+  const SparseArray &rows = tb_table->get_rows();
+  int num_subranges = rows.get_num_subranges();
 
-            // We've just reached the end of the vertices with a matching
-            // blend index.  Transform all those vertices as a block.
-            LMatrix4 mat;
-            tb_table->get_blend(first_bi).get_blend(mat, current_thread);
-            new_data->do_transform_vector_column(new_format, data, mat, first_vertex, next_vertex);
+  const GeomVertexFormat *orig_format = cdata->_format;
+  CPT(GeomVertexArrayFormat) blend_array_format = orig_format->get_array(blend_array_index);
+
+  if (blend_array_format->get_stride() == 2 &&
+      blend_array_format->get_column(0)->get_component_bytes() == 2) {
+    // The blend indices are a table of ushorts.  Optimize this common case.
+    CPT(GeomVertexArrayDataHandle) blend_array_handle =
+      new GeomVertexArrayDataHandle(cdata->_arrays[blend_array_index].get_read_pointer(current_thread), current_thread);
+    const unsigned short *blendt = (const unsigned short *)blend_array_handle->get_read_pointer(true);
+
+    for (int i = 0; i < num_subranges; ++i) {
+      int begin = rows.get_subrange_begin(i);
+      int end = rows.get_subrange_end(i);
+      nassertv(begin < end);
+
+      SkinRun run;
+      run._begin = begin;
+      run._blend = blendt[begin];
+      for (int j = begin + 1; j < end; ++j) {
+        if (blendt[j] != run._blend) {
+          run._end = j;
+          runs.push_back(run);
+          run._begin = j;
+          run._blend = blendt[j];
+        }
+      }
+      run._end = end;
+      runs.push_back(run);
+    }
 
-            first_vertex = next_vertex;
-            first_bi = next_bi;
-          }
+  } else {
+    // The blend indices are anything else.  Use the GeomVertexReader to
+    // iterate through them.
+    GeomVertexReader blendi(this, InternalName::get_transform_blend());
+    nassertv(blendi.has_column());
+
+    for (int i = 0; i < num_subranges; ++i) {
+      int begin = rows.get_subrange_begin(i);
+      int end = rows.get_subrange_end(i);
+      nassertv(begin < end);
+      blendi.set_row_unsafe(begin);
+
+      SkinRun run;
+      run._begin = begin;
+      run._blend = blendi.get_data1i();
+      for (int j = begin + 1; j < end; ++j) {
+        int bi = blendi.get_data1i();
+        if (bi != run._blend) {
+          run._end = j;
+          runs.push_back(run);
+          run._begin = j;
+          run._blend = bi;
         }
       }
+      run._end = end;
+      runs.push_back(run);
     }
   }
 }
 
+/**
+ * Transforms the vertices of the indicated runs in each of the indicated
+ * columns, which must all be tables of 3- or 4-component floats.  This may be
+ * called from any thread, for runs that are not being transformed by another
+ * thread.
+ */
+void GeomVertexData::
+skin_runs(const SkinColumns &columns, const SkinRun *runs, size_t num_runs,
+          const SkinMatrices &mats) {
+  for (size_t ri = 0; ri < num_runs; ++ri) {
+    const SkinRun &run = runs[ri];
+    const SkinMatrix &sm = mats[run._blend];
+    size_t num_rows = run._end - run._begin;
+
+    for (const SkinColumn &column : columns) {
+      unsigned char *datat = column._data + run._begin * column._stride;
+      if (column._is_point) {
+        if (column._num_values == 3) {
+          table_xform_point3f(datat, num_rows, column._stride, sm._matf);
+        } else {
+          table_xform_vecbase4f(datat, num_rows, column._stride, sm._matf);
+        }
+      } else if (column._contents == C_normal) {
+        if (sm._normalize) {
+          table_xform_normal3f(datat, num_rows, column._stride, sm._normalf);
+        } else if (column._num_values == 3) {
+          table_xform_vector3f(datat, num_rows, column._stride, sm._normalf);
+        } else {
+          table_xform_vecbase4f(datat, num_rows, column._stride, sm._normalf);
+        }
+      } else if (column._num_values == 3) {
+        table_xform_vector3f(datat, num_rows, column._stride, sm._matf);
+      } else {
+        table_xform_vecbase4f(datat, num_rows, column._stride, sm._matf);
+      }
+    }
+  }
+}
+
+/**
+ * Computes the matrix with which normals should be transformed by the
+ * indicated matrix, so that they stay perpendicular to the surface.  Returns
+ * true if the transformed normals must also be normalized.
+ */
+bool GeomVertexData::
+compute_normal_xform(const LMatrix4 &mat, LMatrix4 &xform) {
+  LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
+                     mat.get_row3(1).length_squared(),
+                     mat.get_row3(2).length_squared());
+  if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
+      IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
+    // There is a uniform scale.
+    LVecBase3 scale, shear, hpr;
+    if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
+      // No scale to worry about.
+      xform = mat;
+      return false;
+    } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
+      // Make a new matrix with scale/translate taken out of the equation.
+      compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
+      return false;
+    } else {
+      xform = mat;
+      return true;
+    }
+  } else {
+    // There is a non-uniform scale, so we need to do all this to preserve
+    // orthogonality to the surface.
+    xform.invert_from(mat);
+    xform.transpose_in_place();
+    return true;
+  }
+}
 
 /**
  * Transforms a range of vertices for one particular column, as a point.
@@ -1839,29 +1762,7 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   bool normalize = false;
   if (data_column->get_contents() == C_normal) {
     // This is to preserve perpendicularity to the surface.
-    LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
-                       mat.get_row3(1).length_squared(),
-                       mat.get_row3(2).length_squared());
-    if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
-        IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
-      // There is a uniform scale.
-      LVecBase3 scale, shear, hpr;
-      if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
-        // No scale to worry about.
-        xform = mat;
-      } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
-        // Make a new matrix with scale/translate taken out of the equation.
-        compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
-      } else {
-        normalize = true;
-      }
-    } else {
-      // There is a non-uniform scale, so we need to do all this to preserve
-      // orthogonality to the surface.
-      xform.invert_from(mat);
-      xform.transpose_in_place();
-      normalize = true;
-    }
+    normalize = compute_normal_xform(mat, xform);
   } else {
     xform = mat;
   }
@@ -1913,12 +1814,31 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
 void GeomVertexData::
 table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
                     const LMatrix4f &matf) {
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+  // Keep the rows of the matrix in registers, and build each point out of
+  // them.  We load and store the three components separately, so that we
+  // never touch memory past the end of the point.
+  const float *m = matf.get_data();
+  __m128 row0 = _mm_loadu_ps(m);
+  __m128 row1 = _mm_loadu_ps(m + 4);
+  __m128 row2 = _mm_loadu_ps(m + 8);
+  __m128 row3 = _mm_loadu_ps(m + 12);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0), row3);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), row1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), row2));
+    _mm_storel_pi((__m64 *)v, r);
+    _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+  }
+#else
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component point.
   for (size_t i = 0; i < num_rows; ++i) {
     LPoint3f &vertex = *(LPoint3f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif  // __SSE2__
 }
 
 /**
@@ -1928,11 +1848,10 @@ table_xform_point3f(unsigned char *datat, size_t num_rows, size_t stride,
 void GeomVertexData::
 table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
-  // We don't bother checking for the unaligned case here, because in practice
-  // it doesn't matter with a 3-component vector.
+  table_xform_vector3f(datat, num_rows, stride, matf);
+
   for (size_t i = 0; i < num_rows; ++i) {
     LNormalf &vertex = *(LNormalf *)(&datat[i * stride]);
-    vertex *= matf;
     vertex.normalize();
   }
 }
@@ -1944,12 +1863,28 @@ table_xform_normal3f(unsigned char *datat, size_t num_rows, size_t stride,
 void GeomVertexData::
 table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
                      const LMatrix4f &matf) {
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+  // As above, but without the translation.
+  const float *m = matf.get_data();
+  __m128 row0 = _mm_loadu_ps(m);
+  __m128 row1 = _mm_loadu_ps(m + 4);
+  __m128 row2 = _mm_loadu_ps(m + 8);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 r = _mm_mul_ps(_mm_set1_ps(v[0]), row0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), row1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), row2));
+    _mm_storel_pi((__m64 *)v, r);
+    _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+  }
+#else
   // We don't bother checking for the unaligned case here, because in practice
   // it doesn't matter with a 3-component vector.
   for (size_t i = 0; i < num_rows; ++i) {
     LVector3f &vertex = *(LVector3f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif  // __SSE2__
 }
 
 /**
@@ -1959,6 +1894,24 @@ table_xform_vector3f(unsigned char *datat, size_t num_rows, size_t stride,
 void GeomVertexData::
 table_xform_vecbase4f(unsigned char *datat, size_t num_rows, size_t stride,
                       const LMatrix4f &matf) {
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+  // Unaligned loads and stores are as fast as aligned ones on any recent
+  // CPU, so we don't need to check the alignment of the table.
+  const float *m = matf.get_data();
+  __m128 row0 = _mm_loadu_ps(m);
+  __m128 row1 = _mm_loadu_ps(m + 4);
+  __m128 row2 = _mm_loadu_ps(m + 8);
+  __m128 row3 = _mm_loadu_ps(m + 12);
+  for (size_t i = 0; i < num_rows; ++i) {
+    float *v = (float *)(&datat[i * stride]);
+    __m128 a = _mm_loadu_ps(v);
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+    _mm_storeu_ps(v, r);
+  }
+#else
 #if defined(HAVE_EIGEN) && defined(LINMATH_ALIGN)
   // Check if the table is unaligned.  If it is, we can't use the LVecBase4f
   // object directly, which assumes 16-byte alignment.
@@ -1980,6 +1933,7 @@ table_xform_vecbase4f(unsigned char *datat, size_t num_rows, size_t stride,
     LVecBase4f &vertex = *(LVecBase4f *)(&datat[i * stride]);
     vertex *= matf;
   }
+#endif  // __SSE2__
 }
 
 /**
@@ -2300,7 +2254,8 @@ get_array_info(const InternalName *name,
     array_reader = _array_readers[array_index];
     num_values = column->get_num_values();
     numeric_type = column->get_numeric_type();
-    normalized = (column->get_contents() == GeomEnums::C_color);
+    normalized = (column->get_contents() == GeomEnums::C_color ||
+                  numeric_type == GeomEnums::NT_packed_snorm10);
     start = column->get_start();
     stride = _cdata->_format->get_array(array_index)->get_stride();
     divisor = _cdata->_format->get_array(array_index)->get_divisor();
@@ -2496,6 +2451,28 @@ set_num_rows(int n) {
         pointer += stride;
       }
       break;
+
+    case NT_float16:
+      while (pointer < stop) {
+        uint16_t *pi = (uint16_t *)pointer;
+        for (int i = 0; i < num_values; i++) {
+          pi[i] = 0x3c00;
+        }
+        pointer += stride;
+      }
+      break;
+
+    case NT_packed_snorm10:
+      while (pointer < stop) {
+        *(uint32_t *)pointer = 0x5ff7fdff;
+        pointer += stride;
+      }
+      break;
+
+    case NT_packed_oct16:
+      // Shouldn't have this type in the format.
+      nassertr(false, false);
+      break;
     }
   }
 
@@ -186,22 +186,21 @@ public:
   static INLINE float unpack_ufloat_b(uint32_t data);
   static INLINE float unpack_ufloat_c(uint32_t data);
 
+  static INLINE uint16_t pack_half(float a);
+  static INLINE float unpack_half(uint16_t data);
+
+  static INLINE uint32_t pack_snorm10(float a, float b, float c, float d);
+  static INLINE float unpack_snorm10_a(uint32_t data);
+  static INLINE float unpack_snorm10_b(uint32_t data);
+  static INLINE float unpack_snorm10_c(uint32_t data);
+  static INLINE float unpack_snorm10_d(uint32_t data);
+
+  static INLINE uint32_t pack_oct16(float x, float y, float z);
+  static INLINE LVecBase3f unpack_oct16(uint32_t data);
+
 private:
   static void do_set_color(GeomVertexData *vdata, const LColor &color);
 
-  static void bytewise_copy(unsigned char *to, int to_stride,
-                            const unsigned char *from, int from_stride,
-                            const GeomVertexColumn *from_type,
-                            int num_records);
-  static void
-  packed_argb_to_uint8_rgba(unsigned char *to, int to_stride,
-                            const unsigned char *from, int from_stride,
-                            int num_records);
-  static void
-  uint8_rgba_to_packed_argb(unsigned char *to, int to_stride,
-                            const unsigned char *from, int from_stride,
-                            int num_records);
-
   typedef pmap<const VertexTransform *, int> TransformMap;
   INLINE static int
   add_transform(TransformTable *table, const VertexTransform *transform,
@@ -336,7 +335,54 @@ private:
   LightMutex _cache_lock;
 
 private:
+  // A run of consecutive vertices that share the same TransformBlend, which
+  // update_animated_vertices() transforms as a block.
+  class SkinRun {
+  public:
+    int _begin;
+    int _end;
+    int _blend;
+  };
+  typedef pvector<SkinRun> SkinRuns;
+
+  // The matrices with which the vertices of one TransformBlend are
+  // transformed: one for points and vectors, and one for normals.
+  class SkinMatrix {
+  public:
+    SkinMatrix() :
+      _mat(LMatrix4::ident_mat()),
+      _matf(LMatrix4f::ident_mat()),
+      _normalf(LMatrix4f::ident_mat()),
+      _normalize(false),
+      _valid(false) {}
+
+    LMatrix4 _mat;
+    LMatrix4f _matf;
+    LMatrix4f _normalf;
+    bool _normalize;
+    bool _valid;
+  };
+  typedef pvector<SkinMatrix> SkinMatrices;
+
+  // A float32 column of 3 or 4 components that is transformed directly in
+  // memory by the fast skinning path.
+  class SkinColumn {
+  public:
+    unsigned char *_data;
+    size_t _stride;
+    int _num_values;
+    Contents _contents;
+    bool _is_point;
+  };
+  typedef pvector<SkinColumn> SkinColumns;
+
   void update_animated_vertices(CData *cdata, Thread *current_thread);
+  void find_skin_runs(CData *cdata, const TransformBlendTable *tb_table,
+                      int blend_array_index, SkinRuns &runs,
+                      Thread *current_thread) const;
+  static void skin_runs(const SkinColumns &columns, const SkinRun *runs,
+                        size_t num_runs, const SkinMatrices &mats);
+  static bool compute_normal_xform(const LMatrix4 &mat, LMatrix4 &xform);
   void do_transform_point_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
                                  const LMatrix4 &mat, int begin_row, int end_row);
   void do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &data,
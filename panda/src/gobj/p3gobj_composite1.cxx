@@ -13,6 +13,7 @@
 #include "geomLinesAdjacency.cxx"
 #include "geomLinestrips.cxx"
 #include "geomLinestripsAdjacency.cxx"
+#include "geomMeshlets.cxx"
 #include "geomMunger.cxx"
 #include "geomPatches.cxx"
 #include "geomPoints.cxx"
@@ -26,6 +27,7 @@
 #include "geomVertexArrayData.cxx"
 #include "geomVertexArrayFormat.cxx"
 #include "geomVertexColumn.cxx"
+#include "geomVertexConversionPlan.cxx"
 #include "geomVertexData.cxx"
 #include "geomVertexFormat.cxx"
 #include "geomVertexReader.cxx"
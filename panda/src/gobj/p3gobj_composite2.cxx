@@ -20,6 +20,7 @@
 #include "textureReloadRequest.cxx"
 #include "textureStage.cxx"
 #include "textureStagePool.cxx"
+#include "textureStreamer.cxx"
 #include "timerQueryContext.cxx"
 #include "transformBlend.cxx"
 #include "transformBlendTable.cxx"
@@ -31,6 +32,7 @@
 #include "vertexDataBook.cxx"
 #include "vertexDataPage.cxx"
 #include "vertexDataBuffer.cxx"
+#include "vertexDataCompression.cxx"
 #include "vertexDataSaveFile.cxx"
 #include "vertexSlider.cxx"
 #include "vertexTransform.cxx"
@@ -377,6 +377,7 @@ Texture(const string &name) :
   _cvar(_lock)
 {
   _reloading = false;
+  _stream_demand = -1;
 
   CDWriter cdata(_cycler, true);
   do_set_format(cdata, F_rgb);
@@ -394,6 +395,7 @@ Texture(const Texture &copy) :
   _cvar(_lock)
 {
   _reloading = false;
+  _stream_demand = -1;
 }
 
 /**
@@ -1966,6 +1968,37 @@ set_orig_file_size(int x, int y, int z) {
   nassertv(z == cdata->_z_size);
 }
 
+/**
+ * Removes the indicated number of mipmap levels from the top of the mipmap
+ * stack, so that the texture becomes as large as the indicated mipmap level
+ * would otherwise be.  The mipmap levels are generated first, if necessary.
+ * This is used by the TextureStreamer to reduce the memory used by textures
+ * that don't need their full resolution at the moment.
+ *
+ * The level is counted from the image as it was loaded from disk, so passing
+ * a lower number than get_stream_level() restores some of the levels that
+ * were removed before; this requires the texture to be reloaded from disk,
+ * which happens immediately.  Passing a higher number removes more levels;
+ * if the image is not currently in RAM, this only takes effect when it is
+ * next reloaded.
+ */
+void Texture::
+set_stream_level(int level) {
+  nassertv(level >= 0);
+  {
+    CDWriter cdata(_cycler, true);
+    if (level >= cdata->_stream_level) {
+      do_set_stream_level(cdata, level);
+      return;
+    }
+  }
+
+  // We are making the texture larger, which means reading it from disk again.
+  // This is done without holding the lock, so that the texture can go on
+  // being rendered at its current size in the meantime.
+  unlocked_restore_stream_level(level);
+}
+
 /**
  * Creates a context for the texture on the particular GSG, if it does not
  * already exist.  Returns the new (or old) TextureContext.  This assumes that
@@ -3573,7 +3606,15 @@ do_read_txo_file(CData *cdata, const Filename &fullpath) {
       << "Reading texture object " << filename << "\n";
   }
 
-  istream *in = file->open_read_file(true);
+  // The whole file will be read, so read it from memory, which avoids a copy
+  // if the file can be mapped.
+  CPT(FileData) data = file->read_file_data(true);
+  if (data == nullptr) {
+    gobj_cat.error()
+      << "Could not read " << fullpath << "\n";
+    return false;
+  }
+  istream *in = data->open_read();
   bool success = do_read_txo(cdata, *in, fullpath);
   vfs->close_read_file(in);
 
@@ -3628,7 +3669,20 @@ do_read_dds_file(CData *cdata, const Filename &fullpath, bool header_only) {
       << "Reading DDS file " << filename << "\n";
   }
 
-  istream *in = file->open_read_file(true);
+  // Unless we only need the header, the whole file will be read, so read it
+  // from memory, which avoids a copy if the file can be mapped.
+  istream *in;
+  if (header_only) {
+    in = file->open_read_file(true);
+  } else {
+    CPT(FileData) data = file->read_file_data(true);
+    in = (data != nullptr) ? data->open_read() : nullptr;
+  }
+  if (in == nullptr) {
+    gobj_cat.error()
+      << "Could not read " << fullpath << "\n";
+    return false;
+  }
   bool success = do_read_dds(cdata, *in, fullpath, header_only);
   vfs->close_read_file(in);
 
@@ -4308,7 +4362,20 @@ do_read_ktx_file(CData *cdata, const Filename &fullpath, bool header_only) {
       << "Reading KTX file " << filename << "\n";
   }
 
-  istream *in = file->open_read_file(true);
+  // Unless we only need the header, the whole file will be read, so read it
+  // from memory, which avoids a copy if the file can be mapped.
+  istream *in;
+  if (header_only) {
+    in = file->open_read_file(true);
+  } else {
+    CPT(FileData) data = file->read_file_data(true);
+    in = (data != nullptr) ? data->open_read() : nullptr;
+  }
+  if (in == nullptr) {
+    gobj_cat.error()
+      << "Could not read " << fullpath << "\n";
+    return false;
+  }
   bool success = do_read_ktx(cdata, *in, fullpath, header_only);
   vfs->close_read_file(in);
 
@@ -5392,6 +5459,7 @@ unlocked_ensure_ram_image(bool allow_compression) {
   // the original texture.
   cdataw->_orig_file_x_size = cdata_tex->_orig_file_x_size;
   cdataw->_orig_file_y_size = cdata_tex->_orig_file_y_size;
+  cdataw->_stream_level = cdata_tex->_stream_level;
 
   // If any of *these* properties have changed, the texture has changed in
   // some fundamental way.  Update it appropriately.
@@ -5436,6 +5504,93 @@ unlocked_ensure_ram_image(bool allow_compression) {
   return cdataw;
 }
 
+/**
+ * Reloads the texture from disk to restore the mipmap levels that were
+ * removed by set_stream_level(), down to the indicated level.  Like
+ * unlocked_ensure_ram_image(), this reads the image into a copy of the
+ * texture while our own lock is not held, and only holds the lock while
+ * copying the new image back in.
+ */
+void Texture::
+unlocked_restore_stream_level(int level) {
+  Thread *current_thread = Thread::get_current_thread();
+
+  // First, wait for any other threads that might be reloading the texture.
+  MutexHolder holder(_lock);
+  while (_reloading) {
+    _cvar.wait();
+  }
+
+  // Then make sure we still need to reload before continuing.
+  const CData *cdata = _cycler.read(current_thread);
+  if (level >= cdata->_stream_level) {
+    CData *cdataw = _cycler.elevate_read_upstream(cdata, false, current_thread);
+    do_set_stream_level(cdataw, level);
+    _cycler.release_write(cdataw);
+    return;
+  }
+  if (!do_can_reload(cdata)) {
+    gobj_cat.error()
+      << "Cannot restore mipmap levels of " << get_name()
+      << ", which was not loaded from a file.\n";
+    _cycler.release_read(cdata);
+    return;
+  }
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Reloading " << get_name() << " at mipmap level " << level << "\n";
+  }
+
+  nassertv(!_reloading);
+  _reloading = true;
+
+  PT(Texture) tex = do_make_copy(cdata);
+  _cycler.release_read(cdata);
+  _lock.unlock();
+
+  // Perform the actual reload in the copy, while our own mutex is left
+  // unlocked.
+  CDWriter cdata_tex(tex->_cycler, true);
+  cdata_tex->_stream_level = level;
+  tex->do_clear_ram_image(cdata_tex);
+  tex->do_reload_ram_image(cdata_tex, true);
+
+  _lock.lock();
+
+  CData *cdataw = _cycler.write_upstream(false, current_thread);
+  if (tex->do_has_ram_image(cdata_tex)) {
+    // As in unlocked_ensure_ram_image(), we only copy in the properties that
+    // are relevant to the ram image.
+    cdataw->_orig_file_x_size = cdata_tex->_orig_file_x_size;
+    cdataw->_orig_file_y_size = cdata_tex->_orig_file_y_size;
+    cdataw->_stream_level = cdata_tex->_stream_level;
+
+    if (cdata_tex->_num_components != cdataw->_num_components ||
+        cdata_tex->_component_width != cdataw->_component_width ||
+        cdata_tex->_component_type != cdataw->_component_type) {
+      cdataw->_num_components = cdata_tex->_num_components;
+      cdataw->_component_width = cdata_tex->_component_width;
+      cdataw->_format = cdata_tex->_format;
+      cdataw->_component_type = cdata_tex->_component_type;
+      cdataw->inc_properties_modified();
+    }
+
+    cdataw->_x_size = cdata_tex->_x_size;
+    cdataw->_y_size = cdata_tex->_y_size;
+    cdataw->_z_size = cdata_tex->_z_size;
+    do_set_pad_size(cdataw, 0, 0, 0);
+
+    cdataw->_ram_image_compression = cdata_tex->_ram_image_compression;
+    cdataw->_ram_images = cdata_tex->_ram_images;
+    cdataw->inc_image_modified();
+  }
+
+  _reloading = false;
+  _cvar.notify_all();
+  _cycler.release_write(cdataw);
+}
+
 /**
  * Called when the Texture image is required but the ram image is not
  * available, this will reload it from disk or otherwise do whatever is
@@ -5449,6 +5604,11 @@ do_reload_ram_image(CData *cdata, bool allow_compression) {
   BamCache *cache = BamCache::get_global_ptr();
   PT(BamCacheRecord) record;
 
+  // If the texture is being streamed, we read the whole image, and then drop
+  // the top mipmap levels again once we have it (and have stored the full
+  // image in the cache, if appropriate).
+  int stream_level = cdata->_stream_level;
+
   if (!do_has_compression(cdata)) {
     allow_compression = false;
   }
@@ -5516,6 +5676,7 @@ do_reload_ram_image(CData *cdata, bool allow_compression) {
             }
           }
 
+          cdata->_stream_level = do_drop_top_mipmap_levels(cdata, stream_level);
           return;
         }
       }
@@ -5566,6 +5727,10 @@ do_reload_ram_image(CData *cdata, bool allow_compression) {
       cache->store(record);
     }
   }
+
+  if (do_has_ram_image(cdata)) {
+    cdata->_stream_level = do_drop_top_mipmap_levels(cdata, stream_level);
+  }
 }
 
 /**
@@ -6959,6 +7124,7 @@ do_setup_texture(CData *cdata, Texture::TextureType texture_type,
   do_set_pad_size(cdata, 0, 0, 0);
   cdata->_orig_file_x_size = 0;
   cdata->_orig_file_y_size = 0;
+  cdata->_stream_level = 0;
   cdata->_loaded_from_image = false;
   cdata->_loaded_from_txo = false;
   cdata->_has_read_pages = false;
@@ -7841,6 +8007,83 @@ do_reload(CData *cdata) {
   return false;
 }
 
+/**
+ * The internal implementation of set_stream_level(), for the case in which
+ * the texture is made smaller.
+ */
+void Texture::
+do_set_stream_level(CData *cdata, int level) {
+  nassertv(level >= 0);
+  if (level == cdata->_stream_level) {
+    return;
+  }
+
+  if (level > cdata->_stream_level) {
+    // We are making the texture smaller.  If we have the image, we can just
+    // drop the levels we don't want any more.
+    if (do_has_ram_image(cdata)) {
+      cdata->_stream_level += do_drop_top_mipmap_levels(cdata, level - cdata->_stream_level);
+    } else {
+      // Otherwise, we only need to note the new size; the levels will be
+      // dropped when the image is next reloaded.
+      int num_levels = min(level - cdata->_stream_level,
+                           do_get_expected_num_mipmap_levels(cdata) - 1);
+      if (num_levels <= 0) {
+        return;
+      }
+      cdata->_x_size = do_get_expected_mipmap_x_size(cdata, num_levels);
+      cdata->_y_size = do_get_expected_mipmap_y_size(cdata, num_levels);
+      cdata->_z_size = do_get_expected_mipmap_z_size(cdata, num_levels);
+      do_set_pad_size(cdata, 0, 0, 0);
+      cdata->_stream_level += num_levels;
+    }
+    cdata->inc_image_modified();
+    return;
+  }
+
+  // We are making the texture larger, which means reading it from disk again.
+  // This must be done without holding the lock; see
+  // unlocked_restore_stream_level().
+  nassert_raise("do_set_stream_level() cannot restore mipmap levels");
+}
+
+/**
+ * Removes up to the indicated number of mipmap levels from the top of the
+ * mipmap stack, generating them first if necessary, and shrinks the texture
+ * to the size of the new top level.  Returns the number of levels that were
+ * actually removed, which may be fewer than requested if the texture is not
+ * large enough, or 0 if the mipmap levels could not be generated.
+ *
+ * This does not touch _stream_level; the caller should update it.
+ */
+int Texture::
+do_drop_top_mipmap_levels(CData *cdata, int num_levels) {
+  num_levels = min(num_levels, do_get_expected_num_mipmap_levels(cdata) - 1);
+  if (num_levels <= 0 || !do_has_ram_image(cdata)) {
+    return 0;
+  }
+
+  if ((int)cdata->_ram_images.size() <= num_levels ||
+      cdata->_ram_images[num_levels]._image.empty()) {
+    do_generate_ram_mipmap_images(cdata, true);
+    if ((int)cdata->_ram_images.size() <= num_levels ||
+        cdata->_ram_images[num_levels]._image.empty()) {
+      return 0;
+    }
+  }
+
+  int x_size = do_get_expected_mipmap_x_size(cdata, num_levels);
+  int y_size = do_get_expected_mipmap_y_size(cdata, num_levels);
+  int z_size = do_get_expected_mipmap_z_size(cdata, num_levels);
+  cdata->_ram_images.erase(cdata->_ram_images.begin(),
+                           cdata->_ram_images.begin() + num_levels);
+  cdata->_x_size = x_size;
+  cdata->_y_size = y_size;
+  cdata->_z_size = z_size;
+  do_set_pad_size(cdata, 0, 0, 0);
+  return num_levels;
+}
+
 /**
  * Returns true if there is a rawdata image that we have available to write to
  * the bam stream.  For a normal Texture, this is the same thing as
@@ -10210,9 +10453,19 @@ do_write_datagram_rawdata(CData *cdata, BamWriter *manager, Datagram &me) {
   } else {
     me.add_uint8(cdata->_ram_images.size());
     for (size_t n = 0; n < cdata->_ram_images.size(); ++n) {
+      const PTA_uchar &image = cdata->_ram_images[n]._image;
       me.add_uint32(cdata->_ram_images[n]._page_size);
-      me.add_uint32(cdata->_ram_images[n]._image.size());
-      me.append_data(cdata->_ram_images[n]._image, cdata->_ram_images[n]._image.size());
+      me.add_uint32(image.size());
+
+      if (manager->get_file_minor_ver() >= 47) {
+        bool as_payload = manager->should_write_payload(image.size());
+        me.add_bool(as_payload);
+        if (as_payload) {
+          manager->write_payload(image.p(), image.size());
+          continue;
+        }
+      }
+      me.append_data(image, image.size());
     }
   }
 }
@@ -10486,6 +10739,28 @@ do_fillin_rawdata(CData *cdata, DatagramIterator &scan, BamReader *manager) {
     // fill the cdata->_image buffer with image data
     size_t u_size = scan.get_uint32();
 
+    bool as_payload = false;
+    if (manager->get_file_minor_ver() >= 47) {
+      as_payload = scan.get_bool();
+    }
+    if (as_payload) {
+      // The image was written as a payload record.  We still need our own
+      // copy, but we can make it straight from the memory-mapped file.
+      CPT(FileData) data = manager->read_payload();
+      if (data == nullptr || data->get_size() != u_size) {
+        gobj_cat.error()
+          << "RAM image " << n << " payload is missing or has the wrong size, "
+          << "is texture corrupt?\n";
+        return;
+      }
+
+      PTA_uchar image = PTA_uchar::empty_array(u_size, get_class_type());
+      memcpy(image.p(), data->get_data(), u_size);
+
+      cdata->_ram_images[n]._image = image;
+      continue;
+    }
+
     // Protect against large allocation.
     if (u_size > scan.get_remaining_size()) {
       gobj_cat.error()
@@ -10598,6 +10873,7 @@ CData() {
 
   _orig_file_x_size = 0;
   _orig_file_y_size = 0;
+  _stream_level = 0;
 
   _loaded_from_image = false;
   _loaded_from_txo = false;
@@ -10658,6 +10934,7 @@ do_assign(const Texture::CData *copy) {
   _pad_z_size = copy->_pad_z_size;
   _orig_file_x_size = copy->_orig_file_x_size;
   _orig_file_y_size = copy->_orig_file_y_size;
+  _stream_level = copy->_stream_level;
   _num_components = copy->_num_components;
   _component_width = copy->_component_width;
   _texture_type = copy->_texture_type;
@@ -46,6 +46,7 @@
 #include "pnmImage.h"
 #include "pfmFile.h"
 #include "asyncFuture.h"
+#include "atomicAdjust.h"
 
 class TextureContext;
 class FactoryParams;
@@ -575,6 +576,11 @@ PUBLISHED:
 
   void set_orig_file_size(int x, int y, int z = 1);
 
+  INLINE int get_stream_level() const;
+  void set_stream_level(int level);
+  MAKE_PROPERTY(stream_level, get_stream_level, set_stream_level);
+  INLINE void report_stream_demand(int size);
+
   INLINE void set_loaded_from_image(bool flag = true);
   INLINE bool get_loaded_from_image() const;
   MAKE_PROPERTY(loaded_from_image, get_loaded_from_image, set_loaded_from_image);
@@ -622,6 +628,10 @@ PUBLISHED:
 public:
   void texture_uploaded();
 
+  INLINE bool is_streamed() const;
+  INLINE void set_streamed(bool flag);
+  INLINE int reset_stream_demand();
+
   virtual bool has_cull_callback() const;
   virtual bool cull_callback(CullTraverser *trav, const CullTraverserData &data) const;
 
@@ -693,6 +703,7 @@ protected:
   bool do_write_txo(const CData *cdata, std::ostream &out, const std::string &filename) const;
 
   virtual CData *unlocked_ensure_ram_image(bool allow_compression);
+  void unlocked_restore_stream_level(int level);
   virtual void do_reload_ram_image(CData *cdata, bool allow_compression);
 
   PTA_uchar do_modify_ram_image(CData *cdata);
@@ -782,6 +793,8 @@ protected:
   void do_set_pad_size(CData *cdata, int x, int y, int z);
   virtual bool do_can_reload(const CData *cdata) const;
   bool do_reload(CData *cdata);
+  void do_set_stream_level(CData *cdata, int level);
+  int do_drop_top_mipmap_levels(CData *cdata, int num_levels);
 
   INLINE AutoTextureScale do_get_auto_texture_scale(const CData *cdata) const;
 
@@ -997,6 +1010,10 @@ protected:
     int _orig_file_x_size;
     int _orig_file_y_size;
 
+    // The number of mipmap levels that have been dropped from the top of the
+    // mipmap stack by set_stream_level().
+    int _stream_level;
+
     AutoTextureScale _auto_texture_scale;
     CompressionMode _ram_image_compression;
 
@@ -1066,6 +1083,11 @@ protected:
   // The TexturePool finds this useful.
   Filename _texture_pool_key;
 
+  // The largest size on screen, in pixels, that was reported for this
+  // texture by the cull traversal since the TextureStreamer last looked.  It
+  // is -1 if the texture is not being streamed.
+  AtomicAdjust::Integer _stream_demand;
+
 private:
   // The auxiliary data is not recorded to a bam file.
   typedef pmap<std::string, PT(TypedReferenceCount) > AuxData;
@@ -23,6 +23,7 @@
 #include "bamCacheRecord.h"
 #include "pnmFileTypeRegistry.h"
 #include "texturePoolFilter.h"
+#include "asyncTaskManager.h"
 #include "configVariableList.h"
 #include "load_dso.h"
 #include "mutexHolder.h"
@@ -417,6 +418,12 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
     cache->store(record);
   }
 
+  if (texture_streaming) {
+    // Keep only the smaller mipmap levels; the streamer will load the larger
+    // ones when the texture is seen up close.
+    ns_get_streamer()->add_texture(tex);
+  }
+
   if (!(options.get_texture_flags() & LoaderOptions::TF_preload)) {
     // And now drop the RAM until we need it.
     tex->clear_ram_image();
@@ -552,6 +559,12 @@ ns_load_texture(const Filename &orig_filename,
     cache->store(record);
   }
 
+  if (texture_streaming) {
+    // Keep only the smaller mipmap levels; the streamer will load the larger
+    // ones when the texture is seen up close.
+    ns_get_streamer()->add_texture(tex);
+  }
+
   if (!(options.get_texture_flags() & LoaderOptions::TF_preload)) {
     // And now drop the RAM until we need it.
     tex->clear_ram_image();
@@ -1015,6 +1028,28 @@ ns_garbage_collect() {
   return num_released;
 }
 
+/**
+ * The nonstatic implementation of get_streamer().
+ */
+TextureStreamer *TexturePool::
+ns_get_streamer() {
+  MutexHolder holder(_lock);
+  if (_streamer == nullptr) {
+    _streamer = new TextureStreamer;
+
+    AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+    std::string chain_name = _streamer->get_name();
+    if (task_mgr->find_task_chain(chain_name) == nullptr) {
+      PT(AsyncTaskChain) chain = task_mgr->make_task_chain(chain_name);
+      chain->set_num_threads(1);
+      chain->set_thread_priority(TP_low);
+    }
+    _streamer->set_task_chain(chain_name);
+    task_mgr->add(_streamer);
+  }
+  return _streamer;
+}
+
 /**
  * The nonstatic implementation of list_contents().
  */
@@ -24,6 +24,7 @@
 #include "pmutex.h"
 #include "pmap.h"
 #include "textureCollection.h"
+#include "textureStreamer.h"
 
 class TexturePoolFilter;
 class BamCache;
@@ -68,6 +69,8 @@ PUBLISHED:
 
   INLINE static int garbage_collect();
 
+  INLINE static TextureStreamer *get_streamer();
+
   INLINE static void list_contents(std::ostream &out);
   INLINE static void list_contents();
 
@@ -135,6 +138,7 @@ private:
   void ns_release_texture(Texture *texture);
   void ns_release_all_textures();
   int ns_garbage_collect();
+  TextureStreamer *ns_get_streamer();
   void ns_list_contents(std::ostream &out) const;
   Texture *ns_find_texture(const std::string &name) const;
   TextureCollection ns_find_all_textures(const std::string &name) const;
@@ -189,6 +193,8 @@ private:
   PT(Texture) _normalization_cube_map;
   PT(Texture) _alpha_scale_map;
 
+  PT(TextureStreamer) _streamer;
+
   typedef pmap<std::string, MakeTextureFunc *> TypeRegistry;
   TypeRegistry _type_registry;
 
@@ -0,0 +1,354 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file textureStreamer.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "textureStreamer.h"
+#include "config_gobj.h"
+#include "mutexHolder.h"
+
+#include <algorithm>
+
+TypeHandle TextureStreamer::_type_handle;
+
+/**
+ *
+ */
+TextureStreamer::
+TextureStreamer(const std::string &name) :
+  AsyncTask(name),
+  _budget((size_t)texture_stream_budget.get_value()),
+  _initial_size(std::max((int)texture_stream_initial_size, 1)),
+  _resident_size(0),
+  _frame(0)
+{
+  set_delay(texture_stream_interval);
+}
+
+/**
+ *
+ */
+TextureStreamer::
+~TextureStreamer() {
+  Entries::iterator ei;
+  for (ei = _entries.begin(); ei != _entries.end(); ++ei) {
+    PT(Texture) tex = (*ei).second._texture.lock();
+    if (tex != nullptr) {
+      tex->set_streamed(false);
+    }
+  }
+}
+
+/**
+ * Adds the indicated texture to the set of textures managed by this
+ * streamer, and reduces it to its initial size.  Returns true if the texture
+ * was added (or was already there), or false if it cannot be streamed: only
+ * 2-d textures that were loaded from an image file, and that are larger than
+ * get_initial_size(), can be streamed.
+ *
+ * The streamer does not keep the texture alive; it is forgotten when it is
+ * deleted.
+ */
+bool TextureStreamer::
+add_texture(Texture *tex) {
+  nassertr(tex != nullptr, false);
+  if (tex->get_type() != Texture::get_class_type() ||
+      tex->get_texture_type() != Texture::TT_2d_texture ||
+      !tex->get_loaded_from_image() || tex->get_fullpath().empty()) {
+    return false;
+  }
+
+  int min_level;
+  {
+    MutexHolder holder(_lock);
+    Entries::iterator ei = _entries.find(tex);
+    if (ei != _entries.end()) {
+      if (!(*ei).second._texture.was_deleted()) {
+        return true;
+      }
+      // This entry was left behind by a texture that has since been deleted,
+      // and whose memory has been reused for this one.
+      _entries.erase(ei);
+    }
+
+    // The texture may already have been reduced; work out its full size.
+    int level = tex->get_stream_level();
+    int max_size = std::max(tex->get_x_size(), tex->get_y_size()) << level;
+    if (max_size <= _initial_size) {
+      return false;
+    }
+
+    Entry entry;
+    entry._texture = tex;
+    entry._full_size = tex->get_expected_ram_image_size() << (2 * level);
+    entry._max_size = max_size;
+    entry._min_level = 0;
+    while ((max_size >> entry._min_level) > _initial_size) {
+      ++entry._min_level;
+    }
+    entry._level = entry._min_level;
+    entry._wanted_level = entry._min_level;
+    entry._demand = 0;
+    entry._last_seen = _frame;
+    entry._changed = false;
+    _entries[tex] = entry;
+    _resident_size += get_level_size(entry, entry._level);
+    min_level = entry._min_level;
+  }
+
+  tex->set_streamed(true);
+  tex->set_stream_level(min_level);
+  return true;
+}
+
+/**
+ * Removes the indicated texture from the set of textures managed by this
+ * streamer, and restores it to its full size.  Returns true if it was
+ * removed, or false if it was not being managed by this streamer.
+ */
+bool TextureStreamer::
+remove_texture(Texture *tex) {
+  {
+    MutexHolder holder(_lock);
+    Entries::iterator ei = _entries.find(tex);
+    if (ei == _entries.end()) {
+      return false;
+    }
+    const Entry &entry = (*ei).second;
+    _resident_size -= std::min(_resident_size, get_level_size(entry, entry._level));
+    _entries.erase(ei);
+  }
+
+  tex->set_streamed(false);
+  tex->set_stream_level(0);
+  return true;
+}
+
+/**
+ * Returns true if the indicated texture is managed by this streamer.
+ */
+bool TextureStreamer::
+has_texture(Texture *tex) const {
+  MutexHolder holder(_lock);
+  Entries::const_iterator ei = _entries.find(tex);
+  return (ei != _entries.end() && !(*ei).second._texture.was_deleted());
+}
+
+/**
+ * Returns the number of textures managed by this streamer.  This may include
+ * textures that have been deleted since the last call to update().
+ */
+size_t TextureStreamer::
+get_num_textures() const {
+  MutexHolder holder(_lock);
+  return _entries.size();
+}
+
+/**
+ * Returns the estimated number of bytes occupied by the resident mipmap
+ * levels of the textures managed by this streamer, as of the last call to
+ * update().
+ */
+size_t TextureStreamer::
+get_resident_size() const {
+  MutexHolder holder(_lock);
+  return _resident_size;
+}
+
+/**
+ * Collects the sizes reported by the cull traversal since the last call, and
+ * loads the next larger mipmap level of the textures that are rendered larger
+ * than their current size, as far as the budget allows.  Textures that are
+ * larger than they need to be are reduced to make room, starting with the
+ * ones that have gone unseen the longest.
+ *
+ * This is normally called periodically by the task, but it may also be
+ * called directly.  The reloading is done in the calling thread.
+ */
+void TextureStreamer::
+update() {
+  struct Change {
+    PT(Texture) _texture;
+    int _level;
+    bool _seen;
+  };
+  pvector<Change> changes;
+
+  {
+    MutexHolder holder(_lock);
+    ++_frame;
+
+    pvector<Entry *> upgrade;
+    pvector<Entry *> evict;
+    size_t resident = 0;
+
+    Entries::iterator ei = _entries.begin();
+    while (ei != _entries.end()) {
+      Entry &entry = (*ei).second;
+      PT(Texture) tex = entry._texture.lock();
+      if (tex == nullptr) {
+        ei = _entries.erase(ei);
+        continue;
+      }
+
+      entry._changed = false;
+      entry._demand = tex->reset_stream_demand();
+      if (entry._demand > 0) {
+        entry._last_seen = _frame;
+        entry._wanted_level = get_wanted_level(entry, entry._demand);
+      } else {
+        entry._wanted_level = entry._min_level;
+      }
+
+      if (entry._level > entry._wanted_level) {
+        upgrade.push_back(&entry);
+      } else if (entry._level < entry._wanted_level) {
+        evict.push_back(&entry);
+      }
+      resident += get_level_size(entry, entry._level);
+      ++ei;
+    }
+
+    std::sort(upgrade.begin(), upgrade.end(), CompareUpgrade());
+    std::sort(evict.begin(), evict.end(), CompareEvict());
+
+    // First, if we are over budget (because the budget was lowered, or
+    // because of textures that were added), reduce the textures that are
+    // larger than they need to be.
+    size_t ev = 0;
+    while (resident > _budget && ev < evict.size()) {
+      if (reduce(evict[ev], resident)) {
+        ++ev;
+      }
+    }
+
+    // Now load the larger levels of each texture that wants them, most
+    // urgent first, making room as needed.  Since every upgrade reads the
+    // whole file again, we go as far towards the wanted level as the budget
+    // allows in one step, rather than one level at a time.
+    for (Entry *entry : upgrade) {
+      size_t current = get_level_size(*entry, entry->_level);
+      int level = entry->_level;
+      while (level > entry->_wanted_level) {
+        size_t extra = get_level_size(*entry, level - 1) - current;
+        while (resident + extra > _budget && ev < evict.size()) {
+          if (reduce(evict[ev], resident)) {
+            ++ev;
+          }
+        }
+        if (resident + extra > _budget) {
+          break;
+        }
+        --level;
+      }
+      if (level == entry->_level) {
+        break;
+      }
+      resident += get_level_size(*entry, level) - current;
+      entry->_level = level;
+      entry->_changed = true;
+      if (level > entry->_wanted_level) {
+        // We ran out of budget.
+        break;
+      }
+    }
+
+    for (ei = _entries.begin(); ei != _entries.end(); ++ei) {
+      Entry &entry = (*ei).second;
+      if (entry._changed) {
+        Change change;
+        change._texture = entry._texture.lock();
+        change._level = entry._level;
+        change._seen = (entry._last_seen == _frame);
+        changes.push_back(std::move(change));
+      }
+    }
+    _resident_size = resident;
+  }
+
+  // Do the actual work without holding the lock, since it may involve
+  // reading from disk.
+  for (const Change &change : changes) {
+    Texture *tex = change._texture;
+    if (tex == nullptr) {
+      continue;
+    }
+    bool reduced = (change._level > tex->get_stream_level());
+    tex->set_stream_level(change._level);
+
+    if (reduced) {
+      if (change._seen) {
+        // It's still being rendered, so load the reduced image now, rather
+        // than leaving it to the draw thread.
+        if (!tex->has_ram_image()) {
+          tex->get_ram_image();
+        }
+      } else {
+        // Nobody is looking at it, so free the graphics memory now.  It will
+        // be reloaded at its new size when it is rendered again.
+        tex->release_all();
+      }
+    }
+  }
+
+  if (gobj_cat.is_debug() && !changes.empty()) {
+    gobj_cat.debug()
+      << "Changed mipmap levels of " << changes.size()
+      << " streamed textures, " << get_resident_size() << " bytes resident\n";
+  }
+}
+
+/**
+ * Runs one pass of update().
+ */
+AsyncTask::DoneStatus TextureStreamer::
+do_task() {
+  update();
+  return DS_again;
+}
+
+/**
+ * Removes one more mipmap level from the indicated texture, which is larger
+ * than it needs to be, and updates the resident size accordingly.  Returns
+ * true if the texture is now no larger than it needs to be.
+ */
+bool TextureStreamer::
+reduce(Entry *entry, size_t &resident) {
+  resident -= get_level_size(*entry, entry->_level) -
+              get_level_size(*entry, entry->_level + 1);
+  ++entry->_level;
+  entry->_changed = true;
+  return (entry->_level >= entry->_wanted_level);
+}
+
+/**
+ * Returns the estimated number of bytes occupied by the indicated texture
+ * when the indicated number of mipmap levels have been removed from it,
+ * including the smaller mipmap levels.
+ */
+size_t TextureStreamer::
+get_level_size(const Entry &entry, int level) {
+  size_t size = entry._full_size >> (2 * level);
+  return size + size / 3;
+}
+
+/**
+ * Returns the number of mipmap levels that may be removed from the indicated
+ * texture while keeping it at least as large as the indicated size on screen.
+ */
+int TextureStreamer::
+get_wanted_level(const Entry &entry, int demand) {
+  int level = entry._min_level;
+  while (level > 0 && (entry._max_size >> level) < demand) {
+    --level;
+  }
+  return level;
+}
@@ -0,0 +1,128 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file textureStreamer.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include "pandabase.h"
+
+#include "asyncTask.h"
+#include "texture.h"
+#include "weakPointerTo.h"
+#include "pmutex.h"
+#include "pmap.h"
+
+/**
+ * Decides which mipmap levels of a set of textures should be resident,
+ * according to how large the textures appear on the screen, while keeping
+ * the total memory they use within a budget.
+ *
+ * A texture added to the streamer is first reduced so that it is no larger
+ * than get_initial_size() (see Texture::set_stream_level()).  The cull
+ * traversal reports the size at which each streamed texture is rendered, and
+ * each time update() is called, each texture that is rendered larger than
+ * its current size is loaded from disk again at the size it is rendered at,
+ * or as close to it as the budget allows.  To make room, textures that are
+ * larger than they need to be are reduced again, starting with the ones that
+ * have gone unseen the longest.
+ *
+ * The streamer is an AsyncTask, which calls update() periodically.  The
+ * TexturePool creates one on its own task chain, which see
+ * TexturePool::get_streamer().
+ */
+class EXPCL_PANDA_GOBJ TextureStreamer : public AsyncTask {
+public:
+  ALLOC_DELETED_CHAIN(TextureStreamer);
+
+PUBLISHED:
+  explicit TextureStreamer(const std::string &name = "texture_streamer");
+  virtual ~TextureStreamer();
+
+  bool add_texture(Texture *tex);
+  bool remove_texture(Texture *tex);
+  bool has_texture(Texture *tex) const;
+  size_t get_num_textures() const;
+  MAKE_PROPERTY(num_textures, get_num_textures);
+
+  INLINE void set_budget(size_t budget);
+  INLINE size_t get_budget() const;
+  MAKE_PROPERTY(budget, get_budget, set_budget);
+
+  INLINE void set_initial_size(int size);
+  INLINE int get_initial_size() const;
+  MAKE_PROPERTY(initial_size, get_initial_size, set_initial_size);
+
+  size_t get_resident_size() const;
+  MAKE_PROPERTY(resident_size, get_resident_size);
+
+  BLOCKING void update();
+
+protected:
+  virtual DoneStatus do_task();
+
+private:
+  class Entry {
+  public:
+    WPT(Texture) _texture;
+    size_t _full_size;
+    int _max_size;
+    int _min_level;
+    int _level;
+    int _wanted_level;
+    int _demand;
+    int _last_seen;
+    bool _changed;
+  };
+
+  static bool reduce(Entry *entry, size_t &resident);
+  static size_t get_level_size(const Entry &entry, int level);
+  static int get_wanted_level(const Entry &entry, int demand);
+
+  class CompareUpgrade {
+  public:
+    INLINE bool operator () (const Entry *a, const Entry *b) const;
+  };
+  class CompareEvict {
+  public:
+    INLINE bool operator () (const Entry *a, const Entry *b) const;
+  };
+
+  mutable Mutex _lock;
+  typedef pmap<const Texture *, Entry> Entries;
+  Entries _entries;
+  size_t _budget;
+  int _initial_size;
+  size_t _resident_size;
+  int _frame;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AsyncTask::init_type();
+    register_type(_type_handle, "TextureStreamer",
+                  AsyncTask::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "textureStreamer.I"
+
+#endif
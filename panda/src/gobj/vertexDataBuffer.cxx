@@ -39,6 +39,7 @@ operator = (const VertexDataBuffer &copy) {
   _size = copy._size;
   _reserved_size = copy._size;
   _block = copy._block;
+  _mapped_data = copy._mapped_data;
   nassertv(_reserved_size >= _size);
 }
 
@@ -55,6 +56,7 @@ swap(VertexDataBuffer &other) {
   size_t reserved_size = _reserved_size;
 
   _block.swap(other._block);
+  _mapped_data.swap(other._mapped_data);
 
   _resident_data = other._resident_data;
   _size = other._size;
@@ -66,6 +68,41 @@ swap(VertexDataBuffer &other) {
   nassertv(_reserved_size >= _size);
 }
 
+/**
+ * Replaces the contents of the buffer with the indicated data.  If the data
+ * is a suitably aligned view into a memory-mapped file, the buffer keeps a
+ * reference to it and reads from it directly, without copying it; it is
+ * copied only if the buffer is later modified.  Otherwise, the data is copied
+ * into independent memory now.
+ */
+void VertexDataBuffer::
+set_mapped_data(const FileData *data) {
+  LightMutexHolder holder(_lock);
+  nassertv(data != nullptr);
+
+  size_t size = data->get_size();
+  if (size == 0) {
+    do_unclean_realloc(0);
+    return;
+  }
+
+  if (!data->is_mapped() ||
+      ((uintptr_t)data->get_data() % MEMORY_HOOK_ALIGNMENT) != 0) {
+    // There is nothing to gain from holding on to a copy that was made while
+    // reading the file, which may be part of a much larger block.  We also
+    // can't hand out a misaligned pointer.  In either case, we copy it.
+    do_unclean_realloc(size);
+    memcpy(_resident_data, data->get_data(), size);
+    _size = size;
+    return;
+  }
+
+  do_unclean_realloc(0);
+  _mapped_data = data;
+  _size = size;
+  _reserved_size = size;
+}
+
 /**
  * Changes the reserved size of the buffer, preserving its data (except for
  * any data beyond the new end of the buffer, if the buffer is being reduced).
@@ -121,6 +158,7 @@ do_unclean_realloc(size_t reserved_size) {
 
     // If we're paged out, discard the page.
     _block = nullptr;
+    _mapped_data = nullptr;
 
     if (_resident_data != nullptr) {
       nassertv(_reserved_size != 0);
@@ -151,8 +189,9 @@ do_unclean_realloc(size_t reserved_size) {
  */
 void VertexDataBuffer::
 do_page_out(VertexDataBook &book) {
-  if (_block != nullptr || _reserved_size == 0) {
-    // We're already paged out.
+  if (_block != nullptr || _mapped_data != nullptr || _reserved_size == 0) {
+    // We're already paged out, or we can always get the data back from the
+    // file we're mapped to.
     return;
   }
   nassertv(_resident_data != nullptr);
@@ -194,9 +233,21 @@ do_page_in() {
     return;
   }
 
-  nassertv(_block != nullptr);
   nassertv(_reserved_size == _size);
 
+  if (_mapped_data != nullptr) {
+    // Make a private copy of the mapped data.  We no longer need the mapping
+    // after this.
+    _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
+    nassertv(_resident_data != nullptr);
+
+    memcpy(_resident_data, _mapped_data->get_data(), _size);
+    _mapped_data = nullptr;
+    return;
+  }
+
+  nassertv(_block != nullptr);
+
   _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
   nassertv(_resident_data != nullptr);
 
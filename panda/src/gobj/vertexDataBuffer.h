@@ -19,6 +19,7 @@
 #include "vertexDataBlock.h"
 #include "pointerTo.h"
 #include "virtualFile.h"
+#include "fileData.h"
 #include "pStatCollector.h"
 #include "lightMutex.h"
 #include "lightMutexHolder.h"
@@ -27,7 +28,7 @@
  * A block of bytes that stores the actual raw vertex data referenced by a
  * GeomVertexArrayData object.
  *
- * At any point, a buffer may be in any of two states:
+ * At any point, a buffer may be in any of three states:
  *
  * independent - the buffer's memory is resident, and owned by the
  * VertexDataBuffer object itself (in _resident_data).  In this state,
@@ -39,6 +40,11 @@
  * memory is considered read-only.  In this state, _reserved_size will always
  * equal _size.
  *
+ * mapped - the buffer's memory is a read-only view into a FileData, typically
+ * a memory-mapped .bam file (in _mapped_data).  As with the paged state,
+ * _reserved_size will always equal _size, and any attempt to modify the
+ * buffer will first copy it into independent memory.
+ *
  * VertexDataBuffers start out in independent state.  They get moved to paged
  * state when their owning GeomVertexArrayData objects get evicted from the
  * _independent_lru.  They can get moved back to independent state if they are
@@ -66,6 +72,8 @@ public:
   INLINE void clean_realloc(size_t reserved_size);
   INLINE void unclean_realloc(size_t reserved_size);
   INLINE void clear();
+  void set_mapped_data(const FileData *data);
+  INLINE bool is_mapped() const;
 
   INLINE void page_out(VertexDataBook &book);
 
@@ -82,6 +90,7 @@ private:
   size_t _size;
   size_t _reserved_size;
   PT(VertexDataBlock) _block;
+  CPT(FileData) _mapped_data;
   LightMutex _lock;
 
 public:
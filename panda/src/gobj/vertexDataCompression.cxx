@@ -0,0 +1,64 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file vertexDataCompression.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "vertexDataCompression.h"
+#include "string_utils.h"
+#include "config_gobj.h"
+
+using std::istream;
+using std::ostream;
+using std::string;
+
+ostream &
+operator << (ostream &out, VertexDataCompression vdc) {
+  switch (vdc) {
+  case VDC_none:
+    return out << "none";
+
+  case VDC_zlib:
+    return out << "zlib";
+
+  case VDC_lz4:
+    return out << "lz4";
+
+  case VDC_zstd:
+    return out << "zstd";
+  }
+
+  return out << "**invalid VertexDataCompression (" << (int)vdc << ")**";
+}
+
+istream &
+operator >> (istream &in, VertexDataCompression &vdc) {
+  string word;
+  in >> word;
+
+  if (cmp_nocase(word, "none") == 0) {
+    vdc = VDC_none;
+
+  } else if (cmp_nocase(word, "zlib") == 0) {
+    vdc = VDC_zlib;
+
+  } else if (cmp_nocase(word, "lz4") == 0) {
+    vdc = VDC_lz4;
+
+  } else if (cmp_nocase(word, "zstd") == 0) {
+    vdc = VDC_zstd;
+
+  } else {
+    gobj_cat->error() << "Invalid VertexDataCompression value: " << word << "\n";
+    vdc = VDC_none;
+  }
+
+  return in;
+}
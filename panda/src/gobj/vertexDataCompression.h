@@ -0,0 +1,34 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file vertexDataCompression.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef VERTEXDATACOMPRESSION_H
+#define VERTEXDATACOMPRESSION_H
+
+#include "pandabase.h"
+
+// The codec with which a VertexDataPage is compressed, in RAM or in the
+// VertexDataSaveFile.  zlib compresses best, but is slow; lz4 is by far the
+// fastest, and zstd is somewhere in between.
+BEGIN_PUBLISH
+enum VertexDataCompression {
+  VDC_none,
+  VDC_zlib,
+  VDC_lz4,
+  VDC_zstd,
+};
+END_PUBLISH
+
+EXPCL_PANDA_GOBJ std::ostream &operator << (std::ostream &out, VertexDataCompression vdc);
+EXPCL_PANDA_GOBJ std::istream &operator >> (std::istream &in, VertexDataCompression &vdc);
+
+#endif
@@ -13,6 +13,7 @@
 
 #include "vertexDataPage.h"
 #include "configVariableInt.h"
+#include "configVariableEnum.h"
 #include "vertexDataSaveFile.h"
 #include "vertexDataBook.h"
 #include "vertexDataBlock.h"
@@ -25,6 +26,14 @@
 #include <zlib.h>
 #endif
 
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
 ConfigVariableInt max_resident_vertex_data
 ("max-resident-vertex-data", -1,
  PRC_DESC("Specifies the maximum number of bytes of all vertex data "
@@ -41,11 +50,28 @@ ConfigVariableInt max_compressed_vertex_data
           "the least-recently-used ones will be temporarily flushed to "
           "disk until they are needed.  Set it to -1 for no limit."));
 
+ConfigVariableEnum<VertexDataCompression> vertex_data_compression
+("vertex-data-compression", VDC_zlib,
+ PRC_DESC("Specifies the codec used to compress vertex data in system RAM, "
+          "when max-resident-vertex-data is exceeded.  This may be zlib, "
+          "lz4, zstd, or none.  lz4 is many times faster than zlib, at the "
+          "cost of a somewhat worse compression ratio.  If Panda was not "
+          "compiled with the requested codec, zlib is used instead."));
+
+ConfigVariableEnum<VertexDataCompression> vertex_save_file_compression
+("vertex-save-file-compression", VDC_none,
+ PRC_DESC("Specifies the codec used to compress vertex data that is written "
+          "to the save file on disk, if it wasn't already compressed in "
+          "RAM.  This may be zlib, lz4, zstd, or none.  zstd is a good "
+          "choice, since it compresses about as well as zlib but is much "
+          "faster to decompress."));
+
 ConfigVariableInt vertex_data_compression_level
 ("vertex-data-compression-level", 1,
- PRC_DESC("Specifies the zlib compression level to use when compressing "
-          "vertex data.  The number should be in the range 1 to 9, where "
-          "larger values are slower but give better compression."));
+ PRC_DESC("Specifies the compression level to use when compressing "
+          "vertex data with zlib or zstd.  The number should be in the "
+          "range 1 to 9 for zlib, or 1 to 19 for zstd, where larger values "
+          "are slower but give better compression.  It is ignored by lz4."));
 
 ConfigVariableInt max_disk_vertex_data
 ("max-disk-vertex-data", -1,
@@ -78,6 +104,8 @@ Mutex VertexDataPage::_unused_mutex;
 
 PStatCollector VertexDataPage::_vdata_compress_pcollector("*:Vertex Data:Compress");
 PStatCollector VertexDataPage::_vdata_decompress_pcollector("*:Vertex Data:Decompress");
+PStatCollector VertexDataPage::_vdata_compress_bytes_pcollector("Vertex Data throughput:Compress");
+PStatCollector VertexDataPage::_vdata_decompress_bytes_pcollector("Vertex Data throughput:Decompress");
 PStatCollector VertexDataPage::_vdata_save_pcollector("*:Vertex Data:Save");
 PStatCollector VertexDataPage::_vdata_restore_pcollector("*:Vertex Data:Restore");
 PStatCollector VertexDataPage::_thread_wait_pcollector("Wait:Idle");
@@ -114,6 +142,7 @@ VertexDataPage(size_t book_size) :
   _page_data = nullptr;
   _size = 0;
   _uncompressed_size = 0;
+  _compression = VDC_none;
   _ram_class = RC_resident;
   _pending_ram_class = RC_resident;
 }
@@ -134,6 +163,7 @@ VertexDataPage(VertexDataBook *book, size_t page_size, size_t block_size) :
   _size = page_size;
 
   _uncompressed_size = _size;
+  _compression = VDC_none;
   _pending_ram_class = RC_resident;
   set_ram_class(RC_resident);
 }
@@ -348,76 +378,29 @@ make_resident() {
   }
 
   if (_ram_class == RC_compressed) {
-#ifdef HAVE_ZLIB
-    PStatTimer timer(_vdata_decompress_pcollector);
+    if (_compression != VDC_none) {
+      PStatTimer timer(_vdata_decompress_pcollector);
 
-    if (gobj_cat.is_debug()) {
-      gobj_cat.debug()
-        << "Expanding page from " << _size
-        << " to " << _uncompressed_size << "\n";
-    }
-    size_t new_allocated_size = round_up(_uncompressed_size);
-    unsigned char *new_data = alloc_page_data(new_allocated_size);
-    unsigned char *end_data = new_data + new_allocated_size;
-
-    z_stream z_source;
-#ifdef USE_MEMORY_NOWRAPPERS
-    z_source.zalloc = Z_NULL;
-    z_source.zfree = Z_NULL;
-#else
-    z_source.zalloc = (alloc_func)&do_zlib_alloc;
-    z_source.zfree = (free_func)&do_zlib_free;
-#endif
-
-    z_source.opaque = Z_NULL;
-    z_source.msg = (char *) "no error message";
-
-    z_source.next_in = (Bytef *)(char *)_page_data;
-    z_source.avail_in = _size;
-    z_source.next_out = (Bytef *)new_data;
-    z_source.avail_out = new_allocated_size;
-
-    int result = inflateInit(&z_source);
-    if (result < 0) {
-      nassert_raise("zlib error");
-      return;
-    }
-    Thread::consider_yield();
+      if (gobj_cat.is_debug()) {
+        gobj_cat.debug()
+          << "Expanding page from " << _size
+          << " to " << _uncompressed_size << " with " << _compression << "\n";
+      }
+      size_t new_allocated_size = round_up(_uncompressed_size);
+      unsigned char *new_data = alloc_page_data(new_allocated_size);
 
-    size_t output_size = 0;
-
-    int flush = 0;
-    result = 0;
-    while (result != Z_STREAM_END) {
-      unsigned char *start_out = (unsigned char *)z_source.next_out;
-      nassertv(start_out < end_data);
-      z_source.avail_out = std::min((size_t)(end_data - start_out), (size_t)inflate_page_size);
-      nassertv(z_source.avail_out != 0);
-      result = inflate(&z_source, flush);
-      if (result < 0 && result != Z_BUF_ERROR) {
-        nassert_raise("zlib error");
+      if (!decompress_data(_compression, _page_data, _size, new_data, _uncompressed_size)) {
+        free_page_data(new_data, new_allocated_size);
         return;
       }
-      size_t bytes_produced = (size_t)((unsigned char *)z_source.next_out - start_out);
-      output_size += bytes_produced;
-      if (bytes_produced == 0) {
-        // If we ever produce no bytes, then start flushing the output.
-        flush = Z_FINISH;
-      }
+      _vdata_decompress_bytes_pcollector.add_level(_uncompressed_size);
 
-      Thread::consider_yield();
+      free_page_data(_page_data, _allocated_size);
+      _page_data = new_data;
+      _size = _uncompressed_size;
+      _allocated_size = new_allocated_size;
+      _compression = VDC_none;
     }
-    nassertv(z_source.avail_in == 0);
-    nassertv(output_size == _uncompressed_size);
-
-    result = inflateEnd(&z_source);
-    nassertv(result == Z_OK);
-
-    free_page_data(_page_data, _allocated_size);
-    _page_data = new_data;
-    _size = _uncompressed_size;
-    _allocated_size = new_allocated_size;
-#endif
 
     set_lru_size(_size);
     set_ram_class(RC_resident);
@@ -445,109 +428,368 @@ make_compressed() {
   if (_ram_class == RC_resident) {
     nassertv(_size == _uncompressed_size);
 
+    VertexDataCompression compression = choose_compression(vertex_data_compression);
+    if (compression != VDC_none) {
+      PStatTimer timer(_vdata_compress_pcollector);
+
+      size_t output_size, new_allocated_size;
+      unsigned char *new_data =
+        compress_data(compression, _page_data, _uncompressed_size,
+                      output_size, new_allocated_size);
+      if (new_data == nullptr) {
+        return;
+      }
+      _vdata_compress_bytes_pcollector.add_level(_uncompressed_size);
+
+      // Now free the original, uncompressed data, and put this new compressed
+      // buffer in its place.
+      free_page_data(_page_data, _allocated_size);
+      _page_data = new_data;
+      _size = output_size;
+      _allocated_size = new_allocated_size;
+      _compression = compression;
+
+      if (gobj_cat.is_debug()) {
+        gobj_cat.debug()
+          << "Compressed " << *this << " from " << _uncompressed_size
+          << " to " << _size << " with " << _compression << "\n";
+      }
+    }
+    set_lru_size(_size);
+    set_ram_class(RC_compressed);
+  }
+}
+
+/**
+ * Returns true if Panda was compiled with support for the indicated codec.
+ * VDC_none is always available.
+ */
+bool VertexDataPage::
+is_compression_available(VertexDataCompression compression) {
+  switch (compression) {
+  case VDC_none:
+    return true;
+
+  case VDC_zlib:
 #ifdef HAVE_ZLIB
-    PStatTimer timer(_vdata_compress_pcollector);
+    return true;
+#else
+    return false;
+#endif
+
+  case VDC_lz4:
+#ifdef HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
 
-    DeflatePage *page = new DeflatePage;
-    DeflatePage *head = page;
+  case VDC_zstd:
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  return false;
+}
+
+/**
+ * Returns the indicated codec if it is available, or the best available
+ * substitute if it is not.
+ */
+VertexDataCompression VertexDataPage::
+choose_compression(VertexDataCompression compression) {
+  if (is_compression_available(compression)) {
+    return compression;
+  }
+
+  // This may be called by several threads at once.
+  static AtomicAdjust::Integer warned = 0;
+  if (AtomicAdjust::set(warned, 1) == 0) {
+    gobj_cat.warning()
+      << "Vertex data compression " << compression
+      << " is not available; using zlib instead.\n";
+  }
+  return is_compression_available(VDC_zlib) ? VDC_zlib : VDC_none;
+}
+
+/**
+ * Compresses size bytes of source with the indicated codec into a newly
+ * allocated page buffer, which is returned.  compressed_size is filled in
+ * with the number of bytes of compressed data, and allocated_size with the
+ * size of the buffer.  Returns NULL on failure.
+ */
+unsigned char *VertexDataPage::
+compress_data(VertexDataCompression compression,
+              const unsigned char *source, size_t source_size,
+              size_t &compressed_size, size_t &allocated_size) const {
+  switch (compression) {
+  case VDC_zlib:
+#ifdef HAVE_ZLIB
+    {
+      DeflatePage *page = new DeflatePage;
+      DeflatePage *head = page;
 
-    z_stream z_dest;
+      z_stream z_dest;
 #ifdef USE_MEMORY_NOWRAPPERS
-    z_dest.zalloc = Z_NULL;
-    z_dest.zfree = Z_NULL;
+      z_dest.zalloc = Z_NULL;
+      z_dest.zfree = Z_NULL;
 #else
-    z_dest.zalloc = (alloc_func)&do_zlib_alloc;
-    z_dest.zfree = (free_func)&do_zlib_free;
+      z_dest.zalloc = (alloc_func)&do_zlib_alloc;
+      z_dest.zfree = (free_func)&do_zlib_free;
 #endif
 
-    z_dest.opaque = Z_NULL;
-    z_dest.msg = (char *) "no error message";
+      z_dest.opaque = Z_NULL;
+      z_dest.msg = (char *) "no error message";
 
-    int result = deflateInit(&z_dest, vertex_data_compression_level);
-    if (result < 0) {
-      nassert_raise("zlib error");
-      return;
-    }
-    Thread::consider_yield();
+      int result = deflateInit(&z_dest, vertex_data_compression_level);
+      if (result < 0) {
+        nassert_raise("zlib error");
+        return nullptr;
+      }
+      Thread::consider_yield();
 
-    z_dest.next_in = (Bytef *)(char *)_page_data;
-    z_dest.avail_in = _uncompressed_size;
-    size_t output_size = 0;
-
-    // Compress the data into one or more individual pages.  We have to
-    // compress it page-at-a-time, since we're not really sure how big the
-    // result will be (so we can't easily pre-allocate a buffer).
-    int flush = 0;
-    result = 0;
-    while (result != Z_STREAM_END) {
-      unsigned char *start_out = (page->_buffer + page->_used_size);
-      z_dest.next_out = (Bytef *)start_out;
-      z_dest.avail_out = (size_t)deflate_page_size - page->_used_size;
-      if (z_dest.avail_out == 0) {
-        DeflatePage *new_page = new DeflatePage;
-        page->_next = new_page;
-        page = new_page;
-        start_out = page->_buffer;
+      z_dest.next_in = (Bytef *)(char *)source;
+      z_dest.avail_in = source_size;
+      size_t output_size = 0;
+
+      // Compress the data into one or more individual pages.  We have to
+      // compress it page-at-a-time, since we're not really sure how big the
+      // result will be (so we can't easily pre-allocate a buffer).
+      int flush = 0;
+      result = 0;
+      while (result != Z_STREAM_END) {
+        unsigned char *start_out = (page->_buffer + page->_used_size);
         z_dest.next_out = (Bytef *)start_out;
-        z_dest.avail_out = deflate_page_size;
+        z_dest.avail_out = (size_t)deflate_page_size - page->_used_size;
+        if (z_dest.avail_out == 0) {
+          DeflatePage *new_page = new DeflatePage;
+          page->_next = new_page;
+          page = new_page;
+          start_out = page->_buffer;
+          z_dest.next_out = (Bytef *)start_out;
+          z_dest.avail_out = deflate_page_size;
+        }
+
+        result = deflate(&z_dest, flush);
+        if (result < 0 && result != Z_BUF_ERROR) {
+          nassert_raise("zlib error");
+          return nullptr;
+        }
+        size_t bytes_produced = (size_t)((unsigned char *)z_dest.next_out - start_out);
+        page->_used_size += bytes_produced;
+        nassertr(page->_used_size <= deflate_page_size, nullptr);
+        output_size += bytes_produced;
+        if (bytes_produced == 0) {
+          // If we ever produce no bytes, then start flushing the output.
+          flush = Z_FINISH;
+        }
+
+        Thread::consider_yield();
+      }
+      nassertr(z_dest.avail_in == 0, nullptr);
+
+      result = deflateEnd(&z_dest);
+      nassertr(result == Z_OK, nullptr);
+
+      // Now we know how big the result will be.  Allocate a buffer, and copy
+      // the data from the various pages.
+      allocated_size = round_up(output_size);
+      unsigned char *new_data = alloc_page_data(allocated_size);
+
+      size_t copied_size = 0;
+      unsigned char *p = new_data;
+      page = head;
+      while (page != nullptr) {
+        memcpy(p, page->_buffer, page->_used_size);
+        copied_size += page->_used_size;
+        p += page->_used_size;
+        DeflatePage *next = page->_next;
+        delete page;
+        page = next;
       }
+      nassertr(copied_size == output_size, new_data);
 
-      result = deflate(&z_dest, flush);
-      if (result < 0 && result != Z_BUF_ERROR) {
-        nassert_raise("zlib error");
-        return;
+      compressed_size = output_size;
+      return new_data;
+    }
+#else
+    break;
+#endif  // HAVE_ZLIB
+
+  case VDC_lz4:
+#ifdef HAVE_LZ4
+    {
+      // lz4 knows the largest size the output can be, so we can compress it
+      // in one go.  We still copy the result into a page of the right size,
+      // though, since the point is to use less memory.
+      int bound = LZ4_compressBound((int)source_size);
+      char *buffer = (char *)PANDA_MALLOC_ARRAY(bound);
+      int output_size = LZ4_compress_default((const char *)source, buffer,
+                                             (int)source_size, bound);
+      if (output_size <= 0) {
+        PANDA_FREE_ARRAY(buffer);
+        nassert_raise("lz4 error");
+        return nullptr;
       }
-      size_t bytes_produced = (size_t)((unsigned char *)z_dest.next_out - start_out);
-      page->_used_size += bytes_produced;
-      nassertv(page->_used_size <= deflate_page_size);
-      output_size += bytes_produced;
-      if (bytes_produced == 0) {
-        // If we ever produce no bytes, then start flushing the output.
-        flush = Z_FINISH;
+
+      allocated_size = round_up(output_size);
+      unsigned char *new_data = alloc_page_data(allocated_size);
+      memcpy(new_data, buffer, output_size);
+      PANDA_FREE_ARRAY(buffer);
+
+      compressed_size = output_size;
+      return new_data;
+    }
+#else
+    break;
+#endif  // HAVE_LZ4
+
+  case VDC_zstd:
+#ifdef HAVE_ZSTD
+    {
+      size_t bound = ZSTD_compressBound(source_size);
+      void *buffer = PANDA_MALLOC_ARRAY(bound);
+      size_t output_size = ZSTD_compress(buffer, bound, source, source_size,
+                                         vertex_data_compression_level);
+      if (ZSTD_isError(output_size)) {
+        PANDA_FREE_ARRAY(buffer);
+        nassert_raise("zstd error");
+        return nullptr;
       }
 
-      Thread::consider_yield();
+      allocated_size = round_up(output_size);
+      unsigned char *new_data = alloc_page_data(allocated_size);
+      memcpy(new_data, buffer, output_size);
+      PANDA_FREE_ARRAY(buffer);
+
+      compressed_size = output_size;
+      return new_data;
     }
-    nassertv(z_dest.avail_in == 0);
+#else
+    break;
+#endif  // HAVE_ZSTD
 
-    result = deflateEnd(&z_dest);
-    nassertv(result == Z_OK);
+  case VDC_none:
+    break;
+  }
 
-    // Now we know how big the result will be.  Allocate a buffer, and copy
-    // the data from the various pages.
+  nassert_raise("unsupported vertex data compression");
+  return nullptr;
+}
 
-    size_t new_allocated_size = round_up(output_size);
-    unsigned char *new_data = alloc_page_data(new_allocated_size);
+/**
+ * Decompresses source_size bytes of source, which were compressed with the
+ * indicated codec, into dest, which must be exactly large enough to hold the
+ * uncompressed data.  Returns true on success, false on failure.
+ */
+bool VertexDataPage::
+decompress_data(VertexDataCompression compression,
+                const unsigned char *source, size_t source_size,
+                unsigned char *dest, size_t dest_size) const {
+  switch (compression) {
+  case VDC_zlib:
+#ifdef HAVE_ZLIB
+    {
+      unsigned char *end_data = dest + dest_size;
 
-    size_t copied_size = 0;
-    unsigned char *p = new_data;
-    page = head;
-    while (page != nullptr) {
-      memcpy(p, page->_buffer, page->_used_size);
-      copied_size += page->_used_size;
-      p += page->_used_size;
-      DeflatePage *next = page->_next;
-      delete page;
-      page = next;
+      z_stream z_source;
+#ifdef USE_MEMORY_NOWRAPPERS
+      z_source.zalloc = Z_NULL;
+      z_source.zfree = Z_NULL;
+#else
+      z_source.zalloc = (alloc_func)&do_zlib_alloc;
+      z_source.zfree = (free_func)&do_zlib_free;
+#endif
+
+      z_source.opaque = Z_NULL;
+      z_source.msg = (char *) "no error message";
+
+      z_source.next_in = (Bytef *)(char *)source;
+      z_source.avail_in = source_size;
+      z_source.next_out = (Bytef *)dest;
+      z_source.avail_out = dest_size;
+
+      int result = inflateInit(&z_source);
+      if (result < 0) {
+        nassert_raise("zlib error");
+        return false;
+      }
+      Thread::consider_yield();
+
+      size_t output_size = 0;
+
+      int flush = 0;
+      result = 0;
+      while (result != Z_STREAM_END) {
+        unsigned char *start_out = (unsigned char *)z_source.next_out;
+        nassertr(start_out < end_data, false);
+        z_source.avail_out = std::min((size_t)(end_data - start_out), (size_t)inflate_page_size);
+        nassertr(z_source.avail_out != 0, false);
+        result = inflate(&z_source, flush);
+        if (result < 0 && result != Z_BUF_ERROR) {
+          nassert_raise("zlib error");
+          return false;
+        }
+        size_t bytes_produced = (size_t)((unsigned char *)z_source.next_out - start_out);
+        output_size += bytes_produced;
+        if (bytes_produced == 0) {
+          // If we ever produce no bytes, then start flushing the output.
+          flush = Z_FINISH;
+        }
+
+        Thread::consider_yield();
+      }
+      nassertr(z_source.avail_in == 0, false);
+      nassertr(output_size == dest_size, false);
+
+      result = inflateEnd(&z_source);
+      nassertr(result == Z_OK, false);
+      return true;
     }
-    nassertv(copied_size == output_size);
+#else
+    break;
+#endif  // HAVE_ZLIB
 
-    // Now free the original, uncompressed data, and put this new compressed
-    // buffer in its place.
-    free_page_data(_page_data, _allocated_size);
-    _page_data = new_data;
-    _size = output_size;
-    _allocated_size = new_allocated_size;
+  case VDC_lz4:
+#ifdef HAVE_LZ4
+    {
+      int output_size = LZ4_decompress_safe((const char *)source, (char *)dest,
+                                            (int)source_size, (int)dest_size);
+      if (output_size < 0) {
+        nassert_raise("lz4 error");
+        return false;
+      }
+      nassertr((size_t)output_size == dest_size, false);
+      return true;
+    }
+#else
+    break;
+#endif  // HAVE_LZ4
 
-    if (gobj_cat.is_debug()) {
-      gobj_cat.debug()
-        << "Compressed " << *this << " from " << _uncompressed_size
-        << " to " << _size << "\n";
+  case VDC_zstd:
+#ifdef HAVE_ZSTD
+    {
+      size_t output_size = ZSTD_decompress(dest, dest_size, source, source_size);
+      if (ZSTD_isError(output_size)) {
+        nassert_raise("zstd error");
+        return false;
+      }
+      nassertr(output_size == dest_size, false);
+      return true;
     }
-#endif
-    set_lru_size(_size);
-    set_ram_class(RC_compressed);
+#else
+    break;
+#endif  // HAVE_ZSTD
+
+  case VDC_none:
+    break;
   }
+
+  nassert_raise("unsupported vertex data compression");
+  return false;
 }
 
 /**
@@ -599,9 +841,30 @@ do_save_to_disk() {
           << "Storing page, " << _size << " bytes, to disk\n";
       }
 
-      bool compressed = (_ram_class == RC_compressed);
+      if (_ram_class == RC_resident) {
+        // The page isn't compressed yet; we may want to compress it on its
+        // way to disk.
+        VertexDataCompression compression = choose_compression(vertex_save_file_compression);
+        if (compression != VDC_none) {
+          size_t compressed_size, allocated_size;
+          unsigned char *data;
+          {
+            PStatTimer timer2(_vdata_compress_pcollector);
+            data = compress_data(compression, _page_data, _size,
+                                 compressed_size, allocated_size);
+          }
+          if (data != nullptr) {
+            _vdata_compress_bytes_pcollector.add_level(_size);
+            _saved_block = get_save_file()->write_data(data, compressed_size, compression);
+            free_page_data(data, allocated_size);
+            return (_saved_block != nullptr);
+          }
+        }
+      }
 
-      _saved_block = get_save_file()->write_data(_page_data, _allocated_size, compressed);
+      VertexDataCompression compression =
+        (_ram_class == RC_compressed) ? _compression : VDC_none;
+      _saved_block = get_save_file()->write_data(_page_data, _size, compression);
       if (_saved_block == nullptr) {
         // Can't write it to disk.  Too bad.
         return false;
@@ -639,7 +902,7 @@ do_restore_from_disk() {
 
     size_t new_allocated_size = round_up(buffer_size);
     unsigned char *new_data = alloc_page_data(new_allocated_size);
-    if (!get_save_file()->read_data(new_data, new_allocated_size, _saved_block)) {
+    if (!get_save_file()->read_data(new_data, buffer_size, _saved_block)) {
       nassert_raise("read error");
     }
 
@@ -649,7 +912,8 @@ do_restore_from_disk() {
     _allocated_size = new_allocated_size;
 
     set_lru_size(_size);
-    if (_saved_block->get_compressed()) {
+    _compression = _saved_block->get_compression();
+    if (_compression != VDC_none) {
       set_ram_class(RC_compressed);
     } else {
       set_ram_class(RC_resident);
@@ -19,6 +19,7 @@
 #include "simpleAllocator.h"
 #include "pStatCollector.h"
 #include "vertexDataSaveFile.h"
+#include "vertexDataCompression.h"
 #include "pmutex.h"
 #include "conditionVar.h"
 #include "thread.h"
@@ -67,6 +68,8 @@ PUBLISHED:
 
   INLINE bool save_to_disk();
 
+  static bool is_compression_available(VertexDataCompression compression);
+
   INLINE static int get_num_threads();
   INLINE static int get_num_pending_reads();
   INLINE static int get_num_pending_writes();
@@ -95,6 +98,14 @@ private:
   void make_compressed();
   void make_disk();
 
+  static VertexDataCompression choose_compression(VertexDataCompression compression);
+  unsigned char *compress_data(VertexDataCompression compression,
+                               const unsigned char *source, size_t source_size,
+                               size_t &compressed_size, size_t &allocated_size) const;
+  bool decompress_data(VertexDataCompression compression,
+                       const unsigned char *source, size_t source_size,
+                       unsigned char *dest, size_t dest_size) const;
+
   bool do_save_to_disk();
   void do_restore_from_disk();
 
@@ -157,6 +168,7 @@ private:
 
   unsigned char *_page_data;
   size_t _size, _allocated_size, _uncompressed_size;
+  VertexDataCompression _compression;  // of the data while RC_compressed
   RamClass _ram_class;
   PT(VertexDataSaveBlock) _saved_block;
   size_t _book_size;
@@ -212,6 +224,12 @@ private:
   static PStatCollector _thread_wait_pcollector;
   static PStatCollector _alloc_pages_pcollector;
 
+public:
+  // These count the bytes of uncompressed data processed each frame.  They
+  // are cleared by the GraphicsEngine.
+  static PStatCollector _vdata_compress_bytes_pcollector;
+  static PStatCollector _vdata_decompress_bytes_pcollector;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -195,7 +195,8 @@ VertexDataSaveFile::
  * space on the file).
  */
 PT(VertexDataSaveBlock) VertexDataSaveFile::
-write_data(const unsigned char *data, size_t size, bool compressed) {
+write_data(const unsigned char *data, size_t size,
+           VertexDataCompression compression) {
   MutexHolder holder(_lock);
 
   if (!_is_valid) {
@@ -205,7 +206,7 @@ write_data(const unsigned char *data, size_t size, bool compressed) {
   PT(VertexDataSaveBlock) block = (VertexDataSaveBlock *)SimpleAllocator::do_alloc(size);
   if (block != nullptr) {
     _total_file_size = std::max(_total_file_size, block->get_start() + size);
-    block->set_compressed(compressed);
+    block->set_compression(compression);
 
 #ifdef _WIN32
     OVERLAPPED overlapped;
@@ -18,6 +18,7 @@
 #include "simpleAllocator.h"
 #include "filename.h"
 #include "pmutex.h"
+#include "vertexDataCompression.h"
 
 #if defined(_WIN32)
 #ifndef WIN32_LEAN_AND_MEAN
@@ -47,7 +48,7 @@ PUBLISHED:
 
 public:
   PT(VertexDataSaveBlock) write_data(const unsigned char *data, size_t size,
-                                     bool compressed);
+                                     VertexDataCompression compression);
   bool read_data(unsigned char *data, size_t size,
                  VertexDataSaveBlock *block);
 
@@ -76,11 +77,11 @@ protected:
                              size_t start, size_t size);
 
 public:
-  INLINE void set_compressed(bool compressed);
-  INLINE bool get_compressed() const;
+  INLINE void set_compression(VertexDataCompression compression);
+  INLINE VertexDataCompression get_compression() const;
 
 private:
-  bool _compressed;
+  VertexDataCompression _compression;
 
 public:
   INLINE unsigned char *get_pointer() const;
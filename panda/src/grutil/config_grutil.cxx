@@ -23,6 +23,7 @@
 #include "nodeVertexTransform.h"
 #include "rigidBodyCombiner.h"
 #include "pipeOcclusionCullTraverser.h"
+#include "softwareOcclusionCullTraverser.h"
 #include "shaderTerrainMesh.h"
 
 #include "dconfig.h"
@@ -106,6 +107,13 @@ ConfigVariableDouble ae_undershift_factor_32
           "maximum pixel shift when applying a displacement map, in a 32-bit project file.  This is used "
           "to control PfmVizzer::make_displacement()."));
 
+ConfigVariableInt software_occlusion_size
+("software-occlusion-size", "256 128",
+ PRC_DESC("Specify the x y size of the depth buffer that is rasterized on the "
+          "CPU by SoftwareOcclusionCullTraverser.  This is normally much "
+          "smaller than the window; it only needs to be large enough to "
+          "resolve the occluders."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -127,6 +135,7 @@ init_libgrutil() {
   NodeVertexTransform::init_type();
   RigidBodyCombiner::init_type();
   PipeOcclusionCullTraverser::init_type();
+  SoftwareOcclusionCullTraverser::init_type();
   SceneGraphAnalyzerMeter::init_type();
   ShaderTerrainMesh::init_type();
 
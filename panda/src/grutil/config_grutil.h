@@ -44,6 +44,8 @@ extern ConfigVariableInt pfm_vis_max_indices;
 extern ConfigVariableDouble ae_undershift_factor_16;
 extern ConfigVariableDouble ae_undershift_factor_32;
 
+extern ConfigVariableInt software_occlusion_size;
+
 extern EXPCL_PANDA_GRUTIL void init_libgrutil();
 
 #endif
@@ -0,0 +1,640 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file meshSimplifier.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "meshSimplifier.h"
+#include "config_grutil.h"
+#include "geomNode.h"
+#include "geomVertexReader.h"
+#include "geomVertexArrayData.h"
+#include "geomPatches.h"
+#include "finiteBoundingVolume.h"
+#include "pmap.h"
+#include "dcast.h"
+
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+/**
+ *
+ */
+MeshSimplifier::
+MeshSimplifier() {
+  _target_error = 0.01f;
+}
+
+/**
+ * Returns a simplified copy of the indicated Geom, with its triangles reduced
+ * to approximately the indicated fraction of the original number, or fewer
+ * triangles removed if that would exceed the target error.  The result shares
+ * the GeomVertexData of the original.  Returns the original Geom if nothing
+ * could be simplified.
+ */
+CPT(Geom) MeshSimplifier::
+simplify_geom(const Geom *geom, PN_stdfloat ratio) const {
+  CPT(BoundingVolume) bounds = geom->get_bounds();
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr || fbv->is_empty()) {
+    return geom;
+  }
+  PN_stdfloat radius = (fbv->get_max() - fbv->get_min()).length() * 0.5f;
+
+  return do_simplify_geom(geom, ratio, _target_error * radius);
+}
+
+/**
+ * Replaces all of the Geoms at the indicated node and below with simplified
+ * versions, as by simplify_geom().  The target error is measured relative to
+ * the radius of the root node.  Returns the number of Geoms that were
+ * changed.
+ */
+int MeshSimplifier::
+simplify(PandaNode *root, PN_stdfloat ratio) const {
+  LPoint3 center;
+  PN_stdfloat radius;
+  if (!get_radius(root, center, radius)) {
+    return 0;
+  }
+  return r_simplify(root, ratio, _target_error * radius);
+}
+
+/**
+ * Returns a new LODNode that switches between the indicated node and
+ * num_levels - 1 progressively simpler copies of it, each one with
+ * approximately ratio times the number of triangles of the previous one.  The
+ * copies share the vertex data of the original.
+ *
+ * The original is shown closer than near_distance, and the simplest copy is
+ * hidden beyond far_distance; the distances at which the levels in between
+ * switch are spread evenly on a logarithmic scale.  If near_distance is 0, it
+ * is computed as four times the radius of the node, and if far_distance is 0,
+ * it is chosen so that each level is shown over twice the distance of the
+ * previous one.
+ *
+ * The indicated node is parented to the new LODNode as its first child; it
+ * should be removed from its previous parent, if any.  See also the NodePath
+ * version of this method, which does this automatically.
+ */
+PT(LODNode) MeshSimplifier::
+make_lod(PandaNode *node, int num_levels, PN_stdfloat ratio,
+         PN_stdfloat near_distance, PN_stdfloat far_distance) const {
+  nassertr(num_levels >= 1, nullptr);
+  nassertr(ratio > 0.0f && ratio < 1.0f, nullptr);
+
+  PT(LODNode) lod = LODNode::make_default_lod(node->get_name());
+
+  LPoint3 center(0.0f);
+  PN_stdfloat radius = 0.0f;
+  get_radius(node, center, radius);
+  lod->set_center(center);
+
+  if (near_distance <= 0.0f) {
+    near_distance = max(radius * 4.0f, (PN_stdfloat)1.0f);
+  }
+  if (far_distance <= near_distance) {
+    far_distance = near_distance * (PN_stdfloat)(1 << min(num_levels - 1, 16));
+  }
+
+  if (grutil_cat.is_debug()) {
+    grutil_cat.debug()
+      << "Generating " << num_levels << " levels of detail for " << *node
+      << " between " << near_distance << " and " << far_distance << "\n";
+  }
+
+  PN_stdfloat out = 0.0f;
+  PT(PandaNode) level = node;
+  for (int i = 0; i < num_levels; ++i) {
+    PN_stdfloat in = far_distance;
+    if (i + 1 < num_levels) {
+      in = near_distance *
+        cpow(far_distance / near_distance, (PN_stdfloat)i / (PN_stdfloat)(num_levels - 1));
+    }
+
+    if (i > 0) {
+      // The error that is allowed grows with the distance, so that it stays
+      // about the same size on screen.
+      level = level->copy_subgraph();
+      r_simplify(level, ratio, _target_error * radius * (out / near_distance));
+    }
+
+    lod->add_child(level);
+    lod->add_switch(in, out);
+    out = in;
+  }
+
+  return lod;
+}
+
+/**
+ * Replaces the indicated model in the scene graph with a new LODNode that
+ * switches between it and progressively simpler copies of it.  See the other
+ * version of make_lod() for a description of the parameters.
+ *
+ * The model NodePath is updated to refer to its new location below the
+ * LODNode, which is returned.
+ */
+NodePath MeshSimplifier::
+make_lod(NodePath &model, int num_levels, PN_stdfloat ratio,
+         PN_stdfloat near_distance, PN_stdfloat far_distance) const {
+  nassertr(!model.is_empty(), NodePath::fail());
+
+  NodePath parent = model.get_parent();
+  int sort = model.get_sort();
+  PT(PandaNode) node = model.node();
+  model.detach_node();
+
+  PT(LODNode) lod = make_lod(node, num_levels, ratio, near_distance, far_distance);
+  if (lod == nullptr) {
+    return NodePath::fail();
+  }
+
+  NodePath result;
+  if (parent.is_empty()) {
+    result = NodePath(lod);
+  } else {
+    result = parent.attach_new_node(lod, sort);
+  }
+  model = result.get_child(0);
+  return result;
+}
+
+/**
+ * Does the work of simplify_geom(), with the target error given as an
+ * absolute distance.
+ */
+CPT(Geom) MeshSimplifier::
+do_simplify_geom(const Geom *geom, PN_stdfloat ratio, double max_error) const {
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  if (!vdata->has_column(InternalName::get_vertex())) {
+    return geom;
+  }
+
+  PT(Geom) result;
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(i);
+    if (prim->get_primitive_type() != GeomPrimitive::PT_polygons ||
+        prim->is_of_type(GeomPatches::get_class_type())) {
+      continue;
+    }
+    if (!prim->is_exact_type(GeomTriangles::get_class_type())) {
+      // Tristrips and trifans are first converted to triangles.
+      prim = prim->decompose();
+      if (!prim->is_exact_type(GeomTriangles::get_class_type())) {
+        continue;
+      }
+    }
+
+    CPT(GeomPrimitive) new_prim = simplify_triangles(prim, vdata, ratio, max_error);
+    if (new_prim != prim) {
+      if (result == nullptr) {
+        result = geom->make_copy();
+      }
+      result->set_primitive(i, new_prim);
+    }
+  }
+
+  if (result == nullptr) {
+    return geom;
+  }
+  return result;
+}
+
+/**
+ * Collapses the edges of the indicated triangles until the number of
+ * triangles has been reduced by the indicated ratio, or until no edge can be
+ * collapsed without exceeding max_error.  Returns the original primitive if
+ * nothing was collapsed.
+ */
+CPT(GeomPrimitive) MeshSimplifier::
+simplify_triangles(const GeomPrimitive *prim, const GeomVertexData *vdata,
+                   PN_stdfloat ratio, double max_error) const {
+  Thread *current_thread = Thread::get_current_thread();
+
+  int num_triangles = prim->get_num_vertices() / 3;
+  int target = (int)(num_triangles * ratio);
+  if (target >= num_triangles || num_triangles < 2) {
+    return prim;
+  }
+
+  int num_rows = vdata->get_num_rows();
+  GeomVertexReader vertex(vdata, InternalName::get_vertex(), current_thread);
+
+  // Rows that are identical in every column are merged, so that a mesh that
+  // was not indexed can still be simplified.  Of the remaining rows, those
+  // that have the same position as another row are on a seam, and are never
+  // moved.
+  size_t num_arrays = vdata->get_num_arrays();
+  pvector<CPT(GeomVertexArrayDataHandle)> handles;
+  for (size_t ai = 0; ai < num_arrays; ++ai) {
+    handles.push_back(vdata->get_array_handle(ai));
+  }
+
+  enum Kind {
+    K_interior,
+    K_border,
+    K_locked,
+  };
+
+  pvector<int> remap(num_rows, -1);
+  pvector<LPoint3d> positions(num_rows);
+  pvector<unsigned char> kinds(num_rows, K_interior);
+  {
+    pmap<std::string, int> rows;
+    pmap<LPoint3d, int> points;
+    std::string key;
+    for (int i = 0; i < num_triangles * 3; ++i) {
+      int row = prim->get_vertex(i);
+      nassertr(row >= 0 && row < num_rows, prim);
+      if (remap[row] >= 0) {
+        continue;
+      }
+
+      key.clear();
+      for (size_t ai = 0; ai < num_arrays; ++ai) {
+        int stride = handles[ai]->get_array_format()->get_stride();
+        const unsigned char *data = handles[ai]->get_read_pointer(true);
+        key.append((const char *)data + (size_t)row * stride, stride);
+      }
+      int canonical = rows.insert(std::make_pair(key, row)).first->second;
+      remap[row] = canonical;
+      if (canonical != row) {
+        continue;
+      }
+
+      vertex.set_row(row);
+      positions[row] = vertex.get_data3d();
+
+      auto result = points.insert(std::make_pair(positions[row], row));
+      if (!result.second) {
+        kinds[row] = K_locked;
+        kinds[result.first->second] = K_locked;
+      }
+    }
+  }
+
+  pvector<int> tris(num_triangles * 3);
+  pvector<bool> alive(num_triangles, true);
+  pvector<pvector<int> > vertex_tris(num_rows);
+  int num_alive = 0;
+  for (int t = 0; t < num_triangles; ++t) {
+    int a = remap[prim->get_vertex(t * 3)];
+    int b = remap[prim->get_vertex(t * 3 + 1)];
+    int c = remap[prim->get_vertex(t * 3 + 2)];
+    tris[t * 3] = a;
+    tris[t * 3 + 1] = b;
+    tris[t * 3 + 2] = c;
+    if (a == b || b == c || c == a) {
+      alive[t] = false;
+      continue;
+    }
+    vertex_tris[a].push_back(t);
+    vertex_tris[b].push_back(t);
+    vertex_tris[c].push_back(t);
+    ++num_alive;
+  }
+
+  // Add the plane of each triangle to the quadrics of its vertices, weighted
+  // by its area.
+  pvector<Quadric> quadrics(num_rows);
+  pvector<LVector3d> normals(num_triangles);
+  for (int t = 0; t < num_triangles; ++t) {
+    if (!alive[t]) {
+      continue;
+    }
+    const LPoint3d &p0 = positions[tris[t * 3]];
+    LVector3d normal = (positions[tris[t * 3 + 1]] - p0).cross(positions[tris[t * 3 + 2]] - p0);
+    double length = normal.length();
+    if (length == 0.0) {
+      continue;
+    }
+    normal /= length;
+    normals[t] = normal;
+    double d = -normal.dot(p0);
+    for (int k = 0; k < 3; ++k) {
+      quadrics[tris[t * 3 + k]].add_plane(normal, d, length * 0.5);
+    }
+  }
+
+  // Find the edges that belong to only one triangle, and the vertices on
+  // them.  An edge that is shared by more than two triangles locks its
+  // vertices.  The border edges also get a plane perpendicular to the
+  // triangle, so that the outline of the mesh is preserved.
+  typedef pvector<std::pair<int, int> > Neighbors;
+  Neighbors neighbors;
+  auto collect_neighbors = [&](int v) {
+    neighbors.clear();
+    for (int t : vertex_tris[v]) {
+      if (!alive[t]) {
+        continue;
+      }
+      for (int k = 0; k < 3; ++k) {
+        int w = tris[t * 3 + k];
+        if (w == v) {
+          continue;
+        }
+        Neighbors::iterator ni = neighbors.begin();
+        while (ni != neighbors.end() && ni->first != w) {
+          ++ni;
+        }
+        if (ni == neighbors.end()) {
+          neighbors.push_back(std::make_pair(w, 1));
+        } else {
+          ++(ni->second);
+        }
+      }
+    }
+  };
+
+  for (int v = 0; v < num_rows; ++v) {
+    if (vertex_tris[v].empty()) {
+      continue;
+    }
+    collect_neighbors(v);
+    for (const auto &neighbor : neighbors) {
+      int w = neighbor.first;
+      if (neighbor.second > 2) {
+        kinds[v] = K_locked;
+        kinds[w] = K_locked;
+      } else if (neighbor.second == 1) {
+        if (kinds[v] == K_interior) {
+          kinds[v] = K_border;
+        }
+        if (kinds[w] == K_interior) {
+          kinds[w] = K_border;
+        }
+        if (v < w) {
+          for (int t : vertex_tris[v]) {
+            const int *tri = &tris[t * 3];
+            if (alive[t] && (tri[0] == w || tri[1] == w || tri[2] == w)) {
+              LVector3d edge = positions[w] - positions[v];
+              LVector3d normal = edge.cross(normals[t]);
+              double length = normal.length();
+              if (length != 0.0) {
+                normal /= length;
+                double weight = edge.length_squared() * 10.0;
+                quadrics[v].add_plane(normal, -normal.dot(positions[v]), weight);
+                quadrics[w].add_plane(normal, -normal.dot(positions[v]), weight);
+              }
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Finds the cheapest edge along which the indicated vertex can be moved
+  // onto one of its neighbors.  The border vertices can only move along the
+  // border, and no move may flip a triangle or change the topology of the
+  // mesh.
+  pvector<int> neighbor_marks(num_rows, 0);
+  pvector<int> common_marks(num_rows, 0);
+  int neighbor_mark = 0;
+  int common_mark = 0;
+  auto find_collapse = [&](int v, int &best_u, double &best_cost) {
+    best_u = -1;
+    best_cost = 0.0;
+    if (kinds[v] == K_locked) {
+      return;
+    }
+    collect_neighbors(v);
+    ++neighbor_mark;
+    for (const auto &neighbor : neighbors) {
+      neighbor_marks[neighbor.first] = neighbor_mark;
+    }
+
+    for (const auto &neighbor : neighbors) {
+      int u = neighbor.first;
+      int shared = neighbor.second;
+      if (shared != (kinds[v] == K_border ? 1 : 2)) {
+        continue;
+      }
+
+      Quadric quadric = quadrics[v];
+      quadric += quadrics[u];
+      double cost = quadric.evaluate(positions[u]) / max(quadric._weight, 1e-12);
+      if (best_u >= 0 && cost >= best_cost) {
+        continue;
+      }
+
+      // The vertices that are adjacent to both may only be the ones opposite
+      // the shared edge, or the mesh would fold onto itself.
+      int common = 0;
+      ++common_mark;
+      for (int t : vertex_tris[u]) {
+        if (!alive[t]) {
+          continue;
+        }
+        for (int k = 0; k < 3; ++k) {
+          int w = tris[t * 3 + k];
+          if (w != u && w != v && neighbor_marks[w] == neighbor_mark &&
+              common_marks[w] != common_mark) {
+            common_marks[w] = common_mark;
+            ++common;
+          }
+        }
+      }
+      if (common != shared) {
+        continue;
+      }
+
+      bool flips = false;
+      for (int t : vertex_tris[v]) {
+        const int *tri = &tris[t * 3];
+        if (!alive[t] || tri[0] == u || tri[1] == u || tri[2] == u) {
+          continue;
+        }
+        LPoint3d p[3];
+        for (int k = 0; k < 3; ++k) {
+          p[k] = positions[tri[k] == v ? u : tri[k]];
+        }
+        LVector3d normal = (p[1] - p[0]).cross(p[2] - p[0]);
+        if (normal.dot(normals[t]) <= normal.length() * 0.2) {
+          flips = true;
+          break;
+        }
+      }
+      if (!flips) {
+        best_u = u;
+        best_cost = cost;
+      }
+    }
+  };
+
+  class Collapse {
+  public:
+    bool operator < (const Collapse &other) const {
+      return _cost > other._cost;
+    }
+    double _cost;
+    int _v;
+    int _stamp;
+  };
+  pvector<Collapse> heap;
+  pvector<int> stamps(num_rows, 0);
+
+  auto update = [&](int v) {
+    ++stamps[v];
+    int u;
+    double cost;
+    find_collapse(v, u, cost);
+    if (u >= 0) {
+      heap.push_back({cost, v, stamps[v]});
+      std::push_heap(heap.begin(), heap.end());
+    }
+  };
+
+  for (int v = 0; v < num_rows; ++v) {
+    if (!vertex_tris[v].empty()) {
+      update(v);
+    }
+  }
+
+  double max_cost = max_error * max_error;
+  int num_collapsed = 0;
+  while (num_alive > target && !heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end());
+    Collapse collapse = heap.back();
+    heap.pop_back();
+
+    int v = collapse._v;
+    if (collapse._stamp != stamps[v]) {
+      continue;
+    }
+    if (collapse._cost > max_cost) {
+      break;
+    }
+
+    // The neighborhood of the other vertex may have changed since this was
+    // queued, so check it again.
+    int u;
+    double cost;
+    find_collapse(v, u, cost);
+    if (u < 0) {
+      continue;
+    }
+    if (cost > collapse._cost) {
+      ++stamps[v];
+      heap.push_back({cost, v, stamps[v]});
+      std::push_heap(heap.begin(), heap.end());
+      continue;
+    }
+
+    for (int t : vertex_tris[v]) {
+      if (!alive[t]) {
+        continue;
+      }
+      int *tri = &tris[t * 3];
+      if (tri[0] == u || tri[1] == u || tri[2] == u) {
+        alive[t] = false;
+        --num_alive;
+      } else {
+        for (int k = 0; k < 3; ++k) {
+          if (tri[k] == v) {
+            tri[k] = u;
+          }
+        }
+        vertex_tris[u].push_back(t);
+      }
+    }
+    vertex_tris[v].clear();
+    ++stamps[v];
+    quadrics[u] += quadrics[v];
+    ++num_collapsed;
+
+    pvector<int> &u_tris = vertex_tris[u];
+    u_tris.erase(std::remove_if(u_tris.begin(), u_tris.end(),
+                                [&](int t) { return !alive[t]; }),
+                 u_tris.end());
+
+    // Everything around u may now have a different cheapest collapse.
+    update(u);
+    collect_neighbors(u);
+    Neighbors around = neighbors;
+    for (const auto &neighbor : around) {
+      update(neighbor.first);
+    }
+  }
+
+  if (num_collapsed == 0) {
+    return prim;
+  }
+
+  if (grutil_cat.is_debug()) {
+    grutil_cat.debug()
+      << "Simplified " << num_triangles << " triangles to " << num_alive
+      << " by collapsing " << num_collapsed << " edges\n";
+  }
+
+  PT(GeomPrimitive) new_prim = prim->make_copy();
+  new_prim->clear_vertices();
+  new_prim->reserve_num_vertices(num_alive * 3);
+  for (int t = 0; t < num_triangles; ++t) {
+    if (alive[t]) {
+      new_prim->add_vertices(tris[t * 3], tris[t * 3 + 1], tris[t * 3 + 2]);
+    }
+  }
+
+  // The removed triangles leave gaps in the original order, so restore the
+  // use of the vertex cache.
+  return new_prim->optimize_vertex_cache(0, vdata);
+}
+
+/**
+ * The recursive implementation of simplify().
+ */
+int MeshSimplifier::
+r_simplify(PandaNode *node, PN_stdfloat ratio, double max_error) const {
+  int num_changed = 0;
+
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = geom_node->get_geom(i);
+      CPT(Geom) new_geom = do_simplify_geom(geom, ratio, max_error);
+      if (new_geom != geom) {
+        geom_node->set_geom(i, (Geom *)new_geom.p());
+        ++num_changed;
+      }
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_changed += r_simplify(children.get_child(i), ratio, max_error);
+  }
+
+  return num_changed;
+}
+
+/**
+ * Computes the center and radius of the bounding volume of the indicated
+ * node.  Returns false if the node has no finite bounds.
+ */
+bool MeshSimplifier::
+get_radius(const PandaNode *node, LPoint3 &center, PN_stdfloat &radius) {
+  CPT(BoundingVolume) bounds = node->get_bounds();
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr || fbv->is_empty()) {
+    return false;
+  }
+  LPoint3 min_point = fbv->get_min();
+  LPoint3 max_point = fbv->get_max();
+  center = (min_point + max_point) * 0.5f;
+  radius = (max_point - min_point).length() * 0.5f;
+  return true;
+}
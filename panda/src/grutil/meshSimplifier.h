@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file meshSimplifier.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "pandabase.h"
+#include "nodePath.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "lodNode.h"
+#include "luse.h"
+#include "pvector.h"
+
+class GeomNode;
+
+/**
+ * This class reduces the number of triangles in a model by repeatedly
+ * collapsing the edge that least changes its shape, as measured by the
+ * quadric error metric of Garland and Heckbert.  It can also generate an
+ * LODNode with a number of successively simpler versions of a model.
+ *
+ * Each edge is collapsed by moving one of its vertices onto the other, so no
+ * new vertices are created: the simplified Geoms share the GeomVertexData of
+ * the original, and the normals, texture coordinates, colors and joint
+ * weights of the remaining vertices are unchanged.  Vertices at the same
+ * position that differ in any other attribute, such as along a UV seam or a
+ * hard edge, are never moved, and vertices on the open border of a mesh can
+ * only move along the border, so that seams and silhouettes are preserved.
+ *
+ * Only triangles are simplified; other primitives are left alone.
+ */
+class EXPCL_PANDA_GRUTIL MeshSimplifier {
+PUBLISHED:
+  MeshSimplifier();
+
+  INLINE void set_target_error(PN_stdfloat target_error);
+  INLINE PN_stdfloat get_target_error() const;
+  MAKE_PROPERTY(target_error, get_target_error, set_target_error);
+
+  CPT(Geom) simplify_geom(const Geom *geom, PN_stdfloat ratio) const;
+  int simplify(PandaNode *root, PN_stdfloat ratio) const;
+
+  PT(LODNode) make_lod(PandaNode *node, int num_levels,
+                       PN_stdfloat ratio = 0.5f,
+                       PN_stdfloat near_distance = 0.0f,
+                       PN_stdfloat far_distance = 0.0f) const;
+  NodePath make_lod(NodePath &model, int num_levels,
+                    PN_stdfloat ratio = 0.5f,
+                    PN_stdfloat near_distance = 0.0f,
+                    PN_stdfloat far_distance = 0.0f) const;
+
+private:
+  CPT(Geom) do_simplify_geom(const Geom *geom, PN_stdfloat ratio,
+                             double max_error) const;
+  CPT(GeomPrimitive) simplify_triangles(const GeomPrimitive *prim,
+                                        const GeomVertexData *vdata,
+                                        PN_stdfloat ratio,
+                                        double max_error) const;
+  int r_simplify(PandaNode *node, PN_stdfloat ratio, double max_error) const;
+
+  static bool get_radius(const PandaNode *node, LPoint3 &center,
+                         PN_stdfloat &radius);
+
+  // The symmetric 4x4 matrix of the quadric error metric, and the total
+  // weight of the planes that were added to it.
+  class Quadric {
+  public:
+    INLINE Quadric();
+    INLINE void add_plane(const LVector3d &normal, double d, double weight);
+    INLINE void operator += (const Quadric &other);
+    INLINE double evaluate(const LPoint3d &point) const;
+
+    double _a[10];
+    double _weight;
+  };
+
+private:
+  PN_stdfloat _target_error;
+};
+
+#include "meshSimplifier.I"
+
+#endif
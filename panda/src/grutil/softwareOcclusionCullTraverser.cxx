@@ -0,0 +1,685 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareOcclusionCullTraverser.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "softwareOcclusionCullTraverser.h"
+#include "cullTraverserData.h"
+#include "geomNode.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "lensNode.h"
+#include "finiteBoundingVolume.h"
+#include "asyncTaskManager.h"
+#include "pStatTimer.h"
+#include "pnmImage.h"
+#include "config_grutil.h"
+
+#include <float.h>
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#endif
+
+PStatCollector SoftwareOcclusionCullTraverser::_occluders_pcollector("Cull:Occlusion:Occluders");
+PStatCollector SoftwareOcclusionCullTraverser::_pyramid_pcollector("Cull:Occlusion:Pyramid");
+PStatCollector SoftwareOcclusionCullTraverser::_occlusion_passed_pcollector("Occlusion results:Visible");
+PStatCollector SoftwareOcclusionCullTraverser::_occlusion_failed_pcollector("Occlusion results:Occluded");
+PStatCollector SoftwareOcclusionCullTraverser::_occlusion_tests_pcollector("Occlusion tests");
+
+TypeHandle SoftwareOcclusionCullTraverser::_type_handle;
+
+// The number of rows of the depth buffer that are rasterized together by one
+// thread.
+static const int band_height = 16;
+
+// Allows for the rounding error in the rasterized depth, so that occluders
+// are never found to occlude themselves.
+static const float depth_epsilon = 1.0e-5f;
+
+/**
+ *
+ */
+SoftwareOcclusionCullTraverser::
+SoftwareOcclusionCullTraverser() :
+  _x_size(0),
+  _y_size(0),
+  _live(false)
+{
+  if (software_occlusion_size.get_num_words() < 2) {
+    set_size(software_occlusion_size, software_occlusion_size);
+  } else {
+    set_size(software_occlusion_size[0], software_occlusion_size[1]);
+  }
+}
+
+/**
+ * Sets up the traverser for a new frame, which renders the occluders into the
+ * depth buffer from the point of view of the scene's camera.
+ */
+void SoftwareOcclusionCullTraverser::
+set_scene(SceneSetup *scene_setup, GraphicsStateGuardianBase *gsg,
+          bool dr_incomplete_render) {
+  CullTraverser::set_scene(scene_setup, gsg, dr_incomplete_render);
+  do_render_occluders(scene_setup->get_camera_path(), scene_setup->get_lens());
+}
+
+/**
+ * Should be called when the traverser has finished traversing its scene, this
+ * gives it a chance to do any necessary finalization.
+ */
+void SoftwareOcclusionCullTraverser::
+end_traverse() {
+  CullTraverser::end_traverse();
+
+  _occlusion_passed_pcollector.flush_level();
+  _occlusion_failed_pcollector.flush_level();
+  _occlusion_tests_pcollector.flush_level();
+}
+
+/**
+ * Changes the size of the depth buffer in pixels.  The default is given by
+ * the software-occlusion-size config variable.  A larger buffer resolves
+ * smaller gaps between occluders, at the cost of more time spent rasterizing.
+ */
+void SoftwareOcclusionCullTraverser::
+set_size(int x_size, int y_size) {
+  nassertv(x_size > 0 && y_size > 0);
+  _x_size = x_size;
+  _y_size = y_size;
+  _live = false;
+
+  _levels.clear();
+  while (true) {
+    Level level;
+    level._x_size = x_size;
+    level._y_size = y_size;
+    level._stride = _levels.empty() ? ((x_size + 3) & ~3) : x_size;
+    level._depth.assign(level._stride * y_size, 1.0f);
+    _levels.push_back(std::move(level));
+
+    if (x_size == 1 && y_size == 1) {
+      break;
+    }
+    x_size = (x_size + 1) / 2;
+    y_size = (y_size + 1) / 2;
+  }
+
+  _bins.clear();
+  _bins.resize((_y_size + band_height - 1) / band_height);
+}
+
+/**
+ * Adds the indicated node, and all of the geometry below it, to the set of
+ * occluders.  Its transform is evaluated anew each frame.
+ */
+void SoftwareOcclusionCullTraverser::
+add_occluder(const NodePath &occluder) {
+  nassertv(!occluder.is_empty());
+  if (std::find(_occluders.begin(), _occluders.end(), occluder) == _occluders.end()) {
+    _occluders.push_back(occluder);
+  }
+}
+
+/**
+ * Removes an occluder added with add_occluder().  Returns true if it was
+ * removed, or false if it was not an occluder.
+ */
+bool SoftwareOcclusionCullTraverser::
+remove_occluder(const NodePath &occluder) {
+  Occluders::iterator oi = std::find(_occluders.begin(), _occluders.end(), occluder);
+  if (oi == _occluders.end()) {
+    return false;
+  }
+  _occluders.erase(oi);
+  return true;
+}
+
+/**
+ * Removes all of the occluders.
+ */
+void SoftwareOcclusionCullTraverser::
+clear_occluders() {
+  _occluders.clear();
+}
+
+/**
+ * Rasterizes the occluders into the depth buffer as seen from the indicated
+ * camera, which must be a LensNode.  This is done automatically at the start
+ * of each frame when the traverser is used by a DisplayRegion; it only needs
+ * to be called explicitly in order to use is_occluded() without rendering,
+ * for instance on a server.
+ */
+void SoftwareOcclusionCullTraverser::
+render_occluders(const NodePath &camera) {
+  nassertv(!camera.is_empty() &&
+           camera.node()->is_of_type(LensNode::get_class_type()));
+  LensNode *lens_node = DCAST(LensNode, camera.node());
+  do_render_occluders(camera, lens_node->get_lens());
+}
+
+/**
+ * Returns true if the bounding volume of the indicated node is entirely
+ * hidden behind the occluders, as rendered by the most recent call to
+ * render_occluders() or the most recent frame.  Returns false if it may be
+ * visible, or if there is nothing to test against.
+ *
+ * This does not consider the view frustum; a node that is entirely offscreen
+ * is not considered occluded.
+ */
+bool SoftwareOcclusionCullTraverser::
+is_occluded(const NodePath &node) const {
+  nassertr(!node.is_empty(), false);
+  if (!_live) {
+    return false;
+  }
+
+  // The node's bounding volume is in the coordinate space of its parent.
+  Thread *current_thread = Thread::get_current_thread();
+  CPT(TransformState) parent_net = TransformState::make_identity();
+  if (node.has_parent(current_thread)) {
+    parent_net = node.get_parent(current_thread).get_net_transform(current_thread);
+  }
+  CPT(TransformState) modelview =
+    _camera.get_net_transform(current_thread)->invert_compose(parent_net);
+
+  return test_bounds(node.node()->get_bounds(current_thread), modelview);
+}
+
+/**
+ * Copies the indicated level of the depth pyramid into the image, as a
+ * grayscale image in which white is the far plane.  This is useful to
+ * visualize the occluders.
+ */
+void SoftwareOcclusionCullTraverser::
+store_depth(PNMImage &image, int level) const {
+  nassertv(level >= 0 && level < (int)_levels.size());
+  const Level &from = _levels[level];
+
+  image.clear(from._x_size, from._y_size, 1);
+  for (int y = 0; y < from._y_size; ++y) {
+    for (int x = 0; x < from._x_size; ++x) {
+      image.set_gray(x, y, from._depth[y * from._stride + x]);
+    }
+  }
+}
+
+/**
+ * Culls the node against the view frustum, and then against the occluders.
+ */
+bool SoftwareOcclusionCullTraverser::
+is_in_view(CullTraverserData &data) {
+  if (!CullTraverser::is_in_view(data)) {
+    return false;
+  }
+  if (!_live || data._instances != nullptr) {
+    return true;
+  }
+
+  _occlusion_tests_pcollector.add_level(1);
+  if (test_bounds(data.node_reader()->get_bounds(),
+                  data.get_modelview_transform(this))) {
+    _occlusion_failed_pcollector.add_level(1);
+    return false;
+  }
+
+  _occlusion_passed_pcollector.add_level(1);
+  return true;
+}
+
+/**
+ * The implementation of render_occluders().
+ */
+void SoftwareOcclusionCullTraverser::
+do_render_occluders(const NodePath &camera, const Lens *lens) {
+  _live = false;
+  _triangles.clear();
+  if (lens == nullptr || _occluders.empty()) {
+    return;
+  }
+
+  PStatTimer timer(_occluders_pcollector);
+  Thread *current_thread = Thread::get_current_thread();
+
+  _camera = camera;
+  _projection_mat = lens->get_projection_mat();
+
+  CPT(TransformState) camera_net = camera.get_net_transform(current_thread);
+  for (const NodePath &occluder : _occluders) {
+    if (occluder.is_empty()) {
+      continue;
+    }
+    CPT(TransformState) parent_net = TransformState::make_identity();
+    if (occluder.has_parent(current_thread)) {
+      parent_net = occluder.get_parent(current_thread).get_net_transform(current_thread);
+    }
+    r_collect_occluders(occluder.node(), camera_net->invert_compose(parent_net),
+                        current_thread);
+  }
+
+  // Sort the triangles into the bands of rows that they overlap, so that each
+  // band can be rasterized by a different thread.
+  int num_bands = (int)_bins.size();
+  for (pvector<int> &bin : _bins) {
+    bin.clear();
+  }
+  for (int ti = 0; ti < (int)_triangles.size(); ++ti) {
+    const Triangle &tri = _triangles[ti];
+    float min_y = std::min(std::min(tri._y[0], tri._y[1]), tri._y[2]);
+    float max_y = std::max(std::max(tri._y[0], tri._y[1]), tri._y[2]);
+    int first_band = (int)std::max(min_y, 0.0f) / band_height;
+    int last_band = (int)std::min(max_y, (float)(_y_size - 1)) / band_height;
+    for (int band = first_band; band <= last_band; ++band) {
+      _bins[band].push_back(ti);
+    }
+  }
+
+  AsyncTaskManager::get_global_ptr()->parallel_for(0, num_bands,
+    [this] (int begin, int end) {
+      for (int band = begin; band < end; ++band) {
+        rasterize_band(band);
+      }
+    }, 1);
+
+  build_pyramid();
+  _live = true;
+}
+
+/**
+ * Adds the triangles of all of the Geoms at and below the indicated node,
+ * whose parent has the indicated transform relative to the camera.
+ */
+void SoftwareOcclusionCullTraverser::
+r_collect_occluders(PandaNode *node, const TransformState *modelview,
+                    Thread *current_thread) {
+  if (node->is_overall_hidden()) {
+    return;
+  }
+
+  CPT(TransformState) net_modelview =
+    modelview->compose(node->get_transform(current_thread));
+  if (net_modelview->is_invalid()) {
+    return;
+  }
+
+  if (node->is_geom_node()) {
+    GeomNode *gnode = (GeomNode *)node;
+    LMatrix4 mvp = net_modelview->get_mat() * _projection_mat;
+
+    GeomNode::Geoms geoms = gnode->get_geoms(current_thread);
+    int num_geoms = geoms.get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      add_geom_triangles(geoms.get_geom(i), mvp, current_thread);
+    }
+  }
+
+  PandaNode::Children children = node->get_children(current_thread);
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_collect_occluders(children.get_child(i), net_modelview, current_thread);
+  }
+}
+
+/**
+ * Transforms the triangles of the Geom into clip space with the indicated
+ * matrix, and adds them to the list of triangles to rasterize.
+ */
+void SoftwareOcclusionCullTraverser::
+add_geom_triangles(const Geom *geom, const LMatrix4 &mvp,
+                   Thread *current_thread) {
+  if (geom->get_primitive_type() != Geom::PT_polygons) {
+    return;
+  }
+
+  CPT(GeomVertexData) vdata = geom->get_animated_vertex_data(true, current_thread);
+  if (!vdata->has_column(InternalName::get_vertex())) {
+    return;
+  }
+
+  int num_rows = vdata->get_num_rows();
+  pvector<LVecBase4f> clip(num_rows);
+  {
+    GeomVertexReader vertex(vdata, InternalName::get_vertex(), current_thread);
+    for (int i = 0; i < num_rows; ++i) {
+      LVecBase4 point(vertex.get_data3(), 1.0f);
+      clip[i] = LCAST(float, mvp.xform(point));
+    }
+  }
+
+  int num_primitives = geom->get_num_primitives();
+  for (int pi = 0; pi < num_primitives; ++pi) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(pi)->decompose();
+    GeomPrimitivePipelineReader reader(prim, current_thread);
+    int num_vertices = reader.get_num_vertices();
+    for (int i = 0; i + 2 < num_vertices; i += 3) {
+      int a = reader.get_vertex(i);
+      int b = reader.get_vertex(i + 1);
+      int c = reader.get_vertex(i + 2);
+      nassertv(a < num_rows && b < num_rows && c < num_rows);
+      add_triangle(clip[a], clip[b], clip[c]);
+    }
+  }
+}
+
+/**
+ * Clips the indicated triangle, given in clip space, against the near plane,
+ * and adds the result to the list of triangles to rasterize.
+ */
+void SoftwareOcclusionCullTraverser::
+add_triangle(const LVecBase4f &a, const LVecBase4f &b, const LVecBase4f &c) {
+  // Quickly reject the triangles that are entirely outside of one of the
+  // sides of the view frustum.  The near plane is handled below.
+  for (int axis = 0; axis < 3; ++axis) {
+    if (a[axis] > a[3] && b[axis] > b[3] && c[axis] > c[3]) {
+      return;
+    }
+    if (axis < 2 && a[axis] < -a[3] && b[axis] < -b[3] && c[axis] < -c[3]) {
+      return;
+    }
+  }
+
+  const LVecBase4f *in[3] = { &a, &b, &c };
+  LVecBase4f poly[4];
+  int num_points = 0;
+  for (int i = 0; i < 3; ++i) {
+    const LVecBase4f &p = *in[i];
+    const LVecBase4f &q = *in[(i + 1) % 3];
+    float dp = p[2] + p[3];
+    float dq = q[2] + q[3];
+    if (dp >= 0.0f) {
+      poly[num_points++] = p;
+    }
+    if ((dp >= 0.0f) != (dq >= 0.0f)) {
+      poly[num_points++] = p + (q - p) * (dp / (dp - dq));
+    }
+  }
+  if (num_points < 3) {
+    return;
+  }
+
+  // Convert to pixels, with y increasing downward.
+  LVecBase3f screen[4];
+  for (int i = 0; i < num_points; ++i) {
+    if (poly[i][3] <= 0.0f) {
+      return;
+    }
+    float inv_w = 1.0f / poly[i][3];
+    screen[i].set((poly[i][0] * inv_w * 0.5f + 0.5f) * _x_size,
+                  (0.5f - poly[i][1] * inv_w * 0.5f) * _y_size,
+                  poly[i][2] * inv_w * 0.5f + 0.5f);
+  }
+
+  for (int i = 2; i < num_points; ++i) {
+    Triangle tri;
+    const LVecBase3f *points[3] = { &screen[0], &screen[i - 1], &screen[i] };
+    for (int k = 0; k < 3; ++k) {
+      tri._x[k] = (*points[k])[0];
+      tri._y[k] = (*points[k])[1];
+      tri._z[k] = (*points[k])[2];
+    }
+    _triangles.push_back(tri);
+  }
+}
+
+/**
+ * Clears the indicated band of rows of the depth buffer and rasterizes the
+ * triangles that overlap it.  Each band may be rasterized by a different
+ * thread.
+ */
+void SoftwareOcclusionCullTraverser::
+rasterize_band(int band) {
+  Level &level = _levels[0];
+  int stride = level._stride;
+  int y_begin = band * band_height;
+  int y_end = std::min(y_begin + band_height, _y_size);
+  float *depth = &level._depth[0];
+  std::fill(depth + y_begin * stride, depth + y_end * stride, 1.0f);
+
+  for (int ti : _bins[band]) {
+    const Triangle &tri = _triangles[ti];
+    float x0 = tri._x[0], y0 = tri._y[0], z0 = tri._z[0];
+    float x1 = tri._x[1], y1 = tri._y[1], z1 = tri._z[1];
+    float x2 = tri._x[2], y2 = tri._y[2], z2 = tri._z[2];
+
+    // Both sides of the occluders are drawn, so make the winding consistent.
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if (area == 0.0f) {
+      continue;
+    }
+    if (area < 0.0f) {
+      std::swap(x1, x2);
+      std::swap(y1, y2);
+      std::swap(z1, z2);
+      area = -area;
+    }
+
+    int min_x = (int)std::max(floorf(std::min(std::min(x0, x1), x2)), 0.0f);
+    int max_x = (int)std::min(ceilf(std::max(std::max(x0, x1), x2)), (float)(_x_size - 1));
+    int min_y = (int)std::max(floorf(std::min(std::min(y0, y1), y2)), (float)y_begin);
+    int max_y = (int)std::min(ceilf(std::max(std::max(y0, y1), y2)), (float)(y_end - 1));
+    if (min_x > max_x || min_y > max_y) {
+      continue;
+    }
+
+    // Each edge function is positive on the inside of its edge.
+    float ea[3] = { y0 - y1, y1 - y2, y2 - y0 };
+    float eb[3] = { x1 - x0, x2 - x1, x0 - x2 };
+    float ec[3] = {
+      -ea[0] * x0 - eb[0] * y0,
+      -ea[1] * x1 - eb[1] * y1,
+      -ea[2] * x2 - eb[2] * y2,
+    };
+
+    float inv_ea[3] = {
+      (ea[0] != 0.0f) ? 1.0f / ea[0] : 0.0f,
+      (ea[1] != 0.0f) ? 1.0f / ea[1] : 0.0f,
+      (ea[2] != 0.0f) ? 1.0f / ea[2] : 0.0f,
+    };
+
+    // The depth is linear in screen space.
+    float inv_area = 1.0f / area;
+    float dzdx = ((z1 - z0) * (y2 - y0) - (z2 - z0) * (y1 - y0)) * inv_area;
+    float dzdy = ((z2 - z0) * (x1 - x0) - (z1 - z0) * (x2 - x0)) * inv_area;
+    float zc = z0 - dzdx * x0 - dzdy * y0;
+
+    for (int y = min_y; y <= max_y; ++y) {
+      float py = (float)y + 0.5f;
+      float *row = depth + y * stride;
+
+      float r0 = eb[0] * py + ec[0];
+      float r1 = eb[1] * py + ec[1];
+      float r2 = eb[2] * py + ec[2];
+      float rz = dzdy * py + zc;
+
+      // Narrow the row down to the span between the edges, so that we don't
+      // visit all of the empty pixels in the bounding box.  This may include
+      // a pixel too many on either side; the edge functions are still
+      // evaluated below to settle the pixels right on an edge.
+      float span_lo = (float)min_x;
+      float span_hi = (float)max_x;
+      float r[3] = { r0, r1, r2 };
+      for (int k = 0; k < 3; ++k) {
+        if (ea[k] > 0.0f) {
+          span_lo = std::max(span_lo, -r[k] * inv_ea[k] - 1.0f);
+        } else if (ea[k] < 0.0f) {
+          span_hi = std::min(span_hi, -r[k] * inv_ea[k] + 1.0f);
+        } else if (r[k] < 0.0f) {
+          span_hi = -1.0f;
+        }
+      }
+      if (span_lo > span_hi) {
+        continue;
+      }
+      int x_begin = (int)span_lo;
+      int x_end = (int)span_hi;
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+      // Four pixels at a time.  The rows are padded to a multiple of four, so
+      // this may safely run past the end of the span; the edge functions
+      // reject the extra pixels.
+      const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+      const __m128 zero = _mm_setzero_ps();
+      __m128 a0 = _mm_set1_ps(ea[0]);
+      __m128 a1 = _mm_set1_ps(ea[1]);
+      __m128 a2 = _mm_set1_ps(ea[2]);
+      __m128 az = _mm_set1_ps(dzdx);
+      __m128 b0 = _mm_set1_ps(r0);
+      __m128 b1 = _mm_set1_ps(r1);
+      __m128 b2 = _mm_set1_ps(r2);
+      __m128 bz = _mm_set1_ps(rz);
+
+      for (int x = x_begin & ~3; x <= x_end; x += 4) {
+        __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+        __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), b0);
+        __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), b1);
+        __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), b2);
+        __m128 mask = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero),
+                                            _mm_cmpge_ps(e1, zero)),
+                                 _mm_cmpge_ps(e2, zero));
+        if (_mm_movemask_ps(mask) == 0) {
+          continue;
+        }
+        __m128 z = _mm_add_ps(_mm_mul_ps(az, px), bz);
+        __m128 old_z = _mm_loadu_ps(row + x);
+        __m128 new_z = _mm_min_ps(old_z, z);
+        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, new_z),
+                                         _mm_andnot_ps(mask, old_z)));
+      }
+#else
+      for (int x = x_begin; x <= x_end; ++x) {
+        float px = (float)x + 0.5f;
+        if (ea[0] * px + r0 >= 0.0f &&
+            ea[1] * px + r1 >= 0.0f &&
+            ea[2] * px + r2 >= 0.0f) {
+          row[x] = std::min(row[x], dzdx * px + rz);
+        }
+      }
+#endif  // __SSE2__
+    }
+  }
+}
+
+/**
+ * Fills in each level of the depth pyramid after the first with the farthest
+ * depth of the corresponding texels of the level before it.
+ */
+void SoftwareOcclusionCullTraverser::
+build_pyramid() {
+  PStatTimer timer(_pyramid_pcollector);
+
+  for (size_t li = 1; li < _levels.size(); ++li) {
+    const Level &from = _levels[li - 1];
+    Level &to = _levels[li];
+    int max_x = from._x_size - 1;
+    int max_y = from._y_size - 1;
+
+    for (int y = 0; y < to._y_size; ++y) {
+      const float *row0 = &from._depth[(y * 2) * from._stride];
+      const float *row1 = &from._depth[std::min(y * 2 + 1, max_y) * from._stride];
+      float *out = &to._depth[y * to._stride];
+      for (int x = 0; x < to._x_size; ++x) {
+        int x0 = x * 2;
+        int x1 = std::min(x0 + 1, max_x);
+        out[x] = std::max(std::max(row0[x0], row0[x1]),
+                          std::max(row1[x0], row1[x1]));
+      }
+    }
+  }
+}
+
+/**
+ * Projects the corners of the bounding volume, given in the space of the
+ * indicated matrix, to the screen.  Fills in the range of pixels that it
+ * covers and its nearest depth, and returns true; or returns false if it
+ * cannot be tested, because it is not a finite volume, or crosses the near
+ * plane, or is entirely offscreen.
+ */
+bool SoftwareOcclusionCullTraverser::
+project_bounds(const BoundingVolume *bounds, const LMatrix4 &mvp,
+               int &x0, int &y0, int &x1, int &y1, float &min_depth) const {
+  if (bounds == nullptr || bounds->is_empty() || bounds->is_infinite()) {
+    return false;
+  }
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr) {
+    return false;
+  }
+
+  LPoint3 corners[2] = { fbv->get_min(), fbv->get_max() };
+  float min_x = FLT_MAX, min_y = FLT_MAX;
+  float max_x = -FLT_MAX, max_y = -FLT_MAX;
+  min_depth = FLT_MAX;
+
+  for (int i = 0; i < 8; ++i) {
+    LVecBase4 point(corners[i & 1][0], corners[(i >> 1) & 1][1],
+                    corners[(i >> 2) & 1][2], 1.0f);
+    LVecBase4f clip = LCAST(float, mvp.xform(point));
+    if (clip[3] <= 0.0f || clip[2] < -clip[3]) {
+      return false;
+    }
+    float inv_w = 1.0f / clip[3];
+    float sx = (clip[0] * inv_w * 0.5f + 0.5f) * _x_size;
+    float sy = (0.5f - clip[1] * inv_w * 0.5f) * _y_size;
+    min_x = std::min(min_x, sx);
+    max_x = std::max(max_x, sx);
+    min_y = std::min(min_y, sy);
+    max_y = std::max(max_y, sy);
+    min_depth = std::min(min_depth, clip[2] * inv_w * 0.5f + 0.5f);
+  }
+
+  if (max_x < 0.0f || max_y < 0.0f || min_x >= _x_size || min_y >= _y_size) {
+    return false;
+  }
+  x0 = (int)std::max(min_x, 0.0f);
+  y0 = (int)std::max(min_y, 0.0f);
+  x1 = (int)std::min(max_x, (float)(_x_size - 1));
+  y1 = (int)std::min(max_y, (float)(_y_size - 1));
+  return true;
+}
+
+/**
+ * Returns true if the bounding volume, whose coordinate space has the
+ * indicated transform relative to the camera, is entirely behind the
+ * occluders.
+ */
+bool SoftwareOcclusionCullTraverser::
+test_bounds(const BoundingVolume *bounds, const TransformState *modelview) const {
+  if (modelview->is_invalid()) {
+    return false;
+  }
+
+  int x0, y0, x1, y1;
+  float min_depth;
+  LMatrix4 mvp = modelview->get_mat() * _projection_mat;
+  if (!project_bounds(bounds, mvp, x0, y0, x1, y1, min_depth)) {
+    return false;
+  }
+  min_depth -= depth_epsilon;
+
+  // Use the finest level at which the rectangle covers no more than four
+  // texels in each direction.
+  int li = 0;
+  while (li + 1 < (int)_levels.size() &&
+         ((x1 >> li) - (x0 >> li) >= 4 || (y1 >> li) - (y0 >> li) >= 4)) {
+    ++li;
+  }
+
+  const Level &level = _levels[li];
+  for (int y = y0 >> li; y <= (y1 >> li); ++y) {
+    const float *row = &level._depth[y * level._stride];
+    for (int x = x0 >> li; x <= (x1 >> li); ++x) {
+      if (min_depth <= row[x]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
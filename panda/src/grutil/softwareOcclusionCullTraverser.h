@@ -0,0 +1,156 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareOcclusionCullTraverser.h
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#ifndef SOFTWAREOCCLUSIONCULLTRAVERSER_H
+#define SOFTWAREOCCLUSIONCULLTRAVERSER_H
+
+#include "pandabase.h"
+#include "cullTraverser.h"
+#include "nodePath.h"
+#include "lens.h"
+#include "pStatCollector.h"
+#include "pvector.h"
+
+class PNMImage;
+
+/**
+ * This specialization of CullTraverser performs occlusion culling against a
+ * depth buffer that is rasterized on the CPU.  Unlike
+ * PipeOcclusionCullTraverser, it does not need the graphics pipe at all, so
+ * there is no frame of latency, and it may be used with any pipe, including
+ * tinydisplay, or with no pipe at all on a headless server.
+ *
+ * At the start of each frame, the triangles of the designated occluders are
+ * rasterized into a small depth buffer, from which a hierarchical-Z pyramid
+ * is built, in which each level holds the farthest depth of the four texels
+ * beneath it.  Each node is then tested by projecting its bounding volume to
+ * the screen and comparing its nearest depth to the pyramid.
+ *
+ * The occluders should be simple, closed meshes that lie within the visible
+ * geometry they stand in for, such as the walls of a building; they are not
+ * drawn by this traverser.  They are usually kept in a separate part of the
+ * scene graph, or hidden from the camera.
+ */
+class EXPCL_PANDA_GRUTIL SoftwareOcclusionCullTraverser : public CullTraverser {
+PUBLISHED:
+  SoftwareOcclusionCullTraverser();
+  SoftwareOcclusionCullTraverser(const SoftwareOcclusionCullTraverser &copy) = delete;
+
+  virtual void set_scene(SceneSetup *scene_setup,
+                         GraphicsStateGuardianBase *gsg,
+                         bool dr_incomplete_render);
+  virtual void end_traverse();
+
+  void set_size(int x_size, int y_size);
+  INLINE int get_x_size() const;
+  INLINE int get_y_size() const;
+
+  void add_occluder(const NodePath &occluder);
+  bool remove_occluder(const NodePath &occluder);
+  void clear_occluders();
+  INLINE int get_num_occluders() const;
+  INLINE NodePath get_occluder(int n) const;
+  MAKE_SEQ(get_occluders, get_num_occluders, get_occluder);
+  MAKE_SEQ_PROPERTY(occluders, get_num_occluders, get_occluder);
+
+  void render_occluders(const NodePath &camera);
+  bool is_occluded(const NodePath &node) const;
+
+  INLINE int get_num_occluder_triangles() const;
+  INLINE int get_num_levels() const;
+  void store_depth(PNMImage &image, int level = 0) const;
+
+protected:
+  virtual bool is_in_view(CullTraverserData &data);
+
+private:
+  void do_render_occluders(const NodePath &camera, const Lens *lens);
+  void r_collect_occluders(PandaNode *node, const TransformState *modelview,
+                           Thread *current_thread);
+  void add_geom_triangles(const Geom *geom, const LMatrix4 &mvp,
+                          Thread *current_thread);
+  void add_triangle(const LVecBase4f &a, const LVecBase4f &b,
+                    const LVecBase4f &c);
+  void rasterize_band(int band);
+  void build_pyramid();
+
+  bool project_bounds(const BoundingVolume *bounds, const LMatrix4 &mvp,
+                      int &x0, int &y0, int &x1, int &y1,
+                      float &min_depth) const;
+  bool test_bounds(const BoundingVolume *bounds,
+                   const TransformState *modelview) const;
+
+private:
+  // A triangle in screen space, with x and y in pixels and a depth from 0 at
+  // the near plane to 1 at the far plane.
+  class Triangle {
+  public:
+    float _x[3];
+    float _y[3];
+    float _z[3];
+  };
+  typedef pvector<Triangle> Triangles;
+
+  // One level of the depth pyramid.  The rows of level 0 are padded to a
+  // multiple of four pixels.
+  class Level {
+  public:
+    int _x_size;
+    int _y_size;
+    int _stride;
+    pvector<float> _depth;
+  };
+  typedef pvector<Level> Levels;
+
+  int _x_size;
+  int _y_size;
+
+  typedef pvector<NodePath> Occluders;
+  Occluders _occluders;
+
+  // The camera and projection of the most recent render_occluders().
+  bool _live;
+  NodePath _camera;
+  LMatrix4 _projection_mat;
+
+  Triangles _triangles;
+  pvector<pvector<int> > _bins;
+  Levels _levels;
+
+  static PStatCollector _occluders_pcollector;
+  static PStatCollector _pyramid_pcollector;
+  static PStatCollector _occlusion_passed_pcollector;
+  static PStatCollector _occlusion_failed_pcollector;
+  static PStatCollector _occlusion_tests_pcollector;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    CullTraverser::init_type();
+    register_type(_type_handle, "SoftwareOcclusionCullTraverser",
+                  CullTraverser::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "softwareOcclusionCullTraverser.I"
+
+#endif
@@ -16,10 +16,15 @@
 /**
  * Initializes the CacheStats for the first time.  We don't use the
  * constructor for this, since we can't guarantee ordering of static
- * constructors.
+ * constructors.  The name is used to label the PStats collectors.
  */
 void CacheStats::
-init() {
+init(const std::string &name) {
+  _size_pcollector = PStatCollector(name + " cache size");
+  _hit_pcollector = PStatCollector(name + " cache operations:hit");
+  _miss_pcollector = PStatCollector(name + " cache operations:miss");
+  _evict_pcollector = PStatCollector(name + " cache operations:evict");
+
 #ifndef NDEBUG
   // Let's not use the clock at static init time.
   //reset(ClockObject::get_global_clock()->get_real_time());
@@ -41,6 +46,7 @@ reset(double now) {
   _cache_adds = 0;
   _cache_new_adds = 0;
   _cache_dels = 0;
+  _cache_evicts = 0;
   _last_reset = now;
 #endif  // NDEBUG
 }
@@ -51,12 +57,13 @@ reset(double now) {
 void CacheStats::
 write(std::ostream &out, const char *name) const {
 #ifndef NDEBUG
+  AtomicAdjust::Integer num_states = AtomicAdjust::get(_num_states);
   out << name << " cache: " << _cache_hits << " hits, "
       << _cache_misses << " misses\n"
       << _cache_adds + _cache_new_adds << "(" << _cache_new_adds << ") adds(new), "
-      << _cache_dels << " dels, "
-      << _total_cache_size << " / " << _num_states << " = "
-      << (double)_total_cache_size / (double)_num_states
+      << _cache_dels << "(" << _cache_evicts << ") dels(evicted), "
+      << _total_cache_size << " / " << num_states << " = "
+      << (double)_total_cache_size / (double)num_states
       << " average cache size\n";
 #endif  // NDEBUG
 }
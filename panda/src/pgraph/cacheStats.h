@@ -17,6 +17,8 @@
 #include "pandabase.h"
 #include "clockObject.h"
 #include "pnotify.h"
+#include "atomicAdjust.h"
+#include "pStatCollector.h"
 
 /**
  * This is used to track the utilization of the TransformState and RenderState
@@ -25,27 +27,43 @@
 class EXPCL_PANDA_PGRAPH CacheStats {
 public:
   CacheStats() = default;
-  void init();
+  void init(const std::string &name);
   void reset(double now);
   void write(std::ostream &out, const char *name) const;
   INLINE void maybe_report(const char *name);
+  INLINE void flush_level();
 
   INLINE void inc_hits();
   INLINE void inc_misses();
   INLINE void inc_adds(bool is_new);
   INLINE void inc_dels();
+  INLINE void inc_evicts(int count);
   INLINE void add_total_size(int count);
   INLINE void add_num_states(int count);
 
+  INLINE int get_total_size() const;
+
 private:
+  // This one is always kept, since it is needed to enforce
+  // composition-cache-limit.
+  int _total_cache_size = 0;
+
+  // These are kept in release builds too, as long as PStats is compiled in.
+  PStatCollector _size_pcollector;
+  PStatCollector _hit_pcollector;
+  PStatCollector _miss_pcollector;
+  PStatCollector _evict_pcollector;
+
 #ifndef NDEBUG
   int _cache_hits = 0;
   int _cache_misses = 0;
   int _cache_adds = 0;
   int _cache_new_adds = 0;
   int _cache_dels = 0;
-  int _total_cache_size = 0;
-  int _num_states = 0;
+  int _cache_evicts = 0;
+  // States are constructed and destructed without holding the cache lock,
+  // so this one is updated atomically.
+  AtomicAdjust::Integer _num_states = 0;
   double _last_reset = 0.0;
 
   bool _cache_report = false;
@@ -132,6 +132,23 @@ ConfigVariableBool debug_portal_cull
           "(You first need to enable portal culling, using the allow-portal-cull"
           "variable.)"));
 
+ConfigVariableBool meshlet_cull
+("meshlet-cull", true,
+ PRC_DESC("Set this true to cull the meshlets of each Geom that has them "
+          "individually against the view frustum, and to skip those that "
+          "face entirely away from the camera.  See Geom::make_meshlets()."));
+
+ConfigVariableInt cull_num_threads
+("cull-num-threads", 0,
+ PRC_DESC("The default number of threads a CullTraverser may use to traverse "
+          "the scene graph.  When this is greater than 1, the subtrees of the "
+          "scene are handed out to the threads of the task-graph-chain, each "
+          "of which collects its own list of objects for each bin; these are "
+          "merged in scene graph order before the bins are sorted, so the "
+          "result is the same as that of a single-threaded traversal.  The "
+          "cull_callback() methods of nodes may then be called from these "
+          "threads.  Set this to 0 or 1 to cull on a single thread."));
+
 ConfigVariableBool show_occluder_volumes
 ("show-occluder-volumes", false,
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
@@ -219,6 +236,17 @@ ConfigVariableBool state_cache
           "similar to the TransformState cache controlled via "
           "transform-cache."));
 
+ConfigVariableInt composition_cache_limit
+("composition-cache-limit", 0,
+ PRC_DESC("Set this to a positive number to limit the total number of "
+          "entries in the composition caches of all RenderStates, and "
+          "separately of all TransformStates.  When a new composition would "
+          "exceed the limit, compositions that have not been used recently "
+          "are evicted to make room for it.  This is done a few at a time, "
+          "so the caches may briefly exceed the limit.  Set this to 0 "
+          "to let the caches grow without limit, in which case they are "
+          "only cleaned up as states are released."));
+
 ConfigVariableBool uniquify_transforms
 ("uniquify-transforms", true,
  PRC_DESC("Set this true to ensure that equivalent TransformStates "
@@ -306,6 +334,14 @@ ConfigVariableBool flatten_geoms
           "only the NodePath interfaces; you may still make the lower-level "
           "SceneGraphReducer calls directly."));
 
+ConfigVariableBool flatten_optimize_vertex_cache
+("flatten-optimize-vertex-cache", false,
+ PRC_DESC("When this is true, NodePath::flatten_strong() and flatten_medium() "
+          "will also reorder the triangles and vertices of the combined "
+          "Geoms for better use of the post-transform vertex cache and less "
+          "overdraw, as by SceneGraphReducer::optimize_vertex_cache().  "
+          "This has no effect if flatten-geoms is false."));
+
 ConfigVariableInt max_lenses
 ("max-lenses", 100,
  PRC_DESC("Specifies an upper limit on the maximum number of lenses "
@@ -34,6 +34,8 @@ extern ConfigVariableBool fake_view_frustum_cull;
 extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
+extern ConfigVariableBool meshlet_cull;
+extern EXPCL_PANDA_PGRAPH ConfigVariableInt cull_num_threads;
 extern ConfigVariableBool show_occluder_volumes;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
@@ -47,6 +49,7 @@ extern EXPCL_PANDA_PGRAPH ConfigVariableBool garbage_collect_states;
 extern ConfigVariableDouble garbage_collect_states_rate;
 extern ConfigVariableBool transform_cache;
 extern ConfigVariableBool state_cache;
+extern ConfigVariableInt composition_cache_limit;
 extern ConfigVariableBool uniquify_transforms;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool uniquify_states;
 extern ConfigVariableBool uniquify_attribs;
@@ -57,6 +60,7 @@ extern ConfigVariableInt max_collect_indices;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool premunge_data;
 extern ConfigVariableBool preserve_geom_nodes;
 extern ConfigVariableBool flatten_geoms;
+extern ConfigVariableBool flatten_optimize_vertex_cache;
 extern EXPCL_PANDA_PGRAPH ConfigVariableInt max_lenses;
 
 extern ConfigVariableBool polylight_info;
@@ -53,3 +53,29 @@ record_object(CullableObject *object, const CullTraverser *traverser) {
 void CullHandler::
 end_traverse() {
 }
+
+/**
+ * May be overridden by a derived class to support multithreaded cull
+ * traversal.  This should return a new CullHandler that may be used by
+ * another thread to record part of the scene, independently of this one and
+ * of other handlers returned by this method.  The CullTraverser will later
+ * pass it to merge_thread_handler(), in scene graph order, and then delete
+ * it.
+ *
+ * The default implementation returns NULL, which indicates that this handler
+ * can only be used by a single thread.
+ */
+CullHandler *CullHandler::
+make_thread_handler() {
+  return nullptr;
+}
+
+/**
+ * Adds the objects recorded by a handler that was returned by
+ * make_thread_handler() to this one, as though they had been passed to
+ * record_object() directly.
+ */
+void CullHandler::
+merge_thread_handler(CullHandler *handler, Thread *current_thread) {
+  nassertv(false);
+}
@@ -34,6 +34,10 @@ public:
                              const CullTraverser *traverser);
   virtual void end_traverse();
 
+  virtual CullHandler *make_thread_handler();
+  virtual void merge_thread_handler(CullHandler *handler,
+                                    Thread *current_thread);
+
   INLINE static void draw(CullableObject *object,
                           GraphicsStateGuardianBase *gsg,
                           bool force, Thread *current_thread);
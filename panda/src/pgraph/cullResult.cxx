@@ -28,6 +28,7 @@
 #include "config_pgraph.h"
 #include "depthOffsetAttrib.h"
 #include "colorBlendAttrib.h"
+#include "lightMutexHolder.h"
 
 TypeHandle CullResult::_type_handle;
 
@@ -100,6 +101,56 @@ make_next() const {
  */
 void CullResult::
 add_object(CullableObject *object, const CullTraverser *traverser) {
+  do_add_object(object, traverser, nullptr);
+}
+
+/**
+ * A variant of add_object() that may be called from several threads at once,
+ * each with its own PendingObjects.  Instead of being added to the bins
+ * directly, the object is prepared for rendering and added to the pending
+ * list, and must later be transferred to the bins with merge_objects().
+ */
+void CullResult::
+add_object(CullableObject *object, const CullTraverser *traverser,
+           PendingObjects &pending) {
+  do_add_object(object, traverser, &pending);
+}
+
+/**
+ * Transfers the objects collected by add_object() into the indicated
+ * PendingObjects into their bins.  If this is called for each
+ * PendingObjects in turn, in the order in which the scene graph was
+ * traversed, the bins end up with the same contents as though the objects
+ * had been added directly.
+ */
+void CullResult::
+merge_objects(PendingObjects &pending, Thread *current_thread) {
+  for (size_t bin_index = 0; bin_index < pending._bins.size(); ++bin_index) {
+    PendingObjects::Objects &objects = pending._bins[bin_index];
+    if (objects.empty()) {
+      continue;
+    }
+
+    CullBin *bin = get_bin((int)bin_index);
+    PendingObjects::Objects::const_iterator oi;
+    for (oi = objects.begin(); oi != objects.end(); ++oi) {
+      if (bin != nullptr) {
+        bin->add_object(*oi, current_thread);
+      } else {
+        delete (*oi);
+      }
+    }
+    objects.clear();
+  }
+}
+
+/**
+ * The implementation of add_object().  If pending is not NULL, the object is
+ * added to it instead of to the bins.
+ */
+void CullResult::
+do_add_object(CullableObject *object, const CullTraverser *traverser,
+              PendingObjects *pending) {
   static const LColor flash_alpha_color(0.92, 0.96, 0.10, 1.0f);
   static const LColor flash_binary_color(0.21f, 0.67f, 0.24, 1.0f);
   static const LColor flash_multisample_color(0.78f, 0.05f, 0.81f, 1.0f);
@@ -135,14 +186,10 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
       CullableObject *wireframe_part = new CullableObject(*object);
       wireframe_part->_state = get_wireframe_overlay_state(rmode);
 
-      if (wireframe_part->munge_geom
-          (_gsg, _gsg->get_geom_munger(wireframe_part->_state, current_thread),
-           traverser, force)) {
+      if (munge_object(wireframe_part, traverser, force, pending)) {
         int wireframe_bin_index = bin_manager->find_bin("fixed");
-        CullBin *bin = get_bin(wireframe_bin_index);
-        nassertv(bin != nullptr);
         check_flash_bin(wireframe_part->_state, bin_manager, wireframe_bin_index);
-        bin->add_object(wireframe_part, current_thread);
+        add_to_bin(wireframe_bin_index, wireframe_part, current_thread, pending);
       } else {
         delete wireframe_part;
       }
@@ -206,14 +253,10 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
               CullableObject *transparent_part = new CullableObject(*object);
               CPT(RenderState) transparent_state = get_dual_transparent_state();
               transparent_part->_state = object->_state->compose(transparent_state);
-              if (transparent_part->munge_geom
-                  (_gsg, _gsg->get_geom_munger(transparent_part->_state, current_thread),
-                   traverser, force)) {
+              if (munge_object(transparent_part, traverser, force, pending)) {
                 int transparent_bin_index = transparent_part->_state->get_bin_index();
-                CullBin *bin = get_bin(transparent_bin_index);
-                nassertv(bin != nullptr);
                 check_flash_bin(transparent_part->_state, bin_manager, transparent_bin_index);
-                bin->add_object(transparent_part, current_thread);
+                add_to_bin(transparent_bin_index, transparent_part, current_thread, pending);
               } else {
                 delete transparent_part;
               }
@@ -240,22 +283,46 @@ add_object(CullableObject *object, const CullTraverser *traverser) {
   }
 
   int bin_index = object->_state->get_bin_index();
-  CullBin *bin = get_bin(bin_index);
-  nassertv(bin != nullptr);
   check_flash_bin(object->_state, bin_manager, bin_index);
 
   // Munge vertices as needed for the GSG's requirements, and the object's
   // current state.
-  if (object->munge_geom(_gsg, _gsg->get_geom_munger(object->_state, current_thread), traverser, force)) {
+  if (munge_object(object, traverser, force, pending)) {
     // The object may or may not now be fully resident, but this may not
     // matter, since the GSG may have the necessary buffers already loaded.
     // We'll let the GSG ultimately decide whether to render it.
-    bin->add_object(object, current_thread);
+    add_to_bin(bin_index, object, current_thread, pending);
   } else {
     delete object;
   }
 }
 
+/**
+ * Munges the object's vertices as needed for the GSG's requirements and the
+ * object's state.  Returns the result of CullableObject::munge_geom().
+ *
+ * If pending is not NULL, the object is being added from one of several
+ * threads, and _munger_lock is held only while the caches on the RenderState
+ * are consulted.
+ */
+bool CullResult::
+munge_object(CullableObject *object, const CullTraverser *traverser,
+             bool force, PendingObjects *pending) {
+  Thread *current_thread = traverser->get_current_thread();
+  if (pending != nullptr) {
+    // The munger caches on the RenderState aren't safe to use from several
+    // threads at once, but the munging itself is.
+    PT(GeomMunger) munger;
+    {
+      LightMutexHolder holder(_munger_lock);
+      munger = _gsg->get_geom_munger(object->_state, current_thread);
+    }
+    return object->munge_geom(_gsg, munger, traverser, force, &_munger_lock);
+  }
+  return object->munge_geom
+    (_gsg, _gsg->get_geom_munger(object->_state, current_thread), traverser, force);
+}
+
 /**
  * Called after all the geoms have been added, this indicates that the cull
  * process is finished for this frame and gives the bins a chance to do any
@@ -332,6 +399,37 @@ make_result_graph() {
   return root_node;
 }
 
+/**
+ * Creates a new, empty list of pending objects.  This must be called on the
+ * thread that performs the traversal before handing it to another thread,
+ * since it also makes sure the states that add_object() may apply exist.
+ */
+CullResult::PendingObjects::
+PendingObjects() {
+  for (int mode = 0; mode <= (int)RescaleNormalAttrib::M_auto; ++mode) {
+    get_rescale_normal_state((RescaleNormalAttrib::Mode)mode);
+  }
+  get_alpha_state();
+  get_binary_state();
+  get_dual_transparent_state();
+  get_dual_opaque_state();
+  get_wireframe_filled_state();
+}
+
+/**
+ * Deletes any objects that were never merged.
+ */
+CullResult::PendingObjects::
+~PendingObjects() {
+  Bins::iterator bi;
+  for (bi = _bins.begin(); bi != _bins.end(); ++bi) {
+    Objects::iterator oi;
+    for (oi = (*bi).begin(); oi != (*bi).end(); ++oi) {
+      delete (*oi);
+    }
+  }
+}
+
 /**
  * Intended to be called by CullBinManager::remove_bin(), this informs all the
  * CullResults in the world to remove the indicated bin_index from their cache
@@ -26,6 +26,7 @@
 #include "pset.h"
 #include "pmap.h"
 #include "rescaleNormalAttrib.h"
+#include "lightMutex.h"
 
 class CullTraverser;
 class GraphicsStateGuardianBase;
@@ -59,9 +60,31 @@ PUBLISHED:
   PT(PandaNode) make_result_graph();
 
 public:
+  // The objects collected by one thread of a multithreaded cull traversal,
+  // sorted by bin index, in the order they were added.  See merge_objects().
+  class EXPCL_PANDA_PGRAPH PendingObjects {
+  public:
+    PendingObjects();
+    ~PendingObjects();
+
+    typedef pvector<CullableObject *> Objects;
+    typedef pvector<Objects> Bins;
+    Bins _bins;
+  };
+
+  void add_object(CullableObject *object, const CullTraverser *traverser,
+                  PendingObjects &pending);
+  void merge_objects(PendingObjects &pending, Thread *current_thread);
+
   static void bin_removed(int bin_index);
 
 private:
+  void do_add_object(CullableObject *object, const CullTraverser *traverser,
+                     PendingObjects *pending);
+  bool munge_object(CullableObject *object, const CullTraverser *traverser,
+                    bool force, PendingObjects *pending);
+  INLINE void add_to_bin(int bin_index, CullableObject *object,
+                         Thread *current_thread, PendingObjects *pending);
   CullBin *make_new_bin(int bin_index);
 
   INLINE void check_flash_bin(CPT(RenderState) &state, CullBinManager *bin_manager, int bin_index);
@@ -85,6 +108,11 @@ private:
   typedef pvector< PT(CullBin) > Bins;
   Bins _bins;
 
+  // Serializes the GSG's munger, munged state and generated shader lookups
+  // while objects are being added from several threads, since those are
+  // cached on the RenderState.
+  LightMutex _munger_lock;
+
   bool _show_transparency = false;
 
 public:
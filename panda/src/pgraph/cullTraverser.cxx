@@ -34,14 +34,107 @@
 #include "geomLinestrips.h"
 #include "geomLines.h"
 #include "geomVertexWriter.h"
+#include "asyncTaskGraph.h"
 
 PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
 PStatCollector CullTraverser::_geoms_pcollector("Geoms");
 PStatCollector CullTraverser::_geoms_occluded_pcollector("Geoms:Occluded");
+PStatCollector CullTraverser::_meshlets_pcollector("Meshlets");
+PStatCollector CullTraverser::_meshlets_culled_pcollector("Meshlets:Culled");
 
 TypeHandle CullTraverser::_type_handle;
 
+/**
+ * A run of consecutive siblings that is traversed as a separate job during
+ * traverse_parallel(), with its own copy of the CullTraverser and its own
+ * CullHandler.
+ */
+class CullTraverser::ParallelTask {
+public:
+  void traverse() {
+    Thread *current_thread = Thread::get_current_thread();
+    int pipeline_stage = current_thread->get_pipeline_stage();
+    current_thread->set_pipeline_stage(_pipeline_stage);
+    _trav->_current_thread = current_thread;
+
+    for (const NodePath &node_path : _node_paths) {
+      CullTraverserData data(node_path, _net_transform, _state, _view_frustum,
+                             current_thread);
+      data._cull_planes = _cull_planes;
+      data._instances = _instances;
+      data._draw_mask = _draw_mask;
+      data._portal_depth = _portal_depth;
+      _trav->do_traverse(data);
+    }
+
+    current_thread->set_pipeline_stage(pipeline_stage);
+  }
+
+  PT(CullTraverser) _trav;
+  int _pipeline_stage;
+  int _weight;
+
+  // The children to traverse, and the state inherited from their parent.
+  pvector<NodePath> _node_paths;
+  CPT(TransformState) _net_transform;
+  CPT(RenderState) _state;
+  PT(GeometricBoundingVolume) _view_frustum;
+  CPT(CullPlanes) _cull_planes;
+  CPT(InstanceList) _instances;
+  DrawMask _draw_mask;
+  int _portal_depth;
+};
+
+/**
+ * The bookkeeping for traverse_parallel().  The objects recorded during the
+ * traversal are divided into chunks, each with its own CullHandler, in scene
+ * graph order; these are alternately filled by this thread and by a
+ * ParallelTask.
+ */
+class CullTraverser::ParallelState {
+public:
+  class Chunk {
+  public:
+    CullHandler *_handler;
+    ParallelTask *_task;
+  };
+  typedef pvector<Chunk> Chunks;
+  Chunks _chunks;
+
+  // The groups of siblings to be traversed by the AsyncTaskGraph.
+  pvector<ParallelTask *> _tasks;
+
+  CullHandler *_handler;
+  int _target_weight;
+
+  // The siblings being collected for the next ParallelTask, if any.
+  ParallelTask *_group;
+
+  /**
+   * Sets aside the group of siblings collected so far to be traversed as a
+   * separate job, and starts a new chunk for the traverser to continue with.
+   */
+  void flush_group(CullTraverser *trav) {
+    if (_group == nullptr) {
+      return;
+    }
+
+    Chunk task_chunk;
+    task_chunk._handler = _group->_trav->_cull_handler;
+    task_chunk._task = _group;
+    _chunks.push_back(task_chunk);
+    _tasks.push_back(_group);
+    _group = nullptr;
+
+    Chunk chunk;
+    chunk._handler = _handler->make_thread_handler();
+    chunk._task = nullptr;
+    _chunks.push_back(chunk);
+    trav->_cull_handler = chunk._handler;
+  }
+};
+
 /**
  *
  */
@@ -56,6 +149,7 @@ CullTraverser() :
   _cull_handler = nullptr;
   _portal_clipper = nullptr;
   _effective_incomplete_render = true;
+  _num_threads = cull_num_threads;
 }
 
 /**
@@ -73,7 +167,8 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _num_threads(copy._num_threads)
 {
 }
 
@@ -147,12 +242,19 @@ traverse(const NodePath &root) {
     my_data._net_transform = my_data._net_transform->compose(transform);
     traverse(my_data);
 
+    // The PortalClipper doesn't outlive this traversal.
+    set_portal_clipper(nullptr);
+
   } else {
     CullTraverserData data(root, TransformState::make_identity(),
                            _initial_state, _view_frustum,
                            _current_thread);
 
-    do_traverse(data);
+    if (can_traverse_parallel()) {
+      traverse_parallel(data);
+    } else {
+      do_traverse(data);
+    }
   }
 }
 
@@ -172,6 +274,34 @@ traverse(CullTraverserData &data) {
  */
 void CullTraverser::
 traverse_below(CullTraverserData &data) {
+  PandaNode::Children children = visit_node(data);
+  PandaNode *node = data.node();
+
+  // Now visit all the node's children.
+  int num_children = children.get_num_children();
+  if (!node->has_selective_visibility()) {
+    for (int i = 0; i < num_children; ++i) {
+      CullTraverserData next_data(data, children.get_child(i));
+      do_traverse(next_data);
+    }
+  } else {
+    int i = node->get_first_visible_child();
+    while (i < num_children) {
+      CullTraverserData next_data(data, children.get_child(i));
+      do_traverse(next_data);
+      i = node->get_next_visible_child(i);
+    }
+  }
+}
+
+/**
+ * The first part of traverse_below(): adds the contents of the indicated node,
+ * which has been converted into the node's space, to the cull result, and
+ * applies any decal effect to the state inherited by its children.  Returns
+ * the node's children, which are to be visited next.
+ */
+PandaNode::Children CullTraverser::
+visit_node(CullTraverserData &data) {
   _nodes_pcollector.add_level(1);
   PandaNodePipelineReader *node_reader = data.node_reader();
   PandaNode *node = data.node();
@@ -195,23 +325,136 @@ traverse_below(CullTraverserData &data) {
     }
   }
 
-  // Now visit all the node's children.
   PandaNode::Children children = node_reader->get_children();
   node_reader->release();
-  int num_children = children.get_num_children();
-  if (!node->has_selective_visibility()) {
-    for (int i = 0; i < num_children; ++i) {
-      CullTraverserData next_data(data, children.get_child(i));
-      do_traverse(next_data);
+  return children;
+}
+
+/**
+ * Returns true if traverse() should divide the scene among several threads.
+ * This is not done while portal culling, since the PortalClipper keeps track
+ * of the portals visited so far as the traversal proceeds.
+ */
+bool CullTraverser::
+can_traverse_parallel() const {
+  return _num_threads > 1 && Thread::is_true_threads() &&
+    get_type() == CullTraverser::get_class_type() &&
+    _portal_clipper == nullptr;
+}
+
+/**
+ * Traverses the scene from the indicated root, handing out subtrees to other
+ * threads.  Each subtree is weighted by the number of vertices below it; the
+ * subtrees that are too heavy to be a single task are descended into on this
+ * thread, and runs of lighter siblings are grouped into tasks of about
+ * 1 / (4 * num_threads) of the scene each.
+ *
+ * The tasks are run by an AsyncTaskGraph once the subtrees have been divided
+ * up, by this thread and the threads of the chain shared by all graphs.
+ */
+void CullTraverser::
+traverse_parallel(CullTraverserData &data) {
+  int total_weight = data.node()->get_nested_vertices(_current_thread);
+
+  ParallelState state;
+  state._handler = _cull_handler;
+  state._group = nullptr;
+  state._target_weight = std::max(1, total_weight / (_num_threads * 4));
+
+  ParallelState::Chunk chunk;
+  chunk._handler = _cull_handler->make_thread_handler();
+  chunk._task = nullptr;
+  if (chunk._handler == nullptr || total_weight == 0) {
+    // This handler can't be used from several threads.
+    delete chunk._handler;
+    do_traverse(data);
+    return;
+  }
+  state._chunks.push_back(chunk);
+  _cull_handler = chunk._handler;
+
+  r_traverse_parallel(data, state);
+  state.flush_group(this);
+
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph;
+  graph->set_max_workers(_num_threads - 1);
+  graph->add_range(0, (int)state._tasks.size(), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      state._tasks[i]->traverse();
     }
-  } else {
-    int i = node->get_first_visible_child();
-    while (i < num_children) {
-      CullTraverserData next_data(data, children.get_child(i));
-      do_traverse(next_data);
-      i = node->get_next_visible_child(i);
+  }, 1);
+  graph->run();
+
+  // Now gather up the results, in order.
+  _cull_handler = state._handler;
+  for (ParallelState::Chunk &done : state._chunks) {
+    _cull_handler->merge_thread_handler(done._handler, _current_thread);
+    delete done._handler;
+    delete done._task;
+  }
+}
+
+/**
+ * The recursive part of traverse_parallel().  This does the same work as
+ * do_traverse() and traverse_below(), except that the node's children may
+ * be handed off to other threads.
+ */
+void CullTraverser::
+r_traverse_parallel(CullTraverserData &data, ParallelState &state) {
+  if (!enter_node(data)) {
+    return;
+  }
+
+  PandaNode::Children children = visit_node(data);
+  PandaNode *node = data.node();
+  int num_children = children.get_num_children();
+  NodePath node_path;
+
+  int i = node->has_selective_visibility() ? node->get_first_visible_child() : 0;
+  while (i < num_children) {
+    PandaNode *child = children.get_child(i);
+    int weight = child->get_nested_vertices(_current_thread);
+
+    if (weight > state._target_weight &&
+        child->get_num_children(_current_thread) > 0) {
+      // This subtree is too big to give to a single thread; look inside it.
+      state.flush_group(this);
+      CullTraverserData next_data(data, child);
+      r_traverse_parallel(next_data, state);
+
+    } else {
+      // Add it to the group of siblings for the next task.
+      ParallelTask *group = state._group;
+      if (group == nullptr) {
+        group = new ParallelTask;
+        group->_trav = new CullTraverser(*this);
+        group->_trav->_cull_handler = state._handler->make_thread_handler();
+        group->_pipeline_stage = _current_thread->get_pipeline_stage();
+        group->_weight = 0;
+        group->_net_transform = data._net_transform;
+        group->_state = data._state;
+        group->_view_frustum = data._view_frustum;
+        group->_cull_planes = data._cull_planes;
+        group->_instances = data._instances;
+        group->_draw_mask = data._draw_mask;
+        group->_portal_depth = data._portal_depth;
+        state._group = group;
+      }
+      if (node_path.is_empty()) {
+        node_path = data.get_node_path();
+      }
+      group->_node_paths.push_back(NodePath(node_path, child, _current_thread));
+      group->_weight += weight;
+      if (group->_weight >= state._target_weight) {
+        state.flush_group(this);
+      }
     }
+
+    i = node->has_selective_visibility() ? node->get_next_visible_child(i) : i + 1;
   }
+
+  // The siblings in a group must share the same parent.
+  state.flush_group(this);
 }
 
 /**
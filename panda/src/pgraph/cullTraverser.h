@@ -77,6 +77,10 @@ PUBLISHED:
 
   INLINE bool get_effective_incomplete_render() const;
 
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+  MAKE_PROPERTY(num_threads, get_num_threads, set_num_threads);
+
   void traverse(const NodePath &root);
   void traverse(CullTraverserData &data);
   virtual void traverse_below(CullTraverserData &data);
@@ -90,6 +94,7 @@ PUBLISHED:
 
 protected:
   INLINE void do_traverse(CullTraverserData &data);
+  INLINE bool enter_node(CullTraverserData &data);
 
   virtual bool is_in_view(CullTraverserData &data);
 
@@ -99,8 +104,19 @@ public:
   static PStatCollector _geom_nodes_pcollector;
   static PStatCollector _geoms_pcollector;
   static PStatCollector _geoms_occluded_pcollector;
+  static PStatCollector _meshlets_pcollector;
+  static PStatCollector _meshlets_culled_pcollector;
 
 private:
+  class ParallelState;
+  class ParallelTask;
+
+  PandaNode::Children visit_node(CullTraverserData &data);
+
+  bool can_traverse_parallel() const;
+  void traverse_parallel(CullTraverserData &data);
+  void r_traverse_parallel(CullTraverserData &data, ParallelState &state);
+
   void show_bounds(CullTraverserData &data, bool tight);
   static PT(Geom) make_bounds_viz(const BoundingVolume *vol);
   PT(Geom) make_tight_bounds_viz(PandaNode *node) const;
@@ -121,6 +137,7 @@ private:
   CullHandler *_cull_handler;
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
+  int _num_threads;
 
 public:
   static TypeHandle get_class_type() {
@@ -50,10 +50,15 @@ TypeHandle CullableObject::_type_handle;
  * If force is false, this may do nothing and return false if the vertex data
  * is nonresident.  If force is true, this will always return true, but it may
  * have to block while the vertex data is paged in.
+ *
+ * If cache_lock is not NULL, it is held while the munged state and generated
+ * shader are looked up, since these are cached on the RenderState, which
+ * makes it possible to munge objects from several threads at once.
  */
 bool CullableObject::
 munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
-           const CullTraverser *traverser, bool force) {
+           const CullTraverser *traverser, bool force,
+           LightMutex *cache_lock) {
   nassertr(munger != nullptr, false);
 
   Thread *current_thread = traverser->get_current_thread();
@@ -153,12 +158,24 @@ munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
         _state = _state->compose(state);
       }
 
+      if (cache_lock != nullptr) {
+        cache_lock->acquire();
+      }
       gsg->ensure_generated_shader(_state);
+      if (cache_lock != nullptr) {
+        cache_lock->release();
+      }
     } else {
       // We may need to munge the state for the fixed-function pipeline.
       StateMunger *state_munger = (StateMunger *)munger;
       if (state_munger->should_munge_state()) {
+        if (cache_lock != nullptr) {
+          cache_lock->acquire();
+        }
         _state = state_munger->munge_state(_state);
+        if (cache_lock != nullptr) {
+          cache_lock->release();
+        }
       }
     }
 
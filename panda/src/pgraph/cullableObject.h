@@ -49,7 +49,8 @@ public:
   INLINE void operator = (const CullableObject &copy);
 
   bool munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
-                  const CullTraverser *traverser, bool force);
+                  const CullTraverser *traverser, bool force,
+                  LightMutex *cache_lock = nullptr);
   INLINE void draw(GraphicsStateGuardianBase *gsg,
                    bool force, Thread *current_thread);
 
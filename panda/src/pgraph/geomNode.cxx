@@ -37,9 +37,11 @@
 #include "graphicsStateGuardianBase.h"
 #include "boundingBox.h"
 #include "boundingSphere.h"
+#include "finiteBoundingVolume.h"
 #include "config_mathutil.h"
 #include "preparedGraphicsObjects.h"
 #include "instanceList.h"
+#include "lens.h"
 
 
 bool allow_flatten_color = ConfigVariableBool
@@ -48,6 +50,125 @@ bool allow_flatten_color = ConfigVariableBool
 
 TypeHandle GeomNode::_type_handle;
 
+/**
+ * If the indicated Geom has been divided into meshlets, replaces it with the
+ * subset of its meshlets that are within the view frustum and not facing away
+ * from the camera.  Returns false if none of it is visible.
+ */
+static bool
+cull_meshlets(CPT(Geom) &geom, const RenderState *state, CullTraverser *trav,
+              CullTraverserData &data, Thread *current_thread) {
+  CPT(GeomMeshlets) meshlets = geom->get_meshlets(current_thread);
+  if (meshlets == nullptr || !meshlets->is_valid(geom, current_thread)) {
+    return true;
+  }
+
+  // The backface test is only done when we know which side of the triangles
+  // is culled, and only from a perspective lens, which has a single eye point.
+  LPoint3 eye;
+  bool has_eye = false;
+  const Lens *lens = trav->get_scene()->get_lens();
+  const CullFaceAttrib *cfa;
+  state->get_attrib_def(cfa);
+  if (lens != nullptr && lens->is_perspective() &&
+      cfa->get_effective_mode() == CullFaceAttrib::M_cull_clockwise) {
+    CPT(TransformState) modelview = data.get_modelview_transform(trav);
+    if (!modelview->is_invalid() && !modelview->is_singular() &&
+        modelview->get_mat().get_upper_3().determinant() > 0.0f) {
+      eye = modelview->get_inverse()->get_mat().xform_point(lens->get_nodal_point());
+      has_eye = true;
+    }
+  }
+
+  const GeometricBoundingVolume *frustum = data._view_frustum;
+  if (frustum == nullptr && !has_eye) {
+    return true;
+  }
+
+  int num_culled = 0;
+  geom = meshlets->cull(geom, frustum, has_eye ? &eye : nullptr,
+                        num_culled, current_thread);
+  trav->_meshlets_pcollector.add_level(meshlets->get_num_meshlets());
+  trav->_meshlets_culled_pcollector.add_level(num_culled);
+  return (geom != nullptr);
+}
+
+/**
+ * Returns the approximate size of the node on the screen, in pixels: the
+ * projected diameter of the bounding volume of its Geoms.  A node that is not
+ * entirely in front of the camera is taken to fill the screen.
+ */
+static int
+get_screen_size(CullTraverser *trav, CullTraverserData &data) {
+  const SceneSetup *scene = trav->get_scene();
+  int full_size = std::max(scene->get_viewport_width(), scene->get_viewport_height());
+
+  // The internal bounds are in the node's own coordinate space, which is the
+  // space the modelview transform takes us from.  The external bounds would
+  // already include the node's transform.
+  const Lens *lens = scene->get_lens();
+  CPT(BoundingVolume) bounds =
+    data.node()->get_internal_bounds(trav->get_current_thread());
+  if (lens == nullptr || bounds->is_empty() || bounds->is_infinite()) {
+    return full_size;
+  }
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr) {
+    return full_size;
+  }
+
+  CPT(TransformState) modelview = data.get_modelview_transform(trav);
+  const LMatrix4 &mat = modelview->get_mat();
+  LPoint3 min_point = fbv->get_min();
+  LPoint3 max_point = fbv->get_max();
+  LPoint3 center = mat.xform_point((min_point + max_point) * 0.5f);
+  PN_stdfloat scale = std::max(mat.get_row3(0).length(),
+                               std::max(mat.get_row3(1).length(),
+                                        mat.get_row3(2).length()));
+  PN_stdfloat radius = (max_point - min_point).length() * 0.5f * scale;
+  if (center.length() <= radius) {
+    return full_size;
+  }
+
+  const LMatrix4 &proj = lens->get_projection_mat();
+  LVecBase4 p0 = proj.xform(LVecBase4(center, 1.0f));
+  LVecBase4 p1 = proj.xform(LVecBase4(center + lens->get_up_vector() * radius, 1.0f));
+  if (p0[3] <= 0.0f || p1[3] <= 0.0f) {
+    return full_size;
+  }
+
+  // The film is two units high.
+  LVector2 delta(p1[0] / p1[3] - p0[0] / p0[3], p1[1] / p1[3] - p0[1] / p0[3]);
+  PN_stdfloat size = delta.length() * scene->get_viewport_height();
+  return std::min((int)size + 1, full_size);
+}
+
+/**
+ * Tells each streamed texture in the indicated state how large the node
+ * appears on the screen, so that the TextureStreamer can load the mipmap
+ * levels it needs.  The size is computed on first use, and is kept in
+ * screen_size for the other Geoms of the same node.
+ */
+static void
+report_texture_demand(const RenderState *state, CullTraverser *trav,
+                      CullTraverserData &data, int &screen_size) {
+  const TextureAttrib *ta;
+  if (!state->get_attrib(ta)) {
+    return;
+  }
+
+  int num_stages = ta->get_num_on_stages();
+  for (int i = 0; i < num_stages; ++i) {
+    Texture *tex = ta->get_on_texture(ta->get_on_stage(i));
+    if (tex != nullptr && tex->is_streamed()) {
+      if (screen_size < 0) {
+        screen_size = get_screen_size(trav, data);
+      }
+      tex->report_stream_demand(screen_size);
+    }
+  }
+}
+
 /**
  *
  */
@@ -515,6 +636,7 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
   int num_geoms = geoms.get_num_geoms();
   trav->_geoms_pcollector.add_level(num_geoms);
   CPT(TransformState) internal_transform = data.get_internal_transform(trav);
+  int screen_size = -1;
 
   if (num_geoms == 1) {
     // If there's only one Geom, we don't need to bother culling each individual
@@ -523,7 +645,10 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
     CPT(Geom) geom = geoms.get_geom(0);
     if (!geom->is_empty()) {
       CPT(RenderState) state = data._state->compose(geoms.get_geom_state(0));
-      if (!state->has_cull_callback() || state->cull_callback(trav, data)) {
+      if ((!state->has_cull_callback() || state->cull_callback(trav, data)) &&
+          (data._instances != nullptr || !meshlet_cull ||
+           cull_meshlets(geom, state, trav, data, current_thread))) {
+        report_texture_demand(state, trav, data, screen_size);
         CullableObject *object =
           new CullableObject(std::move(geom), std::move(state), std::move(internal_transform));
         object->_instances = data._instances;
@@ -548,6 +673,7 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
       if (data._instances != nullptr) {
         // Draw each individual instance.  We don't bother culling each
         // individual Geom for each instance; that is probably way too slow.
+        report_texture_demand(state, trav, data, screen_size);
         CullableObject *object =
           new CullableObject(std::move(geom), std::move(state), internal_transform);
         object->_instances = data._instances;
@@ -574,6 +700,12 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
         }
       }
 
+      if (meshlet_cull &&
+          !cull_meshlets(geom, state, trav, data, current_thread)) {
+        continue;
+      }
+
+      report_texture_demand(state, trav, data, screen_size);
       CullableObject *object =
         new CullableObject(std::move(geom), std::move(state), internal_transform);
       trav->get_cull_handler()->record_object(object, trav);
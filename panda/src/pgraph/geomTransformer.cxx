@@ -730,6 +730,164 @@ remove_column(GeomNode *node, const InternalName *column) {
   return any_changed;
 }
 
+/**
+ * Replaces the floating-point normal, texcoord, tangent and color columns of
+ * the vertex data in the Geom with smaller, quantized numeric types, as
+ * indicated by quantize_bits, which is the union of
+ * SceneGraphReducer::QuantizeVertices.  Returns true if the Geom was changed,
+ * false otherwise.
+ */
+bool GeomTransformer::
+quantize_vertices(Geom *geom, int quantize_bits) {
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  CPT(GeomVertexFormat) format = vdata->get_format();
+  if ((quantize_bits & SceneGraphReducer::QV_avoid_animated) != 0 &&
+      format->get_animation().get_animation_type() != Geom::AT_none) {
+    return false;
+  }
+
+  PT(GeomVertexFormat) new_format = new GeomVertexFormat(*format);
+  bool any_changed = false;
+
+  for (size_t ai = 0; ai < format->get_num_arrays(); ++ai) {
+    const GeomVertexArrayFormat *array_format = format->get_array(ai);
+    for (int ci = 0; ci < array_format->get_num_columns(); ++ci) {
+      const GeomVertexColumn *column = array_format->get_column(ci);
+      if ((column->get_numeric_type() != Geom::NT_float32 &&
+           column->get_numeric_type() != Geom::NT_float64) ||
+          column->get_num_elements() != 1) {
+        continue;
+      }
+
+      int num_components = column->get_num_components();
+      Geom::NumericType numeric_type;
+      const InternalName *top = column->get_name()->get_top();
+
+      if (column->get_contents() == Geom::C_normal && num_components == 3 &&
+          (quantize_bits & SceneGraphReducer::QV_normal) != 0) {
+        // Normals are unit vectors, which are stored most accurately by the
+        // octahedral encoding.
+        numeric_type = Geom::NT_packed_oct16;
+        num_components = 1;
+
+      } else if (column->get_contents() == Geom::C_texcoord &&
+                 num_components <= 3 &&
+                 (quantize_bits & SceneGraphReducer::QV_texcoord) != 0) {
+        numeric_type = Geom::NT_float16;
+
+      } else if (column->get_contents() == Geom::C_vector && num_components == 3 &&
+                 (top == InternalName::get_tangent() ||
+                  top == InternalName::get_binormal()) &&
+                 (quantize_bits & SceneGraphReducer::QV_tangent) != 0) {
+        numeric_type = Geom::NT_packed_snorm10;
+        num_components = 1;
+
+      } else if (column->get_contents() == Geom::C_color &&
+                 (quantize_bits & SceneGraphReducer::QV_color) != 0) {
+        numeric_type = Geom::NT_uint8;
+
+      } else {
+        continue;
+      }
+
+      new_format->modify_array(ai)->add_column
+        (column->get_name(), num_components, numeric_type,
+         column->get_contents(), column->get_start());
+      any_changed = true;
+    }
+  }
+
+  if (!any_changed) {
+    return false;
+  }
+
+  new_format->pack_columns();
+  format = GeomVertexFormat::register_format(new_format);
+  return set_format(geom, format);
+}
+
+/**
+ * Quantizes the vertex datas within the GeomNode; see the Geom version of
+ * this method.  Returns true if the GeomNode was changed, false otherwise.
+ */
+bool GeomTransformer::
+quantize_vertices(GeomNode *node, int quantize_bits) {
+  bool any_changed = false;
+
+  GeomNode::CDWriter cdata(node->_cycler);
+  GeomNode::GeomList::iterator gi;
+  PT(GeomNode::GeomList) geoms = cdata->modify_geoms();
+  for (gi = geoms->begin(); gi != geoms->end(); ++gi) {
+    GeomNode::GeomEntry &entry = (*gi);
+    PT(Geom) new_geom = entry._geom.get_read_pointer()->make_copy();
+    if (quantize_vertices(new_geom, quantize_bits)) {
+      entry._geom = new_geom;
+      any_changed = true;
+    }
+  }
+
+  return any_changed;
+}
+
+/**
+ * Reorders the triangles of the indicated Geom for better use of the vertex
+ * cache; see Geom::optimize_vertex_cache_in_place().  optimize_bits is the
+ * union of bits from SceneGraphReducer::OptimizeVertexCache.
+ *
+ * If OVC_vertices is set, the Geom is also registered so that its vertices
+ * are reordered by finish_apply(), which should be called after this method.
+ * Returns true if the Geom was changed, false otherwise.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(Geom *geom, int optimize_bits, int cache_size) {
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  if ((optimize_bits & SceneGraphReducer::OVC_avoid_dynamic) != 0 &&
+      (geom->get_usage_hint() != Geom::UH_static ||
+       vdata->get_usage_hint() != Geom::UH_static)) {
+    return false;
+  }
+
+  UpdateSeq modified = geom->get_modified();
+  geom->optimize_vertex_cache_in_place(cache_size);
+  bool any_changed = (geom->get_modified() != modified);
+
+  if ((optimize_bits & SceneGraphReducer::OVC_vertices) != 0) {
+    VertexDataAssoc &assoc = _vdata_assoc[vdata];
+    assoc._geoms.push_back(geom);
+    assoc._reorder_vertices = true;
+  }
+
+  return any_changed;
+}
+
+/**
+ * Reorders the triangles of all of the Geoms within the indicated GeomNode
+ * for better use of the vertex cache.  finish_apply() should be called after
+ * this method.  Returns true if the GeomNode was changed, false otherwise.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(GeomNode *node, int optimize_bits, int cache_size) {
+  bool any_changed = false;
+
+  GeomNode::CDWriter cdata(node->_cycler);
+  GeomNode::GeomList::iterator gi;
+  PT(GeomNode::GeomList) geoms = cdata->modify_geoms();
+  for (gi = geoms->begin(); gi != geoms->end(); ++gi) {
+    GeomNode::GeomEntry &entry = (*gi);
+    PT(Geom) new_geom = entry._geom.get_read_pointer()->make_copy();
+    if (optimize_vertex_cache(new_geom, optimize_bits, cache_size)) {
+      entry._geom = new_geom;
+      any_changed = true;
+
+    } else if ((optimize_bits & SceneGraphReducer::OVC_vertices) != 0) {
+      // The new Geom may still be given new vertices by finish_apply().
+      entry._geom = new_geom;
+    }
+  }
+
+  return any_changed;
+}
+
 /**
  * Checks if the different geoms in the GeomNode have different RenderStates.
  * If so, tries to make the RenderStates the same.  It does this by
@@ -915,7 +1073,9 @@ finish_apply() {
   for (vi = _vdata_assoc.begin(); vi != _vdata_assoc.end(); ++vi) {
     const GeomVertexData *vdata = (*vi).first;
     VertexDataAssoc &assoc = (*vi).second;
-    if (assoc._might_have_unused) {
+    if (assoc._reorder_vertices) {
+      assoc.reorder_vertices(vdata);
+    } else if (assoc._might_have_unused) {
       assoc.remove_unused_vertices(vdata);
     }
   }
@@ -1549,3 +1709,141 @@ remove_unused_vertices(const GeomVertexData *vdata) {
     geom->set_vertex_data(new_vdata);
   }
 }
+
+/**
+ * Reorders the vertices of the GeomVertexData in the order in which they are
+ * first referenced by the associated Geoms, so that the graphics card fetches
+ * them more or less sequentially.  Unused vertices are removed along the way.
+ */
+void GeomTransformer::VertexDataAssoc::
+reorder_vertices(const GeomVertexData *vdata) {
+  if (_geoms.empty()) {
+    // Trivial case.
+    return;
+  }
+
+  if (vdata->get_slider_table() != nullptr) {
+    // The sliders refer to particular rows, which we don't bother to remap.
+    if (_might_have_unused) {
+      remove_unused_vertices(vdata);
+    }
+    return;
+  }
+
+  PT(Thread) current_thread = Thread::get_current_thread();
+
+  int num_vertices = vdata->get_num_rows();
+  pvector<int> remap_array(num_vertices, -1);
+  pvector<int> new_order;
+  new_order.reserve(num_vertices);
+
+  bool any_referenced = false;
+  GeomList::iterator gi;
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    any_referenced = true;
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      GeomPrimitivePipelineReader reader(geom->get_primitive(i), current_thread);
+      int strip_cut_index = reader.get_strip_cut_index();
+      int num_prim_vertices = reader.get_num_vertices();
+      for (int vi = 0; vi < num_prim_vertices; ++vi) {
+        int index = reader.get_vertex(vi);
+        if (index == strip_cut_index) {
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        if (remap_array[index] < 0) {
+          remap_array[index] = (int)new_order.size();
+          new_order.push_back(index);
+        }
+      }
+    }
+  }
+
+  if (!any_referenced) {
+    return;
+  }
+
+  int new_num_vertices = (int)new_order.size();
+  bool in_order = (new_num_vertices == num_vertices);
+  for (int i = 0; i < new_num_vertices && in_order; ++i) {
+    in_order = (new_order[i] == i);
+  }
+  if (in_order) {
+    return;
+  }
+
+  // Now recopy the actual vertex data, one array at a time.
+  PT(GeomVertexData) new_vdata = new GeomVertexData(*vdata);
+  new_vdata->unclean_set_num_rows(new_num_vertices);
+
+  size_t num_arrays = vdata->get_num_arrays();
+  nassertv(num_arrays == new_vdata->get_num_arrays());
+
+  GeomVertexDataPipelineReader reader(vdata, current_thread);
+  reader.check_array_readers();
+  GeomVertexDataPipelineWriter writer(new_vdata, true, current_thread);
+  writer.check_array_writers();
+
+  for (size_t a = 0; a < num_arrays; ++a) {
+    const GeomVertexArrayDataHandle *array_reader = reader.get_array_reader(a);
+    GeomVertexArrayDataHandle *array_writer = writer.get_array_writer(a);
+
+    int stride = array_reader->get_array_format()->get_stride();
+    nassertv(stride == array_writer->get_array_format()->get_stride());
+
+    const unsigned char *from = array_reader->get_read_pointer(true);
+    unsigned char *to = array_writer->get_write_pointer();
+    for (int new_index = 0; new_index < new_num_vertices; ++new_index) {
+      memcpy(to + (size_t)new_index * stride,
+             from + (size_t)new_order[new_index] * stride, stride);
+    }
+  }
+
+  // Update the rows in the TransformBlendTable, if any.
+  PT(TransformBlendTable) tbtable = new_vdata->modify_transform_blend_table();
+  if (!tbtable.is_null()) {
+    const SparseArray &rows = tbtable->get_rows();
+    SparseArray new_rows;
+    for (int new_index = 0; new_index < new_num_vertices; ++new_index) {
+      if (rows.get_bit(new_order[new_index])) {
+        new_rows.set_bit(new_index);
+      }
+    }
+    tbtable->set_rows(new_rows);
+  }
+
+  // Finally, reindex the Geoms.
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      PT(GeomPrimitive) prim = geom->modify_primitive(i);
+      prim->make_indexed();
+      int strip_cut_index = prim->get_strip_cut_index();
+      PT(GeomVertexArrayData) vertices = prim->modify_vertices();
+      GeomVertexRewriter rewriter(vertices, 0, current_thread);
+
+      while (!rewriter.is_at_end()) {
+        int index = rewriter.get_data1i();
+        if (index == strip_cut_index) {
+          rewriter.set_data1i(index);
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        rewriter.set_data1i(remap_array[index]);
+      }
+    }
+
+    geom->set_vertex_data(new_vdata);
+  }
+}
@@ -76,6 +76,12 @@ public:
   bool remove_column(Geom *geom, const InternalName *column);
   bool remove_column(GeomNode *node, const InternalName *column);
 
+  bool quantize_vertices(Geom *geom, int quantize_bits);
+  bool quantize_vertices(GeomNode *node, int quantize_bits);
+
+  bool optimize_vertex_cache(Geom *geom, int optimize_bits, int cache_size);
+  bool optimize_vertex_cache(GeomNode *node, int optimize_bits, int cache_size);
+
   bool make_compatible_state(GeomNode *node);
 
   bool reverse_normals(Geom *geom);
@@ -102,8 +108,10 @@ private:
   public:
     INLINE VertexDataAssoc();
     bool _might_have_unused;
+    bool _reorder_vertices;
     GeomList _geoms;
     void remove_unused_vertices(const GeomVertexData *vdata);
+    void reorder_vertices(const GeomVertexData *vdata);
   };
   typedef pmap<CPT(GeomVertexData), VertexDataAssoc> VertexDataAssocMap;
   VertexDataAssocMap _vdata_assoc;
@@ -39,12 +39,15 @@
 using std::ostream;
 
 LightReMutex *RenderState::_states_lock = nullptr;
-RenderState::States RenderState::_states;
+RenderState::States *RenderState::_states = nullptr;
 const RenderState *RenderState::_empty_state = nullptr;
 UpdateSeq RenderState::_last_cycle_detect;
-size_t RenderState::_garbage_index = 0;
+size_t RenderState::_evict_shard = 0;
+size_t RenderState::_evict_index = 0;
+size_t RenderState::_evict_entry = 0;
 
 PStatCollector RenderState::_cache_update_pcollector("*:State Cache:Update");
+PStatCollector RenderState::_cache_evict_pcollector("*:State Cache:Evict");
 PStatCollector RenderState::_garbage_collect_pcollector("*:State Cache:Garbage Collect");
 PStatCollector RenderState::_state_compose_pcollector("*:State Cache:Compose State");
 PStatCollector RenderState::_state_invert_pcollector("*:State Cache:Invert State");
@@ -117,9 +120,10 @@ RenderState::
   nassertv(!is_destructing());
   set_destructing();
 
-  LightReMutexHolder holder(*_states_lock);
-
-  // unref() should have cleared these.
+  // unref() should have cleared these.  There is no need to hold the
+  // _states_lock here, since nothing in the cache refers to this object any
+  // more, and most states are destructed right after being found to be
+  // duplicates of a state already in the table.
   nassertv(_saved_entry == -1);
   nassertv(_composition_cache.is_empty() && _invert_composition_cache.is_empty());
 
@@ -358,9 +362,37 @@ compose(const RenderState *other) const {
     return do_compose(other);
   }
 
+  {
+    LightReMutexHolder holder(*_states_lock);
+
+    // Is this composition already cached?
+    int index = _composition_cache.find(other);
+    if (index != -1) {
+      Composition &comp = ((RenderState *)this)->_composition_cache.modify_data(index);
+      if (comp._result != nullptr) {
+        comp._used = true;
+        // Here's the cache!
+        _cache_stats.inc_hits();
+        return comp._result;
+      }
+    }
+  }
+
+  // Not in the cache.  Compute a new result.  We don't hold the lock while
+  // we do this, so that other threads can consult the cache in the meantime;
+  // the new state is uniquified through the sharded state table instead.
+  CPT(RenderState) result = do_compose(other);
+
+  // Make room for the new entries, if the caches are limited.  This is done
+  // before we grab the lock, since evict_compositions() takes it itself.
+  if (composition_cache_limit > 0) {
+    evict_compositions(composition_cache_limit - 2);
+  }
+
   LightReMutexHolder holder(*_states_lock);
 
-  // Is this composition already cached?
+  // Check the cache again, since another thread may have added this entry
+  // while we weren't holding the lock.
   int index = _composition_cache.find(other);
   if (index != -1) {
     Composition &comp = ((RenderState *)this)->_composition_cache.modify_data(index);
@@ -368,7 +400,6 @@ compose(const RenderState *other) const {
       // Well, it wasn't cached already, but we already had an entry (probably
       // created for the reverse direction), so use the same entry to store
       // the new result.
-      CPT(RenderState) result = do_compose(other);
       comp._result = result;
 
       if (result != (const RenderState *)this) {
@@ -377,6 +408,8 @@ compose(const RenderState *other) const {
         result->cache_ref();
       }
     }
+    comp._used = true;
+
     // Here's the cache!
     _cache_stats.inc_hits();
     return comp._result;
@@ -389,12 +422,12 @@ compose(const RenderState *other) const {
 
   // The cache entry in this object is the only one that indicates the result;
   // the other will be NULL for now.
-  CPT(RenderState) result = do_compose(other);
-
   _cache_stats.add_total_size(1);
   _cache_stats.inc_adds(_composition_cache.is_empty());
 
-  ((RenderState *)this)->_composition_cache[other]._result = result;
+  Composition &comp = ((RenderState *)this)->_composition_cache[other];
+  comp._result = result;
+  comp._used = true;
 
   if (other != this) {
     _cache_stats.add_total_size(1);
@@ -447,9 +480,37 @@ invert_compose(const RenderState *other) const {
     return do_invert_compose(other);
   }
 
+  {
+    LightReMutexHolder holder(*_states_lock);
+
+    // Is this composition already cached?
+    int index = _invert_composition_cache.find(other);
+    if (index != -1) {
+      Composition &comp = ((RenderState *)this)->_invert_composition_cache.modify_data(index);
+      if (comp._result != nullptr) {
+        comp._used = true;
+        // Here's the cache!
+        _cache_stats.inc_hits();
+        return comp._result;
+      }
+    }
+  }
+
+  // Not in the cache.  Compute a new result.  We don't hold the lock while
+  // we do this, so that other threads can consult the cache in the meantime;
+  // the new state is uniquified through the sharded state table instead.
+  CPT(RenderState) result = do_invert_compose(other);
+
+  // Make room for the new entries, if the caches are limited.  This is done
+  // before we grab the lock, since evict_compositions() takes it itself.
+  if (composition_cache_limit > 0) {
+    evict_compositions(composition_cache_limit - 2);
+  }
+
   LightReMutexHolder holder(*_states_lock);
 
-  // Is this composition already cached?
+  // Check the cache again, since another thread may have added this entry
+  // while we weren't holding the lock.
   int index = _invert_composition_cache.find(other);
   if (index != -1) {
     Composition &comp = ((RenderState *)this)->_invert_composition_cache.modify_data(index);
@@ -457,7 +518,6 @@ invert_compose(const RenderState *other) const {
       // Well, it wasn't cached already, but we already had an entry (probably
       // created for the reverse direction), so use the same entry to store
       // the new result.
-      CPT(RenderState) result = do_invert_compose(other);
       comp._result = result;
 
       if (result != (const RenderState *)this) {
@@ -466,6 +526,8 @@ invert_compose(const RenderState *other) const {
         result->cache_ref();
       }
     }
+    comp._used = true;
+
     // Here's the cache!
     _cache_stats.inc_hits();
     return comp._result;
@@ -478,11 +540,12 @@ invert_compose(const RenderState *other) const {
 
   // The cache entry in this object is the only one that indicates the result;
   // the other will be NULL for now.
-  CPT(RenderState) result = do_invert_compose(other);
-
   _cache_stats.add_total_size(1);
   _cache_stats.inc_adds(_invert_composition_cache.is_empty());
-  ((RenderState *)this)->_invert_composition_cache[other]._result = result;
+
+  Composition &comp = ((RenderState *)this)->_invert_composition_cache[other];
+  comp._result = result;
+  comp._used = true;
 
   if (other != this) {
     _cache_stats.add_total_size(1);
@@ -619,24 +682,33 @@ unref() const {
   // garbage collection in effect.  In this case we will pull the object out
   // of the cache when its reference count goes to 0.
 
-  // We always have to grab the lock, since we will definitely need to be
-  // holding it if we happen to drop the reference count to 0. Having to grab
-  // the lock at every call to unref() is a big limiting factor on
-  // parallelization.
-  LightReMutexHolder holder(*_states_lock);
-
   if (auto_break_cycles && uniquify_states) {
     if (get_cache_ref_count() > 0 &&
         get_ref_count() == get_cache_ref_count() + 1) {
       // If we are about to remove the one reference that is not in the cache,
       // leaving only references in the cache, then we need to check for a
-      // cycle involving this RenderState and break it if it exists.
+      // cycle involving this RenderState and break it if it exists.  This walks
+      // the composition caches, so it needs the global lock.
+      LightReMutexHolder holder(*_states_lock);
       ((RenderState *)this)->detect_and_break_cycles();
     }
   }
 
+  // Most of the time, this is not the last reference, and it can be dropped
+  // without taking any lock.
+  if (unref_if_not_one()) {
+    return true;
+  }
+
+  // Otherwise, we may be about to remove the state from the table.  This
+  // must be done while holding the global lock, since other threads may be
+  // walking the table or the composition caches under it, as well as the lock
+  // of the shard, so that no other thread can find the state there and ref
+  // it while its reference count drops to zero.
+  LightReMutexHolder holder(*_states_lock);
+  States::ShardHolder shard_holder(_states, _states->find_shard(this));
   if (ReferenceCount::unref()) {
-    // The reference count is still nonzero.
+    // Someone else got a reference to it in the meantime.
     return true;
   }
 
@@ -716,8 +788,17 @@ get_max_priority() {
  */
 int RenderState::
 get_num_states() {
-  LightReMutexHolder holder(*_states_lock);
-  return _states.get_num_entries();
+  return (int)_states->get_num_entries();
+}
+
+/**
+ * Returns the number of times, since the program started, that a thread had
+ * to wait for another thread to finish adding to or removing from the table
+ * of unique RenderStates.  This is also reported to PStats.
+ */
+int RenderState::
+get_num_lock_contentions() {
+  return (int)_states->get_num_contentions();
 }
 
 /**
@@ -742,9 +823,12 @@ get_num_unused_states() {
   typedef pmap<const RenderState *, int> StateCount;
   StateCount state_count;
 
-  size_t size = _states.get_num_entries();
+  pvector<const RenderState *> states;
+  _states->get_states(states);
+
+  size_t size = states.size();
   for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
+    const RenderState *state = states[si];
 
     size_t i;
     size_t cache_size = state->_composition_cache.get_num_entries();
@@ -818,7 +902,7 @@ clear_cache() {
   LightReMutexHolder holder(*_states_lock);
 
   PStatTimer timer(_cache_update_pcollector);
-  int orig_size = _states.get_num_entries();
+  int orig_size = (int)_states->get_num_entries();
 
   // First, we need to copy the entire set of states to a temporary vector,
   // reference-counting each object.  That way we can walk through the copy,
@@ -827,12 +911,11 @@ clear_cache() {
   {
     typedef pvector< CPT(RenderState) > TempStates;
     TempStates temp_states;
-    temp_states.reserve(orig_size);
-
-    size_t size = _states.get_num_entries();
-    for (size_t si = 0; si < size; ++si) {
-      const RenderState *state = _states.get_key(si);
-      temp_states.push_back(state);
+    {
+      pvector<const RenderState *> states;
+      states.reserve(orig_size);
+      _states->get_states(states);
+      temp_states.assign(states.begin(), states.end());
     }
 
     // Now it's safe to walk through the list, destroying the cache within
@@ -870,7 +953,7 @@ clear_cache() {
     // the various objects' caches will go away.
   }
 
-  int new_size = _states.get_num_entries();
+  int new_size = (int)_states->get_num_entries();
   return orig_size - new_size;
 }
 
@@ -886,6 +969,8 @@ int RenderState::
 garbage_collect() {
   int num_attribs = RenderAttrib::garbage_collect();
 
+  _states->flush_contention_level();
+
   if (!garbage_collect_states) {
     return num_attribs;
   }
@@ -893,76 +978,93 @@ garbage_collect() {
   LightReMutexHolder holder(*_states_lock);
 
   PStatTimer timer(_garbage_collect_pcollector);
-  size_t orig_size = _states.get_num_entries();
-
-  // How many elements to process this pass?
-  size_t size = orig_size;
-  size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
-  if (num_this_pass <= 0) {
-    return num_attribs;
-  }
 
   bool break_and_uniquify = (auto_break_cycles && uniquify_transforms);
+  int num_collected = 0;
+
+  // Each shard is collected in turn, holding only its own lock, so that
+  // other threads may continue to create states in the other shards.
+  for (size_t n = 0; n < (size_t)States::num_shards; ++n) {
+    States::Shard &shard = _states->get_shard(n);
+    States::ShardHolder shard_holder(_states, shard);
+
+    size_t orig_size = shard._states.get_num_entries();
+
+    // How many elements to process this pass?  Since the states are spread
+    // over many shards, a small shard would never be visited if we rounded
+    // this down to zero, so we always visit at least one state.
+    size_t size = orig_size;
+    if (size == 0 || garbage_collect_states_rate <= 0.0) {
+      continue;
+    }
+    size_t num_this_pass = std::max(1, int(size * garbage_collect_states_rate));
 
-  size_t si = _garbage_index;
-  if (si >= size) {
-    si = 0;
-  }
-
-  num_this_pass = std::min(num_this_pass, size);
-  size_t stop_at_element = (si + num_this_pass) % size;
+    size_t si = shard._garbage_index;
+    if (si >= size) {
+      si = 0;
+    }
 
-  do {
-    RenderState *state = (RenderState *)_states.get_key(si);
-    if (break_and_uniquify) {
-      if (state->get_cache_ref_count() > 0 &&
-          state->get_ref_count() == state->get_cache_ref_count()) {
-        // If we have removed all the references to this state not in the
-        // cache, leaving only references in the cache, then we need to
-        // check for a cycle involving this RenderState and break it if it
-        // exists.
-        state->detect_and_break_cycles();
+    num_this_pass = std::min(num_this_pass, size);
+    size_t stop_at_element = (si + num_this_pass) % size;
+
+    do {
+      RenderState *state = (RenderState *)shard._states.get_key(si);
+      if (break_and_uniquify) {
+        if (state->get_cache_ref_count() > 0 &&
+            state->get_ref_count() == state->get_cache_ref_count()) {
+          // If we have removed all the references to this state not in the
+          // cache, leaving only references in the cache, then we need to
+          // check for a cycle involving this RenderState and break it if it
+          // exists.
+          state->detect_and_break_cycles();
+        }
       }
-    }
 
-    if (!state->unref_if_one()) {
-      // This state has recently been unreffed to 1 (the one we added when
-      // we stored it in the cache).  Now it's time to delete it.  This is
-      // safe, because we're holding the _states_lock, so it's not possible
-      // for some other thread to find the state in the cache and ref it
-      // while we're doing this.  Also, we've just made sure to unref it to 0,
-      // to ensure that another thread can't get it via a weak pointer.
-
-      state->release_new();
-      state->remove_cache_pointers();
-      state->cache_unref_only();
-      delete state;
-
-      // When we removed it from the hash map, it swapped the last element
-      // with the one we just removed.  So the current index contains one we
-      // still need to visit.
-      --size;
-      --si;
-      if (stop_at_element > 0) {
-        --stop_at_element;
+      if (!state->unref_if_one()) {
+        // This state has recently been unreffed to 1 (the one we added when
+        // we stored it in the cache).  Now it's time to delete it.  This is
+        // safe, because we're holding the lock of its shard, so it's not
+        // possible for some other thread to find the state in the cache and
+        // ref it while we're doing this.  Also, we've just made sure to unref
+        // it to 0, to ensure that another thread can't get it via a weak
+        // pointer.
+
+        state->release_new();
+        state->remove_cache_pointers();
+        state->cache_unref_only();
+        delete state;
+
+        // When we removed it from the hash map, it swapped the last element
+        // with the one we just removed.  So the current index contains one we
+        // still need to visit.
+        --size;
+        --si;
+        if (stop_at_element > 0) {
+          --stop_at_element;
+        }
+        if (size == 0) {
+          break;
+        }
       }
-    }
 
-    si = (si + 1) % size;
-  } while (si != stop_at_element);
-  _garbage_index = si;
+      si = (si + 1) % size;
+    } while (si != stop_at_element);
+    shard._garbage_index = si;
 
-  nassertr(_states.get_num_entries() == size, 0);
+    nassertr(shard._states.get_num_entries() == size, 0);
 
 #ifdef _DEBUG
-  nassertr(_states.validate(), 0);
+    nassertr(shard._states.validate(), 0);
 #endif
 
-  // If we just cleaned up a lot of states, see if we can reduce the table in
-  // size.  This will help reduce iteration overhead in the future.
-  _states.consider_shrink_table();
+    // If we just cleaned up a lot of states, see if we can reduce the table
+    // in size.  This will help reduce iteration overhead in the future.
+    shard._states.consider_shrink_table();
+
+    num_collected += (int)orig_size - (int)size;
+  }
 
-  return (int)orig_size - (int)size + num_attribs;
+  return num_collected + num_attribs;
 }
 
 /**
@@ -973,9 +1075,12 @@ void RenderState::
 clear_munger_cache() {
   LightReMutexHolder holder(*_states_lock);
 
-  size_t size = _states.get_num_entries();
+  pvector<const RenderState *> states;
+  _states->get_states(states);
+
+  size_t size = states.size();
   for (size_t si = 0; si < size; ++si) {
-    RenderState *state = (RenderState *)(_states.get_key(si));
+    RenderState *state = (RenderState *)states[si];
     state->_mungers.clear();
     state->_munged_states.clear();
     state->_last_mi = -1;
@@ -1003,9 +1108,12 @@ list_cycles(ostream &out) {
   VisitedStates visited;
   CompositionCycleDesc cycle_desc;
 
-  size_t size = _states.get_num_entries();
+  pvector<const RenderState *> states;
+  _states->get_states(states);
+
+  size_t size = states.size();
   for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
+    const RenderState *state = states[si];
 
     bool inserted = visited.insert(state).second;
     if (inserted) {
@@ -1073,10 +1181,13 @@ void RenderState::
 list_states(ostream &out) {
   LightReMutexHolder holder(*_states_lock);
 
-  size_t size = _states.get_num_entries();
+  pvector<const RenderState *> states;
+  _states->get_states(states);
+
+  size_t size = states.size();
   out << size << " states:\n";
   for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
+    const RenderState *state = states[si];
     state->write(out, 2);
   }
 }
@@ -1092,26 +1203,42 @@ validate_states() {
   PStatTimer timer(_state_validate_pcollector);
 
   LightReMutexHolder holder(*_states_lock);
-  if (_states.is_empty()) {
-    return true;
+
+  for (size_t n = 0; n < (size_t)States::num_shards; ++n) {
+    States::Shard &shard = _states->get_shard(n);
+    States::ShardHolder shard_holder(_states, shard);
+    if (!shard._states.validate()) {
+      pgraph_cat.error()
+        << "RenderState::_states cache is invalid!\n";
+      return false;
+    }
+
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      if (&_states->find_shard(shard._states.get_key(si)) != &shard) {
+        pgraph_cat.error()
+          << "RenderState::_states cache has a state in the wrong shard!\n";
+        return false;
+      }
+    }
   }
 
-  if (!_states.validate()) {
-    pgraph_cat.error()
-      << "RenderState::_states cache is invalid!\n";
-    return false;
+  pvector<const RenderState *> states;
+  _states->get_states(states);
+  if (states.empty()) {
+    return true;
   }
 
-  size_t size = _states.get_num_entries();
+  size_t size = states.size();
   size_t si = 0;
   nassertr(si < size, false);
-  nassertr(_states.get_key(si)->get_ref_count() >= 0, false);
+  nassertr(states[si]->get_ref_count() >= 0, false);
   size_t snext = si;
   ++snext;
   while (snext < size) {
-    nassertr(_states.get_key(snext)->get_ref_count() >= 0, false);
-    const RenderState *ssi = _states.get_key(si);
-    const RenderState *ssnext = _states.get_key(snext);
+    nassertr(states[snext]->get_ref_count() >= 0, false);
+    const RenderState *ssi = states[si];
+    const RenderState *ssnext = states[snext];
     int c = ssi->compare_to(*ssnext);
     int ci = ssnext->compare_to(*ssi);
     if ((ci < 0) != (c > 0) ||
@@ -1278,17 +1405,11 @@ return_unique(RenderState *state) {
   }
 #endif
 
-  LightReMutexHolder holder(*_states_lock);
-
-  if (state->_saved_entry != -1) {
-    // This state is already in the cache.  nassertr(_states.find(state) ==
-    // state->_saved_entry, pt_state);
-    return state;
-  }
-
   // Ensure each of the individual attrib pointers has been uniquified before
-  // we add the state to the cache.
-  if (!uniquify_attribs && !state->is_empty()) {
+  // we add the state to the cache.  This must be done before we look up the
+  // shard, since it changes the hash; a state that is already in the cache is
+  // never modified.
+  if (!uniquify_attribs && !state->is_empty() && state->_saved_entry == -1) {
     SlotMask mask = state->_filled_slots;
     int slot = mask.get_lowest_on_bit();
     while (slot >= 0) {
@@ -1300,29 +1421,44 @@ return_unique(RenderState *state) {
     }
   }
 
-  int si = _states.find(state);
-  if (si != -1) {
-    // There's an equivalent state already in the set.  Return it.  The state
-    // that was passed may be newly created and therefore may not be
-    // automatically deleted.  Do that if necessary.
-    if (state->get_ref_count() == 0) {
-      delete state;
+  States::Shard &shard = _states->find_shard(state);
+  CPT(RenderState) result;
+  {
+    States::ShardHolder holder(_states, shard);
+
+    if (state->_saved_entry != -1) {
+      // This state is already in the cache.
+      // nassertr(shard._states.find(state) == state->_saved_entry, state);
+      return state;
+    }
+
+    int si = shard._states.find(state);
+    if (si == -1) {
+      // Not already in the set; add it.
+      if (garbage_collect_states) {
+        // If we'll be garbage collecting states explicitly, we'll increment
+        // the reference count when we store it in the cache, so that it
+        // won't be deleted while it's in it.
+        state->cache_ref();
+      }
+      si = shard._states.store(state, nullptr);
+
+      // Save the index and return the input state.
+      state->_saved_entry = si;
+      return state;
     }
-    return _states.get_key(si);
-  }
 
-  // Not already in the set; add it.
-  if (garbage_collect_states) {
-    // If we'll be garbage collecting states explicitly, we'll increment the
-    // reference count when we store it in the cache, so that it won't be
-    // deleted while it's in it.
-    state->cache_ref();
+    result = shard._states.get_key(si);
   }
-  si = _states.store(state, nullptr);
 
-  // Save the index and return the input state.
-  state->_saved_entry = si;
-  return state;
+  // There's an equivalent state already in the set.  Return it.  The state
+  // that was passed may be newly created and therefore may not be
+  // automatically deleted.  Do that if necessary, now that we are no longer
+  // holding the shard lock.
+  if (state->get_ref_count() == 0) {
+    delete state;
+  }
+  return result;
 }
 
 /**
@@ -1586,15 +1722,17 @@ r_detect_reverse_cycles(const RenderState *start_state,
  * This inverse of return_new, this releases this object from the global
  * RenderState table.
  *
- * You must already be holding _states_lock before you call this method.
+ * You must already be holding the lock of the shard of the table that holds
+ * this object before you call this method.
  */
 void RenderState::
 release_new() {
-  nassertv(_states_lock->debug_is_locked());
+  States::Shard &shard = _states->find_shard(this);
+  nassertv(shard._lock.debug_is_locked());
 
   if (_saved_entry != -1) {
     _saved_entry = -1;
-    nassertv_always(_states.remove(this));
+    nassertv_always(shard._states.remove(this));
   }
 }
 
@@ -1709,6 +1847,154 @@ remove_cache_pointers() {
   }
 }
 
+/**
+ * Removes the composition of this state with the indicated state from the
+ * composition cache (or from the invert composition cache, if inverted is
+ * true), along with the matching entry in the other state's cache.  Returns
+ * the number of cache entries that were removed.
+ *
+ * You must already be holding _states_lock before you call this method.
+ */
+int RenderState::
+remove_composition(const RenderState *other, bool inverted) {
+  nassertr(_states_lock->debug_is_locked(), 0);
+
+  CompositionCache &cache = inverted ? _invert_composition_cache : _composition_cache;
+  int i = cache.find(other);
+  if (i == -1) {
+    return 0;
+  }
+  Composition comp = cache.get_data(i);
+  cache.remove_element(i);
+  _cache_stats.add_total_size(-1);
+  _cache_stats.inc_dels();
+  int num_removed = 1;
+
+  Composition ocomp;
+  if (other != this) {
+    RenderState *nc_other = (RenderState *)other;
+    CompositionCache &ocache = inverted ? nc_other->_invert_composition_cache : nc_other->_composition_cache;
+    int oi = ocache.find(this);
+    if (oi != -1) {
+      ocomp = ocache.get_data(oi);
+      ocache.remove_element(oi);
+      _cache_stats.add_total_size(-1);
+      _cache_stats.inc_dels();
+      ++num_removed;
+    }
+  }
+
+  // Now that both caches are consistent again, it is safe to let the results
+  // go away.  The caller is responsible for keeping this and other alive.
+  if (ocomp._result != nullptr && ocomp._result != other) {
+    cache_unref_delete(ocomp._result);
+  }
+  if (comp._result != nullptr && comp._result != this) {
+    cache_unref_delete(comp._result);
+  }
+  return num_removed;
+}
+
+/**
+ * Removes entries from the composition caches of the RenderState objects until
+ * the total number of cache entries is no more than target_size.  This is
+ * called before a new composition is added, when composition-cache-limit is
+ * in effect.
+ *
+ * This approximates LRU with a clock: a hand walks over the cache entries of
+ * all states, continuing where it left off the last time.  An entry that has
+ * been used since the hand last passed it is given a second chance; otherwise
+ * it is evicted.  No more than a fixed number of entries are visited on each
+ * call, so that the lock is never held for long; if that is not enough, the
+ * caches may exceed the limit briefly until the next call catches up.
+ */
+void RenderState::
+evict_compositions(int target_size) {
+  // The number of steps of the hand allowed on each call, and the number of
+  // those in which recently used entries are spared.  After that, we evict
+  // what we find, so that the caches can't grow while everything is in use.
+  static const int max_steps = 256;
+  static const int max_second_chances = 64;
+
+  LightReMutexHolder holder(*_states_lock);
+  if (_cache_stats.get_total_size() <= target_size) {
+    return;
+  }
+
+  PStatTimer timer(_cache_evict_pcollector);
+
+  int num_evicted = 0;
+  for (int step = 0;
+       step < max_steps && _cache_stats.get_total_size() > target_size;
+       ++step) {
+    // Find the state under the hand.  We hold a reference to it while we
+    // work, so that it can't destruct as its results are released.  It is
+    // safe to take one while we're holding the lock of its shard.
+    CPT(RenderState) state;
+    {
+      States::Shard &shard = _states->get_shard(_evict_shard);
+      States::ShardHolder shard_holder(_states, shard);
+      if (_evict_index < shard._states.get_num_entries()) {
+        state = shard._states.get_key(_evict_index);
+      }
+    }
+    if (state == nullptr) {
+      // We've reached the end of this shard.
+      _evict_shard = (_evict_shard + 1) % States::num_shards;
+      _evict_index = 0;
+      _evict_entry = 0;
+      continue;
+    }
+
+    RenderState *nc_state = (RenderState *)state.p();
+    bool inverted = false;
+    size_t i = _evict_entry;
+    if (i >= nc_state->_composition_cache.get_num_entries()) {
+      i -= nc_state->_composition_cache.get_num_entries();
+      inverted = true;
+      if (i >= nc_state->_invert_composition_cache.get_num_entries()) {
+        // We've visited all of the entries of this state.
+        ++_evict_index;
+        _evict_entry = 0;
+        continue;
+      }
+    }
+
+    CompositionCache &cache = inverted ? nc_state->_invert_composition_cache : nc_state->_composition_cache;
+    const RenderState *other = cache.get_key(i);
+    Composition &comp = cache.modify_data(i);
+
+    // Each composition is recorded in the caches of both of its operands; we
+    // consider the pair as a unit, used if either half of it was.
+    Composition *ocomp = nullptr;
+    if (other != nc_state) {
+      RenderState *nc_other = (RenderState *)other;
+      CompositionCache &ocache = inverted ? nc_other->_invert_composition_cache : nc_other->_composition_cache;
+      int oi = ocache.find(nc_state);
+      if (oi != -1) {
+        ocomp = &ocache.modify_data(oi);
+      }
+    }
+
+    if (step < max_second_chances &&
+        (comp._used || (ocomp != nullptr && ocomp->_used))) {
+      comp._used = false;
+      if (ocomp != nullptr) {
+        ocomp->_used = false;
+      }
+      ++_evict_entry;
+      continue;
+    }
+
+    // This moves another entry into position i, so the hand stays put.
+    if (nc_state->remove_composition(other, inverted) != 0) {
+      ++num_evicted;
+    }
+  }
+
+  _cache_stats.inc_evicts(num_evicted);
+}
+
 /**
  * This is the private implementation of get_bin_index() and get_draw_order().
  */
@@ -1836,14 +2122,15 @@ init_states() {
   // OK because we guarantee that this method is called at static init time,
   // presumably when there is still only one thread in the world.
   _states_lock = new LightReMutex("RenderState::_states_lock");
-  _cache_stats.init();
+  _states = new States("State lock contention:RenderStates");
+  _cache_stats.init("RenderState");
   nassertv(Thread::get_current_thread() == Thread::get_main_thread());
 
   // Initialize the empty state object as well.  It is used so often that it
   // is declared globally, and lives forever.
   RenderState *state = new RenderState;
   state->local_object();
-  state->_saved_entry = _states.store(state, nullptr);
+  state->_saved_entry = _states->find_shard(state)._states.store(state, nullptr);
   _empty_state = state;
 }
 
@@ -27,9 +27,11 @@
 #include "geomMunger.h"
 #include "weakPointerTo.h"
 #include "lightReMutex.h"
+#include "lightReMutexHolder.h"
 #include "lightMutex.h"
 #include "deletedChain.h"
 #include "simpleHashMap.h"
+#include "stateTable.h"
 #include "cacheStats.h"
 #include "renderAttribRegistry.h"
 
@@ -138,6 +140,7 @@ PUBLISHED:
 
   static int get_num_states();
   static int get_num_unused_states();
+  static int get_num_lock_contentions();
   static int clear_cache();
   static void clear_munger_cache();
   static int garbage_collect();
@@ -210,6 +213,8 @@ private:
 
   void release_new();
   void remove_cache_pointers();
+  int remove_composition(const RenderState *other, bool inverted);
+  static void evict_compositions(int target_size);
 
   void determine_bin_index();
   void determine_cull_callback();
@@ -232,12 +237,13 @@ public:
   mutable UpdateSeq _generated_shader_seq;
 
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // This mutex protects any modification to the cache, which is encoded in
+  // _composition_cache and _invert_composition_cache.  The table of unique
+  // states in _states is divided into shards with their own locks, which
+  // may be acquired while holding this one, but not the other way around.
   static LightReMutex *_states_lock;
-  typedef SimpleHashMap<const RenderState *, std::nullptr_t, indirect_compare_to_hash<const RenderState *> > States;
-  static States _states;
+  typedef StateTable<RenderState, indirect_compare_to_hash<const RenderState *> > States;
+  static States *_states;
   static const RenderState *_empty_state;
 
   // This iterator records the entry corresponding to this RenderState object
@@ -258,6 +264,10 @@ private:
     // _result is reference counted if and only if it is not the same pointer
     // as this.
     const RenderState *_result;
+
+    // Set when this entry is used, and cleared again when the eviction clock
+    // hand passes over it.  See evict_compositions().
+    bool _used;
   };
 
   // The first element of the map is the object we compose with.  This is not
@@ -286,11 +296,14 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
+  // The position of the clock hand of evict_compositions(): a shard of
+  // _states, an entry within that shard, and a cache entry of that state.
+  static size_t _evict_shard;
+  static size_t _evict_index;
+  static size_t _evict_entry;
 
   static PStatCollector _cache_update_pcollector;
+  static PStatCollector _cache_evict_pcollector;
   static PStatCollector _garbage_collect_pcollector;
   static PStatCollector _state_compose_pcollector;
   static PStatCollector _state_invert_pcollector;
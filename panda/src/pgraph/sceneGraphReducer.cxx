@@ -26,6 +26,8 @@
 PStatCollector SceneGraphReducer::_flatten_collector("*:Flatten:flatten");
 PStatCollector SceneGraphReducer::_apply_collector("*:Flatten:apply");
 PStatCollector SceneGraphReducer::_remove_column_collector("*:Flatten:remove column");
+PStatCollector SceneGraphReducer::_quantize_collector("*:Flatten:quantize vertices");
+PStatCollector SceneGraphReducer::_vertex_cache_collector("*:Flatten:optimize vertex cache");
 PStatCollector SceneGraphReducer::_compatible_state_collector("*:Flatten:compatible colors");
 PStatCollector SceneGraphReducer::_collect_collector("*:Flatten:collect");
 PStatCollector SceneGraphReducer::_make_nonindexed_collector("*:Flatten:make nonindexed");
@@ -133,6 +135,79 @@ remove_column(PandaNode *root, const InternalName *column) {
   return count;
 }
 
+/**
+ * Searches for GeomNodes at this level and below whose vertex data stores
+ * normals, texture coordinates, tangents or colors as floating-point values,
+ * and replaces them with the smaller quantized numeric types indicated by
+ * quantize_bits, which is the union of bits from QuantizeVertices.  This
+ * typically makes the vertex data a good deal smaller, both in memory and in
+ * the graphics card, at some loss of precision.
+ *
+ * Note that a .bam file containing quantized vertices can only be written
+ * with bam version 6.46 or later.
+ *
+ * Returns the number of GeomNodes modified.
+ */
+int SceneGraphReducer::
+quantize_vertices(PandaNode *root, int quantize_bits) {
+  nassertr(check_live_flatten(root), 0);
+
+  PStatTimer timer(_quantize_collector);
+  int count = r_quantize_vertices(root, quantize_bits, _transformer);
+  _transformer.finish_apply();
+  return count;
+}
+
+/**
+ * Reorders the triangles of all of the GeomNodes at this level and below, so
+ * that vertices that are shared between triangles are more likely to still be
+ * in the post-transform vertex cache of the graphics card when they are used
+ * again, and that triangles facing outward are drawn first, to reduce
+ * overdraw.  See GeomPrimitive::optimize_vertex_cache().  optimize_bits is
+ * the union of bits from OptimizeVertexCache.
+ *
+ * Only indexed triangles are reordered; it is best to call this after
+ * unify(), and after collect_vertex_data(), so that the vertices can be
+ * reordered across all of the Geoms that share them.
+ *
+ * cache_size is the number of vertices assumed to fit in the cache; if it is
+ * 0, the value of the vertex-cache-size config variable is used.  The effect
+ * can be measured with calc_acmr().
+ *
+ * Returns the number of GeomNodes in which triangles were reordered.
+ */
+int SceneGraphReducer::
+optimize_vertex_cache(PandaNode *root, int optimize_bits, int cache_size) {
+  nassertr(check_live_flatten(root), 0);
+
+  PStatTimer timer(_vertex_cache_collector);
+  int count = r_optimize_vertex_cache(root, optimize_bits, cache_size, _transformer);
+  _transformer.finish_apply();
+  return count;
+}
+
+/**
+ * Returns the average cache miss ratio of all of the triangles at this level
+ * and below: the average number of vertices that need to be transformed for
+ * each triangle drawn, given a FIFO vertex cache of the indicated size.  See
+ * GeomPrimitive::calc_acmr().  Returns 0 if there are no triangles.
+ */
+PN_stdfloat SceneGraphReducer::
+calc_acmr(PandaNode *root, int cache_size) {
+  if (cache_size <= 0) {
+    cache_size = vertex_cache_size;
+  }
+
+  int num_misses = 0;
+  int num_faces = 0;
+  r_calc_acmr(root, cache_size, num_misses, num_faces);
+
+  if (num_faces == 0) {
+    return 0.0f;
+  }
+  return (PN_stdfloat)num_misses / (PN_stdfloat)num_faces;
+}
+
 /**
  * Searches for GeomNodes that contain multiple Geoms that differ only in
  * their ColorAttribs.  If such a GeomNode is found, then all the colors are
@@ -771,6 +846,84 @@ r_remove_column(PandaNode *node, const InternalName *column,
   return num_changed;
 }
 
+/**
+ * The recursive implementation of quantize_vertices().
+ */
+int SceneGraphReducer::
+r_quantize_vertices(PandaNode *node, int quantize_bits,
+                    GeomTransformer &transformer) {
+  int num_changed = 0;
+
+  if (node->is_geom_node()) {
+    if (transformer.quantize_vertices(DCAST(GeomNode, node), quantize_bits)) {
+      ++num_changed;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_changed +=
+      r_quantize_vertices(children.get_child(i), quantize_bits, transformer);
+  }
+
+  return num_changed;
+}
+
+/**
+ * The recursive implementation of optimize_vertex_cache().
+ */
+int SceneGraphReducer::
+r_optimize_vertex_cache(PandaNode *node, int optimize_bits, int cache_size,
+                        GeomTransformer &transformer) {
+  int num_changed = 0;
+
+  if (node->is_geom_node()) {
+    if (transformer.optimize_vertex_cache(DCAST(GeomNode, node),
+                                          optimize_bits, cache_size)) {
+      ++num_changed;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_changed +=
+      r_optimize_vertex_cache(children.get_child(i), optimize_bits,
+                              cache_size, transformer);
+  }
+
+  return num_changed;
+}
+
+/**
+ * The recursive implementation of calc_acmr().
+ */
+void SceneGraphReducer::
+r_calc_acmr(PandaNode *node, int cache_size, int &num_misses, int &num_faces) {
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int gi = 0; gi < num_geoms; ++gi) {
+      const Geom *geom = geom_node->get_geom(gi);
+      int num_primitives = geom->get_num_primitives();
+      for (int pi = 0; pi < num_primitives; ++pi) {
+        const GeomPrimitive *prim = geom->get_primitive(pi);
+        if (prim->get_primitive_type() == GeomPrimitive::PT_polygons) {
+          num_misses += prim->calc_vertex_cache_misses(cache_size);
+          num_faces += prim->get_num_faces();
+        }
+      }
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_calc_acmr(children.get_child(i), cache_size, num_misses, num_faces);
+  }
+}
+
 /**
  * The recursive implementation of make_compatible_state().
  */
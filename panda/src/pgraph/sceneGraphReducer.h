@@ -113,6 +113,37 @@ PUBLISHED:
     MN_avoid_dynamic   = 0x004,
   };
 
+  enum QuantizeVertices {
+    // If set, normals are stored as octahedron-encoded unit vectors in 32
+    // bits, instead of in three floats.
+    QV_normal          = 0x001,
+
+    // If set, texture coordinates are stored as half-precision floats.
+    QV_texcoord        = 0x002,
+
+    // If set, tangents and binormals are stored as three signed normalized
+    // 10-bit values in 32 bits.
+    QV_tangent         = 0x004,
+
+    // If set, floating-point colors are stored as 8-bit values.
+    QV_color           = 0x008,
+
+    // If set, any GeomVertexData with an animation type other than AT_none
+    // will not be quantized.
+    QV_avoid_animated  = 0x010,
+  };
+
+  enum OptimizeVertexCache {
+    // If set, the vertices are also reordered in the order in which they are
+    // first used by the triangles, so that they are fetched sequentially.
+    // Unused vertices are removed.
+    OVC_vertices       = 0x001,
+
+    // If set, any Geom or GeomVertexData with a usage_hint other than
+    // UH_static will not be optimized.
+    OVC_avoid_dynamic  = 0x002,
+  };
+
   void set_gsg(GraphicsStateGuardianBase *gsg);
   void clear_gsg();
   INLINE GraphicsStateGuardianBase *get_gsg() const;
@@ -127,6 +158,10 @@ PUBLISHED:
   int flatten(PandaNode *root, int combine_siblings_bits);
 
   int remove_column(PandaNode *root, const InternalName *column);
+  int quantize_vertices(PandaNode *root, int quantize_bits = ~0);
+  int optimize_vertex_cache(PandaNode *root, int optimize_bits = ~0,
+                            int cache_size = 0);
+  PN_stdfloat calc_acmr(PandaNode *root, int cache_size = 0);
 
   int make_compatible_state(PandaNode *root);
 
@@ -168,6 +203,12 @@ protected:
 
   int r_remove_column(PandaNode *node, const InternalName *column,
                       GeomTransformer &transformer);
+  int r_quantize_vertices(PandaNode *node, int quantize_bits,
+                          GeomTransformer &transformer);
+  int r_optimize_vertex_cache(PandaNode *node, int optimize_bits,
+                              int cache_size, GeomTransformer &transformer);
+  void r_calc_acmr(PandaNode *node, int cache_size,
+                   int &num_misses, int &num_faces);
 
   int r_make_compatible_state(PandaNode *node, GeomTransformer &transformer);
 
@@ -188,6 +229,8 @@ private:
   static PStatCollector _flatten_collector;
   static PStatCollector _apply_collector;
   static PStatCollector _remove_column_collector;
+  static PStatCollector _quantize_collector;
+  static PStatCollector _vertex_cache_collector;
   static PStatCollector _compatible_state_collector;
   static PStatCollector _collect_collector;
   static PStatCollector _make_nonindexed_collector;
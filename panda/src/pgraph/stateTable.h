@@ -0,0 +1,87 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file stateTable.h
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#ifndef STATETABLE_H
+#define STATETABLE_H
+
+#include "pandabase.h"
+#include "simpleHashMap.h"
+#include "lightReMutex.h"
+#include "pStatCollector.h"
+#include "atomicAdjust.h"
+#include "pvector.h"
+
+/**
+ * The global table of unique states, used by RenderState and TransformState
+ * to share a common pointer among all equivalent state objects.
+ *
+ * So that threads creating unrelated states need not wait for each other,
+ * the table is split into a number of shards, chosen by the hash of the
+ * state, each protected by its own lock.  A shard lock protects only the
+ * contents of its shard; the composition caches are still protected by the
+ * _states_lock of the owning class.  A thread that needs both must acquire
+ * the _states_lock first.
+ */
+template<class State, class Compare>
+class StateTable {
+public:
+  typedef SimpleHashMap<const State *, std::nullptr_t, Compare> States;
+
+  enum { num_shards = 16 };
+
+  class Shard {
+  public:
+    INLINE Shard();
+
+    LightReMutex _lock;
+    States _states;
+
+    // This keeps track of our current position through the garbage
+    // collection cycle.
+    size_t _garbage_index;
+  };
+
+  // Holds the lock of a shard for the lifetime of the object, and counts the
+  // occasions on which some other thread already held it.
+  class ShardHolder {
+  public:
+    INLINE ShardHolder(StateTable<State, Compare> *table, Shard &shard);
+    INLINE ~ShardHolder();
+
+  private:
+    Shard &_shard;
+  };
+
+  INLINE explicit StateTable(const char *contention_name);
+  StateTable(const StateTable &copy) = delete;
+
+  INLINE Shard &get_shard(size_t n);
+  INLINE Shard &find_shard(const State *state);
+
+  INLINE size_t get_num_entries();
+  INLINE void get_states(pvector<const State *> &states);
+
+  INLINE void record_contention();
+  INLINE AtomicAdjust::Integer get_num_contentions() const;
+  INLINE void flush_contention_level();
+
+private:
+  Shard _shards[num_shards];
+
+  AtomicAdjust::Integer _num_contentions;
+  PStatCollector _contention_pcollector;
+};
+
+#include "stateTable.I"
+
+#endif
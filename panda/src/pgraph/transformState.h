@@ -30,6 +30,7 @@
 #include "config_pgraph.h"
 #include "deletedChain.h"
 #include "simpleHashMap.h"
+#include "stateTable.h"
 #include "cacheStats.h"
 #include "extension.h"
 
@@ -202,6 +203,7 @@ PUBLISHED:
 
   static int get_num_states();
   static int get_num_unused_states();
+  static int get_num_lock_contentions();
   static int clear_cache();
   static int garbage_collect();
   static void list_cycles(std::ostream &out);
@@ -253,14 +255,17 @@ private:
 
   void release_new();
   void remove_cache_pointers();
+  int remove_composition(const TransformState *other, bool inverted);
+  static void evict_compositions(int target_size);
 
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // This mutex protects any modification to the cache, which is encoded in
+  // _composition_cache and _invert_composition_cache.  The table of unique
+  // states in _states is divided into shards with their own locks, which
+  // may be acquired while holding this one, but not the other way around.
   static LightReMutex *_states_lock;
-  typedef SimpleHashMap<const TransformState *, std::nullptr_t, indirect_equals_hash<const TransformState *> > States;
-  static States _states;
+  typedef StateTable<TransformState, indirect_equals_hash<const TransformState *> > States;
+  static States *_states;
   static CPT(TransformState) _identity_state;
   static CPT(TransformState) _invalid_state;
 
@@ -287,6 +292,10 @@ private:
     // _result is reference counted if and only if it is not the same pointer
     // as this.
     const TransformState *_result;
+
+    // Set when this entry is used, and cleared again when the eviction clock
+    // hand passes over it.  See evict_compositions().
+    bool _used;
   };
 
   typedef SimpleHashMap<const TransformState *, Composition, pointer_hash> CompositionCache;
@@ -297,13 +306,16 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
+  // The position of the clock hand of evict_compositions(): a shard of
+  // _states, an entry within that shard, and a cache entry of that state.
+  static size_t _evict_shard;
+  static size_t _evict_index;
+  static size_t _evict_entry;
 
   static bool _uniquify_matrix;
 
   static PStatCollector _cache_update_pcollector;
+  static PStatCollector _cache_evict_pcollector;
   static PStatCollector _garbage_collect_pcollector;
   static PStatCollector _transform_compose_pcollector;
   static PStatCollector _transform_invert_pcollector;
@@ -134,13 +134,15 @@ get_states() {
   extern struct Dtool_PyTypedObject Dtool_TransformState;
   LightReMutexHolder holder(*TransformState::_states_lock);
 
-  size_t num_states = TransformState::_states.get_num_entries();
+  pvector<const TransformState *> states;
+  TransformState::_states->get_states(states);
+
+  size_t num_states = states.size();
   PyObject *list = PyList_New(num_states);
   size_t i = 0;
 
-  size_t size = TransformState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const TransformState *state = TransformState::_states.get_key(si);
+  for (size_t si = 0; si < num_states; ++si) {
+    const TransformState *state = states[si];
     state->ref();
     PyObject *a =
       DTool_CreatePyInstanceTyped((void *)state, Dtool_TransformState,
@@ -162,10 +164,11 @@ get_unused_states() {
   extern struct Dtool_PyTypedObject Dtool_TransformState;
   LightReMutexHolder holder(*TransformState::_states_lock);
 
+  pvector<const TransformState *> states;
+  TransformState::_states->get_states(states);
+
   PyObject *list = PyList_New(0);
-  size_t size = TransformState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const TransformState *state = TransformState::_states.get_key(si);
+  for (const TransformState *state : states) {
     if (state->get_cache_ref_count() == state->get_ref_count()) {
       state->ref();
       PyObject *a =
@@ -104,6 +104,7 @@ static TimeCollectorProperties time_properties[] = {
   { 1, "Wait:Flip",                        { 1.0, 0.6, 0.3 } },
   { 1, "Wait:Flip:Begin",                  { 0.3, 0.3, 0.9 } },
   { 1, "Wait:Flip:End",                    { 0.9, 0.3, 0.6 } },
+  { 1, "Wait:Idle",                        { 0.7, 0.7, 0.4 } },
   { 1, "App",                              { 0.0, 0.4, 0.8 },  1.0 / 30.0 },
   { 1, "App:Collisions",                   { 1.0, 0.5, 0.0 } },
   { 1, "App:Collisions:Reset",             { 0.0, 0.0, 0.5 } },
@@ -162,6 +163,16 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Geom cache operations:record",     { 0.2, 0.4, 0.8 } },
   { 1, "Geom cache operations:erase",      { 0.4, 0.8, 0.2 } },
   { 1, "Geom cache operations:evict",      { 0.8, 0.2, 0.4 } },
+  { 1, "RenderState cache size",           { 0.5, 0.5, 1.0 },  "", 5000 },
+  { 1, "RenderState cache operations",     { 0.7, 0.7, 1.0 },  "", 500 },
+  { 1, "RenderState cache operations:hit", { 0.2, 0.8, 0.4 } },
+  { 1, "RenderState cache operations:miss",{ 0.9, 0.6, 0.2 } },
+  { 1, "RenderState cache operations:evict",{ 0.8, 0.2, 0.4 } },
+  { 1, "TransformState cache size",        { 1.0, 0.5, 0.5 },  "", 5000 },
+  { 1, "TransformState cache operations",  { 1.0, 0.7, 0.7 },  "", 500 },
+  { 1, "TransformState cache operations:hit", { 0.2, 0.8, 0.4 } },
+  { 1, "TransformState cache operations:miss",{ 0.9, 0.6, 0.2 } },
+  { 1, "TransformState cache operations:evict",{ 0.8, 0.2, 0.4 } },
   { 1, "Data transferred",                 { 0.0, 0.2, 0.4 },  "MB", 12, 1048576 },
   { 1, "Primitive batches",                { 0.2, 0.5, 0.9 },  "", 500 },
   { 1, "Primitive batches:Other",          { 0.2, 0.2, 0.2 } },
@@ -182,6 +193,8 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Nodes",                            { 0.4, 0.2, 0.8 },  "", 500.0 },
   { 1, "Nodes:GeomNodes",                  { 0.8, 0.2, 0.0 } },
   { 1, "Geoms",                            { 0.4, 0.8, 0.3 },  "", 500.0 },
+  { 1, "Meshlets",                         { 0.3, 0.6, 0.8 },  "", 5000.0 },
+  { 1, "Meshlets:Culled",                  { 0.8, 0.4, 0.3 } },
   { 1, "Cull volumes",                     { 0.7, 0.6, 0.9 },  "", 500.0 },
   { 1, "Cull volumes:Transforms",          { 0.9, 0.6, 0.0 } },
   { 1, "State changes",                    { 1.0, 0.5, 0.2 },  "", 500.0 },
@@ -207,6 +220,9 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Vertex Data:Disk",                 { 0.6, 0.9, 0.1 } },
   { 1, "Vertex Data:Disk:Unused",          { 0.8, 0.4, 0.5 } },
   { 1, "Vertex Data:Disk:Used",            { 0.2, 0.1, 0.6 } },
+  { 1, "Vertex Data throughput",           { 0.4, 0.6, 1.0 },  "MB", 16, 1048576 },
+  { 1, "Vertex Data throughput:Compress",  { 0.8, 0.3, 0.2 } },
+  { 1, "Vertex Data throughput:Decompress",{ 0.2, 0.7, 0.3 } },
   { 1, "TransformStates",                  { 1.0, 0.5, 0.5 },  "", 5000 },
   { 1, "TransformStates:On nodes",         { 0.2, 0.8, 1.0 } },
   { 1, "TransformStates:Cached",           { 1.0, 0.0, 0.2 } },
@@ -219,6 +235,7 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Dirty PipelineCyclers",            { 0.2, 0.2, 0.2 },  "", 5000 },
   { 1, "Collision Volumes",                { 1.0, 0.8, 0.5 },  "", 500 },
   { 1, "Collision Tests",                  { 0.5, 0.8, 1.0 },  "", 100 },
+  { 1, "Task steals",                      { 0.9, 0.5, 0.1 },  "", 100 },
   { 1, "Command latency",                  { 0.8, 0.2, 0.0 },  "ms", 10, 1.0 / 1000.0 },
   { 0, nullptr }
 };
@@ -59,6 +59,11 @@ PUBLISHED:
     // May appear at any level and indicates the following datagram contains
     // auxiliary file data that may be referenced by a later object.
     BOC_file_data,
+
+    // Like BOC_file_data, but the following datagram is a block of raw data
+    // that a later object will read directly from memory.  The datagram
+    // containing this code is padded so that the data is aligned in the file.
+    BOC_payload,
   };
 
   // This enum is used to control how textures are written to a bam stream.
@@ -685,6 +685,24 @@ read_file_data(SubfileInfo &info) {
   _file_data_records.pop_front();
 }
 
+/**
+ * Reads a block of raw data that was written by a matching call to
+ * BamWriter::write_payload().  If the bam file is memory-mapped, the returned
+ * FileData is a view into the file, and the data is never copied; it remains
+ * valid for as long as the FileData is held.
+ *
+ * Returns NULL if there is no such block.
+ */
+CPT(FileData) BamReader::
+read_payload() {
+  // As with read_file_data(), the payload has been read from the stream
+  // already, before this object's datagram.
+  nassertr(!_payload_records.empty(), nullptr);
+  CPT(FileData) data = std::move(_payload_records.front());
+  _payload_records.pop_front();
+  return data;
+}
+
 /**
  * Reads in the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
@@ -1111,6 +1129,21 @@ p_read_object() {
 
     return p_read_object();
 
+  case BOC_payload:
+    // Similar to the above, except that we grab the data now.  It may just be
+    // a pointer into a memory-mapped file, so this doesn't cost anything.
+    {
+      CPT(FileData) data = _source->get_datagram_data();
+      if (data == nullptr) {
+        bam_cat.error()
+          << "Failed to read payload.\n";
+        return 0;
+      }
+      _payload_records.push_back(std::move(data));
+    }
+
+    return p_read_object();
+
   default:
     bam_cat.error()
       << "Encountered invalid BamObjectCode 0x" << std::hex << (int)boc << std::dec << ".\n";
@@ -1292,6 +1325,15 @@ p_read_object() {
         << "End of datagram reached while reading bam object "
         << type << ": " << (void *)created_obj._ptr << "\n";
     }
+
+    // Any payloads that the object didn't read were meant for it, not for
+    // the next object, so drop them now.
+    if (!_payload_records.empty()) {
+      bam_cat.warning()
+        << "Discarding " << _payload_records.size()
+        << " unread payload(s) for bam object " << type << "\n";
+      _payload_records.clear();
+    }
   }
 
   return object_id;
@@ -167,6 +167,7 @@ public:
   void skip_pointer(DatagramIterator &scan);
 
   void read_file_data(SubfileInfo &info);
+  CPT(FileData) read_payload();
 
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler);
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler,
@@ -321,6 +322,11 @@ private:
   typedef pdeque<SubfileInfo> FileDataRecords;
   FileDataRecords _file_data_records;
 
+  // Similarly, the queue of payload blocks, which are read into memory (or
+  // viewed from the memory-mapped file) as they are encountered.
+  typedef pdeque<CPT(FileData)> PayloadRecords;
+  PayloadRecords _payload_records;
+
   // This is used internally to record all of the new types created on-the-fly
   // to satisfy bam requirements.  We keep track of this just so we can
   // suppress warning messages from attempts to create objects of these types.
@@ -415,6 +415,62 @@ write_file_data(SubfileInfo &result, const SubfileInfo &source) {
   // order and queued up in the BamReader.
 }
 
+/**
+ * Returns true if a block of the indicated size should be written with
+ * write_payload(), rather than being added directly to the object's datagram.
+ * This is the case for large blocks, if the bam version supports it.
+ */
+bool BamWriter::
+should_write_payload(size_t size) const {
+  if (_file_major < 6 || (_file_major == 6 && _file_minor < 47)) {
+    return false;
+  }
+  int min_size = bam_payload_min_size;
+  return min_size >= 0 && size != 0 && size >= (size_t)min_size;
+}
+
+/**
+ * Writes a block of raw data as a payload record.  The data is written in its
+ * own datagram, aligned within the file according to bam-payload-alignment,
+ * so that the BamReader may be able to hand it back directly from a memory-
+ * mapped file, without copying it.  This must be balanced by a matching call
+ * to read_payload() on restore.
+ */
+void BamWriter::
+write_payload(const unsigned char *data, size_t size) {
+  nassertv(_file_major > 6 || (_file_major == 6 && _file_minor >= 47));
+
+  // We precede the payload with a datagram that contains the BOC_payload
+  // token, padded so that the payload itself begins on an aligned boundary.
+  Datagram dg;
+  dg.add_uint8(BOC_payload);
+
+  std::streampos pos = _target->get_file_pos();
+  size_t alignment = (size_t)std::max((int)bam_payload_alignment, 1);
+  if (pos > 0 && alignment > 1) {
+    // Account for the length prefix of both datagrams, and the token itself.
+    size_t length_size = (size >= (uint32_t)-1) ? 12 : 4;
+    uint64_t start = (uint64_t)pos + 4 + 1 + length_size;
+    dg.pad_bytes((size_t)((alignment - start % alignment) % alignment));
+  }
+
+  if (!_target->put_datagram(dg)) {
+    util_cat.error()
+      << "Unable to write data to output.\n";
+    return;
+  }
+
+  Datagram payload(data, size);
+  if (!_target->put_datagram(payload)) {
+    util_cat.error()
+      << "Unable to write payload to output.\n";
+    return;
+  }
+
+  // As with write_file_data(), these precede the datagram that represents
+  // this particular object in the stream.
+}
+
 /**
  * Writes out the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
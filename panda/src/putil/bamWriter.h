@@ -105,6 +105,9 @@ public:
   void write_file_data(SubfileInfo &result, const Filename &filename);
   void write_file_data(SubfileInfo &result, const SubfileInfo &source);
 
+  bool should_write_payload(size_t size) const;
+  void write_payload(const unsigned char *data, size_t size);
+
   void write_cdata(Datagram &packet, const PipelineCyclerBase &cycler);
   void write_cdata(Datagram &packet, const PipelineCyclerBase &cycler,
                    void *extra_data);
@@ -89,6 +89,22 @@ ConfigVariableEnum<BamEnums::BamTextureMode> bam_texture_mode
  PRC_DESC("Set this to specify how textures should be written into Bam files."
           "See the panda source or documentation for available options."));
 
+ConfigVariableInt bam_payload_min_size
+("bam-payload-min-size", 16384,
+ PRC_DESC("When writing .bam files of version 6.47 or later, vertex arrays and "
+          "texture images of at least this many bytes are written as separate "
+          "payload records, aligned within the file, so that they may be "
+          "used directly from a memory-mapped file when the .bam file is "
+          "loaded, without being copied.  Set this to 0 to write all of "
+          "them this way, or to -1 to disable it."));
+
+ConfigVariableInt bam_payload_alignment
+("bam-payload-alignment", 4096,
+ PRC_DESC("The boundary, in bytes, on which payload records are aligned "
+          "within a .bam file; see bam-payload-min-size.  This should be a "
+          "multiple of the page size, so that each payload starts on a fresh "
+          "page of the file."));
+
 ConfigureFn(config_putil) {
   init_libputil();
 }
@@ -18,6 +18,8 @@
 #include "config_putil.h"
 #include "config_express.h"
 #include "virtualFileSystem.h"
+#include "virtualFileSimple.h"
+#include "dcast.h"
 #include "streamReader.h"
 #include "thread.h"
 
@@ -45,7 +47,21 @@ open(const FileReference *file) {
     return false;
   }
   _timestamp = _vfile->get_timestamp();
-  _in = _vfile->open_read_file(true);
+
+  // If the file is stored uncompressed on disk, read the datagrams straight
+  // out of a memory mapping of it.  This saves copying everything through the
+  // stream buffers.  Any other file is streamed as usual, rather than read
+  // into memory in its entirety first.
+  if (is_mappable()) {
+    CPT(FileData) data = _vfile->read_file_data(true);
+    if (data != nullptr && data->is_mapped()) {
+      _data = std::move(data);
+      _in = _data->open_read();
+    }
+  }
+  if (_in == nullptr) {
+    _in = _vfile->open_read_file(true);
+  }
   _owns_in = (_in != nullptr);
   return _owns_in && !_in->fail();
 }
@@ -71,6 +87,30 @@ open(std::istream &in, const Filename &filename) {
   return !_in->fail();
 }
 
+/**
+ * Returns true if the open file can be mapped into memory, which is the case
+ * if it is stored uncompressed in a file on disk, and need not be
+ * decompressed while it is read.
+ */
+bool DatagramInputFile::
+is_mappable() const {
+  if (!VirtualFileSystem::get_global_ptr()->vfs_mmap) {
+    return false;
+  }
+
+  if (_vfile->is_of_type(VirtualFileSimple::get_class_type()) &&
+      DCAST(VirtualFileSimple, _vfile)->is_implicit_pz_file()) {
+    return false;
+  }
+  std::string extension = _vfile->get_filename().get_extension();
+  if (extension == "pz" || extension == "gz") {
+    return false;
+  }
+
+  SubfileInfo info;
+  return _vfile->get_system_info(info) && !info.get_filename().empty();
+}
+
 /**
  * Closes the file.  This is also implicitly done when the DatagramInputFile
  * destructs.
@@ -78,6 +118,7 @@ open(std::istream &in, const Filename &filename) {
 void DatagramInputFile::
 close() {
   _vfile.clear();
+  _data.clear();
   if (_owns_in) {
     VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
     vfs->close_read_file(_in);
@@ -293,6 +334,51 @@ save_datagram(SubfileInfo &info) {
   return true;
 }
 
+/**
+ * Reads the next datagram and returns its contents as a FileData.  If the
+ * file was opened from disk, this is a view into the file contents, which is
+ * mapped into memory if possible, so the datagram is not copied.
+ *
+ * Returns NULL on failure.
+ */
+CPT(FileData) DatagramInputFile::
+get_datagram_data() {
+  if (_data == nullptr) {
+    // We're reading from an arbitrary stream; we have to copy it.
+    return DatagramGenerator::get_datagram_data();
+  }
+
+  nassertr(_in != nullptr, nullptr);
+  _read_first_datagram = true;
+
+  // First, get the size of the upcoming datagram.
+  StreamReader reader(_in, false);
+  uint64_t num_bytes = reader.get_uint32();
+  if (_in->fail()) {
+    return nullptr;
+  }
+  if (num_bytes == (uint32_t)-1) {
+    // Another special case for a value larger than 32 bits.
+    num_bytes = reader.get_uint64();
+    if (_in->fail()) {
+      _error = true;
+      return nullptr;
+    }
+  }
+
+  // The stream reads directly from _data, so its position is also the offset
+  // into the data.
+  streampos pos = _in->tellg();
+  if (pos < 0 || (uint64_t)pos > _data->get_size() ||
+      num_bytes > _data->get_size() - (uint64_t)pos) {
+    _error = true;
+    return nullptr;
+  }
+
+  _in->seekg((streamsize)num_bytes, std::ios::cur);
+  return new FileData(_data, (size_t)pos, (size_t)num_bytes);
+}
+
 /**
  * Returns true if the file has reached the end-of-file.  This test may only
  * be made after a call to read_header() or get_datagram() has failed.
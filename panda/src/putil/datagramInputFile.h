@@ -40,6 +40,7 @@ PUBLISHED:
   bool read_header(std::string &header, size_t num_bytes);
   virtual bool get_datagram(Datagram &data);
   virtual bool save_datagram(SubfileInfo &info);
+  virtual CPT(FileData) get_datagram_data();
   virtual bool is_eof();
   virtual bool is_error();
 
@@ -50,10 +51,13 @@ PUBLISHED:
   virtual std::streampos get_file_pos();
 
 private:
+  bool is_mappable() const;
+
   bool _read_first_datagram;
   bool _error;
   CPT(FileReference) _file;
   PT(VirtualFile) _vfile;
+  CPT(FileData) _data;
   std::istream *_in;
   bool _owns_in;
   Filename _filename;
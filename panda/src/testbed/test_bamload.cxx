@@ -0,0 +1,201 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_bamload.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "bamFile.h"
+#include "bamWriter.h"
+#include "loader.h"
+#include "loaderOptions.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomVertexData.h"
+#include "geomVertexWriter.h"
+#include "geomTriangles.h"
+#include "texture.h"
+#include "textureAttrib.h"
+#include "load_prc_file.h"
+#include "clockObject.h"
+#include "filename.h"
+
+using std::cerr;
+
+// Compares the time it takes to load a scene from a .bam file written in the
+// default format with the time it takes to load the same scene from a .bam
+// file written with payload records (bam-version 6 47), which allows the
+// vertex data to be used directly from the memory-mapped file.
+//
+// Usage: test_bamload [model]
+//
+// If no model is given, a scene with a few large meshes and a large texture is made
+// up for the purpose.
+
+static const int num_reps = 10;
+
+/**
+ * Makes up a scene with num_geoms meshes of num_rows vertices each, and one
+ * texture of tex_size x tex_size.
+ */
+static PT(PandaNode)
+make_scene(int num_geoms, int num_rows, int tex_size) {
+  PT(GeomNode) node = new GeomNode("scene");
+
+  PT(Texture) tex = new Texture("tex");
+  tex->setup_2d_texture(tex_size, tex_size, Texture::T_unsigned_byte, Texture::F_rgba);
+  PTA_uchar image = tex->modify_ram_image();
+  for (size_t i = 0; i < image.size(); ++i) {
+    image[i] = (unsigned char)i;
+  }
+  CPT(RenderState) state = RenderState::make(TextureAttrib::make(tex));
+
+  for (int g = 0; g < num_geoms; ++g) {
+    PT(GeomVertexData) vdata = new GeomVertexData
+      ("vdata", GeomVertexFormat::get_v3n3t2(), Geom::UH_static);
+    vdata->unclean_set_num_rows(num_rows);
+
+    GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+    GeomVertexWriter normal(vdata, InternalName::get_normal());
+    GeomVertexWriter texcoord(vdata, InternalName::get_texcoord());
+    for (int i = 0; i < num_rows; ++i) {
+      vertex.set_data3(i, g, i % 7);
+      normal.set_data3(0, 0, 1);
+      texcoord.set_data2(i % 2, (i / 2) % 2);
+    }
+
+    PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+    for (int i = 0; i + 2 < num_rows; i += 3) {
+      tris->add_vertices(i, i + 1, i + 2);
+    }
+
+    PT(Geom) geom = new Geom(vdata);
+    geom->add_primitive(tris);
+    node->add_geom(geom, state);
+  }
+
+  return node;
+}
+
+/**
+ * Writes the node to the indicated file, in the indicated bam version.
+ */
+static bool
+write_bam(const Filename &filename, PandaNode *node, const char *version) {
+  load_prc_file_data("", std::string("bam-version ") + version);
+
+  BamFile bam;
+  if (!bam.open_write(filename)) {
+    return false;
+  }
+  bam.get_writer()->set_file_texture_mode(BamWriter::BTM_rawdata);
+  bool okflag = bam.write_object(node);
+  bam.close();
+  return okflag;
+}
+
+/**
+ * Reads every byte of vertex data in the scene, so that any pages that were
+ * mapped in lazily are counted, and returns a checksum.
+ */
+static unsigned int
+touch_scene(PandaNode *node) {
+  unsigned int sum = 0;
+  if (node->is_geom_node()) {
+    GeomNode *gnode = (GeomNode *)node;
+    for (int i = 0; i < gnode->get_num_geoms(); ++i) {
+      const Geom *geom = gnode->get_geom(i);
+      const GeomVertexData *vdata = geom->get_vertex_data();
+      for (size_t a = 0; a < vdata->get_num_arrays(); ++a) {
+        CPT(GeomVertexArrayDataHandle) handle = vdata->get_array(a)->get_handle();
+        const unsigned char *ptr = handle->get_read_pointer(true);
+        size_t size = handle->get_data_size_bytes();
+        for (size_t j = 0; j < size; j += 61) {
+          sum += ptr[j];
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < node->get_num_children(); ++i) {
+    sum += touch_scene(node->get_child(i));
+  }
+  return sum;
+}
+
+/**
+ * Loads the indicated bam file num_reps times, and reports the average time
+ * to read it, and to read it and then touch all of its vertices.
+ */
+static void
+time_load(const Filename &filename, const char *description) {
+  ClockObject *clock = ClockObject::get_global_clock();
+
+  double load_time = 0.0;
+  double touch_time = 0.0;
+  unsigned int sum = 0;
+  for (int r = 0; r < num_reps; ++r) {
+    double start = clock->get_real_time();
+    BamFile bam;
+    if (!bam.open_read(filename)) {
+      cerr << "Couldn't read " << filename << "\n";
+      return;
+    }
+    PT(PandaNode) node = bam.read_node();
+    bam.close();
+    double loaded = clock->get_real_time();
+    sum += touch_scene(node);
+    double touched = clock->get_real_time();
+
+    load_time += loaded - start;
+    touch_time += touched - start;
+  }
+
+  cerr << description << ": load " << load_time * 1000.0 / num_reps
+       << " ms, load and touch " << touch_time * 1000.0 / num_reps
+       << " ms (" << filename.get_file_size() << " bytes, checksum "
+       << sum << ")\n";
+}
+
+int
+main(int argc, char *argv[]) {
+  PT(PandaNode) scene;
+  if (argc > 1) {
+    Loader loader;
+    LoaderOptions options(LoaderOptions::LF_search | LoaderOptions::LF_no_cache);
+    scene = loader.load_sync(Filename::from_os_specific(argv[1]), options);
+    if (scene == nullptr) {
+      cerr << "Couldn't load " << argv[1] << "\n";
+      return 1;
+    }
+  } else {
+    scene = make_scene(32, 65536, 2048);
+  }
+
+  Filename plain_filename = Filename::temporary("", "bamload_", ".bam");
+  Filename payload_filename = Filename::temporary("", "bamload_", ".bam");
+
+  if (!write_bam(plain_filename, scene, "6 44") ||
+      !write_bam(payload_filename, scene, "6 47")) {
+    cerr << "Couldn't write bam files.\n";
+    return 1;
+  }
+  scene.clear();
+
+  // Do it twice, so that the second round has a warm disk cache.
+  for (int i = 0; i < 2; ++i) {
+    time_load(plain_filename, "bam 6.44");
+    time_load(payload_filename, "bam 6.47 with payloads");
+  }
+
+  plain_filename.unlink();
+  payload_filename.unlink();
+  return 0;
+}
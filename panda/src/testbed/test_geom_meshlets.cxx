@@ -0,0 +1,232 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_geom_meshlets.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "geom.h"
+#include "geomMeshlets.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "orthographicLens.h"
+#include "boundingHexahedron.h"
+#include "pset.h"
+
+// GeomMeshlets::cull() is only called by the cull traversal, which can't be
+// run from Python without a graphics context, so it is tested here.
+
+using std::cerr;
+
+static int num_failures = 0;
+
+#define CHECK(condition) \
+  if (!(condition)) { \
+    cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+    ++num_failures; \
+  }
+
+static const int grid_size = 32;
+
+typedef pset<std::pair<int, std::pair<int, int> > > Triangles;
+
+/**
+ * Returns a flat grid of triangles facing up, divided into meshlets.
+ */
+static PT(Geom)
+make_grid() {
+  PT(GeomVertexData) vdata = new GeomVertexData("grid", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  for (int y = 0; y <= grid_size; ++y) {
+    for (int x = 0; x <= grid_size; ++x) {
+      vertex.add_data3(x, y, 0);
+    }
+  }
+
+  PT(GeomTriangles) prim = new GeomTriangles(Geom::UH_static);
+  for (int y = 0; y < grid_size; ++y) {
+    for (int x = 0; x < grid_size; ++x) {
+      int a = y * (grid_size + 1) + x;
+      int b = a + 1;
+      int c = a + grid_size + 1;
+      int d = c + 1;
+      prim->add_vertices(a, b, d);
+      prim->add_vertices(a, d, c);
+    }
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(prim);
+  geom->optimize_vertex_cache_in_place();
+  CHECK(geom->make_meshlets(32, 32));
+  return geom;
+}
+
+/**
+ * Returns the set of triangles drawn by the Geom.
+ */
+static Triangles
+get_triangles(const Geom *geom) {
+  Triangles triangles;
+  CPT(GeomPrimitive) prim = geom->get_primitive(0);
+  for (int i = 0; i < prim->get_num_vertices(); i += 3) {
+    triangles.insert(std::make_pair(prim->get_vertex(i),
+      std::make_pair(prim->get_vertex(i + 1), prim->get_vertex(i + 2))));
+  }
+  return triangles;
+}
+
+/**
+ * Returns a box around x in [x0, x0 + 16] and y in [y0, y0 + 16].
+ */
+static PT(GeometricBoundingVolume)
+make_frustum(PN_stdfloat x0, PN_stdfloat y0) {
+  // An orthographic lens looks down the y axis.
+  PT(OrthographicLens) lens = new OrthographicLens;
+  lens->set_film_size(16, 4);
+  lens->set_near_far(0.001, 16);
+  PT(BoundingVolume) bounds = lens->make_bounds();
+  PT(GeometricBoundingVolume) frustum = bounds->as_geometric_bounding_volume();
+  frustum->xform(LMatrix4::translate_mat(x0 + 8, y0, 0));
+  return frustum;
+}
+
+/**
+ * Checks that the subset of the grid contains all of the triangles in the
+ * indicated box, and no others than those of the original.
+ */
+static void
+check_subset(const Geom *geom, const Geom *subset, PN_stdfloat x0, PN_stdfloat y0) {
+  Triangles all = get_triangles(geom);
+  Triangles visible = get_triangles(subset);
+  CHECK(visible.size() < all.size());
+
+  GeomVertexReader vertex(geom->get_vertex_data(), InternalName::get_vertex());
+  for (const auto &triangle : all) {
+    bool inside = true;
+    for (int v : {triangle.first, triangle.second.first, triangle.second.second}) {
+      vertex.set_row(v);
+      LPoint3 point = vertex.get_data3();
+      inside = inside && point[0] > x0 && point[0] < x0 + 16 &&
+                         point[1] > y0 && point[1] < y0 + 16;
+    }
+    if (inside) {
+      CHECK(visible.count(triangle) == 1);
+    }
+  }
+  for (const auto &triangle : visible) {
+    CHECK(all.count(triangle) == 1);
+  }
+}
+
+/**
+ * Tests culling against a frustum, and against the eye point.
+ */
+static void
+test_cull() {
+  Thread *thread = Thread::get_current_thread();
+  PT(Geom) geom = make_grid();
+  CPT(GeomMeshlets) meshlets = geom->get_meshlets();
+  CHECK(meshlets != nullptr);
+  CHECK(meshlets->is_valid(geom, thread));
+  int num_meshlets = meshlets->get_num_meshlets();
+  CHECK(num_meshlets > 4);
+
+  // Nothing is culled without a frustum or eye point.
+  int num_culled = -1;
+  CHECK(meshlets->cull(geom, nullptr, nullptr, num_culled, thread) == geom);
+  CHECK(num_culled == 0);
+
+  // A frustum around part of the grid.
+  PT(GeometricBoundingVolume) frustum = make_frustum(8, 8);
+  CPT(Geom) subset = meshlets->cull(geom, frustum, nullptr, num_culled, thread);
+  CHECK(subset != nullptr && subset != geom);
+  CHECK(num_culled > 0 && num_culled < num_meshlets);
+  if (subset != nullptr) {
+    check_subset(geom, subset, 8, 8);
+    CHECK(subset->get_meshlets() == nullptr);
+  }
+
+  // A frustum that misses the grid altogether.
+  frustum = make_frustum(100, 100);
+  CHECK(meshlets->cull(geom, frustum, nullptr, num_culled, thread) == nullptr);
+  CHECK(num_culled == num_meshlets);
+
+  // From above, all of the triangles face the eye; from below, none do.
+  LPoint3 eye(16, 16, 100);
+  CHECK(meshlets->cull(geom, nullptr, &eye, num_culled, thread) == geom);
+  CHECK(num_culled == 0);
+
+  eye.set(16, 16, -100);
+  CHECK(meshlets->cull(geom, nullptr, &eye, num_culled, thread) == nullptr);
+  CHECK(num_culled == num_meshlets);
+
+  // The meshlets are no longer valid once the Geom changes.
+  geom->modify_primitive(0);
+  CHECK(!meshlets->is_valid(geom, thread));
+}
+
+/**
+ * Tests that the subsets are kept for different views, and reused.
+ */
+static void
+test_cull_cache() {
+  Thread *thread = Thread::get_current_thread();
+  PT(Geom) geom = make_grid();
+  CPT(GeomMeshlets) meshlets = geom->get_meshlets();
+  int num_culled;
+
+  PT(GeometricBoundingVolume) frustum_a = make_frustum(0, 0);
+  PT(GeometricBoundingVolume) frustum_b = make_frustum(16, 16);
+
+  // Two cameras that alternate get the same subsets each time.
+  CPT(Geom) a = meshlets->cull(geom, frustum_a, nullptr, num_culled, thread);
+  CPT(Geom) b = meshlets->cull(geom, frustum_b, nullptr, num_culled, thread);
+  CHECK(a != nullptr && b != nullptr && a != b);
+  CHECK(meshlets->cull(geom, frustum_a, nullptr, num_culled, thread) == a);
+  CHECK(meshlets->cull(geom, frustum_b, nullptr, num_culled, thread) == b);
+  check_subset(geom, a, 0, 0);
+  check_subset(geom, b, 16, 16);
+
+  // Once nothing else holds on to the least recently used subset, it is
+  // rewritten in place for a different view.
+  const Geom *old_a = a;
+  a.clear();
+  b.clear();
+  CPT(Geom) c = meshlets->cull(geom, make_frustum(0, 16), nullptr, num_culled, thread);
+  CPT(Geom) d = meshlets->cull(geom, make_frustum(16, 0), nullptr, num_culled, thread);
+  CPT(Geom) e = meshlets->cull(geom, make_frustum(8, 8), nullptr, num_culled, thread);
+  CHECK(e == old_a);
+  check_subset(geom, c, 0, 16);
+  check_subset(geom, d, 16, 0);
+  check_subset(geom, e, 8, 8);
+
+  // But not while it is still in use.
+  CPT(Geom) f = meshlets->cull(geom, make_frustum(4, 4), nullptr, num_culled, thread);
+  CHECK(f != c && f != d && f != e);
+  check_subset(geom, f, 4, 4);
+  check_subset(geom, e, 8, 8);
+}
+
+int
+main(int argc, char *argv[]) {
+  test_cull();
+  test_cull_cache();
+
+  if (num_failures != 0) {
+    cerr << num_failures << " checks failed.\n";
+    return 1;
+  }
+  cerr << "All checks passed.\n";
+  return 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_task_graph.cxx
+ * @author jsgrant
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+#include "asyncTaskGraph.h"
+#include "asyncTaskManager.h"
+#include "asyncTaskChain.h"
+#include "atomicAdjust.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
+#include "pvector.h"
+
+// The C++ interface of AsyncTaskGraph, which takes std::function objects,
+// isn't available from Python, so it is tested here rather than in the
+// Python test suite.
+
+using std::cerr;
+
+static int num_failures = 0;
+
+#define CHECK(condition) \
+  if (!(condition)) { \
+    cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+    ++num_failures; \
+  }
+
+static AsyncTaskChain *chain = nullptr;
+
+/**
+ * Runs a number of independent jobs.
+ */
+static void
+test_jobs() {
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+  AtomicAdjust::Integer count = 0;
+  for (int i = 0; i < 100; ++i) {
+    CHECK(graph->add_job([&]() { AtomicAdjust::inc(count); }) == i);
+  }
+  CHECK(graph->get_num_jobs() == 100);
+
+  graph->run();
+  CHECK(graph->done());
+  CHECK(!graph->cancelled());
+  CHECK(AtomicAdjust::get(count) == 100);
+}
+
+/**
+ * Checks that each element of a range is visited exactly once, whatever the
+ * grain size.
+ */
+static void
+test_ranges() {
+  for (int grain_size : {0, 1, 7, 1000}) {
+    pvector<AtomicAdjust::Integer> hits(1000, 0);
+    PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+    graph->add_range(10, 1000, [&](int begin, int end) {
+      CHECK(begin < end);
+      CHECK(grain_size == 0 || end - begin <= grain_size);
+      for (int i = begin; i < end; ++i) {
+        AtomicAdjust::inc(hits[i]);
+      }
+    }, grain_size);
+
+    // An empty range finishes without calling the function.
+    graph->add_range(5, 5, [&](int begin, int end) {
+      CHECK(false);
+    });
+    graph->run();
+    CHECK(graph->done());
+
+    for (int i = 0; i < 1000; ++i) {
+      CHECK(AtomicAdjust::get(hits[i]) == (i < 10 ? 0 : 1));
+    }
+  }
+}
+
+/**
+ * Checks that a job doesn't start before its prerequisites have finished.
+ */
+static void
+test_dependencies() {
+  // A chain of jobs that must run strictly in order.
+  {
+    LightMutex lock;
+    pvector<int> order;
+    PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+    int prev = -1;
+    for (int i = 0; i < 50; ++i) {
+      int job = graph->add_job([&, i]() {
+        LightMutexHolder holder(lock);
+        order.push_back(i);
+      });
+      if (prev >= 0) {
+        graph->add_dependency(job, prev);
+      }
+      prev = job;
+    }
+    graph->run();
+    CHECK(order.size() == 50);
+    for (size_t i = 0; i < order.size(); ++i) {
+      CHECK(order[i] == (int)i);
+    }
+  }
+
+  // A diamond, in which a range depends on a job, and is followed by another
+  // job that sums up its results.
+  {
+    pvector<int> values(500, 0);
+    int total = 0;
+    PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+    int sum = graph->add_job([&]() {
+      for (int value : values) {
+        total += value;
+      }
+    });
+    int fill = graph->add_job([&]() {
+      for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = 1;
+      }
+    });
+    int square = graph->add_range(0, 500, [&](int begin, int end) {
+      for (int i = begin; i < end; ++i) {
+        values[i] *= 2;
+      }
+    });
+    int other = graph->add_job([&]() {});
+    graph->add_dependency(square, fill);
+    graph->add_dependency(sum, square);
+    graph->add_dependency(sum, other);
+    graph->run();
+    CHECK(total == 1000);
+  }
+}
+
+/**
+ * Checks that a graph with a cyclic dependency is cancelled without running
+ * any of its jobs.
+ */
+static void
+test_cycle() {
+  AtomicAdjust::Integer count = 0;
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+  int a = graph->add_job([&]() { AtomicAdjust::inc(count); });
+  int b = graph->add_job([&]() { AtomicAdjust::inc(count); });
+  int c = graph->add_job([&]() { AtomicAdjust::inc(count); });
+  graph->add_dependency(b, a);
+  graph->add_dependency(c, b);
+  graph->add_dependency(a, c);
+
+  cerr << "Expect an assertion failure about a cyclic dependency:\n";
+  graph->run();
+  CHECK(graph->done());
+  CHECK(graph->cancelled());
+  CHECK(AtomicAdjust::get(count) == 0);
+}
+
+/**
+ * Checks that cancelling a running graph lets the running jobs finish, but
+ * doesn't start any others.
+ */
+static void
+test_cancel() {
+  AtomicAdjust::Integer count = 0;
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+  AsyncTaskGraph *graph_ptr = graph;
+  int first = graph->add_job([&]() {
+    CHECK(graph_ptr->cancel());
+    CHECK(!graph_ptr->cancel());
+    AtomicAdjust::inc(count);
+  });
+  int second = graph->add_job([&]() { AtomicAdjust::inc(count); });
+  int third = graph->add_range(0, 100, [&](int, int) { AtomicAdjust::inc(count); });
+  graph->add_dependency(second, first);
+  graph->add_dependency(third, second);
+
+  graph->run();
+  CHECK(graph->done());
+  CHECK(graph->cancelled());
+  CHECK(AtomicAdjust::get(count) == 1);
+
+  // Cancelling a graph that is done has no effect.
+  CHECK(!graph->cancel());
+}
+
+/**
+ * Checks that the jobs all run on the calling thread when no workers are
+ * allowed, and that a job may run a graph of its own.
+ */
+static void
+test_calling_thread() {
+  Thread *thread = Thread::get_current_thread();
+  AtomicAdjust::Integer count = 0;
+  PT(AsyncTaskGraph) graph = new AsyncTaskGraph(chain->get_name());
+  graph->set_max_workers(0);
+  graph->add_range(0, 100, [&](int begin, int end) {
+    CHECK(Thread::get_current_thread() == thread);
+    AtomicAdjust::add(count, end - begin);
+  }, 1);
+  graph->run();
+  CHECK(AtomicAdjust::get(count) == 100);
+
+  count = 0;
+  graph = new AsyncTaskGraph(chain->get_name());
+  graph->add_range(0, 8, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      PT(AsyncTaskGraph) inner = new AsyncTaskGraph(chain->get_name());
+      inner->add_range(0, 100, [&](int begin, int end) {
+        AtomicAdjust::add(count, end - begin);
+      });
+      inner->run();
+      CHECK(inner->done());
+    }
+  }, 1);
+  graph->run();
+  CHECK(AtomicAdjust::get(count) == 800);
+}
+
+int
+main(int argc, char *argv[]) {
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  chain = task_mgr->make_task_chain("test_task_graph");
+  chain->set_num_threads(4);
+
+  for (int i = 0; i < 10; ++i) {
+    test_jobs();
+    test_ranges();
+    test_dependencies();
+    test_cancel();
+    test_calling_thread();
+  }
+  test_cycle();
+
+  chain->stop_threads();
+
+  if (num_failures != 0) {
+    cerr << num_failures << " checks failed.\n";
+    return 1;
+  }
+  cerr << "All checks passed.\n";
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_traverser.cxx
+ * @author jsgrant
+ * @date 2026-10-16
+ */
+
+#include "pandabase.h"
+#include "collisionTraverser.h"
+#include "collisionHandlerQueue.h"
+#include "collisionNode.h"
+#include "collisionSphere.h"
+#include "config_collide.h"
+#include "clockObject.h"
+#include "nodePath.h"
+
+using std::cerr;
+
+// Measures the time taken by CollisionTraverser::traverse() as the number of
+// colliders grows.  Each count is timed twice: once with
+// allow-collider-multiple off, which splits the colliders into a separate
+// pass for each machine word's worth of colliders, and once with it on, which
+// tests all of the colliders in a single walk of the scene graph.
+
+static const int grid_size = 32;
+static const int num_reps = 10;
+
+static NodePath
+make_scene() {
+  NodePath root("root");
+  for (int y = 0; y < grid_size; ++y) {
+    NodePath row = root.attach_new_node("row");
+    row.set_pos(0, y * 4.0f, 0);
+    for (int x = 0; x < grid_size; ++x) {
+      PT(CollisionNode) cnode = new CollisionNode("into");
+      cnode->add_solid(new CollisionSphere(0, 0, 0, 1));
+      cnode->set_from_collide_mask(CollideMask::all_off());
+      NodePath into = row.attach_new_node(cnode);
+      into.set_pos(x * 4.0f, 0, 0);
+    }
+  }
+  return root;
+}
+
+static double
+time_traverse(const NodePath &root, int num_colliders) {
+  PT(CollisionHandlerQueue) queue = new CollisionHandlerQueue;
+  CollisionTraverser trav;
+
+  NodePath colliders = root.attach_new_node("colliders");
+  for (int i = 0; i < num_colliders; ++i) {
+    PT(CollisionNode) cnode = new CollisionNode("from");
+    cnode->add_solid(new CollisionSphere(0, 0, 0, 1.5f));
+    cnode->set_into_collide_mask(CollideMask::all_off());
+    NodePath from = colliders.attach_new_node(cnode);
+    from.set_pos((i % grid_size) * 4.0f + 1.0f,
+                 ((i / grid_size) % grid_size) * 4.0f, 0);
+    trav.add_collider(from, queue);
+  }
+
+  ClockObject *clock = ClockObject::get_global_clock();
+  trav.traverse(root);
+
+  double start = clock->get_real_time();
+  for (int r = 0; r < num_reps; ++r) {
+    trav.traverse(root);
+  }
+  double elapsed = clock->get_real_time() - start;
+
+  colliders.remove_node();
+  return elapsed / num_reps;
+}
+
+int
+main(int argc, char *argv[]) {
+  NodePath root = make_scene();
+
+  static const int counts[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+  static const int num_counts = sizeof(counts) / sizeof(int);
+
+  cerr << "colliders  multi-pass (ms)  single-pass (ms)\n";
+  for (int i = 0; i < num_counts; ++i) {
+    allow_collider_multiple = false;
+    double multi_pass = time_traverse(root, counts[i]);
+
+    allow_collider_multiple = true;
+    double single_pass = time_traverse(root, counts[i]);
+
+    cerr << counts[i] << "  " << multi_pass * 1000.0
+         << "  " << single_pass * 1000.0 << "\n";
+  }
+
+  return 0;
+}
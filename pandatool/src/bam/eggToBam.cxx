@@ -21,6 +21,8 @@
 #include "config_chan.h"
 #include "pandaNode.h"
 #include "geomNode.h"
+#include "sceneGraphReducer.h"
+#include "meshSimplifier.h"
 #include "renderState.h"
 #include "textureAttrib.h"
 #include "dcast.h"
@@ -105,6 +107,47 @@ EggToBam() :
      "written exactly as they are, losslessly.",
      &EggToBam::dispatch_none, &_compression_off);
 
+  add_option
+    ("quantize", "", 0,
+     "Store the vertex normals, texture coordinates, tangents, binormals "
+     "and colors of unanimated geometry in smaller, quantized formats: "
+     "octahedron-encoded normals, half-precision texture coordinates, "
+     "10-bit tangents and 8-bit colors.  This typically reduces the size "
+     "of the vertex data by 40% or more, at a small loss of precision.  "
+     "The new formats require bam version 6.46 or later; if an older "
+     "version is requested, they are written as 32-bit floats instead.",
+     &EggToBam::dispatch_none, &_quantize);
+
+  add_option
+    ("lod", "levels", 0,
+     "Replace the model with an LODNode that switches between the original "
+     "and levels - 1 automatically simplified versions of it, each with "
+     "about half as many triangles as the one before.  The simplified "
+     "versions share the vertex data of the original.",
+     &EggToBam::dispatch_int, &_has_lod_levels, &_lod_levels);
+
+  add_option
+    ("lodratio", "ratio", 0,
+     "Specifies the fraction of triangles that each level generated by -lod "
+     "keeps from the level before it.  The default is 0.5.",
+     &EggToBam::dispatch_double, nullptr, &_lod_ratio);
+
+  add_option
+    ("lodrange", "near,far", 0,
+     "Specifies the distance at which the first simplified level generated "
+     "by -lod is switched in, and the distance beyond which the model is not "
+     "drawn at all.  The default is based on the size of the model.",
+     &EggToBam::dispatch_double_pair, nullptr, &_lod_range[0]);
+
+  add_option
+    ("vcache", "", 0,
+     "Reorder the triangles of the geometry for better use of the "
+     "post-transform vertex cache of the graphics card, and to draw the "
+     "outward-facing triangles first, and then reorder the vertices in the "
+     "order in which they are used.  The average cache miss ratio before "
+     "and after is reported.",
+     &EggToBam::dispatch_none, &_optimize_vertex_cache);
+
   add_option
     ("rawtex", "", 0,
      "Record texture data directly in the bam file, instead of storing "
@@ -210,6 +253,11 @@ EggToBam() :
   _egg_flatten = 0;
   _egg_combine_geoms = 0;
   _egg_suppress_hidden = 1;
+  _quantize = false;
+  _optimize_vertex_cache = false;
+  _lod_ratio = 0.5;
+  _lod_range[0] = 0.0;
+  _lod_range[1] = 0.0;
   _tex_txopz = false;
   _ctex_quality = "best";
 }
@@ -310,6 +358,39 @@ run() {
     }
   }
 
+  if (_has_lod_levels && _lod_levels > 1) {
+    if (_lod_ratio <= 0.0 || _lod_ratio >= 1.0) {
+      nout << "-lodratio must be between 0 and 1.\n";
+      exit(1);
+    }
+
+    PT(PandaNode) model = new PandaNode(root->get_name());
+    model->steal_children(root);
+
+    MeshSimplifier simplifier;
+    root->add_child(simplifier.make_lod(model, _lod_levels, _lod_ratio,
+                                        _lod_range[0], _lod_range[1]));
+  }
+
+  if (_quantize) {
+    SceneGraphReducer gr;
+    gr.quantize_vertices(root);
+
+    if (bam_version.get_num_words() == 0) {
+      // Quantized vertices require a newer bam version than we would write
+      // by default.
+      bam_version.set_string_value("6 46");
+    }
+  }
+
+  if (_optimize_vertex_cache) {
+    SceneGraphReducer gr;
+    PN_stdfloat before = gr.calc_acmr(root);
+    gr.optimize_vertex_cache(root);
+    PN_stdfloat after = gr.calc_acmr(root);
+    nout << "Average cache miss ratio: " << before << " -> " << after << "\n";
+  }
+
   if (_ls) {
     root->ls(nout, 0);
   }
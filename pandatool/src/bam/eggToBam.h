@@ -56,6 +56,12 @@ private:
   int _egg_combine_geoms;
   bool _egg_suppress_hidden;
   bool _ls;
+  bool _quantize;
+  bool _optimize_vertex_cache;
+  bool _has_lod_levels;
+  int _lod_levels;
+  double _lod_ratio;
+  double _lod_range[2];
   bool _has_compression_quality;
   int _compression_quality;
   bool _compression_off;
@@ -0,0 +1,156 @@
+import math
+from panda3d import core
+import pytest
+
+
+def make_character():
+    char = core.Character("char")
+    bundle = char.get_bundle(0)
+    parent = bundle
+    joints = []
+    for i in range(8):
+        parent = core.CharacterJoint(char, bundle, parent, "joint%d" % (i),
+                                     core.Mat4.ident_mat())
+        joints.append(parent)
+    return char, joints
+
+
+def make_anim(seed):
+    anim = core.AnimBundle("char", 24, 10)
+    parent = anim
+    for i in range(8):
+        table = core.AnimChannelMatrixXfmTable(parent, "joint%d" % (i))
+        for c, table_id in enumerate("ijkhprxyz"):
+            values = [(f + seed + i + c) % 10 for f in range(10)]
+            if c < 3:
+                values = [1 + v * 0.1 for v in values]
+            else:
+                values = [v * 10.0 for v in values]
+            table.set_table(table_id, core.PTA_stdfloat(values))
+        parent = table
+    return anim
+
+
+@pytest.mark.parametrize("blend_type", ["BT_linear", "BT_normalized_linear", "BT_componentwise_quat"])
+def test_joint_pose_buffer_blend(blend_type):
+    results = []
+    for flag in (False, True):
+        char, joints = make_character()
+        bundle = char.get_bundle(0)
+        bundle.pose_buffer_flag = flag
+        bundle.anim_blend_flag = True
+        bundle.blend_type = getattr(core.PartBundle, blend_type)
+
+        controls = [bundle.bind_anim(make_anim(seed)) for seed in (0, 3)]
+        for control, effect in zip(controls, (0.25, 0.75)):
+            control.pose(2)
+            bundle.set_control_effect(control, effect)
+        bundle.force_update()
+
+        if flag:
+            pose_buffer = bundle.pose_buffer
+            assert pose_buffer is not None
+            assert pose_buffer.get_num_joints() == 8
+            assert pose_buffer.get_parent_index(0) == -1
+            assert pose_buffer.get_parent_index(3) == 2
+            assert pose_buffer.has_local_transform(3)
+            net = core.LMatrix4()
+            joints[7].get_net_transform(net)
+            assert pose_buffer.get_net_transform(7).almost_equal(net, 0.001)
+
+        results.append([joint.get_transform() for joint in joints])
+
+    for expected, actual in zip(*results):
+        assert actual.almost_equal(expected, 0.001)
+
+
+@pytest.mark.parametrize("blend_type", ["BT_linear", "BT_normalized_linear", "BT_componentwise_quat"])
+def test_joint_pose_buffer_frame_blend(blend_type):
+    # A chain of joints with a short branch off every fourth joint, blending
+    # three animations between frames.
+    num_joints = 64
+    num_frames = 60
+
+    def make_bundle():
+        char = core.Character("char")
+        bundle = char.get_bundle(0)
+        parent = bundle
+        joints = []
+        for i in range(0, num_joints, 4):
+            for j in range(3):
+                parent = core.CharacterJoint(char, bundle, parent, "joint%d" % (i + j),
+                                             core.Mat4.ident_mat())
+                joints.append(parent)
+            joints.append(core.CharacterJoint(char, bundle, parent, "joint%d" % (i + 3),
+                                              core.Mat4.ident_mat()))
+        return char, joints
+
+    def make_anim(seed):
+        anim = core.AnimBundle("char", 24, num_frames)
+        parent = anim
+        for i in range(0, num_joints, 4):
+            for j in range(4):
+                table = core.AnimChannelMatrixXfmTable(parent, "joint%d" % (i + j))
+                for c, table_id in enumerate("ijkhprxyz"):
+                    values = [math.sin((f + seed * 7 + i + c) * 6.28 / num_frames)
+                              for f in range(num_frames)]
+                    if c < 3:
+                        values = [1.0 + 0.1 * v for v in values]
+                    else:
+                        values = [30.0 * v for v in values]
+                    table.set_table(table_id, core.PTA_stdfloat(values))
+                if j < 3:
+                    parent = table
+        return anim
+
+    results = []
+    for flag in (False, True):
+        char, joints = make_bundle()
+        bundle = char.get_bundle(0)
+        bundle.anim_blend_flag = True
+        bundle.frame_blend_flag = True
+        bundle.pose_buffer_flag = flag
+        bundle.blend_type = getattr(core.PartBundle, blend_type)
+
+        controls = [bundle.bind_anim(make_anim(seed)) for seed in range(3)]
+        for seed, control in enumerate(controls):
+            control.pose(10.3 + seed * 5.6)
+            bundle.set_control_effect(control, 1.0 / 3)
+        bundle.force_update()
+
+        if flag:
+            assert bundle.pose_buffer.get_num_joints() == num_joints
+        results.append([joint.get_transform() for joint in joints])
+
+    for expected, actual in zip(*results):
+        assert actual.almost_equal(expected, 0.001)
+
+
+def test_joint_pose_buffer_lifetime():
+    char, joints = make_character()
+    bundle = char.get_bundle(0)
+    bundle.pose_buffer_flag = True
+    control = bundle.bind_anim(make_anim(0))
+    control.pose(2)
+    bundle.force_update()
+    expected = [joint.get_transform() for joint in joints]
+
+    # Replacing the buffer while the old one is still around doesn't confuse
+    # the joints when the old one goes away.
+    old_buffer = bundle.pose_buffer
+    assert old_buffer.bundle == bundle
+    bundle.pose_buffer_flag = False
+    bundle.pose_buffer_flag = True
+    bundle.force_update()
+    new_buffer = bundle.pose_buffer
+    assert new_buffer != old_buffer
+    del old_buffer
+
+    bundle.force_update()
+    for joint, mat in zip(joints, expected):
+        assert joint.get_transform().almost_equal(mat, 0.001)
+
+    # The buffer doesn't keep the bundle alive.
+    del char, bundle, control, joints
+    assert new_buffer.bundle is None
+    new_buffer.get_net_transform(0)
@@ -0,0 +1,52 @@
+from panda3d import core
+
+
+def make_characters(root, count):
+    joints = []
+    for i in range(count):
+        char = core.Character("char%d" % (i))
+        bundle = char.get_bundle(0)
+        joint = core.CharacterJoint(char, bundle, bundle, "joint",
+                                    core.Mat4.ident_mat())
+        root.attach_new_node(char)
+        joints.append(joint)
+    return joints
+
+
+def test_part_bundle_updater_collect():
+    root = core.NodePath("root")
+    make_characters(root, 4)
+
+    updater = core.PartBundleUpdater()
+    updater.collect_bundles(root)
+    assert updater.get_num_bundles() == 4
+
+    # Collecting the same bundles again doesn't add them twice.
+    updater.collect_bundles(root)
+    assert updater.get_num_bundles() == 4
+
+    assert updater.remove_bundle(updater.get_bundle(0))
+    assert updater.get_num_bundles() == 3
+
+    updater.clear_bundles()
+    assert updater.get_num_bundles() == 0
+
+
+def test_part_bundle_updater_update():
+    for num_threads in (1, 4):
+        root = core.NodePath("root")
+        joints = make_characters(root, 32)
+
+        updater = core.PartBundleUpdater()
+        updater.num_threads = num_threads
+        updater.collect_bundles(root)
+
+        for i, bundle in enumerate(updater.bundles):
+            bundle.freeze_joint("joint", core.TransformState.make_pos((i, 0, 0)))
+
+        assert updater.update() == 32
+        for i, joint in enumerate(joints):
+            assert joint.get_transform_state().pos == (i, 0, 0)
+
+        # Nothing has changed since, so there is nothing left to do.
+        assert updater.update() == 0
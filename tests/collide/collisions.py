@@ -4,6 +4,8 @@ from panda3d.core import CollisionSphere, CollisionInvSphere, CollisionBox, Coll
 from panda3d.core import CollisionLine, CollisionRay, CollisionSegment, CollisionParabola
 from panda3d.core import CollisionPlane
 from panda3d.core import Point3, Vec3, Plane, LParabola
+from panda3d.core import GeomNode, GeomVertexFormat, GeomVertexData
+from panda3d.core import GeomVertexWriter, GeomTriangles, Geom
 
 
 def make_collision(solid_from, solid_into):
@@ -28,3 +30,24 @@ def make_collision(solid_from, solid_into):
             entry = e
 
     return (entry, np_from, np_into)
+
+
+def make_grid_geom(size):
+    vdata = GeomVertexData("grid", GeomVertexFormat.get_v3(), Geom.UH_static)
+    writer = GeomVertexWriter(vdata, "vertex")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            writer.add_data3(x, y, 0)
+
+    tris = GeomTriangles(Geom.UH_static)
+    for y in range(size):
+        for x in range(size):
+            i = y * (size + 1) + x
+            tris.add_vertices(i, i + 1, i + size + 2)
+            tris.add_vertices(i, i + size + 2, i + size + 1)
+
+    geom = Geom(vdata)
+    geom.add_primitive(tris)
+    node = GeomNode("grid")
+    node.add_geom(geom)
+    return node
@@ -0,0 +1,76 @@
+from collisions import *
+from panda3d.core import ConfigVariableInt
+
+
+def make_grid_node(size):
+    # A size x size grid of unit quads in the XY plane.
+    node = CollisionNode("grid")
+    for y in range(size):
+        for x in range(size):
+            node.add_solid(CollisionPolygon(Point3(x, y, 0), Point3(x + 1, y, 0),
+                                            Point3(x + 1, y + 1, 0), Point3(x, y + 1, 0)))
+    return node
+
+
+def collide_rays(into_node, threshold):
+    root = NodePath("root")
+    root.attach_new_node(into_node)
+
+    trav = CollisionTraverser()
+    queue = CollisionHandlerQueue()
+    for i in range(10):
+        from_node = CollisionNode("ray%d" % (i))
+        from_node.add_solid(CollisionRay(i + 0.5, i * 0.7 + 0.25, 10, 0, 0, -1))
+        from_node.set_into_collide_mask(0)
+        from_node.set_from_collide_mask(into_node.get_into_collide_mask())
+        trav.add_collider(root.attach_new_node(from_node), queue)
+
+    bvh_threshold = ConfigVariableInt("collision-bvh-threshold")
+    old_value = bvh_threshold.value
+    try:
+        bvh_threshold.value = threshold
+        trav.traverse(root)
+    finally:
+        bvh_threshold.value = old_value
+
+    return sorted((entry.from_node.name, tuple(entry.get_surface_point(root)))
+                  for entry in queue.entries)
+
+
+def test_bvh_into_collision_node():
+    node = make_grid_node(16)
+    linear = collide_rays(node, 0)
+    assert len(linear) == 10
+    assert collide_rays(node, 1) == linear
+
+
+def test_bvh_into_geom_node():
+    node = make_grid_geom(16)
+    node.set_into_collide_mask(GeomNode.get_default_collide_mask())
+    linear = collide_rays(node, 0)
+    assert len(linear) == 10
+    assert collide_rays(node, 1) == linear
+
+
+def test_bvh_after_modify():
+    node = make_grid_node(16)
+    assert len(collide_rays(node, 1)) == 10
+
+    # Moving all of the solids out of the way must be noticed.
+    node.clear_solids()
+    for i in range(32):
+        node.add_solid(CollisionSphere(100 + i, 100, 0, 0.5))
+    assert collide_rays(node, 1) == []
+
+
+def test_bvh_geom_after_modify():
+    node = make_grid_geom(16)
+    node.set_into_collide_mask(GeomNode.get_default_collide_mask())
+    assert len(collide_rays(node, 1)) == 10
+
+    # The triangles cached on the Geom must be rebuilt once its vertices move.
+    vdata = node.modify_geom(0).modify_vertex_data()
+    writer = GeomVertexWriter(vdata, "vertex")
+    for i in range(vdata.get_num_rows()):
+        writer.set_data3(100 + i, 100, 0)
+    assert collide_rays(node, 1) == []
@@ -0,0 +1,104 @@
+from collisions import *
+from panda3d.core import CollisionRayBatch, GeomNode, BitMask32
+
+
+def make_scene():
+    root = NodePath("root")
+
+    spheres = CollisionNode("spheres")
+    for i in range(8):
+        spheres.add_solid(CollisionSphere(i * 2 + 1, 1, 3, 0.75))
+    spheres.set_into_collide_mask(BitMask32.bit(1))
+    root.attach_new_node(spheres)
+
+    ground = root.attach_new_node(make_grid_geom(16))
+    ground.node().set_into_collide_mask(BitMask32.bit(2))
+    ground.set_pos(0, 0, -1)
+    ground.set_scale(2, 2, 1)
+    return root
+
+
+def reference_hits(root, rays, mask):
+    # Find the nearest hits with an ordinary traversal.
+    trav = CollisionTraverser()
+    queue = CollisionHandlerQueue()
+    for i, (origin, direction) in enumerate(rays):
+        node = CollisionNode("ray%d" % (i))
+        node.add_solid(CollisionRay(origin, direction))
+        node.set_from_collide_mask(mask)
+        node.set_into_collide_mask(0)
+        trav.add_collider(root.attach_new_node(node), queue)
+
+    trav.traverse(root)
+    queue.sort_entries()
+
+    hits = {}
+    for entry in queue.entries:
+        name = entry.from_node.name
+        if name not in hits:
+            hits[name] = (entry.into_node.name, entry.get_surface_point(root))
+
+    for np in root.find_all_matches("ray*"):
+        np.remove_node()
+    return [hits.get("ray%d" % (i)) for i in range(len(rays))]
+
+
+def test_ray_batch_matches_traverse():
+    root = make_scene()
+    rays = []
+    for i in range(16):
+        rays.append((Point3(i + 0.3, 1.1, 10), Vec3(0, 0, -1)))
+    rays.append((Point3(100, 100, 10), Vec3(0, 0, -1)))
+    rays.append((Point3(5, 5, 10), Vec3(0, 0, 1)))
+
+    mask = BitMask32.bit(1) | BitMask32.bit(2)
+    batch = CollisionRayBatch()
+    for origin, direction in rays:
+        batch.add_ray(origin, direction)
+
+    trav = CollisionTraverser()
+    trav.traverse_rays(root, batch, mask)
+    expected = reference_hits(root, rays, mask)
+
+    assert batch.get_num_rays() == len(rays)
+    assert batch.get_num_hits() == len([hit for hit in expected if hit])
+    for i, hit in enumerate(expected):
+        assert batch.has_hit(i) == (hit is not None)
+        if hit is not None:
+            assert batch.get_hit_node_path(i).name == hit[0]
+            assert batch.get_hit_pos(i).almost_equal(hit[1], 0.001)
+
+
+def test_ray_batch_mask():
+    root = make_scene()
+    batch = CollisionRayBatch()
+    batch.add_ray((1, 1, 10), (0, 0, -1))
+
+    trav = CollisionTraverser()
+    trav.traverse_rays(root, batch, BitMask32.bit(1))
+    assert batch.get_hit_node_path(0).name == "spheres"
+    assert batch.get_hit_pos(0).almost_equal((1, 1, 3.75), 0.001)
+    assert batch.get_hit_normal(0).almost_equal((0, 0, 1), 0.001)
+
+    trav.traverse_rays(root, batch, BitMask32.bit(2))
+    assert batch.get_hit_node_path(0).name == "grid"
+    assert batch.get_hit_pos(0).almost_equal((1, 1, -1), 0.001)
+    assert batch.get_hit_normal(0).almost_equal((0, 0, 1), 0.001)
+
+    trav.traverse_rays(root, batch, BitMask32.bit(3))
+    assert not batch.has_hit(0)
+
+
+def test_ray_batch_segment():
+    root = make_scene()
+    batch = CollisionRayBatch()
+    batch.add_segment((1, 1, 10), (1, 1, 5))
+    batch.add_segment((1, 1, 10), (1, 1, 0))
+    batch.add_segment((1, 1, 10), (1, 1, -5))
+
+    trav = CollisionTraverser()
+    trav.traverse_rays(root, batch, BitMask32.bit(2))
+    assert not batch.has_hit(0)
+    assert not batch.has_hit(1)
+    assert batch.has_hit(2)
+    assert abs(batch.get_hit_t(2) - 11 / 15.0) < 0.001
@@ -29,3 +29,105 @@ def test_collision_traverser_pickle():
     # Two colliders must still be the same object; this only works with our own
     # version of the pickle module, in direct.stdpy.pickle.
     assert trav.get_handler(collider1) == trav.get_handler(collider2)
+
+
+def test_collision_traverser_threads():
+    from panda3d.core import CollisionSphere, ConfigVariableBool
+
+    root = NodePath("root")
+    for i in range(20):
+        into = root.attach_new_node(CollisionNode("into%d" % (i)))
+        into.node().add_solid(CollisionSphere(0, 0, 0, 1))
+        into.set_pos(i * 1.5, 0, 0)
+
+    def collect(num_threads):
+        trav = CollisionTraverser()
+        trav.num_threads = num_threads
+        queue = CollisionHandlerQueue()
+        # Enough colliders for several passes of 32.
+        for i in range(100):
+            from_np = root.attach_new_node(CollisionNode("from%d" % (i)))
+            from_np.node().add_solid(CollisionSphere(0, 0, 0, 0.5))
+            from_np.node().set_into_collide_mask(0)
+            from_np.set_pos(i * 0.3, 0, 0)
+            trav.add_collider(from_np, queue)
+
+        trav.traverse(root)
+        result = [(entry.from_node.name, entry.into_node.name)
+                  for entry in queue.entries]
+
+        for i in range(trav.get_num_colliders()):
+            trav.get_collider(i).remove_node()
+        return result
+
+    # The parallel traversal delivers the entries in the same order as the
+    # serial traversal does with the same passes.
+    allow_multiple = ConfigVariableBool("allow-collider-multiple")
+    old_value = allow_multiple.value
+    try:
+        allow_multiple.value = False
+        serial = collect(0)
+    finally:
+        allow_multiple.value = old_value
+
+    assert len(serial) > 0
+    assert collect(4) == serial
+
+
+def test_collision_traverser_many_colliders():
+    from panda3d.core import CollisionSphere, ConfigVariableBool
+
+    root = NodePath("root")
+    into = root.attach_new_node(CollisionNode("into"))
+    into.node().add_solid(CollisionSphere(0, 0, 0, 100))
+
+    queue = CollisionHandlerQueue()
+    trav = CollisionTraverser()
+    for i in range(300):
+        from_np = root.attach_new_node(CollisionNode("from%d" % (i)))
+        from_np.node().add_solid(CollisionSphere(0, 0, 0, 0.5))
+        from_np.node().set_into_collide_mask(0)
+        from_np.set_pos(i * 0.1, 0, 0)
+        trav.add_collider(from_np, queue)
+
+    allow_multiple = ConfigVariableBool("allow-collider-multiple")
+    old_value = allow_multiple.value
+    try:
+        allow_multiple.value = False
+        trav.traverse(root)
+        multi_pass = sorted(entry.from_node.name for entry in queue.entries)
+
+        allow_multiple.value = True
+        trav.traverse(root)
+        single_pass = sorted(entry.from_node.name for entry in queue.entries)
+    finally:
+        allow_multiple.value = old_value
+
+    assert len(multi_pass) == 300
+    assert single_pass == multi_pass
+
+
+def test_collision_traverser_broadphase():
+    from panda3d.core import CollisionSphere
+
+    # A crowd of spheres that collide with each other.
+    root = NodePath("root")
+    for i in range(100):
+        np = root.attach_new_node(CollisionNode("agent%d" % (i)))
+        np.node().add_solid(CollisionSphere(0, 0, 0, 0.6))
+        np.set_pos((i % 10) * 1.1, (i // 10) * 1.3, (i % 3) * 0.2)
+
+    def collect(threshold):
+        trav = CollisionTraverser()
+        trav.broadphase_threshold = threshold
+        queue = CollisionHandlerQueue()
+        for np in root.get_children():
+            trav.add_collider(np, queue)
+
+        trav.traverse(root)
+        return sorted((entry.from_node.name, entry.into_node.name)
+                      for entry in queue.entries)
+
+    brute_force = collect(0)
+    assert len(brute_force) > 0
+    assert collect(4) == brute_force
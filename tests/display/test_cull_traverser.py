@@ -0,0 +1,87 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def region(graphics_pipe):
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.force_hardware = True
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(32, 32),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    buffer.set_clear_color_active(True)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    yield buffer.make_display_region()
+
+    engine.remove_window(buffer)
+
+
+def make_scene(bin_name, num_sorts):
+    # A grid of small overlapping cards, spread across many groups, each with
+    # one of a few colors.  Since depth testing is off, the resulting image
+    # depends on the order in which the cards are drawn.
+    scene = core.NodePath("root")
+    scene.set_depth_test(False)
+    scene.set_depth_write(False)
+
+    cm = core.CardMaker("card")
+    cm.set_frame(-0.2, 0.2, -0.2, 0.2)
+    for g in range(16):
+        group = scene.attach_new_node("group%d" % (g))
+        for c in range(16):
+            i = g * 16 + c
+            card = group.attach_new_node(cm.generate())
+            card.set_pos((i % 16) / 8.0 - 1, 2, (i // 16) / 8.0 - 1)
+            card.set_color((i % 7) / 6.0, (i % 5) / 4.0, (i % 3) / 2.0, 1)
+            if bin_name is not None:
+                card.set_bin(bin_name, (i * 37) % num_sorts)
+
+    camera = scene.attach_new_node(core.Camera("camera"))
+    camera.node().get_lens().set_fov(90)
+    return scene, camera
+
+
+def render_scene(region, num_threads, bin_name, num_sorts):
+    scene, camera = make_scene(bin_name, num_sorts)
+    region.camera = camera
+    region.cull_traverser.num_threads = num_threads
+
+    tex = core.Texture()
+    region.window.add_render_texture(tex, core.GraphicsOutput.RTM_copy_ram)
+    region.window.engine.render_frame()
+    region.window.clear_render_textures()
+    region.cull_traverser.num_threads = 0
+    return bytes(tex.get_ram_image())
+
+
+@pytest.mark.parametrize("bin_name,num_sorts", [
+    # Every card has its own sort within the fixed bin.
+    ("fixed", 256),
+    # Many cards share the same sort, so that they are drawn in the order in
+    # which they were added to the bin.
+    ("fixed", 4),
+    # The default opaque bin, which is sorted by state.
+    (None, 1),
+])
+def test_cull_traverser_num_threads(region, bin_name, num_sorts):
+    serial = render_scene(region, 0, bin_name, num_sorts)
+    assert serial.count(0) != len(serial)
+
+    for num_threads in (2, 4):
+        assert render_scene(region, num_threads, bin_name, num_sorts) == serial
@@ -0,0 +1,116 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def buffer(graphics_pipe):
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.force_hardware = True
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+    fbprops.set_depth_bits(16)
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(64, 32),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    buffer.set_clear_color_active(True)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    yield buffer
+
+    engine.remove_window(buffer)
+
+
+def make_scene():
+    # A large grid with a different color for each vertex, divided into
+    # meshlets, of which each camera only sees a part.
+    size = 32
+    vdata = core.GeomVertexData("grid", core.GeomVertexFormat.get_v3c4(), core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    color = core.GeomVertexWriter(vdata, "color")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x - size / 2, y - size / 2, 0)
+            color.add_data4((x % 5) / 4.0, (y % 3) / 2.0, ((x + y) % 7) / 6.0, 1)
+
+    prim = core.GeomTriangles(core.Geom.UH_static)
+    for y in range(size):
+        for x in range(size):
+            a = y * (size + 1) + x
+            b = a + 1
+            c = a + size + 1
+            d = c + 1
+            prim.add_vertices(a, b, d)
+            prim.add_vertices(a, d, c)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(prim)
+    geom.optimize_vertex_cache_in_place()
+    assert geom.make_meshlets(32, 32)
+
+    scene = core.NodePath("root")
+    node = core.GeomNode("grid")
+    node.add_geom(geom)
+    scene.attach_new_node(node)
+
+    cameras = []
+    for pos in ((-6, -6, 8), (8, 4, 5)):
+        camera = scene.attach_new_node(core.Camera("camera"))
+        camera.node().get_lens().set_fov(60)
+        camera.set_pos(pos)
+        camera.look_at(pos[0] * 0.5, pos[1] * 0.5, 0)
+        cameras.append(camera)
+
+    return scene, cameras
+
+
+def render(buffer, cameras):
+    # The two cameras render side by side, so that the Geom is culled twice
+    # in each frame.
+    buffer.remove_all_display_regions()
+    for i, camera in enumerate(cameras):
+        region = buffer.make_display_region(i * 0.5, i * 0.5 + 0.5, 0, 1)
+        region.camera = camera
+
+    tex = core.Texture()
+    buffer.add_render_texture(tex, core.GraphicsOutput.RTM_copy_ram)
+    buffer.engine.render_frame()
+    buffer.clear_render_textures()
+    return bytes(tex.get_ram_image())
+
+
+def test_meshlet_cull(buffer):
+    scene, cameras = make_scene()
+
+    page = core.load_prc_file_data("", "meshlet-cull false")
+    try:
+        expected = render(buffer, cameras)
+    finally:
+        core.unload_prc_file(page)
+    assert expected.count(0) != len(expected)
+
+    # Culling the meshlets doesn't change what is drawn, in either camera,
+    # however often they alternate.
+    for i in range(3):
+        assert render(buffer, cameras) == expected
+
+    # Also when a camera moves.
+    cameras[0].set_pos(-5, -6, 8)
+    page = core.load_prc_file_data("", "meshlet-cull false")
+    try:
+        expected = render(buffer, cameras)
+    finally:
+        core.unload_prc_file(page)
+    assert render(buffer, cameras) == expected
@@ -0,0 +1,71 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture(scope='module')
+def buffer(graphics_pipe):
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.force_hardware = True
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+
+    buffer = engine.make_output(
+        graphics_pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(256, 256),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("GraphicsPipe cannot make offscreen buffers")
+
+    yield buffer
+
+    engine.remove_window(buffer)
+
+
+def test_texture_stream_demand_scaled(buffer, tmp_path):
+    img = core.PNMImage(256, 128, 3)
+    img.fill(0.25, 0.5, 0.75)
+    path = core.Filename.from_os_specific(str(tmp_path / "stream.png"))
+    assert img.write(path)
+
+    streamer = core.TextureStreamer()
+    streamer.initial_size = 16
+
+    scene = core.NodePath("root")
+    camera = scene.attach_new_node(core.Camera("camera"))
+    camera.node().get_lens().set_fov(60)
+    camera.set_pos(0, -10, 0)
+
+    # Two cards of the same size on the screen, about 64 pixels across, one of
+    # which is made that large by the scale on its node.
+    textures = []
+    for x, size, scale in ((-2, 1, 2), (2, 2, 1)):
+        cm = core.CardMaker("card")
+        cm.set_frame(-size / 2, size / 2, -size / 2, size / 2)
+        card = scene.attach_new_node(cm.generate())
+        card.set_pos(x, 0, 0)
+        card.set_scale(scale)
+
+        tex = core.Texture()
+        assert tex.read(path)
+        assert streamer.add_texture(tex)
+        card.set_texture(tex)
+        textures.append(tex)
+
+    buffer.remove_all_display_regions()
+    region = buffer.make_display_region()
+    region.camera = camera
+    buffer.engine.render_frame()
+    streamer.update()
+
+    # Both are loaded at the same size, which is smaller than the full image.
+    scaled, unscaled = textures
+    assert unscaled.stream_level > 0
+    assert scaled.stream_level == unscaled.stream_level
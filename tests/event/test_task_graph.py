@@ -0,0 +1,37 @@
+from panda3d import core
+
+
+def test_task_graph_empty():
+    graph = core.AsyncTaskGraph()
+    assert graph.chain_name == core.ConfigVariableString("task-graph-chain").value
+    assert graph.get_num_jobs() == 0
+    assert not graph.is_started()
+
+    graph.run()
+    assert graph.is_started()
+    assert graph.done()
+    assert not graph.cancelled()
+
+
+def test_task_graph_cancel_before_start():
+    graph = core.AsyncTaskGraph()
+    assert graph.cancel()
+    assert graph.done()
+    assert graph.cancelled()
+
+    # Running it now does nothing.
+    graph.run()
+    assert graph.cancelled()
+
+
+def test_task_graph_chain():
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    task_chain = task_mgr.make_task_chain("test_task_graph_chain")
+    task_chain.set_num_threads(2)
+
+    graph = core.AsyncTaskGraph(task_chain.name)
+    assert graph.chain_name == task_chain.name
+    graph.run()
+    assert graph.done()
+
+    task_chain.stop_threads()
@@ -0,0 +1,164 @@
+from panda3d import core
+import threading
+
+
+def make_chain(name, num_threads=4):
+    task_mgr = core.AsyncTaskManager.get_global_ptr()
+    task_chain = task_mgr.make_task_chain(name)
+    task_chain.set_num_threads(num_threads)
+    task_chain.set_work_stealing(True)
+    assert task_chain.get_work_stealing()
+    return task_mgr, task_chain
+
+
+def test_work_stealing_runs_all_tasks():
+    task_mgr, task_chain = make_chain("test_work_stealing_runs_all_tasks")
+
+    lock = threading.Lock()
+    counts = {}
+
+    def task_main(task):
+        with lock:
+            counts[task.name] = counts.get(task.name, 0) + 1
+        if counts[task.name] < 3:
+            return task.cont
+        return task.done
+
+    tasks = []
+    for i in range(100):
+        task = core.PythonTask(task_main, "task%d" % (i))
+        task.set_task_chain(task_chain.name)
+        task.set_priority(i % 5)
+        tasks.append(task)
+        task_mgr.add(task)
+
+    task_chain.wait_for_tasks()
+    task_chain.stop_threads()
+
+    assert all(task.done() for task in tasks)
+    assert len(counts) == 100
+    assert all(count == 3 for count in counts.values())
+
+
+def test_work_stealing_sort_barrier():
+    task_mgr, task_chain = make_chain("test_work_stealing_sort_barrier")
+
+    lock = threading.Lock()
+    finished = []
+    order_ok = [True]
+
+    def task_main(task):
+        with lock:
+            # No task of a higher sort may have finished before this one.
+            if finished and finished[-1] > task.sort:
+                order_ok[0] = False
+            finished.append(task.sort)
+        return task.done
+
+    for i in range(60):
+        task = core.PythonTask(task_main, "task%d" % (i))
+        task.set_task_chain(task_chain.name)
+        task.set_sort(i % 3)
+        task_mgr.add(task)
+
+    task_chain.wait_for_tasks()
+    task_chain.stop_threads()
+
+    assert len(finished) == 60
+    assert order_ok[0]
+
+
+def test_work_stealing_remove():
+    task_mgr, task_chain = make_chain("test_work_stealing_remove")
+
+    def task_main(task):
+        # Remove the other tasks, which may still be waiting on a queue.
+        for other in others:
+            other.remove()
+        return task.done
+
+    def other_main(task):
+        return task.cont
+
+    others = []
+    for i in range(20):
+        task = core.PythonTask(other_main, "other%d" % (i))
+        task.set_task_chain(task_chain.name)
+        task.set_sort(1)
+        others.append(task)
+
+    for other in others:
+        task_mgr.add(other)
+    task = core.PythonTask(task_main, "remover")
+    task.set_task_chain(task_chain.name)
+    task_mgr.add(task)
+
+    task_chain.wait_for_tasks()
+    task_chain.stop_threads()
+
+    assert task.done()
+    assert all(other.cancelled() for other in others)
+
+
+def test_work_stealing_remove_queued():
+    # With two threads, the remover and the gate are dealt first, one to each
+    # thread, and the victims are queued up behind them.  The gate keeps the
+    # second thread busy, so the victims are all still waiting on the queues
+    # when the remover removes them.
+    task_mgr, task_chain = make_chain("test_work_stealing_remove_queued", 2)
+
+    added = threading.Event()
+    removed = threading.Event()
+    results = []
+    ran = []
+
+    def blocker_main(task):
+        # This runs first, in a sort group of its own, so that the others are
+        # all dealt out together once they have been added.
+        added.wait(10)
+        return task.done
+
+    def remover_main(task):
+        for victim in victims:
+            results.append(victim.remove())
+        removed.set()
+        return task.done
+
+    def gate_main(task):
+        removed.wait(10)
+        return task.done
+
+    def victim_main(task):
+        ran.append(task.name)
+        return task.done
+
+    blocker = core.PythonTask(blocker_main, "blocker")
+    blocker.set_task_chain(task_chain.name)
+    blocker.set_sort(-1)
+    task_mgr.add(blocker)
+
+    remover = core.PythonTask(remover_main, "remover")
+    remover.set_task_chain(task_chain.name)
+    remover.set_priority(10)
+    gate = core.PythonTask(gate_main, "gate")
+    gate.set_task_chain(task_chain.name)
+    gate.set_priority(9)
+
+    victims = []
+    for i in range(10):
+        victim = core.PythonTask(victim_main, "victim%d" % (i))
+        victim.set_task_chain(task_chain.name)
+        victims.append(victim)
+
+    for task in [remover, gate] + victims:
+        task_mgr.add(task)
+    added.set()
+
+    task_chain.wait_for_tasks()
+    task_chain.stop_threads()
+
+    assert removed.is_set()
+    assert remover.done() and gate.done()
+    assert results == [True] * 10
+    assert not ran
+    assert all(victim.cancelled() for victim in victims)
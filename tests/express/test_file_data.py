@@ -0,0 +1,56 @@
+from panda3d.core import VirtualFileSystem, VirtualFileMountRamdisk
+from panda3d.core import Multifile, StringStream, Filename
+
+
+def test_file_data_system(tmp_path):
+    path = tmp_path / "data.bin"
+    path.write_bytes(bytes(range(256)) * 16)
+    filename = Filename.from_os_specific(str(path))
+
+    vfs = VirtualFileSystem.get_global_ptr()
+    data = vfs.read_file_data(filename, True)
+    assert data is not None
+    assert data.size == 4096
+    assert data.mapped
+    assert data.get_subdata(254, 4) == b'\xfe\xff\x00\x01'
+
+    # Reading past the end is clamped.
+    assert data.get_subdata(4094, 100) == b'\xfe\xff'
+
+    assert vfs.read_file_data(Filename(filename.get_fullpath() + ".missing"), True) is None
+
+
+def test_file_data_multifile(tmp_path):
+    filename = Filename.from_os_specific(str(tmp_path / "test.mf"))
+    m = Multifile()
+    assert m.open_write(filename)
+    m.add_subfile("plain.txt", StringStream(b"plain contents"), 0)
+    m.add_subfile("compressed.txt", StringStream(b"compressed contents"), 6)
+    assert m.flush()
+    m.close()
+
+    vfs = VirtualFileSystem.get_global_ptr()
+    assert vfs.mount(filename, "/test_file_data_mf", 0)
+    try:
+        data = vfs.read_file_data("/test_file_data_mf/plain.txt", True)
+        assert data.get_subdata(0, data.size) == b"plain contents"
+        assert data.mapped
+
+        # Compressed subfiles are decompressed into a copy.
+        data = vfs.read_file_data("/test_file_data_mf/compressed.txt", True)
+        assert data.get_subdata(0, data.size) == b"compressed contents"
+        assert not data.mapped
+    finally:
+        vfs.unmount_point("/test_file_data_mf")
+
+
+def test_file_data_ramdisk():
+    vfs = VirtualFileSystem.get_global_ptr()
+    assert vfs.mount(VirtualFileMountRamdisk(), "/test_file_data_ramdisk", 0)
+    try:
+        assert vfs.write_file("/test_file_data_ramdisk/file.txt", b"ramdisk", False)
+        data = vfs.read_file_data("/test_file_data_ramdisk/file.txt", True)
+        assert data.get_subdata(0, data.size) == b"ramdisk"
+        assert not data.mapped
+    finally:
+        vfs.unmount_point("/test_file_data_ramdisk")
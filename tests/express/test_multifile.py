@@ -1,4 +1,5 @@
-from panda3d.core import Multifile, StringStream, IStreamWrapper
+from panda3d.core import Multifile, StringStream, IStreamWrapper, Filename
+import threading
 
 
 def test_multifile_read_empty():
@@ -10,3 +11,33 @@ def test_multifile_read_empty():
     assert m.is_read_valid()
     assert m.get_num_subfiles() == 0
     m.close()
+
+
+def test_multifile_read_concurrent(tmp_path):
+    filename = Filename.from_os_specific(str(tmp_path / "test.mf"))
+    contents = [bytes([i]) * (100000 + i) for i in range(8)]
+
+    m = Multifile()
+    assert m.open_write(filename)
+    for i, data in enumerate(contents):
+        m.add_subfile("file%d" % (i), StringStream(data), 6 if i % 2 else 0)
+    assert m.flush()
+    m.close()
+
+    m = Multifile()
+    assert m.open_read(filename)
+
+    errors = []
+    def read_all():
+        for i, data in enumerate(contents):
+            if m.read_subfile(m.find_subfile("file%d" % (i))) != data:
+                errors.append(i)
+
+    threads = [threading.Thread(target=read_all) for i in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert not errors
+    m.close()
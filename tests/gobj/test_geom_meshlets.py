@@ -0,0 +1,82 @@
+from panda3d.core import GeomVertexFormat, GeomVertexData, Geom
+from panda3d.core import GeomTriangles, GeomLines, GeomVertexWriter
+from panda3d.core import GeomVertexReader
+from panda3d.core import LVector3
+
+
+def make_grid(size):
+    vdata = GeomVertexData("grid", GeomVertexFormat.get_v3(), Geom.UH_static)
+    vertex = GeomVertexWriter(vdata, "vertex")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x, y, 0)
+
+    prim = GeomTriangles(Geom.UH_static)
+    for y in range(size):
+        for x in range(size):
+            a = y * (size + 1) + x
+            b = a + 1
+            c = a + size + 1
+            d = c + 1
+            prim.add_vertices(a, b, d)
+            prim.add_vertices(a, d, c)
+
+    geom = Geom(vdata)
+    geom.add_primitive(prim)
+    return geom
+
+
+def test_geom_make_meshlets():
+    geom = make_grid(16)
+    geom.optimize_vertex_cache_in_place()
+    assert geom.get_meshlets() is None
+
+    assert geom.make_meshlets(32, 40)
+    meshlets = geom.get_meshlets()
+    assert meshlets is not None
+    assert meshlets.get_num_meshlets() > 1
+
+    # The meshlets cover the whole index buffer in order.
+    reader = GeomVertexReader(geom.get_vertex_data(), "vertex")
+    prim = geom.get_primitive(0)
+    vertex_list = prim.get_vertex_list()
+    num_indices = 0
+    for n in range(meshlets.get_num_meshlets()):
+        assert meshlets.get_first_index(n) == num_indices
+        count = meshlets.get_num_indices(n)
+        assert 0 < count <= 40 * 3
+        num_indices += count
+
+        indices = vertex_list[num_indices - count:num_indices]
+        assert len(set(indices)) <= 32
+
+        # The bounding sphere contains all of the vertices.
+        center = meshlets.get_center(n)
+        radius = meshlets.get_radius(n)
+        for i in indices:
+            reader.set_row(i)
+            assert (reader.get_data3() - center).length() <= radius + 0.001
+
+        # The grid is flat, so the normals all point up.
+        assert meshlets.get_cone_axis(n).almost_equal(LVector3(0, 0, 1))
+        assert abs(meshlets.get_cone_cutoff(n)) < 0.001
+
+    assert num_indices == prim.get_num_vertices()
+
+    geom.clear_meshlets()
+    assert geom.get_meshlets() is None
+
+
+def test_geom_make_meshlets_unsupported():
+    vdata = GeomVertexData("lines", GeomVertexFormat.get_v3(), Geom.UH_static)
+    vertex = GeomVertexWriter(vdata, "vertex")
+    vertex.add_data3(0, 0, 0)
+    vertex.add_data3(1, 0, 0)
+
+    prim = GeomLines(Geom.UH_static)
+    prim.add_vertices(0, 1)
+    geom = Geom(vdata)
+    geom.add_primitive(prim)
+
+    assert not geom.make_meshlets()
+    assert geom.get_meshlets() is None
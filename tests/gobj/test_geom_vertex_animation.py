@@ -0,0 +1,117 @@
+from panda3d.core import GeomVertexArrayFormat, GeomVertexFormat, GeomVertexData, Geom
+from panda3d.core import GeomVertexAnimationSpec, GeomVertexReader, GeomVertexWriter
+from panda3d.core import TransformBlend, TransformBlendTable, UserVertexTransform
+from panda3d.core import SparseArray, Thread, LMatrix4, LPoint3, LVector3
+from panda3d.core import load_prc_file_data, unload_prc_file
+import pytest
+
+
+def make_vdata(num_rows, num_values=3):
+    array = GeomVertexArrayFormat()
+    array.add_column("vertex", num_values, Geom.NT_float32, Geom.C_point)
+    array.add_column("normal", 3, Geom.NT_float32, Geom.C_normal)
+    array.add_column("transform_blend", 1, Geom.NT_uint16, Geom.C_index)
+    format = GeomVertexFormat()
+    format.add_array(array)
+    spec = GeomVertexAnimationSpec()
+    spec.set_panda()
+    format.set_animation(spec)
+    format = GeomVertexFormat.register_format(format)
+
+    vdata = GeomVertexData("test", format, Geom.UH_static)
+    vdata.set_num_rows(num_rows)
+    vertex = GeomVertexWriter(vdata, 'vertex')
+    normal = GeomVertexWriter(vdata, 'normal')
+    blend = GeomVertexWriter(vdata, 'transform_blend')
+    for i in range(num_rows):
+        if num_values == 4:
+            vertex.set_data4(i, i + 1, -i, 1)
+        else:
+            vertex.set_data3(i, i + 1, -i)
+        normal.set_data3(0, 0, 1)
+        # Make runs of a few vertices that share the same blend.
+        blend.set_data1i((i // 3) % 2)
+
+    return vdata
+
+
+def test_animated_vertices():
+    vdata = make_vdata(20)
+
+    xform0 = UserVertexTransform("a")
+    xform0.set_matrix(LMatrix4.translate_mat(1, 2, 3))
+    xform1 = UserVertexTransform("b")
+    xform1.set_matrix(LMatrix4.scale_mat(2, 1, 4) * LMatrix4.translate_mat(0, 0, 1))
+
+    table = TransformBlendTable()
+    table.add_blend(TransformBlend(xform0, 1.0))
+    table.add_blend(TransformBlend(xform1, 1.0))
+    table.set_rows(SparseArray.range(0, 20))
+    vdata.set_transform_blend_table(table)
+
+    animated = vdata.animate_vertices(True, Thread.get_current_thread())
+    vertex = GeomVertexReader(animated, 'vertex')
+    normal = GeomVertexReader(animated, 'normal')
+    for i in range(20):
+        orig = LPoint3(i, i + 1, -i)
+        if (i // 3) % 2 == 0:
+            expected = orig + LVector3(1, 2, 3)
+        else:
+            expected = LPoint3(orig.x * 2, orig.y, orig.z * 4 + 1)
+        assert vertex.get_data3().almost_equal(expected)
+
+        # The normal is still perpendicular to the xy plane, and normalized.
+        assert normal.get_data3().almost_equal(LVector3(0, 0, 1))
+
+
+def test_animated_vertices_vec4():
+    vdata = make_vdata(10, num_values=4)
+
+    xform = UserVertexTransform("a")
+    xform.set_matrix(LMatrix4.translate_mat(1, 2, 3))
+
+    table = TransformBlendTable()
+    table.add_blend(TransformBlend(xform, 1.0))
+    table.add_blend(TransformBlend(xform, 1.0))
+    table.set_rows(SparseArray.range(0, 10))
+    vdata.set_transform_blend_table(table)
+
+    animated = vdata.animate_vertices(True, Thread.get_current_thread())
+    vertex = GeomVertexReader(animated, 'vertex')
+    for i in range(10):
+        assert vertex.get_data4().almost_equal((i + 1, i + 3, 3 - i, 1))
+
+
+def test_animated_vertices_parallel():
+    # Enough vertices to exceed the threshold, so they are transformed on
+    # several threads; the result should be the same as on one thread.
+    num_rows = 3000
+
+    xform0 = UserVertexTransform("a")
+    xform0.set_matrix(LMatrix4.translate_mat(1, 2, 3))
+    xform1 = UserVertexTransform("b")
+    xform1.set_matrix(LMatrix4.scale_mat(2, 1, 4) * LMatrix4.rotate_mat(30, (0, 1, 0)))
+
+    def animate(threshold):
+        vdata = make_vdata(num_rows)
+        table = TransformBlendTable()
+        table.add_blend(TransformBlend(xform0, 1.0))
+        table.add_blend(TransformBlend(xform1, 1.0))
+        table.set_rows(SparseArray.range(0, num_rows))
+        vdata.set_transform_blend_table(table)
+
+        page = load_prc_file_data("", "skinning-parallel-threshold %d" % (threshold))
+        try:
+            animated = vdata.animate_vertices(True, Thread.get_current_thread())
+        finally:
+            unload_prc_file(page)
+
+        vertex = GeomVertexReader(animated, 'vertex')
+        normal = GeomVertexReader(animated, 'normal')
+        return [(vertex.get_data3(), normal.get_data3()) for i in range(num_rows)]
+
+    serial = animate(0)
+    parallel = animate(100)
+    for (v1, n1), (v2, n2) in zip(serial, parallel):
+        assert v1 == v2
+        assert n1 == n2
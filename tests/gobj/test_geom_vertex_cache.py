@@ -0,0 +1,132 @@
+from panda3d.core import GeomVertexFormat, GeomVertexData, Geom, GeomNode
+from panda3d.core import GeomTriangles, GeomVertexReader, GeomVertexWriter
+from panda3d.core import SceneGraphReducer
+import random
+
+
+def make_grid(size, shuffle=True, unused=0):
+    vdata = GeomVertexData("grid", GeomVertexFormat.get_v3(), Geom.UH_static)
+    vdata.set_num_rows((size + 1) * (size + 1) + unused)
+    vertex = GeomVertexWriter(vdata, "vertex")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.set_data3(x, y, (x * y) % 3)
+
+    triangles = []
+    for y in range(size):
+        for x in range(size):
+            a = y * (size + 1) + x
+            b = a + 1
+            c = a + size + 1
+            d = c + 1
+            triangles.append((a, b, d))
+            triangles.append((a, d, c))
+
+    if shuffle:
+        random.Random(1).shuffle(triangles)
+
+    prim = GeomTriangles(Geom.UH_static)
+    for triangle in triangles:
+        prim.add_vertices(*triangle)
+
+    geom = Geom(vdata)
+    geom.add_primitive(prim)
+    return geom
+
+
+def get_triangles(geom):
+    """Returns the set of triangles by vertex position, with the winding
+    order preserved."""
+    reader = GeomVertexReader(geom.get_vertex_data(), "vertex")
+    prim = geom.get_primitive(0)
+    triangles = set()
+    for i in range(0, prim.get_num_vertices(), 3):
+        points = []
+        for j in range(3):
+            reader.set_row(prim.get_vertex(i + j))
+            points.append(tuple(reader.get_data3()))
+        first = points.index(min(points))
+        triangles.add(tuple(points[first:] + points[:first]))
+    return triangles
+
+
+def test_calc_acmr():
+    # Every vertex is a miss with an unindexed primitive.
+    prim = GeomTriangles(Geom.UH_static)
+    prim.add_next_vertices(6)
+    assert prim.calc_acmr(16) == 3
+
+    # Two triangles sharing an edge need only four vertices.
+    prim = GeomTriangles(Geom.UH_static)
+    prim.add_vertices(0, 1, 2)
+    prim.add_vertices(2, 1, 3)
+    assert prim.calc_acmr(16) == 2
+
+
+def test_optimize_vertex_cache():
+    geom = make_grid(16)
+    prim = geom.get_primitive(0)
+    before = prim.calc_acmr(16)
+    assert before > 2
+
+    optimized = geom.optimize_vertex_cache(16)
+    after = optimized.get_primitive(0).calc_acmr(16)
+    assert after < 1
+    assert optimized.calc_acmr(16) == after
+
+    # The same triangles are drawn, facing the same way.
+    assert optimized.get_primitive(0).get_num_faces() == prim.get_num_faces()
+    assert get_triangles(optimized) == get_triangles(geom)
+
+    # The original is unchanged.
+    assert geom.get_primitive(0).calc_acmr(16) == before
+
+
+def test_optimize_vertex_cache_sorted():
+    # Sorting the clusters to reduce overdraw only changes the cache
+    # efficiency at the boundaries between clusters, which hardly matters.
+    geom = make_grid(32)
+    prim = geom.get_primitive(0)
+    vdata = geom.get_vertex_data()
+
+    unsorted = prim.optimize_vertex_cache(16)
+    reordered = prim.optimize_vertex_cache(16, vdata)
+    assert reordered.get_num_faces() == prim.get_num_faces()
+    assert reordered.calc_acmr(16) < 1
+    assert abs(reordered.calc_acmr(16) - unsorted.calc_acmr(16)) < 0.01
+
+
+def test_reducer_optimize_vertex_cache():
+    geom = make_grid(8, unused=3)
+    triangles = get_triangles(geom)
+
+    node = GeomNode("test")
+    node.add_geom(geom)
+
+    gr = SceneGraphReducer()
+    before = gr.calc_acmr(node, 16)
+    assert gr.optimize_vertex_cache(node, cache_size=16) == 1
+    assert gr.calc_acmr(node, 16) < before
+
+    geom = node.get_geom(0)
+    assert get_triangles(geom) == triangles
+
+    # The vertices are now fetched in order, and the unused ones are gone.
+    assert geom.get_vertex_data().get_num_rows() == 81
+    prim = geom.get_primitive(0)
+    highest = -1
+    for i in range(prim.get_num_vertices()):
+        assert prim.get_vertex(i) <= highest + 1
+        highest = max(highest, prim.get_vertex(i))
+
+
+def test_reducer_avoid_dynamic():
+    geom = make_grid(4)
+    geom.modify_vertex_data().set_usage_hint(Geom.UH_dynamic)
+
+    node = GeomNode("test")
+    node.add_geom(geom)
+
+    gr = SceneGraphReducer()
+    assert gr.optimize_vertex_cache(node, SceneGraphReducer.OVC_avoid_dynamic) == 0
+    assert gr.optimize_vertex_cache(node, SceneGraphReducer.OVC_vertices) == 1
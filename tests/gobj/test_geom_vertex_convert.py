@@ -0,0 +1,131 @@
+from panda3d.core import GeomVertexArrayFormat, GeomVertexFormat, GeomVertexData, Geom
+from panda3d.core import GeomVertexReader, GeomVertexWriter
+
+
+def make_format(*arrays):
+    format = GeomVertexFormat()
+    for columns in arrays:
+        array = GeomVertexArrayFormat()
+        for name, num_components, numeric_type, contents in columns:
+            array.add_column(name, num_components, numeric_type, contents)
+        format.add_array(array)
+    return GeomVertexFormat.register_format(format)
+
+
+def make_vdata(num_rows):
+    format = make_format([
+        ("vertex", 3, Geom.NT_float32, Geom.C_point),
+        ("normal", 3, Geom.NT_float32, Geom.C_normal),
+        ("color", 4, Geom.NT_uint8, Geom.C_color),
+        ("texcoord", 2, Geom.NT_float32, Geom.C_texcoord),
+        ("index", 1, Geom.NT_uint32, Geom.C_index),
+    ])
+    vdata = GeomVertexData("test", format, Geom.UH_static)
+    vdata.set_num_rows(num_rows)
+
+    vertex = GeomVertexWriter(vdata, "vertex")
+    normal = GeomVertexWriter(vdata, "normal")
+    color = GeomVertexWriter(vdata, "color")
+    texcoord = GeomVertexWriter(vdata, "texcoord")
+    index = GeomVertexWriter(vdata, "index")
+    for i in range(num_rows):
+        vertex.set_data3(i, -i, i * 0.5)
+        normal.set_data3(0, 0, 1)
+        color.set_data4i(i % 256, 1, 2, 255)
+        texcoord.set_data2(i * 0.25, 1)
+        index.set_data1i(16777217 + i)
+    return vdata
+
+
+def test_convert_float64_packed_color():
+    vdata = make_vdata(20)
+    format = make_format([
+        ("vertex", 3, Geom.NT_float64, Geom.C_point),
+        ("normal", 3, Geom.NT_float32, Geom.C_normal),
+        ("color", 1, Geom.NT_packed_dabc, Geom.C_color),
+        ("texcoord", 2, Geom.NT_float16, Geom.C_texcoord),
+        ("index", 1, Geom.NT_int32, Geom.C_index),
+    ])
+    converted = vdata.convert_to(format)
+    assert converted.format == format
+    assert converted.get_num_rows() == 20
+
+    vertex = GeomVertexReader(converted, "vertex")
+    normal = GeomVertexReader(converted, "normal")
+    color = GeomVertexReader(converted, "color")
+    texcoord = GeomVertexReader(converted, "texcoord")
+    index = GeomVertexReader(converted, "index")
+    for i in range(20):
+        assert vertex.get_data3() == (i, -i, i * 0.5)
+        assert normal.get_data3() == (0, 0, 1)
+        assert color.get_data4i() == (i % 256, 1, 2, 255)
+        assert texcoord.get_data2() == (i * 0.25, 1)
+
+        # This is too large to survive a round trip through a float.
+        assert index.get_data1i() == 16777217 + i
+
+
+def test_convert_split_arrays():
+    vdata = make_vdata(10)
+    format = make_format(
+        [("normal", 3, Geom.NT_float32, Geom.C_normal),
+         ("vertex", 3, Geom.NT_float32, Geom.C_point)],
+        [("color", 4, Geom.NT_float32, Geom.C_color)],
+        [("texcoord", 2, Geom.NT_float32, Geom.C_texcoord),
+         ("binormal", 3, Geom.NT_float32, Geom.C_vector)],
+    )
+    converted = vdata.convert_to(format)
+    assert converted.get_num_arrays() == 3
+
+    vertex = GeomVertexReader(converted, "vertex")
+    normal = GeomVertexReader(converted, "normal")
+    color = GeomVertexReader(converted, "color")
+    texcoord = GeomVertexReader(converted, "texcoord")
+    for i in range(10):
+        assert vertex.get_data3() == (i, -i, i * 0.5)
+        assert normal.get_data3() == (0, 0, 1)
+        assert color.get_data4().almost_equal(((i % 256) / 255.0, 1 / 255.0, 2 / 255.0, 1))
+        assert texcoord.get_data2() == (i * 0.25, 1)
+
+    # Converting back gives the original data.
+    back = converted.convert_to(vdata.format)
+    vertex = GeomVertexReader(back, "vertex")
+    color = GeomVertexReader(back, "color")
+    for i in range(10):
+        assert vertex.get_data3() == (i, -i, i * 0.5)
+        assert color.get_data4i() == (i % 256, 1, 2, 255)
+
+
+def test_convert_subset_shares_array():
+    vdata = make_vdata(5)
+    array = GeomVertexArrayFormat()
+    array.add_column("vertex", 3, Geom.NT_float32, Geom.C_point)
+    array.add_column("normal", 3, Geom.NT_float32, Geom.C_normal)
+    array.set_stride(vdata.format.get_array(0).stride)
+    format = GeomVertexFormat()
+    format.add_array(array)
+    format = GeomVertexFormat.register_format(format)
+    converted = vdata.convert_to(format)
+
+    # The original array can be used as-is, since it contains the columns at
+    # the same positions, with the same stride.
+    assert converted.get_array(0) == vdata.get_array(0)
+
+    vertex = GeomVertexReader(converted, "vertex")
+    for i in range(5):
+        assert vertex.get_data3() == (i, -i, i * 0.5)
+
+
+def test_convert_point_add_w():
+    vdata = make_vdata(3)
+    format = make_format([
+        ("vertex", 4, Geom.NT_float32, Geom.C_point),
+        ("normal", 3, Geom.NT_float64, Geom.C_normal),
+    ])
+    converted = vdata.convert_to(format)
+
+    vertex = GeomVertexReader(converted, "vertex")
+    normal = GeomVertexReader(converted, "normal")
+    for i in range(3):
+        assert vertex.get_data4() == (i, -i, i * 0.5, 1)
+        assert normal.get_data3() == (0, 0, 1)
@@ -0,0 +1,184 @@
+from panda3d.core import GeomVertexArrayFormat, GeomVertexFormat, GeomVertexData, Geom, GeomNode
+from panda3d.core import GeomVertexReader, GeomVertexWriter, SceneGraphReducer, PandaNode
+from panda3d.core import LVector3
+import pytest
+
+
+def make_vdata(columns, num_rows=1):
+    array = GeomVertexArrayFormat()
+    for name, num_components, numeric_type, contents in columns:
+        array.add_column(name, num_components, numeric_type, contents)
+    format = GeomVertexFormat()
+    format.add_array(array)
+    format = GeomVertexFormat.register_format(format)
+
+    vdata = GeomVertexData("test", format, Geom.UH_static)
+    vdata.set_num_rows(num_rows)
+    return vdata
+
+
+def test_float16_texcoord():
+    vdata = make_vdata([("texcoord", 2, Geom.NT_float16, Geom.C_texcoord)], 4)
+    assert vdata.format.get_array(0).stride == 4
+
+    values = [(0, 0), (1, -1), (0.5, 0.25), (100.5, -2048)]
+    writer = GeomVertexWriter(vdata, "texcoord")
+    for value in values:
+        writer.set_data2(value)
+
+    reader = GeomVertexReader(vdata, "texcoord")
+    for value in values:
+        assert reader.get_data2() == value
+
+
+def test_float16_precision():
+    vdata = make_vdata([("texcoord", 1, Geom.NT_float16, Geom.C_other)])
+    writer = GeomVertexWriter(vdata, "texcoord")
+    reader = GeomVertexReader(vdata, "texcoord")
+
+    for value in (0.1, -3.3, 1.0 / 3.0, 1e-4, 65504.0):
+        writer.set_row(0)
+        writer.set_data1(value)
+        reader.set_row(0)
+        assert reader.get_data1() == pytest.approx(value, rel=1e-3)
+
+    # Too large to be represented.
+    writer.set_row(0)
+    writer.set_data1(1e6)
+    reader.set_row(0)
+    assert reader.get_data1() == float("inf")
+
+
+def test_packed_snorm10_tangent():
+    vdata = make_vdata([("tangent", 1, Geom.NT_packed_snorm10, Geom.C_vector)])
+    assert vdata.format.get_array(0).stride == 4
+    assert vdata.format.get_column("tangent").num_values == 4
+
+    writer = GeomVertexWriter(vdata, "tangent")
+    writer.set_data4(0.6, -0.8, 0, -1)
+
+    reader = GeomVertexReader(vdata, "tangent")
+    assert reader.get_data4().almost_equal((0.6, -0.8, 0, -1), 0.002)
+    reader.set_row(0)
+    assert reader.get_data3().almost_equal((0.6, -0.8, 0), 0.002)
+
+    # Out-of-range values are clamped.
+    writer.set_row(0)
+    writer.set_data4(2, -2, 1, 1)
+    reader.set_row(0)
+    assert reader.get_data4() == (1, -1, 1, 1)
+
+
+@pytest.mark.parametrize("normal", [
+    (0, 0, 1), (0, 0, -1), (1, 0, 0), (0, -1, 0),
+    (1, 2, 3), (-1, 2, -3), (0.1, -0.7, -0.2),
+])
+def test_packed_oct16_normal(normal):
+    vdata = make_vdata([("normal", 1, Geom.NT_packed_oct16, Geom.C_normal)])
+    assert vdata.format.get_array(0).stride == 4
+    assert vdata.format.get_column("normal").num_values == 3
+
+    writer = GeomVertexWriter(vdata, "normal")
+    writer.set_data3(normal)
+
+    # Only the direction is preserved.
+    reader = GeomVertexReader(vdata, "normal")
+    assert reader.get_data3().almost_equal(LVector3(normal).normalized(), 1e-4)
+
+
+def test_quantize_vertices():
+    vdata = make_vdata([
+        ("vertex", 3, Geom.NT_float32, Geom.C_point),
+        ("normal", 3, Geom.NT_float32, Geom.C_normal),
+        ("tangent", 3, Geom.NT_float32, Geom.C_vector),
+        ("texcoord", 2, Geom.NT_float32, Geom.C_texcoord),
+    ], 2)
+    assert vdata.format.get_array(0).stride == 44
+
+    vertex = GeomVertexWriter(vdata, "vertex")
+    normal = GeomVertexWriter(vdata, "normal")
+    tangent = GeomVertexWriter(vdata, "tangent")
+    texcoord = GeomVertexWriter(vdata, "texcoord")
+    vertex.add_data3(1, 2, 3)
+    normal.add_data3(0, 0, 1)
+    tangent.add_data3(1, 0, 0)
+    texcoord.add_data2(0.5, 0.75)
+    vertex.add_data3(4, 5, 6)
+    normal.add_data3(0, -1, 0)
+    tangent.add_data3(0, 0, -1)
+    texcoord.add_data2(2, -1)
+
+    node = GeomNode("test")
+    node.add_geom(Geom(vdata))
+
+    gr = SceneGraphReducer()
+    assert gr.quantize_vertices(node) == 1
+
+    format = node.get_geom(0).get_vertex_data().format
+    assert format.get_column("vertex").numeric_type == Geom.NT_float32
+    assert format.get_column("normal").numeric_type == Geom.NT_packed_oct16
+    assert format.get_column("tangent").numeric_type == Geom.NT_packed_snorm10
+    assert format.get_column("texcoord").numeric_type == Geom.NT_float16
+    assert format.get_array(0).stride == 24
+
+    # Doing it again changes nothing.
+    assert gr.quantize_vertices(node) == 0
+
+    # The data survives a round trip through a .bam stream.
+    node = PandaNode.decode_from_bam_stream(node.encode_to_bam_stream())
+    vdata = node.get_geom(0).get_vertex_data()
+    vertex = GeomVertexReader(vdata, "vertex")
+    normal = GeomVertexReader(vdata, "normal")
+    tangent = GeomVertexReader(vdata, "tangent")
+    texcoord = GeomVertexReader(vdata, "texcoord")
+    assert vertex.get_data3() == (1, 2, 3)
+    assert normal.get_data3().almost_equal((0, 0, 1), 1e-4)
+    assert tangent.get_data3().almost_equal((1, 0, 0), 0.002)
+    assert texcoord.get_data2() == (0.5, 0.75)
+    assert vertex.get_data3() == (4, 5, 6)
+    assert normal.get_data3().almost_equal((0, -1, 0), 1e-4)
+    assert tangent.get_data3().almost_equal((0, 0, -1), 0.002)
+    assert texcoord.get_data2() == (2, -1)
+
+
+def test_quantized_write_old_bam():
+    from panda3d.core import DatagramBuffer, BamWriter, BamReader
+
+    vdata = make_vdata([("vertex", 3, Geom.NT_float32, Geom.C_point),
+                        ("normal", 1, Geom.NT_packed_oct16, Geom.C_normal),
+                        ("texcoord", 2, Geom.NT_float16, Geom.C_texcoord)], 2)
+    vertex = GeomVertexWriter(vdata, "vertex")
+    normal = GeomVertexWriter(vdata, "normal")
+    texcoord = GeomVertexWriter(vdata, "texcoord")
+    for i in range(2):
+        vertex.set_data3(i, 2, 3)
+        normal.set_data3(0, 0, 1)
+        texcoord.set_data2(0.5, i)
+
+    # A file of version 6.45 can't hold these types, so they are written as
+    # 32-bit floats instead.
+    buffer = DatagramBuffer()
+    writer = BamWriter(buffer)
+    writer.set_file_minor_ver(45)
+    writer.init()
+    writer.write_object(vdata)
+    writer.flush()
+
+    reader = BamReader(DatagramBuffer(buffer.data))
+    reader.init()
+    assert reader.file_version == (6, 45)
+    result = reader.read_object()
+    reader.resolve()
+
+    array = result.format.get_array(0)
+    assert array.get_column("normal").numeric_type == Geom.NT_float32
+    assert array.get_column("normal").num_components == 3
+    assert array.get_column("texcoord").numeric_type == Geom.NT_float32
+
+    vertex = GeomVertexReader(result, "vertex")
+    normal = GeomVertexReader(result, "normal")
+    texcoord = GeomVertexReader(result, "texcoord")
+    for i in range(2):
+        assert vertex.get_data3() == (i, 2, 3)
+        assert normal.get_data3().almost_equal(LVector3(0, 0, 1))
+        assert texcoord.get_data2() == (0.5, i)
@@ -0,0 +1,131 @@
+from panda3d import core
+from panda3d.core import Texture, TexturePool, TextureStreamer, Filename
+import pytest
+
+
+@pytest.fixture
+def image_path(tmp_path):
+    img = core.PNMImage(256, 128, 3)
+    img.fill(0.25, 0.5, 0.75)
+    path = Filename.from_os_specific(str(tmp_path / "stream.png"))
+    assert img.write(path)
+    return path
+
+
+@pytest.fixture
+def tex(image_path):
+    tex = Texture()
+    assert tex.read(image_path)
+    return tex
+
+
+def test_texture_stream_level(tex):
+    assert tex.stream_level == 0
+
+    tex.set_stream_level(2)
+    assert tex.stream_level == 2
+    assert tex.get_x_size() == 64 and tex.get_y_size() == 32
+    assert tex.get_ram_image_size() == 64 * 32 * 3
+
+    # Asking for the larger levels back reloads them from disk.
+    tex.set_stream_level(1)
+    assert tex.stream_level == 1
+    assert tex.get_x_size() == 128 and tex.get_y_size() == 64
+    assert tex.get_ram_image_size() == 128 * 64 * 3
+
+    tex.set_stream_level(0)
+    assert tex.get_x_size() == 256 and tex.get_y_size() == 128
+
+
+def test_texture_stream_level_reload(tex):
+    # The level is kept when the image is reloaded.
+    tex.set_stream_level(3)
+    tex.clear_ram_image()
+    assert tex.get_x_size() == 32
+    assert len(tex.get_ram_image().get_data()) == 32 * 16 * 3
+    assert tex.stream_level == 3
+
+
+def test_texture_streamer(tex):
+    streamer = TextureStreamer()
+    streamer.initial_size = 32
+    assert streamer.add_texture(tex)
+    assert streamer.has_texture(tex)
+    assert tex.is_streamed()
+    assert tex.stream_level == 3
+    assert tex.get_x_size() == 32
+
+    # Nothing happens while the texture isn't rendered.
+    streamer.update()
+    assert tex.stream_level == 3
+
+    # The texture is loaded at the size it is rendered at in one update.
+    tex.report_stream_demand(100)
+    streamer.update()
+    assert tex.get_x_size() == 128
+    assert tex.stream_level == 1
+
+    tex.report_stream_demand(100)
+    streamer.update()
+    assert tex.get_x_size() == 128
+
+    assert streamer.remove_texture(tex)
+    assert not tex.is_streamed()
+    assert tex.get_x_size() == 256
+
+
+def test_texture_streamer_budget(tex):
+    streamer = TextureStreamer()
+    streamer.initial_size = 32
+    assert streamer.add_texture(tex)
+    for i in range(3):
+        tex.report_stream_demand(1000)
+        streamer.update()
+    assert tex.stream_level == 0
+    large_size = streamer.resident_size
+
+    # Shrinking the budget reduces the texture once it is no longer seen.
+    streamer.budget = large_size // 4
+    tex.report_stream_demand(1000)
+    streamer.update()
+    assert tex.stream_level == 0
+
+    streamer.update()
+    assert tex.stream_level > 0
+    assert streamer.resident_size <= streamer.budget
+
+    # And it can't grow past the budget.
+    tex.report_stream_demand(1000)
+    streamer.update()
+    assert streamer.resident_size <= streamer.budget
+
+
+def test_texture_streamer_reject(tex):
+    streamer = TextureStreamer()
+    streamer.initial_size = 256
+    assert not streamer.add_texture(tex)
+
+    streamer.initial_size = 32
+    empty = Texture()
+    empty.setup_2d_texture(256, 256, Texture.T_unsigned_byte, Texture.F_rgb)
+    assert not streamer.add_texture(empty)
+    assert streamer.num_textures == 0
+
+
+def test_texture_pool_streaming(image_path):
+    streamer = TexturePool.get_streamer()
+    streamer.initial_size = 32
+
+    page = core.load_prc_file_data("", "texture-streaming 1")
+    try:
+        tex = TexturePool.load_texture(image_path)
+    finally:
+        core.unload_prc_file(page)
+
+    assert tex is not None
+    assert streamer.has_texture(tex)
+    assert tex.get_x_size() == 32 and tex.get_y_size() == 16
+    assert len(tex.get_ram_image().get_data()) == 32 * 16 * 3
+
+    assert streamer.remove_texture(tex)
+    TexturePool.release_texture(tex)
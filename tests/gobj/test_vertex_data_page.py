@@ -0,0 +1,51 @@
+from panda3d import core
+import pytest
+
+
+def test_vertex_data_compression_available():
+    assert core.VertexDataPage.is_compression_available(core.VDC_none)
+
+    # The default codec is zlib, which all builds are expected to have.
+    var = core.ConfigVariableString("vertex-data-compression")
+    assert var.value == "zlib"
+
+
+def test_vertex_data_save_file_compression_default():
+    var = core.ConfigVariableString("vertex-save-file-compression")
+    assert var.value == "none"
+
+
+@pytest.mark.parametrize("codec", ["zlib", "lz4", "zstd"])
+def test_vertex_data_compression_round_trip(codec):
+    compression = getattr(core, "VDC_" + codec)
+    if not core.VertexDataPage.is_compression_available(compression):
+        pytest.skip("%s is not available" % (codec))
+
+    # Some compressible data, which isn't all the same byte.
+    format = core.GeomVertexArrayFormat("data", 4, core.Geom.NT_uint8, core.Geom.C_other)
+    format = core.GeomVertexArrayFormat.register_format(format)
+    array = core.GeomVertexArrayData(format, core.Geom.UH_static)
+    data = bytes(bytearray((i // 7) % 251 for i in range(256 * 1024)))
+    array.modify_handle().set_data(data)
+
+    independent_lru = core.GeomVertexArrayData.get_independent_lru()
+    resident_lru = core.VertexDataPage.get_global_lru(core.VertexDataPage.RC_resident)
+    compressed_lru = core.VertexDataPage.get_global_lru(core.VertexDataPage.RC_compressed)
+    compressed_max_size = compressed_lru.get_max_size()
+
+    page = core.load_prc_file_data("", "vertex-data-compression " + codec)
+    try:
+        compressed_lru.set_max_size(1 << 30)
+
+        # Page the array out to the book, then evict the page to the
+        # compressed state.
+        independent_lru.evict_to(0)
+        resident_lru.evict_to(0)
+        core.VertexDataPage.flush_threads()
+        assert compressed_lru.get_total_size() > 0
+
+        # Reading it back decompresses it again.
+        assert array.get_handle().get_data() == data
+    finally:
+        compressed_lru.set_max_size(compressed_max_size)
+        core.unload_prc_file(page)
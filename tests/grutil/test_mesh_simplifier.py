@@ -0,0 +1,117 @@
+from panda3d.core import GeomVertexFormat, GeomVertexData, Geom, GeomNode
+from panda3d.core import GeomTriangles, GeomVertexWriter, NodePath, LODNode
+from panda3d.core import MeshSimplifier
+import math
+
+
+def make_grid(size, seam=None):
+    """Makes a gently curved grid of size x size squares.  If seam is given,
+    the vertices in that column are duplicated with different texture
+    coordinates for the squares on either side of it.  Returns the Geom and
+    a dictionary mapping (x, y, side) to the row of each vertex."""
+
+    vdata = GeomVertexData("grid", GeomVertexFormat.get_v3t2(), Geom.UH_static)
+    vertex = GeomVertexWriter(vdata, "vertex")
+    texcoord = GeomVertexWriter(vdata, "texcoord")
+
+    rows = {}
+    def add_vertex(x, y, side):
+        key = (x, y, side if x == seam else 0)
+        if key not in rows:
+            rows[key] = vertex.get_write_row()
+            vertex.add_data3(x, y, math.sin(x * 0.2) + math.cos(y * 0.2))
+            texcoord.add_data2(x / size + key[2], y / size)
+        return rows[key]
+
+    prim = GeomTriangles(Geom.UH_static)
+    for y in range(size):
+        for x in range(size):
+            side = 0 if seam is None or x < seam else 1
+            a = add_vertex(x, y, side)
+            b = add_vertex(x + 1, y, side)
+            c = add_vertex(x, y + 1, side)
+            d = add_vertex(x + 1, y + 1, side)
+            prim.add_vertices(a, b, d)
+            prim.add_vertices(a, d, c)
+
+    geom = Geom(vdata)
+    geom.add_primitive(prim)
+    return geom, rows
+
+
+def count_triangles(node):
+    count = 0
+    for geom_np in NodePath(node).find_all_matches("**/+GeomNode"):
+        for geom in geom_np.node().get_geoms():
+            for prim in geom.get_primitives():
+                count += prim.get_num_faces()
+    return count
+
+
+def test_simplify_geom():
+    geom, rows = make_grid(16)
+    simplifier = MeshSimplifier()
+    simplifier.target_error = 1.0
+    simple = simplifier.simplify_geom(geom, 0.25)
+
+    num_faces = simple.get_primitive(0).get_num_faces()
+    assert 0 < num_faces <= 512 * 0.25
+
+    # No new vertices are made.
+    assert simple.get_vertex_data() == geom.get_vertex_data()
+
+    # The corners of the grid are still there.
+    vertices = set(simple.get_primitive(0).get_vertex_list())
+    for corner in ((0, 0), (16, 0), (0, 16), (16, 16)):
+        assert rows[corner + (0,)] in vertices
+
+
+def test_simplify_target_error():
+    geom, rows = make_grid(16)
+    simplifier = MeshSimplifier()
+
+    # A tiny error allows only the flattest parts to be simplified.
+    simplifier.target_error = 1e-6
+    simple = simplifier.simplify_geom(geom, 0.25)
+    assert simple.get_primitive(0).get_num_faces() > 512 * 0.25
+
+
+def test_simplify_keeps_seam():
+    geom, rows = make_grid(16, seam=8)
+
+    simplifier = MeshSimplifier()
+    simplifier.target_error = 1.0
+    simple = simplifier.simplify_geom(geom, 0.25)
+    assert simple.get_primitive(0).get_num_faces() < 512
+
+    # Neither copy of the seam vertices is moved away.
+    vertices = set(simple.get_primitive(0).get_vertex_list())
+    for y in range(17):
+        assert rows[(8, y, 0)] in vertices
+        assert rows[(8, y, 1)] in vertices
+
+
+def test_make_lod():
+    root = NodePath("root")
+    node = GeomNode("model")
+    node.add_geom(make_grid(16)[0])
+    model = root.attach_new_node(node)
+
+    simplifier = MeshSimplifier()
+    simplifier.target_error = 1.0
+    lod = simplifier.make_lod(model, 3, 0.5, 10, 40)
+
+    assert isinstance(lod.node(), LODNode)
+    assert lod.get_parent() == root
+    assert model.get_parent() == lod
+    assert model.node() == node
+
+    assert lod.node().get_num_switches() == 3
+    assert lod.node().get_out(0) == 0
+    assert lod.node().get_in(0) == 10
+    assert lod.node().get_in(1) == 20
+    assert lod.node().get_in(2) == 40
+
+    counts = [count_triangles(child) for child in lod.node().get_children()]
+    assert counts[0] == 512
+    assert counts[0] > counts[1] > counts[2] > 0
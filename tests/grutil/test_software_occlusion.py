@@ -0,0 +1,74 @@
+from panda3d.core import NodePath, Camera, PerspectiveLens, CardMaker
+from panda3d.core import SoftwareOcclusionCullTraverser, PNMImage
+
+
+def make_card(parent, name, size, pos):
+    cm = CardMaker(name)
+    cm.set_frame(-size, size, -size, size)
+    card = parent.attach_new_node(cm.generate())
+    card.set_pos(pos)
+    return card
+
+
+def make_scene():
+    root = NodePath("root")
+    camera = root.attach_new_node(Camera("camera", PerspectiveLens()))
+
+    occluders = NodePath("occluders")
+    make_card(occluders, "wall", 2, (0, 10, 0))
+    return root, camera, occluders
+
+
+def test_software_occlusion():
+    root, camera, occluders = make_scene()
+    trav = SoftwareOcclusionCullTraverser()
+    trav.set_size(128, 64)
+    trav.add_occluder(occluders)
+    assert trav.get_num_occluders() == 1
+
+    behind = make_card(root, "behind", 0.5, (0, 20, 0))
+    beside = make_card(root, "beside", 0.5, (5, 20, 0))
+    front = make_card(root, "front", 0.5, (0, 5, 0))
+
+    # Nothing has been rendered yet.
+    assert not trav.is_occluded(behind)
+
+    trav.render_occluders(camera)
+    assert trav.get_num_occluder_triangles() == 2
+    assert trav.is_occluded(behind)
+    assert not trav.is_occluded(beside)
+    assert not trav.is_occluded(front)
+
+    # The wall doesn't occlude itself.
+    assert not trav.is_occluded(occluders.find("wall"))
+
+    # Looking from the other side, the wall no longer hides the card.
+    camera.set_pos(0, 30, 0)
+    camera.look_at(0, 0, 0)
+    trav.render_occluders(camera)
+    assert not trav.is_occluded(behind)
+
+
+def test_software_occlusion_depth():
+    root, camera, occluders = make_scene()
+    trav = SoftwareOcclusionCullTraverser()
+    trav.set_size(64, 32)
+    trav.add_occluder(occluders)
+    trav.render_occluders(camera)
+
+    # The wall is in the middle of the buffer, and the pyramid goes down to a
+    # single pixel.
+    image = PNMImage()
+    trav.store_depth(image)
+    assert image.get_x_size() == 64 and image.get_y_size() == 32
+    assert image.get_gray(32, 16) < 1.0
+    assert image.get_gray(0, 0) == 1.0
+
+    assert trav.get_num_levels() == 7
+    trav.store_depth(image, trav.get_num_levels() - 1)
+    assert image.get_x_size() == 1 and image.get_y_size() == 1
+    assert image.get_gray(0, 0) == 1.0
+
+    trav.clear_occluders()
+    trav.render_occluders(camera)
+    assert trav.get_num_occluder_triangles() == 0
@@ -0,0 +1,82 @@
+from panda3d import core
+from panda3d.core import BamFile, BamWriter, Filename, GeomNode, Geom
+from panda3d.core import GeomVertexData, GeomVertexFormat, GeomVertexWriter
+from panda3d.core import GeomVertexReader, GeomTriangles, Texture, RenderState
+from panda3d.core import TextureAttrib
+import pytest
+
+
+@pytest.fixture
+def payload_config():
+    page = core.load_prc_file_data("", "bam-version 6 47\n"
+                                       "bam-payload-min-size 0")
+    yield
+    core.unload_prc_file(page)
+
+
+def make_scene(num_rows):
+    vdata = GeomVertexData("test", GeomVertexFormat.get_v3(), Geom.UH_static)
+    vdata.set_num_rows(num_rows)
+    writer = GeomVertexWriter(vdata, "vertex")
+    for i in range(num_rows):
+        writer.set_data3(i, -i, i * 0.5)
+
+    tris = GeomTriangles(Geom.UH_static)
+    tris.add_next_vertices(num_rows - num_rows % 3)
+    geom = Geom(vdata)
+    geom.add_primitive(tris)
+
+    tex = Texture("tex")
+    tex.setup_2d_texture(16, 16, Texture.T_unsigned_byte, Texture.F_rgba)
+    tex.set_ram_image(bytes(range(256)) * 4)
+
+    node = GeomNode("node")
+    node.add_geom(geom, RenderState.make(TextureAttrib.make(tex)))
+    return node
+
+
+def write_and_read(node, tmp_path, name="payload.bam"):
+    filename = Filename.from_os_specific(str(tmp_path / name))
+    bam = BamFile()
+    assert bam.open_write(filename)
+    assert bam.writer.get_file_minor_ver() == 47
+    bam.writer.set_file_texture_mode(BamWriter.BTM_rawdata)
+    assert bam.write_object(node)
+    bam.close()
+
+    assert bam.open_read(filename)
+    result = bam.read_node()
+    bam.close()
+    return result
+
+
+@pytest.mark.parametrize("name", ["payload.bam", "payload.bam.pz"])
+def test_bam_payload(payload_config, tmp_path, name):
+    # A compressed file can't be mapped, so its payloads are copied instead.
+    node = write_and_read(make_scene(1000), tmp_path, name)
+    assert node is not None
+    assert node.get_num_geoms() == 1
+
+    geom = node.get_geom(0)
+    reader = GeomVertexReader(geom.get_vertex_data(), "vertex")
+    for i in range(1000):
+        assert reader.get_data3() == (i, -i, i * 0.5)
+
+    prim = geom.get_primitive(0)
+    assert prim.get_num_vertices() == 999
+    assert prim.get_vertex(998) == 998
+
+    tex = node.get_geom_state(0).get_attrib(TextureAttrib).get_texture()
+    assert tex.get_ram_image().get_data() == bytes(range(256)) * 4
+
+
+def test_bam_payload_modify(payload_config, tmp_path):
+    node = write_and_read(make_scene(100), tmp_path)
+    vdata = node.modify_geom(0).modify_vertex_data()
+
+    # Writing to data that was read from the file makes a copy first.
+    writer = GeomVertexWriter(vdata, "vertex")
+    writer.set_data3(7, 8, 9)
+    reader = GeomVertexReader(vdata, "vertex")
+    assert reader.get_data3() == (7, 8, 9)
+    assert reader.get_data3() == (1, -1, 0.5)
@@ -0,0 +1,46 @@
+from panda3d import core
+
+
+def cache_entries(states):
+    return sum(state.get_composition_cache_num_entries() +
+               state.get_invert_composition_cache_num_entries()
+               for state in states)
+
+
+# Entries are evicted a few at a time, so the caches may briefly exceed the
+# limit, but not by much.
+SLACK = 32
+
+
+def test_composition_cache_limit():
+    limit = core.ConfigVariableInt("composition-cache-limit")
+    old_value = limit.value
+    try:
+        limit.value = 64
+
+        transforms = [core.TransformState.make_pos((i, 0, 4321.5)) for i in range(40)]
+        for a in transforms:
+            for b in transforms:
+                result = a.compose(b)
+                assert result.pos == a.pos + b.pos
+                assert cache_entries(transforms) <= 64 + SLACK
+
+                result = a.invert_compose(b)
+                assert result.pos == b.pos - a.pos
+                assert cache_entries(transforms) <= 64 + SLACK
+
+        states = [core.RenderState.make(core.ColorAttrib.make_flat((i / 40.0, 0, 1, 1)))
+                  for i in range(40)]
+        for a in states:
+            for b in states:
+                assert a.compose(b) == b
+                assert cache_entries(states) <= 64 + SLACK
+
+        # A recently used composition is the last to be evicted.
+        transforms[0].compose(transforms[1])
+        assert transforms[0].get_composition_cache_num_entries() > 0
+    finally:
+        limit.value = old_value
+
+    assert core.TransformState.validate_states()
+    assert core.RenderState.validate_states()
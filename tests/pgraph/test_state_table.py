@@ -0,0 +1,45 @@
+from panda3d import core
+import threading
+
+
+def make_states(results, index):
+    states = []
+    for i in range(200):
+        color = core.ColorAttrib.make_flat((i / 200.0, 0, 0, 1))
+        state = core.RenderState.make(color, core.CullFaceAttrib.make_reverse())
+        transform = core.TransformState.make_pos((i, index % 2, 0))
+        states.append((state, transform))
+    results[index] = states
+
+
+def test_state_table_threads():
+    results = [None] * 4
+    threads = [threading.Thread(target=make_states, args=(results, i))
+               for i in range(len(results))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    # Equivalent states made on different threads must be shared.
+    for states in results[1:]:
+        for (state, transform), (state0, transform0) in zip(states, results[0]):
+            assert state.this == state0.this
+            assert (transform.this == transform0.this) == (transform.pos == transform0.pos)
+
+    assert core.RenderState.validate_states()
+    assert core.TransformState.validate_states()
+    assert core.RenderState.get_num_lock_contentions() >= 0
+    assert core.TransformState.get_num_lock_contentions() >= 0
+
+
+def test_state_table_garbage_collect():
+    num_states = core.TransformState.get_num_states()
+    transforms = [core.TransformState.make_pos((i, 0, 1234.5)) for i in range(100)]
+    num_with_transforms = core.TransformState.get_num_states()
+    assert num_with_transforms >= num_states + 100
+
+    transforms = None
+    core.TransformState.garbage_collect()
+    assert core.TransformState.get_num_states() <= num_with_transforms - 100
+    assert core.TransformState.validate_states()